@@ -1,64 +1,39 @@
 //Esta es una biblioteca con una estructura que implementa una tabla hash con Open Addressing
-#include <stdio.h>
-#include <stdlib.h>
-#include <stdint.h>
-#include <assert.h>
-#include <string.h>
-#include <time.h>
-
-//Definimos macros (cuando el PC compile, YES lo traduce a 1 y NO a 0... no son variables globales)
-#define YES 1
-#define NO 0
-#define VALID 1
-#define NOTVALID 0
-#define DELETED NOTVALID
+#include "ht_common.h"
+#include <signal.h>
+#include <sched.h>
+
+//Macros propias de Open Addressing (las comunes están en ht_common.h)
 #define LAZY_DELETED -1
-#define MAX_64 2147483647
-#define FULL 2
-#define EMPTY 1
-#define UP 1
-#define DOWN 0
 #define LP 1
 #define QP 2
 #define DH 3
+#define HS 4
+#define CO 5
+#define PK 6
+#define SH 7
+#define HOP_RANGE 31
+#define HOP_OVERFLOW (1u<<31)
+#define HOP_FAIL ((size_t)-1)
+#define PROBE_FAIL ((size_t)-1)        //El sondeo de LP, QP o DH no encontró casilla libre
 
-//En este arreglo se contienen los números primos menores a cada potencia de 2 (hasta 2^16)
-const uint32_t HASH_SIZE[] = {5, 23, 127, 251, 509, 1021, 2039, 4093, 8191, 16381, 32749, 65521, 131071, 262139, 524287, 1048573, 2097143, 4194301, 8388593, 16777213, 33554393, 67108859, 134217689, 268435399, 536870909, 1073741789, 2147483647, 4294967291};
-
-//Constante de ADLER
-const uint32_t MOD_ADLER = 65521;
-
-//Variable Global para la histéresis
-int hist = 0;
+//Variable Global para la histéresis (una por hilo: en la repetición de trazas cada hilo tiene su propia tabla)
+__thread int hist = 0;
 
 int aux = 0;
 
-/*Función generador de llaves*/
-uint32_t adler32(unsigned char *data, size_t len) {
-    uint32_t a = 1, b = 0;
-    size_t index;
-
-    //Process each byte of the data in order
-    for (index = 0; index < len; ++index){
-        a = (a + data[index]) % MOD_ADLER;
-        b = (b + a) % MOD_ADLER;
-    }
-    return (b << 16) | a; //Aquí se recorre b 16 bits a la izquierda y después cada bit de b se opera OR con el respectivo bit de a
-}
-
-/*Estructura tipo record para incluir la longitud de cadena y los bytes de una información (como un stream de datos, con un puntero al inicio y de ahí sabemos la longitud)*/
-typedef struct{
-    void *bytes;                //El "void" es para que podamos decir que es un puntero de cualquier tipo de datos
-    size_t len;                 //Longitud del contenido
-}record;
-
 /*Estos será el tipo de estructura de un elemento de una tabla hash*/
 typedef struct {
     record rec;                 //Contenido a guardar en la posición de la tabla
-    size_t len;                 //Longitud en bytes del record
+    union{
+        int64_t acc;            //Acumulador del modo de agregación (en los demás modos se queda en 0)
+        uint64_t expires;       //Vencimiento del modo TTL (ns; 0 = no vence). Comparte el lugar con el acumulador
+        uint64_t node;          //Nodo de la lista del LRU segmentado en modo caché (la caché no se combina con TTL ni agregación)
+    };
     char status;                //Estado del item (ponemos si está libre, si está sucio, etc...)
     char lazy_deleted;          //Bandera para indicar si hubo o no un elemento borrado en esa posición
     char leapt;
+    char ref;                   //Bit de referencia del modo caché (reloj); ocupa un byte que antes era relleno
     uint32_t key;               //La llave del contenido
 } hash_item;                    //Nombre
 
@@ -68,18 +43,29 @@ typedef struct{
     size_t index_size;          //Índice del tipo de capacidad (arreglo de diferentes tamaños con números impares)
     size_t size;                //Tamaño del arreglo
     size_t occupied_elements;   //Cantidad de elementos ocupados en la tabla
+    size_t max_load;            //Carga máxima en % antes de expandir (50 salvo en la tabla adaptativa)
+    uint64_t seed;              //Semilla de las llaves (ver LLAVES CON SEMILLA)
+    size_t reseed_floor;        //No se vuelve a resembrar hasta tener al menos estos elementos (el doble que en el último resiembro)
+    int flooded;                //YES si la última inserción tuvo un recorrido anormalmente largo
+    int pinned;                 //YES mientras el hilo de "bg" la copia (entonces no se puede reconstruir, ver placeKeyOA##P)
+    uint32_t *hop_info;         //Mapas de bits de vecindario por cubeta (sólo se reserva en modo HS)
+    hash_item *stash;           //Elementos de hopscotch que no cupieron en su vecindario (llaves repetidas)
+    size_t stash_len;           //No. de elementos en el stash
+    size_t stash_cap;           //Capacidad reservada del stash (potencia de 2)
+    size_t *stash_heads;        //Primer elemento (+1) de cada lista del stash, agrupados por llave (0 = lista vacía)
+    size_t *stash_next;         //Siguiente elemento (+1) de la misma lista para cada elemento del stash
 }HTable_OA;
 
 /*Función para hacer una nueva tabla Hash con Open Addressing*/
 HTable_OA* newHTableCap_OA(size_t index){
     //Reservamos memoria para la tabla Hash
-    HTable_OA *HT = (HTable_OA*)malloc(sizeof(HTable_OA)*1);        //Reserva memoria para la tabla
+    HTable_OA *HT = (HTable_OA*)memMalloc(MEM_TABLE, sizeof(HTable_OA)*1);        //Reserva memoria para la tabla
     if(HT == NULL){                                                //Si HT es NULL, MALLOC no pudo reservar más memoria
         fprintf(stderr, "Cannot allocate memory for table.");
         exit(1);
     }
     //Reservamos memoria para el arreglo de los elementos hash (la tabla misma)
-    HT->table = (hash_item*)calloc(HASH_SIZE[index], sizeof(hash_item));
+    HT->table = (hash_item*)allocTableArray(HASH_SIZE[index]*sizeof(hash_item));
     if(HT->table == NULL){                                          //Si table es NULL, MALLOC no pudo reservar más memoria
         fprintf(stderr, "Cannot allocate memory for table.");
         exit(1);
@@ -89,6 +75,18 @@ HTable_OA* newHTableCap_OA(size_t index){
     HT->index_size = index;                                   //Indicar el índice de tamaño
     //Inicializamos en 0 la cantidad de elementos ocupados en total(apenas es nueva la tabla)
     HT->occupied_elements = 0;
+    HT->max_load = 50;
+    HT->seed = tableSeed();
+    HT->reseed_floor = 0;
+    HT->flooded = NO;
+    HT->pinned = NO;
+    //Los mapas de vecindario se reservan hasta la primera inserción con hopscotch
+    HT->hop_info = NULL;
+    HT->stash = NULL;
+    HT->stash_len = 0;
+    HT->stash_cap = 0;
+    HT->stash_heads = NULL;
+    HT->stash_next = NULL;
     for(size_t i = 0; i<HT->size; i++){
         HT->table[i].status = NOTVALID;                     //Marcamos los elementos como NOTVALID
         HT->table[i].lazy_deleted = NO;                     //Quitamos bandera de lazy deleted
@@ -103,16 +101,33 @@ HTable_OA* newHTable_OA(){
     return newHTableCap_OA(0);
 }
 
+/*Función para calcular la llave de un record con la semilla de la tabla*/
+static inline uint32_t keyOA(HTable_OA *HT, record *rec){
+    return seededKey(HT->seed, (unsigned char*)rec->bytes, rec->len);
+}
+
+/*Función para obtener la llave de un elemento de una tabla con semilla "seed" en la tabla HT (sólo se recalcula si las semillas difieren)*/
+static inline uint32_t itemKeyOA(HTable_OA *HT, hash_item *item, uint64_t seed){
+    return (HT->seed == seed) ? item->key : keyOA(HT, &(item->rec));
+}
+
 /*Función para liberar el espacio de toda la tabla (elemento por elemento)*/
 void freeHTable_OA(HTable_OA *HT){
     //Se libera elemento por elemento
     for(size_t i=0; i<HT->size; i++){
-        //Se libera los espacios reservados para el contenido en cada elemento
-        //free(HT->table[i].rec.bytes);
+        //Se libera los espacios reservados para el contenido en cada elemento (los borrados también conservan el suyo;
+        //...las casillas nunca usadas tienen NULL, pues el arreglo se reserva en 0)
+        memFree(MEM_KEYS, HT->table[i].rec.bytes, HT->table[i].rec.len);
     }
-    free(HT->table);
+    for(size_t i=0; i<HT->stash_len; i++)
+        memFree(MEM_KEYS, HT->stash[i].rec.bytes, HT->stash[i].rec.len);
+    freeTableArray(HT->table, HT->size*sizeof(hash_item));
     assert(HT->table != NULL);//"Asegúrate de que el arreglo de cabezas no es nulo"
-    free(HT);
+    freeTableArray(HT->hop_info, HT->size*sizeof(uint32_t));
+    memFree(MEM_NODES, HT->stash, sizeof(hash_item)*HT->stash_cap);
+    memFree(MEM_NODES, HT->stash_heads, sizeof(size_t)*HT->stash_cap);
+    memFree(MEM_NODES, HT->stash_next, sizeof(size_t)*HT->stash_cap);
+    memFree(MEM_TABLE, HT, sizeof(HTable_OA));
 }
 
 //Funcion para sacar el módulo de una llave
@@ -122,9 +137,22 @@ static inline size_t hashFunction(uint32_t key, size_t hashSize){ //static inlin
 
 /*Prototipo para poder usar la función de insertar en la función "Remodel"*/
 hash_item* HTinsertRecord_OA(HTable_OA **HT, record *rec, int mode);
+void migrateItemsOA(HTable_OA **HT, hash_item *items, size_t n, uint64_t seed, int mode);
+HTable_OA* RemodelHTableCap_OA(HTable_OA *PreviousHT, int state, size_t mode);
+hash_item* HTfindkey_OA(HTable_OA **HT, uint32_t key, size_t mode, record *rec);
+hash_item* HTfindRecord_OA(HTable_OA **HT, record *rec, size_t mode);
 
-/*Función para para expandir o reducir espacio: reserva memoria y reacomoda el contenido de una tabla ya existente*/
-HTable_OA* RemodelHTableCap_OA(HTable_OA *PreviousHT, int state, size_t mode){
+/*Función para pasarle a la copia de un elemento (ya insertada en "HT") el acumulador del modo de agregación (o el vencimiento del TTL)*/
+//NOTA: la copia se busca por su contenido, porque si la tabla nueva tiene otra semilla su llave es otra
+void copyAccumulatorOA(HTable_OA **HT, hash_item *item, size_t mode){
+    hash_item *copy = HTfindRecord_OA(HT, &(item->rec), mode);
+    if(copy != NULL)
+        copy->acc = item->acc;
+}
+
+/*Función para crear la tabla a la que se pasará el contenido de otra al expandir o reducir espacio (el reacomodo lo hace
+//...RemodelHTableCap_OA con el sondeo de la tabla)*/
+HTable_OA* remodelTargetOA(HTable_OA *PreviousHT, int state){
     //Variable auxiliar para guardar el índice de tamaño de la tabla antigua
     size_t newIndex = PreviousHT->index_size;
     //Ahora aumentamos o disminuimos el tamaño de la tabla según el valor de "state"
@@ -136,32 +164,30 @@ HTable_OA* RemodelHTableCap_OA(HTable_OA *PreviousHT, int state, size_t mode){
     //Aquí aseguramos que state no sea 0. Si es así, entonces hubo un erro al mandar llamar la función sin necesidad
     //...(DETENTE si la tabla no está ni llena ni vacía)
     assert(state!=0);
-    //Creamos una nueva tabla con el nuevo índice
+    //Creamos una nueva tabla con el nuevo índice (y la misma carga máxima y semilla; con RESEED, del mismo tamaño y con otra semilla)
     HTable_OA *HT = newHTableCap_OA(newIndex);
-    //Aquí se insertará cada elemento de la tabla antigua a la nueva
-    for(size_t i=0; i< ((PreviousHT->size)); i++){
-        hash_item aux = PreviousHT->table[i];
-            //Si el estado es NOTVALID, es porque ya estaba borrado. Por lo tanto no se vuelve a insertar
-            if(aux.status==VALID)
-                HTinsertRecord_OA(&HT, &aux.rec, mode);
-        }
-    //Liberamos el espacio de la tabla antigua
-    freeHTable_OA(PreviousHT);
-    //Regresamos la nueva tabla (con el contenido incluído)
-    return HT;
+    HT->max_load = PreviousHT->max_load;
+    HT->seed = PreviousHT->seed;
+    HT->reseed_floor = PreviousHT->reseed_floor;
+    if(state==RESEED){
+        HT->seed = randomSeed();
+        HT->reseed_floor = 2*PreviousHT->occupied_elements;
+        __atomic_add_fetch(&flood_reseeds, 1, __ATOMIC_RELAXED);
     }
+    return HT;
+}
 
 /*Función para evaluar si la tabla está llena o vacía (relativamente hablando)*/
 //NOTA: "operation" indica si se mandó llamar la función para insertar ("UP") o para borrar ("DOWN") elementos
 int checkSizeOA(HTable_OA *HT, int operation){
-    //Checamos si la cantidad de elementos ocupados es mayor al 50% de capacidad. Si es así, está llena.
-    if((HT->occupied_elements>(HT->size/2))&&(operation==UP))
+    //Checamos si la cantidad de elementos ocupados es mayor a la carga máxima (max_load, 50% de capacidad si no la cambia el modo adaptativo).
+    //Si es así, está llena.
+    if((HT->occupied_elements*100>(HT->size*HT->max_load))&&(operation==UP))
         return FULL;
     //Ahora, se evalúa si la cantidad de elementos ocupados es menor que un cuarto de la capacidad total
     //NOTA: Aquí le sumamos el cuadrado de la variable global "hist" (histéresis)
-    size_t aux1 = HT->occupied_elements;
-    size_t aux2 = HT->size/10 +(hist*hist);
-    if((HT->occupied_elements<(aux2))&&(operation==DOWN)){
+    //(la histéresis sólo se lee al borrar: el hilo de redimensión en segundo plano también llama esta función para insertar)
+    if((operation==DOWN)&&(HT->occupied_elements<(HT->size/10 +(hist*hist)))){
         //Por supuesto, si tenemos el menor tamaño posible, no mandamos "empty" para no reducir (ya no se puede)
         if((HT->index_size)>0)
             hist++;                 //Aumentamos el valor de la histéresis en 1 (cada vez que se reduzca la tabla)
@@ -175,94 +201,343 @@ int checkMatchRecord(record *A, record *B);
 
 //************************************FUNCIONES PARA LAS OPERACIONES BÁSICAS*******************************************************************************************
 /************************TIPOS DE SONDEO PARA BUSCAR ELEMENTOS***************************************/
-/*Función para buscar una llave usando sondeo lineal*/
-/*NOTA: index es el resultado de la función hash original*/
-hash_item* LPFindKey(HTable_OA **HT, size_t key, record *rec){
-    size_t index = hashFunction(key, (*HT)->size);
-    //La variable i representa la cantidad de colisiones
-    size_t i = 0;
-    //Si hubo coincidencia con la llave, se regresa el hash item correspondiente
-    if(checkMatchRecord(&((*HT)->table[index].rec), rec)==YES)
-        return (&(*HT)->table[index]);
-    //Ciclo que recorre toda la tabla hasta dar con un espacio sin lazy deleted (función anticolisiones: f(i)=i)
-    while(((*HT)->table[index].lazy_deleted==YES || (*HT)->table[index].leapt==YES)){
-        //Si hubo coincidencia con la llave, se regresa el hash item correspondiente
-        if(checkMatchRecord(&((*HT)->table[index].rec), rec)==YES)
+/*Políticas de sondeo (funciones anticolisiones): dan la siguiente casilla a revisar después de "i" colisiones, a partir de la casilla
+//...actual "index". Se le pasan a las macros DEFINE_PROBE_OA y DEFINE_HTABLE_OA_INT, así que quedan en línea dentro de cada ciclo de
+//...sondeo; todas reciben lo mismo aunque sólo double hashing usa la llave ("hash") y el índice de capacidad*/
+/*Sondeo lineal: f(i)=i*/
+static inline size_t probeLP(size_t index, size_t i, uint64_t hash, size_t size, size_t index_size){
+    (void)hash;
+    (void)index_size;
+    return (index + i) % size;
+}
+/*Sondeo cuadrático: f(i)=i^2*/
+static inline size_t probeQP(size_t index, size_t i, uint64_t hash, size_t size, size_t index_size){
+    (void)hash;
+    (void)index_size;
+    return (index + i*i) % size;
+}
+/*Double hashing: f(i)= i*(R - llave mod R), siendo R el primo anterior a HASH_SIZE en el arreglo de capacidades (3 con la capacidad
+//...mínima, que es 5)*/
+static inline size_t probeDH(size_t index, size_t i, uint64_t hash, size_t size, size_t index_size){
+    size_t R = (size <= 5) ? 3 : HASH_SIZE[index_size - 1];
+    return (index + i*(R - hash % R)) % size;
+}
+/*Función para escoger la lista del stash de una llave (se mezclan los 16 bits altos porque adler32 varía poco en los bajos)*/
+static inline size_t stashBucket(uint32_t key, size_t cap){
+    return (key ^ (key >> 16)) & (cap - 1);
+}
+
+/*Función para buscar una llave con hopscotch: sólo se revisan las posiciones marcadas en el mapa de bits de su cubeta origen*/
+hash_item* HSFindKey(HTable_OA **HT, size_t key, record *rec){
+    //Si nunca se insertó con hopscotch, no hay nada que buscar
+    if((*HT)->hop_info == NULL)
+        return NULL;
+    size_t home = hashFunction(key, (*HT)->size);
+    uint32_t hop = (*HT)->hop_info[home] & ~HOP_OVERFLOW;
+    //Cada bit encendido indica la distancia (desde la cubeta origen) de un elemento que pertenece a ella
+    while(hop != 0){
+        size_t index = hashFunction(home + __builtin_ctz(hop), (*HT)->size);
+        if((*HT)->table[index].key == key && checkMatchRecord(&((*HT)->table[index].rec), rec)==YES)
             return (&(*HT)->table[index]);
-        //Se incremente la cantidad de colisiones en 1
-        i++;
-        index = hashFunction(index + i, (*HT)->size);     //Aquí se aplica h2(i) = (x + f(i)) mod HASH_SIZE
+        hop &= hop - 1;                                     //Apagamos el bit menos significativo
+    }
+    //Si la cubeta se desbordó alguna vez, el elemento puede estar en el stash
+    //(sólo se recorre la lista de su llave, no todo el stash)
+    if((*HT)->hop_info[home] & HOP_OVERFLOW){
+        for(size_t i = (*HT)->stash_heads[stashBucket(key, (*HT)->stash_cap)]; i != 0; i = (*HT)->stash_next[i-1]){
+            if((*HT)->stash[i-1].key == key && checkMatchRecord(&((*HT)->stash[i-1].rec), rec)==YES)
+                return (&(*HT)->stash[i-1]);
+        }
     }
-    //Si hubo coincidencia con la llave, se regresa el hash item correspondiente
-    if(checkMatchRecord(&((*HT)->table[index].rec), rec)==YES)
-        return (&(*HT)->table[index]);
-
-    //Si no se encontró regresa NULL
     return NULL;
 }
 
-/*Función para buscar un espacio de tabla disponible con sondeo cuadrático*/
-hash_item* QPFindKey(HTable_OA **HT, size_t key, record *rec){
-    size_t index = hashFunction(key, (*HT)->size);
-    //Si hubo coincidencia con la llave, se regresa el hash item correspondiente
-        if(checkMatchRecord(&((*HT)->table[index].rec), rec)==YES)
-            return (&(*HT)->table[index]);
-    //La variable i representa la cantidad de colisiones
-    size_t i = 0;
-    //Ciclo que recorre toda la tabla hasta dar con un espacio disponible (función anticolisiones: f(i)=i^2)
-     while(((*HT)->table[index].lazy_deleted==YES || (*HT)->table[index].leapt==YES)){
-        //Si hubo coincidencia con la llave, se regresa el hash item correspondiente
-        if(checkMatchRecord(&((*HT)->table[index].rec), rec)==YES)
-            return (&(*HT)->table[index]);
-        //Se incremente la cantidad de colisiones en 1
-        i++;
-        index = hashFunction(index + (i*i), (*HT)->size);     //Aquí se aplica h2(i) = (x + f(i)) mod HASH_SIZE
+
+/*Función para checar los bytes entre dos contenidos y ver si son iguales o no*/
+/*NOTA: es el mismo núcleo que checkMatchRecord, pero cuenta en "aux" los contenidos del mismo tamaño que no coincidieron*/
+int checkMatchRecord2(record *A, record *B){
+    //Si la longitud de A y B son diferentes, de antemano ya sabemos que no son iguales
+    if(A->len != B->len)
+        return NO;
+    if(compareBytes(A->bytes, B->bytes, A->len)==NO){
+        __atomic_add_fetch(&aux, 1, __ATOMIC_RELAXED);
+        return NO;
     }
-    //Si hubo coincidencia con la llave, se regresa el hash item correspondiente
-        if(checkMatchRecord(&((*HT)->table[index].rec), rec)==YES)
-            return (&(*HT)->table[index]);
+    return YES;
+}
+
+/*Función para encontrar un record en una tabla Hash con su llave ya calculada (con la semilla actual de la tabla)*/
+hash_item* HTfindRecordKey_OA(HTable_OA **HT, uint32_t key, record *rec, size_t mode){
+    //Se manda llamar la función de encontrar llave
+    //(con LP, QP y DH puede llegar a la lápida que conserva el mismo contenido: ésa no cuenta como encontrada)
+    hash_item *item = HTfindkey_OA(HT, key, mode, rec);
+    if(item == NULL || item->status != VALID)
+        return NULL;
+    //Si se encontró la llave, se verifica si hay coincidencia en el contenido
+    if(checkMatchRecord(rec, &(item->rec))==YES)
+        return item;
     return NULL;
 }
 
-/*Función para buscar un espacio de tabla disponible con double hashing*/
-hash_item* DHFindKey(HTable_OA **HT, size_t key, record *rec){
-    size_t index = hashFunction(key, (*HT)->size);
-    //La variable i representa la cantidad de colisiones
-    size_t i = 0;
-    //Si hubo coincidencia con la llave, se regresa el hash item correspondiente
-    if(checkMatchRecord(&((*HT)->table[index].rec), rec)==YES)
-        return (&(*HT)->table[index]);
-    //Ciclo que recorre toda la tabla hasta dar con un espacio disponible (función anticolisiones: f(i)= R - i mod R, ...
-    //... siendo R un número primo menor a HASH_SIZE)
-    //Se define primeramente R (véase comentario anterior) con el número primo previo al de HASH_SIZE según el
-    //arreglo de capacidades posibles. Sólo se hace la excepción para cuando es la primera capacidad posible
-    size_t R;
-    //Si el tamaño de la tabla es el mínimo, establecemos R=3 (primo menor al mínimo tamaño, el cual es 5)
-    if((*HT)->size <= 5){
-        R = 3;
+/*Función para encontrar un record en una tabla Hash*/
+hash_item* HTfindRecord_OA(HTable_OA **HT, record *rec, size_t mode){
+    //Se calcula la llave de acuerdo al contenido
+    uint32_t key = keyOA(*HT, rec);               //Encuentro la llave asociada a record (con la semilla de la tabla)
+    return HTfindRecordKey_OA(HT, key, rec, mode);
+}
+
+/*Función para encontrar un record en una tabla Hash*/
+hash_item* HTfindRecord_OA2(HTable_OA **HT, record *rec, size_t mode){
+    //Se calcula la llave de acuerdo al contenido
+    uint32_t key = keyOA(*HT, rec);               //Encuentro la llave asociada a record (con la semilla de la tabla)
+    //Se manda llamar la función de encontrar llave
+    hash_item *item = HTfindkey_OA(HT, key, mode, rec);
+    if(item == NULL || item->status != VALID)
+        return NULL;
+    //Si se encontró la llave, se verifica si hay coincidencia en el contenido
+    if(checkMatchRecord2(rec, &(item->rec))==YES)
+        return item;
+    return NULL;
+}
+
+/************************TIPOS DE SONDEO PARA INSERTAR ELEMENTOS***************************************/
+/*Función para marcar la tabla si una inserción recorrió más casillas de las que se toleran (la revisa HTinsertRecord_OA)*/
+static inline void noteProbeOA(HTable_OA *HT, size_t probes){
+    if(probes > floodLimit(HT->size))
+        HT->flooded = YES;
+}
+
+
+/*Función para buscar un espacio de tabla disponible con hopscotch hashing*/
+/*NOTA: el espacio libre se va desplazando hacia la cubeta origen hasta quedar a menos de HOP_RANGE posiciones. Si no se puede, regresa HOP_FAIL*/
+size_t HopscotchProbing(HTable_OA **HT, size_t key){
+    size_t size = (*HT)->size;
+    //Reservamos los mapas de vecindario la primera vez que se usa hopscotch en esta tabla
+    if((*HT)->hop_info == NULL){
+        (*HT)->hop_info = (uint32_t*)allocTableArray(size*sizeof(uint32_t));
+        if((*HT)->hop_info == NULL){
+            fprintf(stderr, "Cannot allocate memory for table.");
+            exit(1);
+        }
     }
-    else
-    //Se establece como R el primo menor anterior en el arreglo de capacidades
-        R = HASH_SIZE[(*HT)->index_size - 1];
-    size_t Hash2;
-     while(((*HT)->table[index].lazy_deleted==YES || (*HT)->table[index].leapt==YES)){
-        //Si hubo coincidencia con la llave, se regresa el hash item correspondiente
-        if(checkMatchRecord(&((*HT)->table[index].rec), rec)==YES)
-            return (&(*HT)->table[index]);
-        //Se incremente la cantidad de colisiones en 1
-        i++;
-        //Se realiza aquí el double hashing
-        Hash2 = R - hashFunction(key, R);
-        index = hashFunction((index + i*Hash2),(*HT)->size);     //Aquí se aplica h2(i) = (x + f(i)) mod HASH_SIZE
+    size_t home = hashFunction(key, size);
+    size_t index = home;
+    //La variable dist representa la distancia entre la cubeta origen y el espacio libre
+    size_t dist = 0;
+    //Primero se busca linealmente el espacio libre más cercano
+    while((*HT)->table[index].status==VALID){
+        dist++;
+        if(dist>=size)
+            return HOP_FAIL;
+        index = hashFunction(home + dist, size);
+    }
+    //Mientras el espacio libre esté fuera del vecindario, se intercambia con algún elemento anterior que pueda moverse ahí
+    while(dist>=HOP_RANGE){
+        size_t moved = NO;
+        //Revisamos las cubetas desde la más lejana (para acercar lo más posible el espacio libre)
+        for(size_t back = HOP_RANGE-1; back>0 && moved==NO; back--){
+            size_t candidate = hashFunction(index + size - back, size);
+            uint32_t hop = (*HT)->hop_info[candidate];
+            //Sólo sirven los elementos de esa cubeta que estén antes del espacio libre
+            for(size_t b = 0; b<back; b++){
+                if(hop & (1u<<b)){
+                    size_t from = hashFunction(candidate + b, size);
+                    //Movemos el elemento al espacio libre y dejamos libre su posición anterior (si el espacio libre era de un
+                    //...borrado, antes se libera el contenido que conservaba)
+                    memFree(MEM_KEYS, (*HT)->table[index].rec.bytes, (*HT)->table[index].rec.len);
+                    (*HT)->table[index] = (*HT)->table[from];
+                    (*HT)->table[from].status = NOTVALID;
+                    (*HT)->table[from].rec.bytes = NULL;
+                    (*HT)->table[from].rec.len = 0;
+                    (*HT)->hop_info[candidate] &= ~(1u<<b);
+                    (*HT)->hop_info[candidate] |= (1u<<back);
+                    dist -= back - b;
+                    index = from;
+                    moved = YES;
+                    break;
+                }
+            }
+        }
+        //Si ningún elemento se pudo mover, hay que expandir la tabla
+        if(moved==NO)
+            return HOP_FAIL;
+    }
+    //Marcamos en el mapa de la cubeta origen la posición que ocupará el nuevo elemento
+    (*HT)->hop_info[home] |= (1u<<dist);
+    return index;
+}
 
+/*Función para guardar en el stash un elemento que no cupo en su vecindario aunque la tabla tiene espacio*/
+/*NOTA: esto pasa cuando muchas llaves de adler32 son iguales o consecutivas; expandir la tabla no las separa*/
+/*NOTA: el stash es una pequeña tabla con listas (por índices) para no recorrerlo completo en cada búsqueda*/
+hash_item* HopscotchStash(HTable_OA **HT, uint32_t key, record *rec){
+    //Si el stash está lleno, se duplica su capacidad y se rehacen sus listas
+    if((*HT)->stash_len == (*HT)->stash_cap){
+        size_t cap = ((*HT)->stash_cap == 0) ? 8 : (*HT)->stash_cap*2;
+        size_t old = (*HT)->stash_cap;
+        hash_item *stash = (hash_item*)memRealloc(MEM_NODES, (*HT)->stash, sizeof(hash_item)*old, sizeof(hash_item)*cap);
+        if(stash != NULL)
+            (*HT)->stash = stash;
+        size_t *next = (size_t*)memRealloc(MEM_NODES, (*HT)->stash_next, sizeof(size_t)*old, sizeof(size_t)*cap);
+        if(next != NULL)
+            (*HT)->stash_next = next;
+        size_t *heads = (size_t*)memRealloc(MEM_NODES, (*HT)->stash_heads, sizeof(size_t)*old, sizeof(size_t)*cap);
+        if(heads != NULL)
+            (*HT)->stash_heads = heads;
+        if(stash == NULL || next == NULL || heads == NULL){
+            fprintf(stderr, "Cannot allocate memory for element!\n");
+            return NULL;
+        }
+        (*HT)->stash_cap = cap;
+        memset(heads, 0, sizeof(size_t)*cap);
+        for(size_t i=0; i<(*HT)->stash_len; i++){
+            size_t b = stashBucket(stash[i].key, cap);
+            next[i] = heads[b];
+            heads[b] = i+1;
+        }
     }
-    //Si hubo coincidencia con la llave, se regresa el hash item correspondiente
-        if(checkMatchRecord(&((*HT)->table[index].rec), rec)==YES)
-            return (&(*HT)->table[index]);
-    return NULL;
+    hash_item *item = &((*HT)->stash[(*HT)->stash_len]);
+    item->rec.bytes = memMalloc(MEM_KEYS, rec->len);
+    if(item->rec.bytes == NULL){
+        fprintf(stderr, "Cannot allocate memory for element!\n");
+        return NULL;
+    }
+    memcpy(item->rec.bytes, rec->bytes, rec->len);
+    item->rec.len = rec->len;
+    item->key = key;
+    item->acc = 0;
+    item->status = VALID;
+    item->lazy_deleted = NO;
+    item->leapt = NO;
+    //Lo ligamos al inicio de la lista de su llave
+    size_t b = stashBucket(key, (*HT)->stash_cap);
+    (*HT)->stash_next[(*HT)->stash_len] = (*HT)->stash_heads[b];
+    (*HT)->stash_heads[b] = (*HT)->stash_len + 1;
+    //Si la lista ya es más larga de lo que se tolera, la tabla se marca (sólo se cuenta hasta el límite)
+    size_t length = 0, limit = floodLimit((*HT)->size);
+    for(size_t i = (*HT)->stash_heads[b]; i != 0 && length <= limit; i = (*HT)->stash_next[i-1])
+        length++;
+    noteProbeOA(*HT, length);
+    //Marcamos la cubeta origen para que las búsquedas revisen el stash
+    (*HT)->hop_info[hashFunction(key, (*HT)->size)] |= HOP_OVERFLOW;
+    (*HT)->stash_len++;
+    (*HT)->occupied_elements++;
+    return item;
+}
+
+/*Función para cambiar, en las listas del stash, el link que apunta al elemento "from" para que apunte a "to" (índices +1)*/
+void relinkStash(HTable_OA *HT, size_t from, size_t to){
+    size_t *link = &(HT->stash_heads[stashBucket(HT->stash[from-1].key, HT->stash_cap)]);
+    while(*link != from)
+        link = &(HT->stash_next[*link - 1]);
+    *link = to;
+}
+
+/*Función para quitar un elemento del stash: se desliga de su lista y el último elemento se recorre a su lugar*/
+void HopscotchUnstash(HTable_OA *HT, hash_item *item){
+    size_t i = (size_t)(item - HT->stash) + 1;
+    size_t last = HT->stash_len;
+    memFree(MEM_KEYS, item->rec.bytes, item->rec.len);
+    relinkStash(HT, i, HT->stash_next[i-1]);
+    if(i != last){
+        relinkStash(HT, last, i);
+        HT->stash[i-1] = HT->stash[last-1];
+        HT->stash_next[i-1] = HT->stash_next[last-1];
+    }
+    HT->stash_len--;
+}
+
+/*************************************************************************************************/
+/*Los ciclos de sondeo de LP, QP y DH sólo difieren en la función anticolisiones: como en las tablas de llaves enteras, se generan con una
+//...macro para cada política (la búsqueda, el espacio disponible y la colocación), así que en cada ciclo la política queda en línea y no se
+//...revisa "mode" en cada casilla. "mode" sólo se usa una vez, en las funciones de entrada, para escoger la versión del sondeo*/
+
+/*Función para guardar un record en la casilla "index" (si era de un borrado, primero se libera el contenido que conservaba)*/
+static inline hash_item* fillSlotOA(HTable_OA *HT, size_t index, uint32_t key, record *rec){
+    memFree(MEM_KEYS, HT->table[index].rec.bytes, HT->table[index].rec.len);
+    HT->table[index].key = key;
+    HT->table[index].acc = 0;
+    HT->table[index].status = VALID;
+    HT->table[index].rec.bytes = memMalloc(MEM_KEYS, rec->len);
+    HT->table[index].rec.len = rec->len;
+    if(HT->table[index].rec.bytes == NULL){
+        fprintf(stderr, "Cannot allocate memory for element!\n");
+        return NULL;
+    }
+    //Se copia el contenido (con memcpy, pues los bytes de un record no necesariamente terminan en '\0')
+    memcpy(HT->table[index].rec.bytes, rec->bytes, rec->len);
+    HT->occupied_elements++;
+    return &(HT->table[index]);
+}
+
+/*Macro que genera para el sondeo P (con la política PROBE) las funciones P##FindKey, P##Probing y placeKeyOA##P*/
+#define DEFINE_PROBE_OA(P, PROBE)                                                                                                       \
+HTable_OA* RemodelHTableCap_OA##P(HTable_OA *PreviousHT, int state);                                                                    \
+                                                                                                                                        \
+/*Función para buscar una llave con el sondeo P: se sigue mientras la casilla tenga lazy deleted o haya sido saltada*/                  \
+hash_item* P##FindKey(HTable_OA **HT, size_t key, record *rec){                                                                         \
+    hash_item *table = (*HT)->table;                                                                                                    \
+    size_t index = hashFunction(key, (*HT)->size);                                                                                      \
+    /*La variable i representa la cantidad de colisiones (a lo más "size": ahí la secuencia ya se repite y, con muchas lápidas,*/       \
+    /*...puede que ninguna de sus casillas esté limpia)*/                                                                               \
+    for(size_t i = 1; i <= (*HT)->size; i++){                                                                                           \
+        /*Si hubo coincidencia con la llave, se regresa el hash item correspondiente*/                                                  \
+        if(checkMatchRecord(&(table[index].rec), rec)==YES)                                                                             \
+            return &(table[index]);                                                                                                     \
+        if(table[index].lazy_deleted!=YES && table[index].leapt!=YES)                                                                   \
+            return NULL;                                                                                                                \
+        index = PROBE(index, i, key, (*HT)->size, (*HT)->index_size);                                                                   \
+    }                                                                                                                                   \
+    return NULL;                                                                                                                        \
+}                                                                                                                                       \
+                                                                                                                                        \
+/*Función para buscar un espacio de tabla disponible con el sondeo P (las casillas que se recorren se marcan como saltadas). Como en*/  \
+/*...P##FindKey, se dan a lo más "size" pasos: la secuencia no pasa por todas las casillas (con LP y DH, más o menos por la mitad),*/   \
+/*...así que con la tabla muy llena puede que ninguna de las suyas esté libre; entonces regresa PROBE_FAIL*/                            \
+size_t P##Probing(HTable_OA **HT, size_t key){                                                                                          \
+    size_t index = hashFunction(key, (*HT)->size);                                                                                      \
+    for(size_t i = 0; i <= (*HT)->size; i++){                                                                                           \
+        if((*HT)->table[index].status!=VALID){                                                                                          \
+            noteProbeOA(*HT, i);                                                                                                        \
+            return index;                                                                                                               \
+        }                                                                                                                               \
+        (*HT)->table[index].leapt=YES;                                                                                                  \
+        index = PROBE(index, i+1, key, (*HT)->size, (*HT)->index_size);                                                                 \
+    }                                                                                                                                   \
+    noteProbeOA(*HT, (*HT)->size);                                                                                                      \
+    return PROBE_FAIL;                                                                                                                  \
+}                                                                                                                                       \
+                                                                                                                                        \
+/*Función para colocar con el sondeo P un record que se sabe que no está. Si el sondeo no encontró lugar se expande la tabla (como*/    \
+/*...con hopscotch), salvo si la está copiando el hilo de "bg": ahí regresa NULL y la inserción espera a que termine*/                  \
+hash_item* placeKeyOA##P(HTable_OA **HT, uint32_t key, record *rec){                                                                    \
+    size_t index = P##Probing(HT, key);                                                                                                 \
+    while(index == PROBE_FAIL){                                                                                                         \
+        if((*HT)->pinned == YES)                                                                                                        \
+            return NULL;                                                                                                                \
+        (*HT)=RemodelHTableCap_OA##P(*HT, FULL);                                                                                        \
+        index = P##Probing(HT, key);                                                                                                    \
+    }                                                                                                                                   \
+    return fillSlotOA(*HT, index, key, rec);                                                                                            \
+}
+DEFINE_PROBE_OA(LP, probeLP)
+DEFINE_PROBE_OA(QP, probeQP)
+DEFINE_PROBE_OA(DH, probeDH)
+
+/*Función para colocar con hopscotch un record que se sabe que no está*/
+hash_item* placeKeyOAHS(HTable_OA **HT, uint32_t key, record *rec){
+    size_t index = HopscotchProbing(HT, key);
+    //Si no se pudo acercar un espacio libre al vecindario, se expande la tabla (si ya tiene al menos un cuarto ocupado)...
+    while(index == HOP_FAIL && (*HT)->occupied_elements > (*HT)->size/4){
+        (*HT)=RemodelHTableCap_OA(*HT, FULL, HS);
+        index = HopscotchProbing(HT, key);
+    }
+    //...y si aun así no cupo, el elemento se va al stash
+    if(index == HOP_FAIL)
+        return HopscotchStash(HT, key, rec);
+    return fillSlotOA(*HT, index, key, rec);
 }
 
-/***************************************************************************************/
 /*Función para encontrar una llave en una tabla Hash*/
 hash_item* HTfindkey_OA(HTable_OA **HT, uint32_t key, size_t mode, record *rec){
     switch (mode)
@@ -277,199 +552,317 @@ hash_item* HTfindkey_OA(HTable_OA **HT, uint32_t key, size_t mode, record *rec){
     case DH:
         return DHFindKey(HT, key, rec);
         break;
+    case HS:
+        return HSFindKey(HT, key, rec);
+        break;
     default:
         break;
     }
     return NULL;
 }
 
-/*Función para checar los bytes entre dos contenidos y ver si son iguales o no*/
-int checkMatchRecord(record *A, record *B){
-    //Si la longitud de A y B son diferentes, de antemano ya sabemos que no son iguales
-    if(A->len != B->len)
-        return NO;
-    unsigned char *pA = (unsigned char*)A->bytes;            // Este "(unsigned char*)" es lo que conocemos como un untpype cast
-    unsigned char *pB = (unsigned char*)B->bytes;
-    //Si uno de los bytes es diferente entre sí de A y B, entonces no son iguales
-    for(size_t i=0; i<A->len; i++){
-        if(pA[i] != pB[i])
-            return NO;
+/*Función para colocar un record que se sabe que no está, con su llave ya calculada. Regresa el elemento donde quedó (o NULL)*/
+hash_item* placeKeyOA(HTable_OA **HT, uint32_t key, record *rec, int mode){
+    //A continuación realizamos la búsqueda de un espacio disponible según el tipo de sondeo elegido en MAIN
+    switch (mode)
+    {
+    case LP:
+        return placeKeyOALP(HT, key, rec);
+    case QP:
+        return placeKeyOAQP(HT, key, rec);
+    case DH:
+        return placeKeyOADH(HT, key, rec);
+    case HS:
+        return placeKeyOAHS(HT, key, rec);
+    default:
+        break;
     }
-    //Si A y B pasaron las pruebas anteriores, entonces sí son iguales
-    return YES;
+    return NULL;
 }
 
-/*Función para checar los bytes entre dos contenidos y ver si son iguales o no*/
-int checkMatchRecord2(record *A, record *B){
-    //Si la longitud de A y B son diferentes, de antemano ya sabemos que no son iguales
-    if(A->len != B->len)
-	return NO;
-    unsigned char *pA = (unsigned char*)A->bytes;            // Este "(unsigned char*)" es lo que conocemos como un untpype cast
-    unsigned char *pB = (unsigned char*)B->bytes;
-    //Si uno de los bytes es diferente entre sí de A y B, entonces no son iguales
-    for(size_t i=0; i<B->len; i++){
-        if(pA[i] != pB[i]){
-            ++aux;
-	    return NO;}
-    }
-    //Si A y B pasaron las pruebas anteriores, entonces sí son iguales
+/*Función para volver a usar la casilla que encontró la búsqueda de un record. Con LP, QP y DH la búsqueda puede llegar a la lápida que
+//...conserva el mismo contenido: ésa se trata como casilla libre y se vuelve a usar en su lugar (así el contenido no queda dos veces en la
+//...secuencia de sondeo). En "added" se indica si se colocó (o NULL si no interesa)*/
+static inline hash_item* reviveItemOA(HTable_OA *HT, hash_item *item, int *added){
+    if(added != NULL)
+        *added = (item->status != VALID) ? YES : NO;
+    if(item->status == VALID)
+        return item;
+    item->status = VALID;
+    item->acc = 0;
+    HT->occupied_elements++;
+    return item;
+}
+
+/*Función para revisar si la última inserción tuvo un recorrido anormalmente largo. Si es así se cuenta y, si la tabla ya tiene el doble
+//...de elementos que en su último resiembro, se reconstruye con otra semilla. Regresa YES si se reconstruyó*/
+int checkFloodOA(HTable_OA **HT, size_t mode){
+    if(!floodReseedDue(&(*HT)->flooded, (*HT)->occupied_elements, (*HT)->reseed_floor))
+        return NO;
+    (*HT) = RemodelHTableCap_OA(*HT, RESEED, mode);
     return YES;
 }
+/*Función para calcular por lotes las llaves de "n" records (a lo más HASH_BATCH) con la semilla actual de la tabla y pedir de antemano
+//...la casilla de inicio de cada uno (así las lecturas de memoria del lote se traslapan)*/
+void batchKeysOA(HTable_OA *HT, record *recs, size_t n, uint32_t *keys){
+    const unsigned char *data[HASH_BATCH];
+    size_t len[HASH_BATCH] = {0};
+    for(size_t i=0; i<n; i++){
+        data[i] = (const unsigned char*)recs[i].bytes;
+        len[i] = recs[i].len;
+    }
+    seededKeyBatch(HT->seed, data, len, n, keys);
+    for(size_t i=0; i<n; i++)
+        __builtin_prefetch(&HT->table[hashFunction(keys[i], HT->size)]);
+}
 
-/*Función para encontrar un record en una tabla Hash*/
-hash_item* HTfindRecord_OA(HTable_OA **HT, record *rec, size_t mode){
-    //Se calcula la llave de acuerdo al contenido
-    uint32_t key = adler32((unsigned char*)rec->bytes, rec->len);               //Encuentro la llave asociada a record (una cadena de longitud "len")
-    //Se manda llamar la función de encontrar llave
-    hash_item *item = HTfindkey_OA(HT, key, mode, rec);
-    if(item == NULL)
-        return NULL;
-    //Si se encontró la llave, se verifica si hay coincidencia en el contenido
-    if(checkMatchRecord(rec, &(item->rec))==YES)
-        return item;
-    return NULL;
+
+/*Macro que genera para el sondeo P (LP, QP, DH o HS, con P##FindKey y placeKeyOA##P ya definidas) las funciones que recorren muchos
+//...elementos: la inserción y el reacomodo de Remodel llaman directamente a la búsqueda y la colocación de su sondeo*/
+#define DEFINE_PROBE_OPS_OA(P)                                                                                                          \
+HTable_OA* RemodelHTableCap_OA##P(HTable_OA *PreviousHT, int state);                                                                    \
+                                                                                                                                        \
+/*Función para obtener con el sondeo P la casilla de un record con su llave ya calculada, colocándolo si no estaba (ver reviveItemOA)*/ \
+hash_item* claimKeyOA##P(HTable_OA **HT, uint32_t key, record *rec, int *added){                                                        \
+    hash_item *item = P##FindKey(HT, key, rec);                                                                                         \
+    if(item != NULL)                                                                                                                    \
+        return reviveItemOA(*HT, item, added);                                                                                          \
+    if(added != NULL)                                                                                                                   \
+        *added = YES;                                                                                                                   \
+    return placeKeyOA##P(HT, key, rec);                                                                                                 \
+}                                                                                                                                       \
+                                                                                                                                        \
+/*Función para insertar con el sondeo P un elemento con su llave ya calculada. Regresa NULL si ya estaba*/                              \
+hash_item* HTinsertRecordKey_OA##P(HTable_OA **HT, uint32_t key, record *rec){                                                          \
+    /*Primeramente vamos a ver si la tabla tiene un tamaño grande. Si es así, la expandemos*/                                           \
+    if(checkSizeOA(*HT, UP)==FULL)                                                                                                      \
+        (*HT)=RemodelHTableCap_OA##P(*HT, FULL);                                                                                        \
+    int added;                                                                                                                          \
+    hash_item *placed = claimKeyOA##P(HT, key, rec, &added);                                                                            \
+    if(added==NO)                                                                                                                       \
+        return NULL;                                                                                                                    \
+    if(placed != NULL && checkFloodOA(HT, P)==YES)                                                                                      \
+        placed = (*HT)->table;                                                                                                          \
+    return placed;                                                                                                                      \
+}                                                                                                                                       \
+                                                                                                                                        \
+/*Función para pasar con el sondeo P los elementos válidos de items[0..n) (ver migrateItemsOA)*/                                        \
+void migrateItemsOA##P(HTable_OA **HT, hash_item *items, size_t n, uint64_t seed){                                                      \
+    record recs[HASH_BATCH];                                                                                                            \
+    uint32_t keys[HASH_BATCH];                                                                                                          \
+    hash_item *batch[HASH_BATCH];                                                                                                       \
+    for(size_t i=0; i<n; ){                                                                                                             \
+        /*Se junta un lote con los que siguen válidos (si el estado es NOTVALID, ya estaba borrado y no se vuelve a insertar)*/         \
+        size_t m = 0;                                                                                                                   \
+        for(; i<n && m<HASH_BATCH; i++){                                                                                                \
+            if(items[i].status!=VALID)                                                                                                  \
+                continue;                                                                                                               \
+            batch[m] = &items[i];                                                                                                       \
+            recs[m] = items[i].rec;                                                                                                     \
+            keys[m] = items[i].key;                                                                                                     \
+            m++;                                                                                                                        \
+        }                                                                                                                               \
+        uint64_t used = seed;                                                                                                           \
+        if((*HT)->seed != seed){                                                                                                        \
+            used = (*HT)->seed;                                                                                                         \
+            batchKeysOA(*HT, recs, m, keys);                                                                                            \
+        }                                                                                                                               \
+        for(size_t j=0; j<m; j++){                                                                                                      \
+            uint32_t key = ((*HT)->seed == used) ? keys[j] : keyOA(*HT, &recs[j]);                                                      \
+            HTinsertRecordKey_OA##P(HT, key, &recs[j]);                                                                                 \
+            /*En el modo de agregación también se conserva el acumulador (y en el TTL, el vencimiento)*/                                \
+            if(batch[j]->acc != 0)                                                                                                      \
+                copyAccumulatorOA(HT, batch[j], P);                                                                                     \
+        }                                                                                                                               \
+    }                                                                                                                                   \
+}                                                                                                                                       \
+                                                                                                                                        \
+/*Función para expandir o reducir espacio con el sondeo P: reserva memoria y reacomoda el contenido de una tabla ya existente*/         \
+HTable_OA* RemodelHTableCap_OA##P(HTable_OA *PreviousHT, int state){                                                                    \
+    size_t mark = memRemodelBegin();                                                                                                    \
+    HTable_OA *HT = remodelTargetOA(PreviousHT, state);                                                                                 \
+    /*Aquí se insertará cada elemento válido de la tabla antigua a la nueva (con las llaves que ya tenían, o calculadas por lotes si*/  \
+    /*...cambió la semilla); los elementos del stash (sólo hopscotch) también se reinsertan*/                                           \
+    migrateItemsOA##P(&HT, PreviousHT->table, PreviousHT->size, PreviousHT->seed);                                                      \
+    migrateItemsOA##P(&HT, PreviousHT->stash, PreviousHT->stash_len, PreviousHT->seed);                                                 \
+    memRemodelEnd(mark);                                                                                                                \
+    /*Liberamos el espacio de la tabla antigua*/                                                                                        \
+    freeHTable_OA(PreviousHT);                                                                                                          \
+    return HT;                                                                                                                          \
 }
+DEFINE_PROBE_OPS_OA(LP)
+DEFINE_PROBE_OPS_OA(QP)
+DEFINE_PROBE_OPS_OA(DH)
+DEFINE_PROBE_OPS_OA(HS)
 
-/*Función para encontrar un record en una tabla Hash*/
-hash_item* HTfindRecord_OA2(HTable_OA **HT, record *rec, size_t mode){
-    //Se calcula la llave de acuerdo al contenido
-    uint32_t key = adler32((unsigned char*)rec->bytes, rec->len);               //Encuentro la llave asociada a record (una cadena de longitud "len")
-    //Se manda llamar la función de encontrar llave
-    hash_item *item = HTfindkey_OA(HT, key, mode, rec);
-    if(item == NULL)
-        return NULL;
-    //Si se encontró la llave, se verifica si hay coincidencia en el contenido
-    if(checkMatchRecord2(rec, &(item->rec))==YES)
-        return item;
+/*Función para obtener la casilla de un record con su llave ya calculada, colocándolo si no estaba (ver reviveItemOA)*/
+hash_item* claimKeyOA(HTable_OA **HT, uint32_t key, record *rec, int mode, int *added){
+    switch (mode)
+    {
+    case LP:
+        return claimKeyOALP(HT, key, rec, added);
+    case QP:
+        return claimKeyOAQP(HT, key, rec, added);
+    case DH:
+        return claimKeyOADH(HT, key, rec, added);
+    case HS:
+        return claimKeyOAHS(HT, key, rec, added);
+    default:
+        break;
+    }
     return NULL;
 }
 
-/************************TIPOS DE SONDEO PARA INSERTAR ELEMENTOS***************************************/
-/*Función para buscar un espacio de tabla disponible con sondeo lineal*/
-/*NOTA: index es el resultado de la función hash original*/
-size_t LinealProbing(HTable_OA **HT, size_t index){
-    //La variable i representa la cantidad de colisiones
-    size_t i = 0;
-    //Ciclo que recorre toda la tabla hasta dar con un espacio disponible (función anticolisiones: f(i)=i)
-    while(((*HT)->table[index].status==VALID)){
-        //Se incremente la cantidad de colisiones en 1
-        i++;
-        //Se marca el elemento actual como saltado
-        (*HT)->table[index].leapt=YES;
-        index = hashFunction(index + i, (*HT)->size);     //Aquí se aplica h2(i) = (x + f(i)) mod HASH_SIZE
-    }
-    return index;
+/*Función para colocar un record con su llave ya calculada sin revisar antes si hay que expandirla. Regresa NULL si ya estaba*/
+hash_item* placeRecordKeyOA(HTable_OA **HT, uint32_t key, record *rec, int mode){
+    int added;
+    hash_item *item = claimKeyOA(HT, key, rec, mode, &added);
+    return (added==YES) ? item : NULL;
 }
 
-/*Función para buscar un espacio de tabla disponible con sondeo cuadrático*/
-size_t QuadraticProbing(HTable_OA **HT, size_t index){
-    //La variable i representa la cantidad de colisiones
-    size_t i = 0;
-    //Ciclo que recorre toda la tabla hasta dar con un espacio disponible (función anticolisiones: f(i)=i^2)
-    while(((*HT)->table[index].status==VALID)){
-        //Se incremente la cantidad de colisiones en 1
-        i++;
-        //Se marca el elemento actual como saltado
-        (*HT)->table[index].leapt=YES;
-        index = hashFunction(index + (i*i), (*HT)->size);     //Aquí se aplica h2(i) = (x + f(i)) mod HASH_SIZE
-    }
-    return index;
+/*Función para colocar un record en la tabla sin revisar antes si hay que expandirla (la usa la redimensión en segundo plano)*/
+hash_item* placeRecordOA(HTable_OA **HT, record *rec, int mode){
+    //Se calcula la llave (una sola vez: la búsqueda y la colocación la comparten)
+    return placeRecordKeyOA(HT, keyOA(*HT, rec), rec, mode);
 }
 
-/*Función para buscar un espacio de tabla disponible con double hashing*/
-size_t DoubleHashing(HTable_OA **HT, size_t key){
-    size_t index = hashFunction(key, (*HT)->size);
-    //La variable i representa la cantidad de colisiones
-    size_t i = 0;
-    //Ciclo que recorre toda la tabla hasta dar con un espacio disponible (función anticolisiones: f(i)= R - i mod R, ...
-    //... siendo R un número primo menor a HASH_SIZE)
-    //Se define primeramente R (véase comentario anterior) con el número primo previo al de HASH_SIZE según el
-    //arreglo de capacidades posibles. Sólo se hace la excepción para cuando es la primera capacidad posible
-    //size_t R = HASH_SIZE[(*HT)->index_size - 1];
-    size_t R;
-    if((*HT)->size <= 5){
-        R = 3;
-    }
-    else
-        R = HASH_SIZE[(*HT)->index_size - 1];
-    size_t Hash2;
-    while(((*HT)->table[index].status==VALID)){
-        //Se incremente la cantidad de colisiones en 1
-        i++;
-        //Se marca el elemento actual como saltado
-        (*HT)->table[index].leapt=YES;
-        Hash2 = R - hashFunction(key, R);
-        index = hashFunction((index + i*Hash2), (*HT)->size);     //Aquí se aplica h2(i) = (x + f(i)) mod HASH_SIZE
+/*Función para insertar un elemento con su llave ya calculada (con la semilla actual de la tabla)*/
+//NOTA: expandir la tabla conserva la semilla, así que la llave sigue valiendo; sólo el resiembro (al final) la cambia
+hash_item* HTinsertRecordKey_OA(HTable_OA **HT, uint32_t key, record *rec, int mode){
+    switch (mode)
+    {
+    case LP:
+        return HTinsertRecordKey_OALP(HT, key, rec);
+    case QP:
+        return HTinsertRecordKey_OAQP(HT, key, rec);
+    case DH:
+        return HTinsertRecordKey_OADH(HT, key, rec);
+    case HS:
+        return HTinsertRecordKey_OAHS(HT, key, rec);
+    default:
+        break;
     }
-    return index;
+    return NULL;
 }
 
-/*************************************************************************************************/
-
 /*Función para insertar un elemento en una tabla hash*/
 /*NOTA: la variable local "mode" es para indicar qué tipo de sonde se empleará*/
 hash_item* HTinsertRecord_OA(HTable_OA **HT, record *rec, int mode){
-    //Primeramente vamos a ver si la tabla tiene un tamaño grande. Si es así, la expandemos
-    if(checkSizeOA(*HT, UP)==FULL){
-        (*HT)=RemodelHTableCap_OA(*HT, FULL, mode);
-    }
-    //Se calcula la llave
-    uint32_t key = adler32(rec->bytes, rec->len);
-    //Usando la función para encontrar una llave, se evalúa si lo que regresa es nulo o no (si no lo es, quiere decir que ya estaba el contenido...
-    //... en la tabla)
-    if(HTfindRecord_OA(HT, rec, mode) != NULL)
-        return NULL;
-    
-    //Si la ejecución llega hasta aquí, el contenido no estaba presente.
-    //Se realiza la función hash original
-    size_t index = hashFunction(key, (*HT)->size);
-    //A continuación realizamos la búsqueda de un espacio disponible según el tipo de sondeo elegido en MAIN
+    return HTinsertRecordKey_OA(HT, keyOA(*HT, rec), rec, mode);
+}
+
+/*Función para pasar a "HT" los elementos válidos de items[0..n), que vienen de una tabla con semilla "seed" (la usan Remodel y la
+//...redimensión en segundo plano). Si las semillas coinciden se reutilizan las llaves guardadas; si no, se calculan por lotes*/
+void migrateItemsOA(HTable_OA **HT, hash_item *items, size_t n, uint64_t seed, int mode){
     switch (mode)
     {
     case LP:
-        index = LinealProbing(HT, index);
+        migrateItemsOALP(HT, items, n, seed);
         break;
     case QP:
-        index = QuadraticProbing(HT, index);
+        migrateItemsOAQP(HT, items, n, seed);
         break;
     case DH:
-        index = DoubleHashing(HT, key);
+        migrateItemsOADH(HT, items, n, seed);
+        break;
+    case HS:
+        migrateItemsOAHS(HT, items, n, seed);
         break;
     default:
         break;
     }
-    //Insertamos el record en el lugar encontrado
-    (*HT)->table[index].key = key;
-    (*HT)->table[index].status = VALID;
-    (*HT)->table[index].rec.bytes = malloc(sizeof(rec->len));
-    (*HT)->table[index].rec.len = rec->len;
-    if((*HT)->table[index].rec.bytes == NULL){
-        fprintf(stderr, "Cannot allocate memory for element!\n");
-        return NULL;
+}
+
+/*Función para para expandir o reducir espacio: reserva memoria y reacomoda el contenido de una tabla ya existente*/
+HTable_OA* RemodelHTableCap_OA(HTable_OA *PreviousHT, int state, size_t mode){
+    switch (mode)
+    {
+    case LP:
+        return RemodelHTableCap_OALP(PreviousHT, state);
+    case QP:
+        return RemodelHTableCap_OAQP(PreviousHT, state);
+    case DH:
+        return RemodelHTableCap_OADH(PreviousHT, state);
+    case HS:
+        return RemodelHTableCap_OAHS(PreviousHT, state);
+    default:
+        break;
     }
-    //Se copia el contenido
-    strcpy((*HT)->table[index].rec.bytes, rec->bytes);
-    (*HT)->occupied_elements++;
-    return (*HT)->table;
+    return PreviousHT;
 }
 
-//Función para borrar un record en una tabla hash
-void HTdeleteRecordOA(HTable_OA **HT, record *rec, size_t mode){
+/*Función para insertar "n" records por lotes. Regresa cuántos se insertaron (los que ya estaban no cuentan)*/
+size_t HTinsertBatch_OA(HTable_OA **HT, record *recs, size_t n, int mode){
+    uint32_t keys[HASH_BATCH];
+    size_t inserted = 0;
+    for(size_t base=0; base<n; base+=HASH_BATCH){
+        size_t m = (n - base < HASH_BATCH) ? n - base : HASH_BATCH;
+        uint64_t seed = (*HT)->seed;
+        batchKeysOA(*HT, recs + base, m, keys);
+        for(size_t i=0; i<m; i++){
+            //Si la tabla se resembró a medio lote, las llaves que faltan se recalculan una por una
+            uint32_t key = ((*HT)->seed == seed) ? keys[i] : keyOA(*HT, &recs[base+i]);
+            if(HTinsertRecordKey_OA(HT, key, &recs[base+i], mode) != NULL)
+                inserted++;
+        }
+    }
+    return inserted;
+}
+
+/*Función para buscar "n" records por lotes (si "found" no es NULL, ahí queda el elemento de cada uno o NULL). Regresa cuántos estaban*/
+size_t HTfindBatch_OA(HTable_OA **HT, record *recs, size_t n, size_t mode, hash_item **found){
+    uint32_t keys[HASH_BATCH];
+    size_t hits = 0;
+    for(size_t base=0; base<n; base+=HASH_BATCH){
+        size_t m = (n - base < HASH_BATCH) ? n - base : HASH_BATCH;
+        batchKeysOA(*HT, recs + base, m, keys);
+        for(size_t i=0; i<m; i++){
+            hash_item *item = HTfindRecordKey_OA(HT, keys[i], &recs[base+i], mode);
+            if(item != NULL)
+                hits++;
+            if(found != NULL)
+                found[base+i] = item;
+        }
+    }
+    return hits;
+}
+
+/*Función para quitar un record de la tabla sin revisar si hay que reducirla ni descontarlo. Regresa YES si estaba*/
+int removeRecordOA(HTable_OA **HT, record *rec, size_t mode){
     //Se verifica si no exisitía antes el record en la tabla
     hash_item* item = HTfindRecord_OA2(HT, rec, mode);
     if(item == NULL)
-        return;
+        return NO;
     item ->status = NOTVALID;
     item ->lazy_deleted = YES;
+    //Con hopscotch no hace falta lápida: basta con apagar el bit del elemento en el mapa de su cubeta origen
+    //(si estaba en el stash, se recorre ahí el último elemento a su lugar)
+    if(mode==HS){
+        if(item >= (*HT)->stash && item < (*HT)->stash + (*HT)->stash_len){
+            HopscotchUnstash(*HT, item);
+        }
+        else{
+            size_t home = hashFunction(item->key, (*HT)->size);
+            size_t pos = (size_t)(item - (*HT)->table);
+            (*HT)->hop_info[home] &= ~(1u<<hashFunction(pos + (*HT)->size - home, (*HT)->size));
+        }
+    }
+    return YES;
+}
+
+//Función para borrar un record en una tabla hash
+void HTdeleteRecordOA(HTable_OA **HT, record *rec, size_t mode){
+    if(removeRecordOA(HT, rec, mode)==NO)
+        return;
+    //Reducimos en uno el número de elementos ocupados (antes de un posible Remodel, que ya cuenta sin el borrado)
+    if((*HT)->occupied_elements>0)
+    	(*HT)->occupied_elements--;
     //Finalmente vamos a ver si la tabla tiene muchos elementos sin ocupar. Si es así, la reducimos
     if(checkSizeOA(*HT, DOWN)==EMPTY){
         if((*HT)->index_size>0){
             (*HT)=RemodelHTableCap_OA(*HT, EMPTY, mode);
         }
     }
-    //Reducimos en uno el número de elementos ocupados
-    if((*HT)->occupied_elements>0)
-    	(*HT)->occupied_elements--;
     return;
 }
 
@@ -496,61 +889,4048 @@ void HTprint_OA(HTable_OA *HT){
         HTprintItem_OA(&(HT->table[i]));
     printf("\n");
     }
+    //Si hay elementos en el stash (hopscotch), se imprimen al final
+    if(HT->stash_len > 0){
+        printf("stash ");
+        for(size_t i=0; i<HT->stash_len; i++)
+            HTprintItem_OA(&(HT->stash[i]));
+        printf("\n");
+    }
 }
 
 
-//************************************INT MAIN********************************************************************************************
-int main(int argc, char **argv){
-    HTable_OA *HT = newHTable_OA();
+/*......................................OPERACIONES DE CONJUNTOS.........................................................................*/
+/*Unión, intersección y diferencia entre dos tablas con el mismo sondeo, ya sea sólo contando o generando una tabla nueva. La tabla que se
+//...recorre se reparte por rangos de casillas entre varios hilos ("threads=N"); como la casilla origen es la llave módulo el tamaño, a cada
+//...hilo le toca un rango de llaves. Cada elemento se busca en la otra tabla con la llave que ya tiene guardada (sin volver a calcular
+//...adler32). Los hilos sólo leen las dos tablas y juntan los elementos del resultado; al final ya se sabe cuántos son, así que la tabla
+//...del resultado se reserva desde el principio con esa capacidad y se llena sin pasar por checkSize (no hay Remodel a media operación)*/
+#define SET_UNION 1
+#define SET_INTERSECT 2
+#define SET_DIFF 3
+
+const char *SET_NAMES[] = {"", "Unión", "Intersección", "Diferencia"};
+
+/*Estructura de cada hilo de una operación de conjuntos*/
+typedef struct{
+    pthread_t thread;
+    HTable_OA *scan;            //Tabla que se recorre
+    HTable_OA *probe;           //Tabla donde se busca cada elemento (NULL = quedarse con todos)
     size_t mode;
-    //Aquí se elige manualmente el tipo de sondeo a emplear (LP = Lineal Proubing, QP = Quadratic Proubing y DH = Double Hashing)
-    if(argc == 1){
-        printf("Bienvenid@. Eliga la estrategia (1 = Lineal Proubing, 2 = Quadratic Proubing y 3 = Double Hashing): ");
-        scanf("%ld", &mode);
+    int keep;                   //YES: quedarse con los que están en "probe"; NO: con los que no están
+    int collect;                //NO si sólo se cuenta
+    size_t begin;               //Rango de casillas de "scan" (el último hilo también revisa el stash)
+    size_t end;
+    hash_item **out;            //Elementos del resultado (apuntan dentro de las tablas de origen)
+    size_t n_out;
+    size_t cap_out;
+}set_worker_OA;
+
+/*Función para saber si un elemento (con su llave ya calculada con la semilla "seed") está en una tabla*/
+static inline int containsItemOA(HTable_OA *HT, hash_item *item, uint64_t seed, size_t mode){
+    return HTfindRecordKey_OA(&HT, itemKeyOA(HT, item, seed), &(item->rec), mode) != NULL;
+}
+
+/*Función para decidir si un elemento va en el resultado y, si es así, agregarlo a la lista del hilo*/
+void setKeepItemOA(set_worker_OA *W, hash_item *item){
+    if(W->probe != NULL && containsItemOA(W->probe, item, W->scan->seed, W->mode) != W->keep)
+        return;
+    if(W->collect){
+        if(W->n_out == W->cap_out){
+            size_t cap = (W->cap_out == 0) ? 64 : W->cap_out*2;
+            hash_item **out = (hash_item**)realloc(W->out, sizeof(hash_item*)*cap);
+            if(out == NULL){
+                fprintf(stderr, "Cannot allocate memory for set operation.\n");
+                exit(1);
+            }
+            W->out = out;
+            W->cap_out = cap;
+        }
+        W->out[W->n_out] = item;
     }
-    else{
-        mode = atoi(argv[1]);
+    W->n_out++;
+}
+
+/*Función que ejecuta cada hilo: recorre su rango de casillas (y el stash, si es el último)*/
+void* setWorkerOA(void *arg){
+    set_worker_OA *W = (set_worker_OA*)arg;
+    for(size_t i=W->begin; i<W->end; i++){
+        if(W->scan->table[i].status==VALID)
+            setKeepItemOA(W, &(W->scan->table[i]));
     }
-    if(mode!=1 && mode!=2 && mode!=3)
-        return 0;
-    record rec;
+    if(W->end == W->scan->size){
+        for(size_t i=0; i<W->scan->stash_len; i++)
+            setKeepItemOA(W, &(W->scan->stash[i]));
+    }
+    return NULL;
+}
+
+/*Función para recorrer "scan" con "threads" hilos (el primero es el hilo actual); cada uno deja su parte del resultado en W[t]*/
+void runSetWorkersOA(set_worker_OA *W, int threads, HTable_OA *scan, HTable_OA *probe, size_t mode, int keep, int collect){
+    for(int t=0; t<threads; t++){
+        W[t].scan = scan;
+        W[t].probe = probe;
+        W[t].mode = mode;
+        W[t].keep = keep;
+        W[t].collect = collect;
+        W[t].begin = scan->size*t/threads;
+        W[t].end = scan->size*(t+1)/threads;
+        W[t].out = NULL;
+        W[t].n_out = 0;
+        W[t].cap_out = 0;
+    }
+    W[0].thread = pthread_self();
+    for(int t=1; t<threads; t++){
+        if(pthread_create(&W[t].thread, NULL, setWorkerOA, &W[t]) != 0){
+            //Si no se pudo crear el hilo, su rango se recorre aquí mismo
+            setWorkerOA(&W[t]);
+            W[t].thread = pthread_self();
+        }
+    }
+    setWorkerOA(&W[0]);
+    for(int t=1; t<threads; t++){
+        if(!pthread_equal(W[t].thread, pthread_self()))
+            pthread_join(W[t].thread, NULL);
+    }
+}
+
+/*Función para colocar en una tabla ya dimensionada un elemento que se sabe que no está (con la llave que ya traía, si su tabla tenía
+//...la misma semilla). Con LP, QP y DH, si el sondeo no encontrara lugar, la tabla se expande (ver placeKeyOA##P)*/
+void placeItemOA(HTable_OA **HT, hash_item *item, uint64_t seed, size_t mode){
+    uint32_t key = itemKeyOA(*HT, item, seed);
+    size_t index;
+    switch (mode)
+    {
+    case LP:
+        placeKeyOALP(HT, key, &(item->rec));
+        return;
+    case QP:
+        placeKeyOAQP(HT, key, &(item->rec));
+        return;
+    case DH:
+        placeKeyOADH(HT, key, &(item->rec));
+        return;
+    case HS:
+        index = HopscotchProbing(HT, key);
+        //Aquí no se expande la tabla: si no cupo en su vecindario, se va directo al stash
+        if(index == HOP_FAIL){
+            HopscotchStash(HT, key, &(item->rec));
+            return;
+        }
+        fillSlotOA(*HT, index, key, &(item->rec));
+        return;
+    default:
+        return;
+    }
+}
+
+/*Función para calcular "A op B" con "threads" hilos. Regresa el No. de elementos del resultado y, si "result" no es NULL, deja ahí
+//...una tabla nueva con ellos (A y B no se modifican)*/
+size_t HTsetOperation_OA(HTable_OA *A, HTable_OA *B, int op, size_t mode, int threads, HTable_OA **result){
+    if(threads < 1)
+        threads = 1;
+    int collect = (result != NULL) ? YES : NO;
+    set_worker_OA *W = (set_worker_OA*)calloc(2*threads, sizeof(set_worker_OA));
+    if(W == NULL){
+        fprintf(stderr, "Cannot allocate memory for set operation.\n");
+        exit(1);
+    }
+    int passes = 1;
+    switch (op)
+    {
+    case SET_UNION:
+        //Todos los de A y los de B que no están en A
+        runSetWorkersOA(W, threads, A, NULL, mode, YES, collect);
+        runSetWorkersOA(W+threads, threads, B, A, mode, NO, collect);
+        passes = 2;
+        break;
+    case SET_INTERSECT:
+        //Se recorre la tabla con menos elementos y se busca en la otra
+        if(A->occupied_elements <= B->occupied_elements)
+            runSetWorkersOA(W, threads, A, B, mode, YES, collect);
+        else
+            runSetWorkersOA(W, threads, B, A, mode, YES, collect);
+        break;
+    case SET_DIFF:
+        runSetWorkersOA(W, threads, A, B, mode, NO, collect);
+        break;
+    default:
+        free(W);
+        return 0;
+    }
+    size_t count = 0;
+    for(int t=0; t<passes*threads; t++)
+        count += W[t].n_out;
+    if(collect){
+        //La capacidad del resultado es la menor en la que "count" elementos no pasan de la mitad (el límite de checkSizeOA)
+        size_t index = 0;
+        while(index+1 < sizeof(HASH_SIZE)/sizeof(HASH_SIZE[0]) && HASH_SIZE[index]/2 < count)
+            index++;
+        //El resultado usa la semilla de A (a sus elementos no hay que recalcularles la llave)
+        HTable_OA *HT = newHTableCap_OA(index);
+        HT->seed = A->seed;
+        for(int t=0; t<passes*threads; t++){
+            for(size_t i=0; i<W[t].n_out; i++)
+                placeItemOA(&HT, W[t].out[i], W[t].scan->seed, mode);
+        }
+        *result = HT;
+    }
+    for(int t=0; t<passes*threads; t++)
+        free(W[t].out);
+    free(W);
+    return count;
+}
+
+/*Función para saber si un comando es una operación de conjuntos (regresa su tipo o 0)*/
+int setOperationCode(const char *command){
+    if(strcmp("union", command)==0)
+        return SET_UNION;
+    if(strcmp("intersect", command)==0)
+        return SET_INTERSECT;
+    if(strcmp("diff", command)==0)
+        return SET_DIFF;
+    return 0;
+}
+
+/*Función para leer la otra tabla de las operaciones de conjuntos desde un archivo de comandos (sólo se atienden "insert" y "delete")*/
+HTable_OA* loadHTable_OA(const char *path, size_t mode){
+    FILE *file = fopen(path, "r");
+    if(file == NULL){
+        fprintf(stderr, "Cannot open %s\n", path);
+        return NULL;
+    }
+    HTable_OA *HT = newHTable_OA();
     char buffer[100];
-    //int cont = 0;
-    while(fgets(buffer, 100, stdin) != NULL){
+    while(fgets(buffer, 100, file) != NULL){
         char command[20] = " ";
         char number[30] = " ";
-        sscanf(buffer, "%s %s", command, &number);     //Recuerda usar el espacio para separar
+        sscanf(buffer, "%19s %29s", command, number);
+        record rec;
         rec.bytes = number;
         rec.len = strlen(number);
-        if(strcmp("insert", command)==0){               //insertar
-            HTinsertRecord_OA(&HT, &rec, mode);      
-            continue;
-        }
-        if(strcmp("delete", command)==0){               //borrar
+        if(strcmp("insert", command)==0)
+            HTinsertRecord_OA(&HT, &rec, mode);
+        if(strcmp("delete", command)==0)
             HTdeleteRecordOA(&HT, &rec, mode);
+    }
+    fclose(file);
+    return HT;
+}
+
+/*Función para saber si un comando es de lotes*/
+int isBatchCommand(const char *command){
+    return strcmp("insertall", command)==0 || strcmp("findall", command)==0;
+}
+
+/*Función para atender "insertall archivo" y "findall archivo": inserta o busca por lotes (HASH_BATCH a la vez) las llaves de un archivo
+//...(de cada línea se toma la última palabra). Regresa NO si el comando no es de lotes*/
+int batchCommandOA(HTable_OA **HT, char *command, char *number, size_t mode){
+    if(!isBatchCommand(command))
+        return NO;
+    int insert = (strcmp("insertall", command)==0);
+    FILE *file = fopen(number, "r");
+    if(file == NULL){
+        fprintf(stderr, "Cannot open %s\n", number);
+        return YES;
+    }
+    char (*keys)[100] = (char(*)[100])memMalloc(MEM_NODES, HASH_BATCH*100);
+    if(keys == NULL){
+        fprintf(stderr, "Cannot allocate memory for batch!\n");
+        fclose(file);
+        return YES;
+    }
+    record recs[HASH_BATCH];
+    char line[200];
+    size_t n = 0, total = 0, done = 0;
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    while(fgets(line, sizeof(line), file) != NULL){
+        char first[100] = "", second[100] = "";
+        int words = sscanf(line, "%99s %99s", first, second);
+        if(words < 1)
             continue;
+        strcpy(keys[n], (words == 2) ? second : first);
+        recs[n].bytes = keys[n];
+        recs[n].len = strlen(keys[n]);
+        if(++n == HASH_BATCH){
+            done += insert ? HTinsertBatch_OA(HT, recs, n, mode) : HTfindBatch_OA(HT, recs, n, mode, NULL);
+            total += n;
+            n = 0;
+        }
+    }
+    done += insert ? HTinsertBatch_OA(HT, recs, n, mode) : HTfindBatch_OA(HT, recs, n, mode, NULL);
+    total += n;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("%s: %zu de %zu (%.3f ms)\n", insert ? "Insertados" : "Encontrados", done, total,
+           (end.tv_sec - start.tv_sec)*1e3 + (end.tv_nsec - start.tv_nsec)/1e6);
+    memFree(MEM_NODES, keys, HASH_BATCH*100);
+    fclose(file);
+    return YES;
+}
+
+/*Función para atender los comandos de conjuntos. "load archivo" lee la otra tabla; "union", "intersect" y "diff" la combinan con "HT"
+//...(con "count" sólo se cuenta; si no, el resultado reemplaza a "HT"). Regresa NO si el comando no es de conjuntos*/
+int setCommandOA(HTable_OA **HT, HTable_OA **other, char *command, char *number, size_t mode, int threads){
+    if(strcmp("load", command)==0){
+        HTable_OA *loaded = loadHTable_OA(number, mode);
+        if(loaded != NULL){
+            if(*other != NULL)
+                freeHTable_OA(*other);
+            *other = loaded;
         }
-        if(strcmp("print", command)==0){                //imprimir
-            HTprint_OA(HT);
+        return YES;
+    }
+    int op = setOperationCode(command);
+    if(op == 0)
+        return NO;
+    //Sin "load" la otra tabla está vacía
+    if(*other == NULL)
+        *other = newHTable_OA();
+    int count_only = (strcmp("count", number)==0);
+    HTable_OA *result = NULL;
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    size_t count = HTsetOperation_OA(*HT, *other, op, mode, threads, count_only ? NULL : &result);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    if(result != NULL){
+        freeHTable_OA(*HT);
+        *HT = result;
+    }
+    printf("%s: %zu elementos (%.3f ms, %d hilos)\n", SET_NAMES[op], count,
+           (end.tv_sec - start.tv_sec)*1e3 + (end.tv_nsec - start.tv_nsec)/1e6, (threads < 1) ? 1 : threads);
+    return YES;
+}
+
+/*...............................................AGREGACIÓN...............................................................................*/
+/*Para contar frecuencias (o sumar por llave) cada elemento tiene un acumulador: "add llave [delta]" lo suma con una sola búsqueda (la
+//...llave se calcula una vez y si no estaba se coloca ahí mismo con ese valor). Para flujos grandes, "aggload archivo" reparte el archivo
+//...entre varios hilos ("threads=N"): cada uno preagrega en sus propias tablas, una por partición (según los bits altos de la llave
+//...mezclada), y después cada hilo junta una partición de todos los demás. Como las particiones no comparten llaves, al final sólo se
+//...pasan a la tabla principal, ya dimensionada para todas. Estos comandos necesitan la opción "agg" (como en Separate Chaining) y con
+//...ella "insert llave" es "add llave 1", igual que las líneas "insert" de "aggload"*/
+
+/*Función para sumar "delta" al acumulador de un record con su llave ya calculada. Si no estaba, se coloca con acumulador "delta"*/
+hash_item* upsertKeyOA(HTable_OA **HT, uint32_t key, record *rec, int64_t delta, size_t mode){
+    //Primero se expande la tabla si hace falta (así el elemento que se encuentre ya no se mueve)
+    if(checkSizeOA(*HT, UP)==FULL)
+        (*HT)=RemodelHTableCap_OA(*HT, FULL, mode);
+    hash_item *item = claimKeyOA(HT, key, rec, mode, NULL);
+    if(item != NULL)
+        item->acc += delta;
+    return item;
+}
+
+/*Función para sumar "delta" al acumulador de un record (upsert_add)*/
+hash_item* HTupsertAdd_OA(HTable_OA **HT, record *rec, int64_t delta, size_t mode){
+    uint32_t key = keyOA(*HT, rec);
+    hash_item *item = upsertKeyOA(HT, key, rec, delta, mode);
+    //Si hubo que resembrar, el elemento ya está en otro lugar
+    if(item != NULL && checkFloodOA(HT, mode)==YES)
+        item = HTfindRecord_OA(HT, rec, mode);
+    return item;
+}
+
+/*Función para leer el acumulador de un record. Regresa NO si no está*/
+int HTgetAccumulator_OA(HTable_OA **HT, record *rec, size_t mode, int64_t *acc){
+    hash_item *item = HTfindRecord_OA(HT, rec, mode);
+    if(item == NULL)
+        return NO;
+    *acc = item->acc;
+    return YES;
+}
+
+/*Estructura de cada hilo de la agregación en paralelo*/
+typedef struct{
+    pthread_t thread;
+    size_t mode;
+    const char *begin;          //Líneas del archivo que le tocan a este hilo
+    const char *end;
+    size_t partitions;
+    HTable_OA **local;          //Una tabla de preagregación por partición
+    uint64_t seed;              //Semilla de la tabla principal
+    size_t lines;               //Líneas que sí sumaron algo
+    void *all;                  //Todos los hilos (para juntar la partición "id")
+    int id;
+    int threads;
+}agg_worker_OA;
+
+/*Primera fase: cada hilo preagrega sus líneas en sus tablas locales*/
+void* aggBuildWorkerOA(void *arg){
+    agg_worker_OA *W = (agg_worker_OA*)arg;
+    char line[AGG_LINE];
+    char number[AGG_KEY];
+    record rec;
+    int64_t delta;
+    const char *p = W->begin;
+    while(p < W->end){
+        const char *eol = memchr(p, '\n', W->end - p);
+        size_t len = (eol != NULL) ? (size_t)(eol - p) : (size_t)(W->end - p);
+        if(len >= sizeof(line))
+            len = sizeof(line) - 1;
+        memcpy(line, p, len);
+        line[len] = '\0';
+        p = (eol != NULL) ? eol + 1 : W->end;
+        if(parseAggLine(line, &rec, number, &delta)==NO)
             continue;
-            break;
+        //La partición sale de la llave con la semilla de la tabla principal (la de todas las tablas locales, salvo que alguna se resiembre)
+        uint32_t key = seededKey(W->seed, (unsigned char*)rec.bytes, rec.len);
+        HTable_OA **local = &(W->local[aggPartition(key, W->partitions)]);
+        upsertKeyOA(local, ((*local)->seed == W->seed) ? key : keyOA(*local, &rec), &rec, delta, W->mode);
+        checkFloodOA(local, W->mode);
+        W->lines++;
+    }
+    return NULL;
+}
+
+/*Función para sumar todos los elementos (con su llave y su acumulador) de "source" en "HT"*/
+void mergeAccumulatorsOA(HTable_OA **HT, HTable_OA *source, size_t mode){
+    for(size_t i=0; i<source->size; i++){
+        if(source->table[i].status==VALID)
+            upsertKeyOA(HT, itemKeyOA(*HT, &(source->table[i]), source->seed), &(source->table[i].rec), source->table[i].acc, mode);
+    }
+    for(size_t i=0; i<source->stash_len; i++)
+        upsertKeyOA(HT, itemKeyOA(*HT, &(source->stash[i]), source->seed), &(source->stash[i].rec), source->stash[i].acc, mode);
+}
+
+/*Segunda fase: el hilo "id" junta en la tabla del primer hilo su partición de todos los demás*/
+void* aggMergeWorkerOA(void *arg){
+    agg_worker_OA *W = (agg_worker_OA*)arg;
+    agg_worker_OA *all = (agg_worker_OA*)W->all;
+    for(int t=1; t<W->threads; t++){
+        mergeAccumulatorsOA(&(all[0].local[W->id]), all[t].local[W->id], W->mode);
+        freeHTable_OA(all[t].local[W->id]);
+        all[t].local[W->id] = NULL;
+    }
+    return NULL;
+}
+
+/*Función para correr una fase en todos los hilos (el primero es el hilo actual)*/
+void runAggWorkersOA(agg_worker_OA *W, int threads, void* (*phase)(void *arg)){
+    W[0].thread = pthread_self();
+    for(int t=1; t<threads; t++){
+        if(pthread_create(&W[t].thread, NULL, phase, &W[t]) != 0){
+            //Si no se pudo crear el hilo, su parte se hace aquí mismo
+            phase(&W[t]);
+            W[t].thread = pthread_self();
         }
-        if(strcmp("stop", command)==0){                 //Parar (crea un ciclo infinito para medir memoria en servidor)
-            size_t i = 0;
-            while(i<1){
-                continue;
+    }
+    phase(&W[0]);
+    for(int t=1; t<threads; t++){
+        if(!pthread_equal(W[t].thread, pthread_self()))
+            pthread_join(W[t].thread, NULL);
+    }
+}
+
+/*Función para agregar un archivo completo en "HT" con "threads" hilos. Regresa el No. de líneas que sumaron algo*/
+size_t HTaggregateFile_OA(HTable_OA **HT, const char *path, size_t mode, int threads){
+    FILE *file = fopen(path, "rb");
+    if(file == NULL){
+        fprintf(stderr, "Cannot open %s\n", path);
+        return 0;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char *data = (char*)malloc((size > 0) ? (size_t)size : 1);
+    if(data == NULL){
+        fprintf(stderr, "Cannot allocate memory for aggregation.\n");
+        fclose(file);
+        return 0;
+    }
+    size_t n = fread(data, 1, (size > 0) ? (size_t)size : 0, file);
+    fclose(file);
+    if(threads < 1)
+        threads = 1;
+    agg_worker_OA *W = (agg_worker_OA*)calloc(threads, sizeof(agg_worker_OA));
+    if(W == NULL){
+        fprintf(stderr, "Cannot allocate memory for aggregation.\n");
+        exit(1);
+    }
+    //Se reparte el archivo en pedazos del mismo tamaño, recorridos hasta el siguiente fin de línea
+    const char *p = data;
+    for(int t=0; t<threads; t++){
+        const char *end = data + n*(t+1)/threads;
+        if(end < p)
+            end = p;
+        while(end < data + n && end > data && end[-1] != '\n')
+            end++;
+        W[t].mode = mode;
+        W[t].begin = p;
+        W[t].end = end;
+        W[t].partitions = threads;
+        W[t].id = t;
+        W[t].threads = threads;
+        W[t].all = W;
+        W[t].local = (HTable_OA**)malloc(sizeof(HTable_OA*)*threads);
+        if(W[t].local == NULL){
+            fprintf(stderr, "Cannot allocate memory for aggregation.\n");
+            exit(1);
+        }
+        W[t].seed = (*HT)->seed;
+        for(int q=0; q<threads; q++){
+            W[t].local[q] = newHTable_OA();
+            W[t].local[q]->seed = (*HT)->seed;
+        }
+        p = end;
+    }
+    runAggWorkersOA(W, threads, aggBuildWorkerOA);
+    runAggWorkersOA(W, threads, aggMergeWorkerOA);
+    //Las particiones no comparten llaves: la tabla principal se expande una sola vez para todas y luego sólo se pasan
+    size_t lines = 0, total = (*HT)->occupied_elements;
+    for(int t=0; t<threads; t++){
+        lines += W[t].lines;
+        total += W[0].local[t]->occupied_elements;
+    }
+    while((*HT)->size/2 < total && (*HT)->index_size+1 < sizeof(HASH_SIZE)/sizeof(HASH_SIZE[0]))
+        (*HT) = RemodelHTableCap_OA(*HT, FULL, mode);
+    for(int q=0; q<threads; q++){
+        mergeAccumulatorsOA(HT, W[0].local[q], mode);
+        freeHTable_OA(W[0].local[q]);
+    }
+    for(int t=0; t<threads; t++)
+        free(W[t].local);
+    free(W);
+    free(data);
+    return lines;
+}
+
+/*Función para atender los comandos de agregación: "add llave [delta]", "get llave" y "aggload archivo". Regresa NO si no es uno de ellos*/
+int aggCommandOA(HTable_OA **HT, const char *buffer, char *command, char *number, size_t mode, int threads){
+    record rec;
+    rec.bytes = number;
+    rec.len = strlen(number);
+    if(strcmp("add", command)==0){
+        char key[AGG_KEY];
+        int64_t delta;
+        if(parseAggLine(buffer, &rec, key, &delta)==YES)
+            HTupsertAdd_OA(HT, &rec, delta, mode);
+        return YES;
+    }
+    if(strcmp("get", command)==0){
+        int64_t acc;
+        if(HTgetAccumulator_OA(HT, &rec, mode, &acc)==YES)
+            printf("%s: %lld\n", number, (long long)acc);
+        else
+            printf("No encontrado: %s\n", number);
+        return YES;
+    }
+    if(strcmp("aggload", command)==0){
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        size_t lines = HTaggregateFile_OA(HT, number, mode, threads);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        printf("Agregación: %zu líneas, %zu llaves (%.3f ms, %d hilos)\n", lines, (*HT)->occupied_elements,
+               (end.tv_sec - start.tv_sec)*1e3 + (end.tv_nsec - start.tv_nsec)/1e6, (threads < 1) ? 1 : threads);
+        return YES;
+    }
+    return NO;
+}
+
+/*.................................................CACHÉ..................................................................................*/
+/*Con "cache=N" (máximo de elementos) o "cachemem=bytes" (máximo de memoria; acepta K, M o G), LP, QP, DH y HS se usan como caché: la
+//...tabla se reserva una sola vez y nunca pasa por Remodel. Cuando ya no cabe un elemento nuevo se desaloja uno con el algoritmo del reloj
+//...(CLOCK): cada casilla tiene un bit de referencia que se enciende en cada acierto, y la manecilla avanza apagando bits hasta dar con
+//...una casilla que no se usó desde su vuelta anterior. Un acierto sólo enciende el bit (no se mueve nada ni se reserva memoria).
+//...Con "evict=slru" se desaloja con LRU segmentado: los elementos nuevos entran a un segmento de prueba y pasan al protegido (a lo más
+//...SLRU_PROTECTED% de la capacidad) en su primer acierto; el que sobra del protegido regresa al inicio del de prueba, y se desaloja el
+//...último del de prueba. Las listas son de índices sobre un arreglo de nodos que se reserva junto con la tabla, así que un acierto sólo
+//...reenlaza su nodo (O(1) y sin reservar memoria). Cada elemento guarda el índice de su nodo y cada nodo el record del elemento, que
+//...sigue siendo válido aunque hopscotch o el stash muevan el elemento (el contenido no se copia; sólo se actualiza al reconstruir).
+//...Con LP, QP y DH las casillas desalojadas quedan como borradas, así que cada size/4 inserciones la tabla se reconstruye con el mismo
+//...tamaño para limpiar las marcas de los sondeos. Esa reconstrucción recorre las "size" casillas de una vez, así que con LP, QP y DH el
+//...costo por operación es O(1) amortizado (a lo más 4 casillas por inserción repartidas entre las size/4 que la provocan), no en el peor
+//...caso; sólo hopscotch, que nunca se reconstruye salvo para resembrar, lo cumple en cada operación. Mientras se reconstruye existen las
+//...dos tablas, así que con "cachemem" el límite de memoria ya cuenta los dos arreglos de casillas*/
+
+#define CLOCK 0
+#define SLRU 1
+#define SLRU_PROTECTED 80               //Porcentaje de la capacidad para el segmento protegido
+#define SLRU_NIL UINT32_MAX
+#define PROBATION 0
+#define PROTECTED 1
+
+/*Estructura de un nodo del LRU segmentado*/
+typedef struct{
+    record rec;                 //El mismo contenido del elemento (para encontrarlo al desalojarlo)
+    uint32_t prev;
+    uint32_t next;              //Siguiente de la lista (o de la lista de nodos libres)
+    char segment;
+}lru_node;
+
+/*Estructura de una tabla caché (K de caché: la C ya es de la compacta)*/
+typedef struct{
+    HTable_OA *HT;
+    size_t mode;
+    int policy;                 //CLOCK o SLRU
+    lru_node *nodes;            //Nodos del LRU segmentado (capacity nodos; NULL con CLOCK)
+    uint32_t free_node;
+    uint32_t head[2];           //Más reciente de cada segmento
+    uint32_t tail[2];           //Menos reciente de cada segmento
+    size_t segment_len[2];
+    size_t protected_cap;
+    size_t capacity;            //Máximo de elementos (a lo más una cuarta parte de las casillas)
+    size_t budget;              //Máximo de bytes de contenido (0 = sin límite)
+    size_t bytes;               //Bytes de contenido guardados
+    size_t hand;                //Manecilla del reloj (casillas y después el stash)
+    size_t inserts;             //Inserciones desde la última reconstrucción
+    size_t hits;
+    size_t misses;
+    size_t evictions;
+    size_t rebuilds;
+}HTable_OAK;
+
+/*Función para leer las opciones de la caché ("cache=N", "cachemem=bytes" y "evict=clock" o "evict=slru")*/
+int parseCacheOption(size_t *entries, size_t *bytes, int *policy, const char *arg){
+    char *end;
+    if(strcmp(arg, "evict=clock")==0 || strcmp(arg, "evict=slru")==0){
+        *policy = (arg[6]=='s') ? SLRU : CLOCK;
+        return YES;
+    }
+    if(strncmp(arg, "cache=", 6)==0){
+        *entries = (size_t)strtoull(arg + 6, NULL, 10);
+        return YES;
+    }
+    if(strncmp(arg, "cachemem=", 9)==0){
+        *bytes = (size_t)strtoull(arg + 9, &end, 10);
+        if(*end == 'K' || *end == 'k')
+            *bytes <<= 10;
+        if(*end == 'M' || *end == 'm')
+            *bytes <<= 20;
+        if(*end == 'G' || *end == 'g')
+            *bytes <<= 30;
+        return YES;
+    }
+    return NO;
+}
+
+/*Función para hacer una caché con a lo más "entries" elementos y "bytes" de memoria (0 = sin ese límite)*/
+HTable_OAK* newHTable_OAK(size_t mode, size_t entries, size_t bytes, int policy){
+    HTable_OAK *K = (HTable_OAK*)memMalloc(MEM_TABLE, sizeof(HTable_OAK));
+    if(K == NULL){
+        fprintf(stderr, "Cannot allocate memory for table.");
+        exit(1);
+    }
+    size_t count = sizeof(HASH_SIZE)/sizeof(HASH_SIZE[0]);
+    size_t index = 0;
+    size_t arrays = (mode==HS) ? 1 : 2;        //Arreglos de casillas que llegan a existir a la vez (la reconstrucción hace otro)
+    if(entries != 0){
+        //La menor tabla en la que caben "entries" elementos en una cuarta parte de las casillas
+        while(index+1 < count && HASH_SIZE[index]/4 < entries)
+            index++;
+    }
+    else{
+        //Con sólo el límite de memoria, la mayor tabla cuyos arreglos ocupan a lo más la mitad
+        while(index+1 < count && arrays*HASH_SIZE[index+1]*sizeof(hash_item) <= bytes/2)
+            index++;
+    }
+    K->HT = newHTableCap_OA(index);
+    K->mode = mode;
+    K->capacity = K->HT->size/4;
+    if(entries != 0 && entries < K->capacity)
+        K->capacity = entries;
+    if(K->capacity == 0)
+        K->capacity = 1;
+    K->policy = policy;
+    K->nodes = NULL;
+    if(policy == SLRU){
+        K->nodes = (lru_node*)memMalloc(MEM_TABLE, K->capacity*sizeof(lru_node));
+        if(K->nodes == NULL){
+            fprintf(stderr, "Cannot allocate memory for table.");
+            exit(1);
+        }
+        //Al principio todos los nodos están en la lista de libres
+        for(size_t i=0; i<K->capacity; i++)
+            K->nodes[i].next = (i+1 < K->capacity) ? (uint32_t)(i+1) : SLRU_NIL;
+    }
+    K->free_node = 0;
+    K->head[PROBATION] = K->head[PROTECTED] = SLRU_NIL;
+    K->tail[PROBATION] = K->tail[PROTECTED] = SLRU_NIL;
+    K->segment_len[PROBATION] = K->segment_len[PROTECTED] = 0;
+    K->protected_cap = K->capacity*SLRU_PROTECTED/100;
+    //Los arreglos de casillas (el de la reconstrucción también) y el de nodos también cuentan para el límite de memoria
+    K->budget = 0;
+    if(bytes != 0){
+        size_t table = arrays*K->HT->size*sizeof(hash_item) + ((policy == SLRU) ? K->capacity*sizeof(lru_node) : 0);
+        K->budget = (bytes > table) ? bytes - table : 1;
+    }
+    K->bytes = 0;
+    K->hand = 0;
+    K->inserts = 0;
+    K->hits = 0;
+    K->misses = 0;
+    K->evictions = 0;
+    K->rebuilds = 0;
+    return K;
+}
+
+/*Función para liberar una caché*/
+void freeHTable_OAK(HTable_OAK *K){
+    freeHTable_OA(K->HT);
+    if(K->nodes != NULL)
+        memFree(MEM_TABLE, K->nodes, K->capacity*sizeof(lru_node));
+    memFree(MEM_TABLE, K, sizeof(HTable_OAK));
+}
+
+/*Función para sacar un nodo de la lista de su segmento*/
+static inline void unlinkNodeOAK(HTable_OAK *K, uint32_t n){
+    lru_node *node = &(K->nodes[n]);
+    if(node->prev != SLRU_NIL)
+        K->nodes[node->prev].next = node->next;
+    else
+        K->head[(int)node->segment] = node->next;
+    if(node->next != SLRU_NIL)
+        K->nodes[node->next].prev = node->prev;
+    else
+        K->tail[(int)node->segment] = node->prev;
+    K->segment_len[(int)node->segment]--;
+}
+
+/*Función para poner un nodo como el más reciente del segmento "segment"*/
+static inline void pushNodeOAK(HTable_OAK *K, uint32_t n, char segment){
+    lru_node *node = &(K->nodes[n]);
+    node->segment = segment;
+    node->prev = SLRU_NIL;
+    node->next = K->head[(int)segment];
+    if(node->next != SLRU_NIL)
+        K->nodes[node->next].prev = n;
+    else
+        K->tail[(int)segment] = n;
+    K->head[(int)segment] = n;
+    K->segment_len[(int)segment]++;
+}
+
+/*Función para regresar un nodo a la lista de libres*/
+static inline void releaseNodeOAK(HTable_OAK *K, uint32_t n){
+    unlinkNodeOAK(K, n);
+    K->nodes[n].next = K->free_node;
+    K->free_node = n;
+}
+
+/*Función para marcar un acierto: con CLOCK enciende el bit; con SLRU pasa el nodo al inicio del protegido (y si el protegido se pasa
+//...de su parte de la capacidad, su último elemento regresa al inicio del de prueba)*/
+static inline void touchItemOAK(HTable_OAK *K, hash_item *item){
+    item->ref = YES;
+    if(K->policy != SLRU)
+        return;
+    uint32_t n = (uint32_t)item->node;
+    unlinkNodeOAK(K, n);
+    pushNodeOAK(K, n, PROTECTED);
+    while(K->segment_len[PROTECTED] > K->protected_cap && K->segment_len[PROTECTED] > 1){
+        uint32_t last = K->tail[PROTECTED];
+        unlinkNodeOAK(K, last);
+        pushNodeOAK(K, last, PROBATION);
+    }
+}
+
+/*Función para quitar un elemento de la caché (su contenido se libera de una vez, así la búsqueda ya no lo encuentra)*/
+void evictItemOAK(HTable_OAK *K, hash_item *item){
+    HTable_OA *HT = K->HT;
+    //Su nodo se libera antes de que el stash pueda mover otro elemento a esta casilla
+    if(K->policy == SLRU)
+        releaseNodeOAK(K, (uint32_t)item->node);
+    K->bytes -= item->rec.len;
+    HT->occupied_elements--;
+    if(K->mode==HS){
+        //Si estaba en el stash, se recorre ahí el último a su lugar (HopscotchUnstash libera el contenido)
+        if(item >= HT->stash && item < HT->stash + HT->stash_len){
+            HopscotchUnstash(HT, item);
+            return;
+        }
+        size_t home = hashFunction(item->key, HT->size);
+        size_t pos = (size_t)(item - HT->table);
+        HT->hop_info[home] &= ~(1u<<hashFunction(pos + HT->size - home, HT->size));
+    }
+    memFree(MEM_KEYS, item->rec.bytes, item->rec.len);
+    item->rec.bytes = NULL;
+    item->rec.len = 0;
+    item->status = NOTVALID;
+    item->lazy_deleted = YES;
+    item->ref = NO;
+}
+
+/*Función para desalojar un elemento con el reloj: los que tienen el bit encendido se salvan una vuelta (y se les apaga)*/
+void evictClockOAK(HTable_OAK *K){
+    HTable_OA *HT = K->HT;
+    while(1){
+        if(K->hand >= HT->size + HT->stash_len)
+            K->hand = 0;
+        hash_item *item = (K->hand < HT->size) ? &(HT->table[K->hand]) : &(HT->stash[K->hand - HT->size]);
+        if(item->status == VALID){
+            if(item->ref == YES)
+                item->ref = NO;
+            else{
+                //En el stash el último elemento queda en esta posición, así que ahí no se avanza
+                int stashed = (K->hand >= HT->size);
+                evictItemOAK(K, item);
+                K->evictions++;
+                if(!stashed)
+                    K->hand++;
+                return;
             }
+        }
+        K->hand++;
+    }
+}
+
+/*Función para desalojar con LRU segmentado: el menos reciente del segmento de prueba (o del protegido si el de prueba está vacío)*/
+void evictSLRUOAK(HTable_OAK *K){
+    uint32_t n = (K->tail[PROBATION] != SLRU_NIL) ? K->tail[PROBATION] : K->tail[PROTECTED];
+    hash_item *item = HTfindRecord_OA(&(K->HT), &(K->nodes[n].rec), K->mode);
+    if(item == NULL){
+        //No debería pasar; se libera el nodo para no ciclar
+        releaseNodeOAK(K, n);
+        return;
+    }
+    evictItemOAK(K, item);
+    K->evictions++;
+}
+
+/*Función para pasar a un elemento reconstruido el bit y el nodo del original (el contenido se copió, así que el nodo se actualiza)*/
+static inline void moveItemOAK(HTable_OAK *K, hash_item *item, hash_item *old){
+    item->ref = old->ref;
+    if(K->policy == SLRU){
+        item->node = old->node;
+        K->nodes[item->node].rec = item->rec;
+    }
+}
+
+/*Función para reconstruir la tabla con el mismo tamaño (limpia las marcas de borrado y de "saltado" que dejan LP, QP y DH)*/
+//...Con "reseed" la tabla nueva además tiene otra semilla (ver LLAVES CON SEMILLA)
+void rebuildHTable_OAK(HTable_OAK *K, int reseed){
+    size_t mark = memRemodelBegin();
+    HTable_OA *old = K->HT;
+    HTable_OA *HT = newHTableCap_OA(old->index_size);
+    HT->seed = old->seed;
+    HT->reseed_floor = old->reseed_floor;
+    if(reseed){
+        HT->seed = randomSeed();
+        HT->reseed_floor = 2*old->occupied_elements;
+        __atomic_add_fetch(&flood_reseeds, 1, __ATOMIC_RELAXED);
+    }
+    for(size_t i=0; i<old->size; i++){
+        if(old->table[i].status != VALID)
             continue;
+        hash_item *item = placeKeyOA(&HT, itemKeyOA(HT, &(old->table[i]), old->seed), &(old->table[i].rec), K->mode);
+        if(item != NULL)
+            moveItemOAK(K, item, &(old->table[i]));
+    }
+    //Con hopscotch también se pasan los del stash
+    for(size_t i=0; i<old->stash_len; i++){
+        hash_item *item = placeKeyOA(&HT, itemKeyOA(HT, &(old->stash[i]), old->seed), &(old->stash[i].rec), K->mode);
+        if(item != NULL)
+            moveItemOAK(K, item, &(old->stash[i]));
+    }
+    HT->flooded = NO;
+    freeHTable_OA(old);
+    K->HT = HT;
+    K->hand = 0;
+    K->inserts = 0;
+    K->rebuilds++;
+    memRemodelEnd(mark);
+}
+
+/*Función para buscar en la caché: un acierto sólo enciende el bit de referencia (o reenlaza su nodo con SLRU). Regresa YES si está*/
+int HTfindRecord_OAK(HTable_OAK *K, record *rec){
+    hash_item *item = HTfindRecord_OA(&(K->HT), rec, K->mode);
+    if(item != NULL){
+        touchItemOAK(K, item);
+        K->hits++;
+        return YES;
+    }
+    K->misses++;
+    return NO;
+}
+
+/*Función para guardar un record en la caché, desalojando lo necesario. Regresa NO si el contenido solo no cabe en el límite de memoria*/
+int HTinsertRecord_OAK(HTable_OAK *K, record *rec){
+    //La reconstrucción es O(size), pero sólo ocurre cada size/4 inserciones (O(1) amortizado, ver arriba)
+    if(K->mode != HS && K->inserts >= K->HT->size/4)
+        rebuildHTable_OAK(K, NO);
+    uint32_t key = keyOA(K->HT, rec);
+    hash_item *item = HTfindkey_OA(&(K->HT), key, K->mode, rec);
+    if(item != NULL && item->status == VALID){
+        touchItemOAK(K, item);
+        return YES;
+    }
+    if(K->budget != 0 && rec->len > K->budget)
+        return NO;
+    while(K->HT->occupied_elements >= K->capacity || (K->budget != 0 && K->bytes + rec->len > K->budget)){
+        if(K->policy == SLRU)
+            evictSLRUOAK(K);
+        else
+            evictClockOAK(K);
+    }
+    item = placeKeyOA(&(K->HT), key, rec, K->mode);
+    if(item == NULL)
+        return NO;
+    item->ref = YES;
+    if(K->policy == SLRU){
+        //Hay a lo más capacity elementos, así que siempre queda un nodo libre
+        uint32_t n = K->free_node;
+        K->free_node = K->nodes[n].next;
+        K->nodes[n].rec = item->rec;
+        item->node = n;
+        pushNodeOAK(K, n, PROBATION);
+    }
+    K->bytes += rec->len;
+    K->inserts++;
+    //Si la inserción tuvo un recorrido anormalmente largo, se reconstruye con otra semilla (con el mismo límite que checkFloodOA)
+    if(floodReseedDue(&K->HT->flooded, K->HT->occupied_elements, K->HT->reseed_floor))
+        rebuildHTable_OAK(K, YES);
+    return YES;
+}
+
+/*Función para borrar un record de la caché*/
+void HTdeleteRecordOAK(HTable_OAK *K, record *rec){
+    hash_item *item = HTfindRecord_OA(&(K->HT), rec, K->mode);
+    if(item != NULL)
+        evictItemOAK(K, item);
+}
+
+/*Función para imprimir los contadores de la caché*/
+void HTstats_OAK(HTable_OAK *K){
+    size_t lookups = K->hits + K->misses;
+    printf("Caché: %zu de %zu elementos, %zu bytes de contenido", K->HT->occupied_elements, K->capacity, K->bytes);
+    if(K->budget != 0)
+        printf(" (límite %zu)", K->budget);
+    if(K->policy == SLRU)
+        printf("\nLRU segmentado: %zu de prueba, %zu protegidos (límite %zu)", K->segment_len[PROBATION], K->segment_len[PROTECTED],
+               K->protected_cap);
+    printf("\nAciertos: %zu, fallos: %zu (%.1f%% de aciertos), desalojos: %zu, reconstrucciones: %zu\n", K->hits, K->misses,
+           (lookups > 0) ? 100.0*K->hits/lookups : 0.0, K->evictions, K->rebuilds);
+}
+
+/*...............................................ADAPTATIVA.................................................................................*/
+/*Con la opción "adapt" (o "adapt=archivo" para guardar el registro en un archivo; si no, va a stderr) la tabla escoge sola su sondeo
+//...(LP, QP, DH o HS) y su carga máxima. Una de cada ADAPT_SAMPLE operaciones se mide: se cuentan las casillas que recorre su búsqueda y
+//...se suma lo que predice la teoría para ese sondeo con la carga efectiva de ese momento (elementos más lápidas; hopscotch no deja
+//...lápidas). La razón entre ambas sumas (kappa) dice qué tanto se amontonan las llaves reales con ese sondeo. En cada redimensión se
+//...predice el costo de cada sondeo con la carga que tendrá la tabla nueva (los que no se han probado se suponen como la teoría) y se
+//...cambia al más barato si ahorra al menos 15%. Después la carga máxima se baja o se sube de 10 en 10 para que el costo predicho quede
+//...dentro de ADAPT_BUDGET casillas por operación, sin pasar del tope de cada sondeo (ver adaptLoadCapOA). Cada decisión se escribe en el
+//...registro con los datos que la justificaron*/
+#define ADAPT_SAMPLE 16                 //Se mide una de cada tantas operaciones
+#define ADAPT_MIN_SAMPLES 32            //Muestras mínimas para actualizar la kappa de un sondeo
+#define ADAPT_BUDGET 3.0                //Casillas por operación que se aceptan al escoger la carga máxima
+#define ADAPT_SWITCH 0.85               //Sólo se cambia de sondeo si el otro cuesta a lo más esto del actual
+#define ADAPT_MIN_LOAD 30
+#define ADAPT_MAX_LOAD 80               //Tope de hopscotch (su vecindario y el stash no dependen de la secuencia de sondeo)
+#define ADAPT_MAX_LOAD_QP 60
+#define ADAPT_MAX_LOAD_LPDH 50
+#define REBUILD 3                       //Estado para Remodel: reconstruir del mismo tamaño (el mismo valor que COMPACT)
+const char *PROBE_NAMES[] = {"", "LP", "QP", "DH", "HS"};
+
+/*Estructura de la tabla adaptativa*/
+typedef struct{
+    HTable_OA *HT;
+    size_t mode;                    //Sondeo actual
+    FILE *log;                      //Registro de decisiones
+    size_t ops;                     //Operaciones (para escoger las que se miden)
+    size_t tombstones;              //Borrados desde la última redimensión (cada uno deja una lápida con LP, QP y DH)
+    double observed;                //Casillas recorridas por las operaciones medidas desde la última redimensión
+    double expected;                //Lo que predecía la teoría para esas mismas operaciones
+    size_t samples;
+    size_t hits;                    //Operaciones medidas cuyo record sí estaba
+    double kappa[HS+1];             //Razón observado/teórico de cada sondeo (0 = no se ha probado)
+    size_t resizes;
+    size_t switches;
+}HTable_OAD;
+
+/*Función para leer la opción "adapt" o "adapt=archivo". Regresa YES si era ésa*/
+int parseAdaptOption(int *adapt, const char **log, const char *arg){
+    if(strcmp(arg, "adapt")==0)
+        *adapt = YES;
+    else if(strncmp(arg, "adapt=", 6)==0){
+        *adapt = YES;
+        *log = arg + 6;
+    }
+    else
+        return NO;
+    return YES;
+}
+
+/*Función para el No. esperado de casillas que recorre una búsqueda con carga "a", exitosa o no (fórmulas de Knuth para LP; hashing
+//...uniforme para QP y DH; con hopscotch se revisa la cubeta origen y los elementos de su vecindario)*/
+double expectedProbes(size_t mode, double a, int hit){
+    if(a > 0.95)
+        a = 0.95;
+    switch(mode){
+    case LP:
+        return hit ? 0.5*(1 + 1/(1 - a)) : 0.5*(1 + 1/((1 - a)*(1 - a)));
+    case QP:
+    case DH:
+        if(!hit)
+            return 1/(1 - a);
+        //ln(1/(1-a))/a = 1 + a/2 + a^2/3 + ... (así no hace falta math.h)
+        {
+            double sum = 0, power = 1;
+            for(int k=1; k<=200; k++){
+                sum += power/k;
+                power *= a;
+            }
+            return sum;
         }
-	 if(strcmp("count", command)==0){              //Imprimir no. de elementos en la tabla
-                    printf("Elementos ocupados: %ld\n", HT->occupied_elements);
-            continue;}
-        if(strcmp("exit", command)==0)                  //salir
-            break;
+    case HS:
+        return hit ? 1 + a/2 : 1 + a;
+    default:
+        return 1;
+    }
+}
+
+/*Función para contar las casillas que recorre la búsqueda de una llave (la misma secuencia que HTfindkey_OA). En "hit" deja si estaba*/
+size_t probeCountOA(HTable_OA *HT, uint32_t key, record *rec, size_t mode, int *hit){
+    size_t count = 1;
+    *hit = NO;
+    if(mode==HS){
+        if(HT->hop_info == NULL)
+            return count;
+        size_t home = hashFunction(key, HT->size);
+        uint32_t hop = HT->hop_info[home] & ~HOP_OVERFLOW;
+        while(hop != 0){
+            count++;
+            hash_item *item = &(HT->table[hashFunction(home + __builtin_ctz(hop), HT->size)]);
+            if(item->key == key && checkMatchRecord(&(item->rec), rec)==YES){
+                *hit = YES;
+                return count;
+            }
+            hop &= hop - 1;
+        }
+        if(HT->hop_info[home] & HOP_OVERFLOW){
+            for(size_t i = HT->stash_heads[stashBucket(key, HT->stash_cap)]; i != 0; i = HT->stash_next[i-1]){
+                count++;
+                if(HT->stash[i-1].key == key && checkMatchRecord(&(HT->stash[i-1].rec), rec)==YES){
+                    *hit = YES;
+                    return count;
+                }
+            }
+        }
+        return count;
+    }
+    size_t index = hashFunction(key, HT->size);
+    size_t R = (HT->size <= 5) ? 3 : HASH_SIZE[HT->index_size - 1];
+    //Se dan a lo más "size" pasos, igual que en P##FindKey (la secuencia puede volver a las mismas casillas sin encontrar una limpia)
+    for(size_t i=0; i<HT->size; ){
+        //Como en la búsqueda, la lápida del mismo contenido también detiene el recorrido (ahí no cuenta como acierto)
+        if(checkMatchRecord(&(HT->table[index].rec), rec)==YES){
+            *hit = (HT->table[index].status==VALID) ? YES : NO;
+            return count;
+        }
+        if(HT->table[index].lazy_deleted!=YES && HT->table[index].leapt!=YES)
+            return count;
+        i++;
+        count++;
+        if(mode==LP)
+            index = hashFunction(index + i, HT->size);
+        else if(mode==QP)
+            index = hashFunction(index + i*i, HT->size);
+        else
+            index = hashFunction(index + i*(R - hashFunction(key, R)), HT->size);
+    }
+    return count;
+}
+
+/*Función para crear una tabla adaptativa que empieza con el sondeo "mode"*/
+HTable_OAD* newHTable_OAD(size_t mode, const char *log){
+    HTable_OAD *A = (HTable_OAD*)memMalloc(MEM_TABLE, sizeof(HTable_OAD));
+    if(A == NULL){
+        fprintf(stderr, "Cannot allocate memory for table.");
+        exit(1);
+    }
+    memset(A, 0, sizeof(HTable_OAD));
+    A->HT = newHTable_OA();
+    A->mode = mode;
+    A->log = stderr;
+    if(log != NULL && (A->log = fopen(log, "w")) == NULL){
+        fprintf(stderr, "Cannot open %s\n", log);
+        A->log = stderr;
+    }
+    return A;
+}
+
+/*Función para liberar la tabla adaptativa (y cerrar su registro)*/
+void freeHTable_OAD(HTable_OAD *A){
+    if(A->log != stderr)
+        fclose(A->log);
+    freeHTable_OA(A->HT);
+    memFree(MEM_TABLE, A, sizeof(HTable_OAD));
+}
+
+/*Función para medir una de cada ADAPT_SAMPLE operaciones*/
+static inline void adaptSampleOA(HTable_OAD *A, record *rec){
+    if(++A->ops % ADAPT_SAMPLE != 0)
+        return;
+    uint32_t key = keyOA(A->HT, rec);
+    int hit;
+    size_t probes = probeCountOA(A->HT, key, rec, A->mode, &hit);
+    double a = (double)(A->HT->occupied_elements + ((A->mode==HS) ? 0 : A->tombstones))/A->HT->size;
+    A->observed += probes;
+    A->expected += expectedProbes(A->mode, a, hit);
+    A->samples++;
+    A->hits += hit;
+}
+
+/*Función para el tope de la carga máxima de un sondeo: la secuencia de LP y DH sólo pasa por más o menos la mitad de las casillas y la
+//...de QP por un poco más, así que más allá de ese tope una inserción podría no encontrar lugar aunque la tabla no esté llena*/
+static inline size_t adaptLoadCapOA(size_t mode){
+    if(mode==HS)
+        return ADAPT_MAX_LOAD;
+    return (mode==QP) ? ADAPT_MAX_LOAD_QP : ADAPT_MAX_LOAD_LPDH;
+}
+
+/*Función para predecir las casillas por operación de un sondeo con carga máxima "load" (%) y la proporción de lápidas "tomb". Durante
+//...una época la carga va de la mitad de la máxima (recién expandida) a la máxima, así que se usan tres cuartos de ella*/
+double adaptCostOA(HTable_OAD *A, size_t mode, size_t load, double tomb, double hit){
+    double kappa = (A->kappa[mode] != 0) ? A->kappa[mode] : 1;
+    double a = 0.75*load/100.0 + ((mode==HS) ? 0 : tomb);
+    return kappa*(hit*expectedProbes(mode, a, YES) + (1 - hit)*expectedProbes(mode, a, NO));
+}
+
+/*Función para redimensionar la tabla adaptativa: antes de reconstruirla se escogen el sondeo y la carga máxima de la tabla nueva
+//...("state" es FULL o EMPTY; REBUILD cuando hopscotch ya la expandió por su cuenta y sólo falta decidir)*/
+void adaptResizeOA(HTable_OAD *A, int state){
+    HTable_OA *HT = A->HT;
+    size_t old_mode = A->mode;
+    size_t old_load = HT->max_load;
+    //Primero se actualiza la kappa del sondeo actual con lo medido en esta época
+    double measured = 0;
+    if(A->samples >= ADAPT_MIN_SAMPLES){
+        measured = A->observed/A->expected;
+        A->kappa[A->mode] = (A->kappa[A->mode] != 0) ? (A->kappa[A->mode] + measured)/2 : measured;
+    }
+    double tomb = (double)A->tombstones/HT->size;
+    double hit = (A->samples > 0) ? (double)A->hits/A->samples : 0.5;
+    //Se escoge el sondeo más barato con la carga máxima actual (sólo se cambia si ahorra lo suficiente)
+    double cost[HS+1];
+    size_t best = A->mode;
+    for(size_t m=LP; m<=HS; m++)
+        cost[m] = adaptCostOA(A, m, old_load, tomb, hit);
+    for(size_t m=LP; m<=HS; m++){
+        if(cost[m] < cost[best])
+            best = m;
+    }
+    if(best != A->mode && cost[best] < ADAPT_SWITCH*cost[A->mode]){
+        A->mode = best;
+        A->switches++;
+    }
+    //Y luego la carga máxima: se baja mientras el costo pase del presupuesto, o se sube un paso si aun así cabe en él (nunca más allá del
+    //...tope del sondeo escogido, que puede ser menor que la carga que traía el anterior)
+    size_t cap = adaptLoadCapOA(A->mode);
+    size_t load = (old_load < cap) ? old_load : cap;
+    while(load > ADAPT_MIN_LOAD && adaptCostOA(A, A->mode, load, tomb, hit) > ADAPT_BUDGET)
+        load -= 10;
+    if(load == old_load && load + 10 <= cap && adaptCostOA(A, A->mode, load + 10, tomb, hit) <= ADAPT_BUDGET)
+        load += 10;
+    //Se registra la decisión con los datos que la justificaron
+    size_t newIndex = (state==FULL) ? HT->index_size + 1 : ((state==EMPTY) ? HT->index_size - 1 : HT->index_size);
+    A->resizes++;
+    if(state==REBUILD)
+        fprintf(A->log, "redimensión %zu: hopscotch creció a %zu sin llegar a la carga máxima (elementos %zu, carga %.1f%%); ", A->resizes,
+                HT->size, HT->occupied_elements, 100.0*HT->occupied_elements/HT->size);
+    else
+        fprintf(A->log, "redimensión %zu: %s %zu -> %u (elementos %zu, carga %.1f%%, lápidas %.1f%%, aciertos %.0f%%); ", A->resizes,
+                (state==FULL) ? "crece" : "se reduce", HT->size, HASH_SIZE[newIndex], HT->occupied_elements,
+                100.0*HT->occupied_elements/HT->size, 100.0*tomb, 100.0*hit);
+    if(A->samples >= ADAPT_MIN_SAMPLES)
+        fprintf(A->log, "medido %s: %zu muestras, %.2f casillas/op (kappa %.2f); ", PROBE_NAMES[old_mode], A->samples,
+                A->observed/A->samples, measured);
+    else
+        fprintf(A->log, "medido %s: %zu muestras (pocas, no se actualiza kappa); ", PROBE_NAMES[old_mode], A->samples);
+    fprintf(A->log, "predicción LP=%.2f QP=%.2f DH=%.2f HS=%.2f; sondeo %s -> %s, carga máxima %zu%% -> %zu%%\n", cost[LP], cost[QP],
+            cost[DH], cost[HS], PROBE_NAMES[old_mode], PROBE_NAMES[A->mode], old_load, load);
+    fflush(A->log);
+    //Ahora sí se reconstruye con el sondeo escogido (Remodel pasa la carga máxima a la tabla nueva). Si hopscotch ya la expandió,
+    //...sólo se reconstruye del mismo tamaño cuando cambia el sondeo
+    HT->max_load = load;
+    if(state!=REBUILD || A->mode!=old_mode)
+        A->HT = RemodelHTableCap_OA(HT, state, A->mode);
+    A->tombstones = 0;
+    A->observed = 0;
+    A->expected = 0;
+    A->samples = 0;
+    A->hits = 0;
+}
+
+/*Función para insertar un record en la tabla adaptativa*/
+void HTinsertRecord_OAD(HTable_OAD *A, record *rec){
+    adaptSampleOA(A, rec);
+    if(checkSizeOA(A->HT, UP)==FULL)
+        adaptResizeOA(A, FULL);
+    HTable_OA *before = A->HT;
+    size_t size = A->HT->size;
+    HTinsertRecord_OA(&A->HT, rec, A->mode);
+    //Si se resembró, la tabla nueva ya no tiene lápidas
+    if(A->HT != before)
+        A->tombstones = 0;
+    //Con hopscotch la tabla también crece desde adentro cuando un vecindario ya no tiene espacio: eso no lo ve el modelo (las búsquedas
+    //...siguen siendo cortas), así que se castiga la kappa de hopscotch y se vuelve a decidir sobre la tabla ya expandida
+    if(A->HT->size != size){
+        A->kappa[HS] = 2*((A->kappa[HS] > 1) ? A->kappa[HS] : 1);
+        adaptResizeOA(A, REBUILD);
+    }
+}
+
+/*Función para borrar un record de la tabla adaptativa*/
+void HTdeleteRecordOAD(HTable_OAD *A, record *rec){
+    adaptSampleOA(A, rec);
+    if(removeRecordOA(&A->HT, rec, A->mode)==NO)
+        return;
+    A->HT->occupied_elements--;
+    if(A->mode != HS)
+        A->tombstones++;
+    if(A->HT->index_size>0 && checkSizeOA(A->HT, DOWN)==EMPTY)
+        adaptResizeOA(A, EMPTY);
+}
+
+/*Función para buscar un record en la tabla adaptativa. Regresa YES si está*/
+int HTfindRecord_OAD(HTable_OAD *A, record *rec){
+    adaptSampleOA(A, rec);
+    return (HTfindRecord_OA(&A->HT, rec, A->mode) != NULL) ? YES : NO;
+}
+
+/*Función para imprimir el estado de la tabla adaptativa*/
+void HTstats_OAD(HTable_OAD *A){
+    printf("Adaptativa: sondeo %s, carga máxima %zu%%, %zu redimensiones, %zu cambios de sondeo; kappa LP=%.2f QP=%.2f DH=%.2f HS=%.2f\n",
+           PROBE_NAMES[A->mode], A->HT->max_load, A->resizes, A->switches, A->kappa[LP], A->kappa[QP], A->kappa[DH], A->kappa[HS]);
+}
+
+/*.....................................REDIMENSIÓN EN SEGUNDO PLANO......................................................................*/
+/*Lo propio de LP, QP y DH para la redimensión en segundo plano (el hilo, la bitácora y la opción "bg" están en ht_common)*/
+
+/*Función del hilo para copiar las casillas [start, end) de la tabla vieja: como en Remodel, sólo se copian los elementos válidos (la
+//...inserción crece la tabla nueva si hiciera falta)*/
+void copyResizeOA(resize_worker *RW, size_t start, size_t end){
+    HTable_OA *source = (HTable_OA*)RW->source;
+    HTable_OA *target = (HTable_OA*)RW->target;
+    migrateItemsOA(&target, source->table + start, end - start, source->seed, RW->mode);
+    RW->target = target;
+}
+
+/*Función del hilo para aplicar una operación de la bitácora a la tabla nueva*/
+void replayResizeOA(resize_worker *RW, record *rec, int operation){
+    HTable_OA *target = (HTable_OA*)RW->target;
+    if(operation == UP)
+        HTinsertRecord_OA(&target, rec, RW->mode);
+    else if(removeRecordOA(&target, rec, RW->mode)==YES && target->occupied_elements>0)
+        target->occupied_elements--;
+    RW->target = target;
+}
+
+/*Función para agendar una redimensión (sólo se crea la tabla nueva vacía y el hilo; no se copia nada aquí)*/
+void scheduleResizeOA(resize_worker *RW, HTable_OA **HT, int state){
+    size_t newIndex = (*HT)->index_size;
+    if(state==FULL)
+        newIndex+=1;
+    if(state==EMPTY)
+        newIndex-=1;
+    (*HT)->pinned = YES;
+    HTable_OA *target = newHTableCap_OA(newIndex);
+    if(startResizeWorker(RW, *HT, target, (*HT)->size)==NO){
+        //Si no se pudo crear el hilo, se redimensiona aquí mismo como siempre
+        (*HT)->pinned = NO;
+        freeHTable_OA(target);
+        (*HT) = RemodelHTableCap_OA(*HT, state, RW->mode);
+    }
+}
+
+/*Función para cambiar la tabla vieja por la nueva si el hilo ya terminó. Con "wait" se espera a que termine*/
+void swapResizedOA(resize_worker *RW, HTable_OA **HT, int wait){
+    if(finishResizeWorker(RW, wait)==NO)
+        return;
+    (*HT) = (HTable_OA*)RW->target;
+    freeHTable_OA((HTable_OA*)RW->source);
+    RW->source = NULL;
+    RW->target = NULL;
+}
+
+/*Función para saber si la tabla ya pasó 3/4 de su carga máxima: ahí se agenda la redimensión en segundo plano, así el hilo tiene margen
+//...para copiarla antes de que la tabla vieja llegue a la carga máxima*/
+static inline int nearFullOA(HTable_OA *HT){
+    return (HT->occupied_elements*400 > HT->size*HT->max_load*3) ? YES : NO;
+}
+
+/*Función para insertar con redimensión en segundo plano (LP, QP y DH; hopscotch puede reconstruir dentro de la inserción)*/
+hash_item* HTinsertRecord_OABG(resize_worker *RW, HTable_OA **HT, record *rec){
+    swapResizedOA(RW, HT, NO);
+    //Si el hilo no alcanza a terminar y la tabla vieja ya llegó a su carga máxima, se le espera: la secuencia de sondeo de LP, QP y DH
+    //...sólo pasa por una parte de las casillas (con LP y DH, más o menos la mitad), así que más allá podría no haber lugar
+    if(resizePhase(RW) != RS_IDLE && checkSizeOA(*HT, UP)==FULL)
+        swapResizedOA(RW, HT, YES);
+    if(resizePhase(RW) == RS_IDLE){
+        if(nearFullOA(*HT)==NO)
+            return placeRecordOA(HT, rec, RW->mode);
+        scheduleResizeOA(RW, HT, FULL);
+        if(resizePhase(RW) == RS_IDLE)
+            return placeRecordOA(HT, rec, RW->mode);
+    }
+    pthread_mutex_lock(&RW->lock);
+    //Si el hilo acaba de terminar, la bitácora ya no se aplicaría: se cambia de tabla y se inserta en la nueva
+    if(RW->phase != RS_BUILDING){
+        pthread_mutex_unlock(&RW->lock);
+        return HTinsertRecord_OABG(RW, HT, rec);
+    }
+    int added;
+    hash_item *item = claimKeyOA(HT, keyOA(*HT, rec), rec, RW->mode, &added);
+    //Si el sondeo no encontró lugar en la tabla vieja (que no se puede reconstruir mientras el hilo la copia), se espera al hilo y se
+    //...inserta en la nueva
+    if(added==YES && item==NULL){
+        pthread_mutex_unlock(&RW->lock);
+        swapResizedOA(RW, HT, YES);
+        return HTinsertRecord_OABG(RW, HT, rec);
+    }
+    if(added==YES)
+        logResizeOp(RW, rec, UP);
+    pthread_mutex_unlock(&RW->lock);
+    return (added==YES) ? item : NULL;
+}
+
+/*Función para borrar con redimensión en segundo plano*/
+void HTdeleteRecordOABG(resize_worker *RW, HTable_OA **HT, record *rec){
+    swapResizedOA(RW, HT, NO);
+    if(resizePhase(RW) == RS_IDLE){
+        if(removeRecordOA(HT, rec, RW->mode)==NO)
+            return;
+        if((*HT)->occupied_elements>0)
+            (*HT)->occupied_elements--;
+        if(checkSizeOA(*HT, DOWN)==EMPTY && (*HT)->index_size>0)
+            scheduleResizeOA(RW, HT, EMPTY);
+        return;
+    }
+    pthread_mutex_lock(&RW->lock);
+    if(RW->phase != RS_BUILDING){
+        pthread_mutex_unlock(&RW->lock);
+        HTdeleteRecordOABG(RW, HT, rec);
+        return;
+    }
+    if(removeRecordOA(HT, rec, RW->mode)==YES){
+        if((*HT)->occupied_elements>0)
+            (*HT)->occupied_elements--;
+        logResizeOp(RW, rec, DOWN);
+    }
+    pthread_mutex_unlock(&RW->lock);
+}
+
+/*Función para buscar con redimensión en segundo plano (mientras el hilo copia, la tabla vieja sigue teniendo todo). Regresa YES si está*/
+int HTfindRecord_OABG(resize_worker *RW, HTable_OA **HT, record *rec){
+    swapResizedOA(RW, HT, NO);
+    if(resizePhase(RW) == RS_IDLE)
+        return (HTfindRecord_OA(HT, rec, RW->mode) != NULL) ? YES : NO;
+    pthread_mutex_lock(&RW->lock);
+    int found = (HTfindRecord_OA(HT, rec, RW->mode) != NULL) ? YES : NO;
+    pthread_mutex_unlock(&RW->lock);
+    return found;
+}
+
+/*Función para terminar: espera a la redimensión pendiente (si la hay) y libera la bitácora*/
+void freeResizeOA(resize_worker *RW, HTable_OA **HT){
+    swapResizedOA(RW, HT, YES);
+    freeResizeWorker(RW);
+}
+
+/*............................................COMPACTA ORDENADA............................................................................*/
+/*Esta variante guarda los elementos en segmentos densos de OAC_SEG elementos que sólo crecen al final (en orden de inserción) y la
+//...tabla hash sólo guarda, en cada posición, el número de elemento (+2) con 1, 2 o 4 bytes según lo que haga falta. Recorrer la
+//...tabla es recorrer los segmentos y al cambiar de tamaño sólo se reconstruye el índice: los elementos nunca se mueven de lugar
+//...(un segmento que se queda sin elementos se libera y al reconstruir el índice se vuelven a numerar los que quedan)*/
+#define IX_EMPTY 0              //Posición del índice que nunca se ha usado
+#define IX_DUMMY 1              //Posición del índice cuyo elemento se borró (el sondeo debe seguir)
+#define COMPACT 3               //Estado para reconstruir el índice del mismo tamaño (sólo quitar borrados)
+#define OAC_SEG_BITS 5
+#define OAC_SEG (1u<<OAC_SEG_BITS)      //Elementos por segmento
+
+/*Estructura de un elemento de un segmento*/
+typedef struct{
+    record rec;                 //Contenido (rec.bytes es NULL si el elemento se borró)
+    uint32_t key;               //La llave del contenido
+}compact_item;
+
+/*Estructura de un segmento denso*/
+typedef struct{
+    compact_item items[OAC_SEG];
+    size_t live;                //Elementos del segmento que no se han borrado
+}compact_segment;
+
+/*Estructura de la tabla compacta*/
+typedef struct{
+    void *index;                //Índice disperso (arreglo de "size" posiciones de "width" bytes)
+    size_t width;               //Bytes por posición del índice (1, 2 o 4)
+    compact_segment **segs;     //Segmentos en orden de inserción (NULL si ya se liberó; se quitan al reconstruir el índice)
+    size_t nsegs;               //Segmentos en uso
+    size_t segs_cap;            //Capacidad del arreglo de segmentos
+    size_t used;                //Siguiente número de elemento (incluyendo huecos de borrados)
+    size_t index_used;          //Posiciones del índice que no están vacías (elementos más borrados)
+    size_t index_size;          //Índice del tipo de capacidad (arreglo de diferentes tamaños con números impares)
+    size_t size;                //Tamaño del índice
+    size_t occupied_elements;   //Cantidad de elementos ocupados en la tabla
+    uint64_t seed;              //Semilla con la que se calculan las llaves
+    size_t reseed_floor;        //No se vuelve a resembrar hasta tener al menos estos elementos (el doble que en el último resiembro)
+    int flooded;                //YES si la última inserción tuvo un recorrido anormalmente largo
+}HTable_OAC;
+
+/*Funciones para leer y escribir una posición del índice según su ancho*/
+static inline size_t getIndexOAC(HTable_OAC *HT, size_t i){
+    if(HT->width == 1)
+        return ((uint8_t*)HT->index)[i];
+    if(HT->width == 2)
+        return ((uint16_t*)HT->index)[i];
+    return ((uint32_t*)HT->index)[i];
+}
+static inline void setIndexOAC(HTable_OAC *HT, size_t i, size_t value){
+    if(HT->width == 1)
+        ((uint8_t*)HT->index)[i] = (uint8_t)value;
+    else if(HT->width == 2)
+        ((uint16_t*)HT->index)[i] = (uint16_t)value;
+    else
+        ((uint32_t*)HT->index)[i] = (uint32_t)value;
+}
+
+/*Función para saber el valor más grande que cabe en una posición del índice*/
+static inline size_t widthMaxOAC(HTable_OAC *HT){
+    if(HT->width == 1)
+        return UINT8_MAX;
+    if(HT->width == 2)
+        return UINT16_MAX;
+    return UINT32_MAX;
+}
+
+/*Función para ubicar el elemento con el número "e"*/
+static inline compact_item* itemOAC(HTable_OAC *HT, size_t e){
+    return &(HT->segs[e>>OAC_SEG_BITS]->items[e & (OAC_SEG-1)]);
+}
+
+/*Función para reservar el índice (en 0 = IX_EMPTY) de la capacidad "index" y escoger su ancho*/
+void newIndexOAC(HTable_OAC *HT, size_t index){
+    HT->size = HASH_SIZE[index];
+    HT->index_size = index;
+    //Se escoge el menor ancho en el que caben los números de elemento que puede haber antes de volver a reconstruirlo (los que ya hay
+    //...más la mitad del índice, más los dos valores especiales); si se llegara al límite antes, checkSizeOAC pide reconstruirlo
+    size_t max_value = HT->used + HT->size/2 + 2;
+    if(max_value <= UINT8_MAX)
+        HT->width = 1;
+    else if(max_value <= UINT16_MAX)
+        HT->width = 2;
+    else
+        HT->width = 4;
+    HT->index = allocTableArray(HT->size*HT->width);
+    if(HT->index == NULL){
+        fprintf(stderr, "Cannot allocate memory for table.");
+        exit(1);
+    }
+    HT->index_used = 0;
+}
+
+/*Función para hacer una nueva tabla compacta*/
+HTable_OAC* newHTableCap_OAC(size_t index){
+    HTable_OAC *HT = (HTable_OAC*)memMalloc(MEM_TABLE, sizeof(HTable_OAC)*1);
+    if(HT == NULL){
+        fprintf(stderr, "Cannot allocate memory for table.");
+        exit(1);
+    }
+    HT->used = 0;
+    newIndexOAC(HT, index);
+    HT->segs = NULL;
+    HT->nsegs = 0;
+    HT->segs_cap = 0;
+    HT->occupied_elements = 0;
+    HT->seed = tableSeed();
+    HT->reseed_floor = 0;
+    HT->flooded = NO;
+    return HT;
+}
+
+/*Aquí definimos una función para generar una tabla compacta con el primer tamaño disponible*/
+HTable_OAC* newHTable_OAC(){
+    return newHTableCap_OAC(0);
+}
+
+/*Función para liberar un segmento con sus contenidos*/
+void freeSegmentOAC(compact_segment *seg){
+    for(size_t i=0; i<OAC_SEG; i++)
+        memFree(MEM_KEYS, seg->items[i].rec.bytes, seg->items[i].rec.len);      //Los huecos tienen NULL, así que no hace nada
+    memFree(MEM_TABLE, seg, sizeof(compact_segment));
+}
+
+/*Función para liberar el espacio de toda la tabla compacta*/
+void freeHTable_OAC(HTable_OAC *HT){
+    for(size_t s=0; s<HT->nsegs; s++){
+        if(HT->segs[s] != NULL)
+            freeSegmentOAC(HT->segs[s]);
+    }
+    memFree(MEM_TABLE, HT->segs, sizeof(compact_segment*)*HT->segs_cap);
+    freeTableArray(HT->index, HT->size*HT->width);
+    memFree(MEM_TABLE, HT, sizeof(HTable_OAC));
+}
+
+/*Función para calcular la llave de un contenido con la semilla de la tabla compacta*/
+static inline uint32_t keyOAC(HTable_OAC *HT, record *rec){
+    return seededKey(HT->seed, (const unsigned char*)rec->bytes, rec->len);
+}
+
+/*Función para reconstruir el índice con otra capacidad (o la misma, con COMPACT o con RESEED, que además cambia la semilla y vuelve a
+//...calcular las llaves). Los elementos no se mueven: sólo se quitan del arreglo de segmentos los que ya se liberaron*/
+void RemodelHTableCap_OAC(HTable_OAC *HT, int state){
+    size_t newIndex = HT->index_size;
+    if(state==FULL)
+        newIndex+=1;
+    if(state==EMPTY)
+        newIndex-=1;
+    assert(state!=0);
+    size_t mark = memRemodelBegin();
+    //Se vuelven a numerar los elementos saltando los segmentos liberados (el último sigue siendo el último, así que conserva su llenado)
+    size_t tail = HT->used - ((HT->nsegs > 0) ? (HT->nsegs-1)*OAC_SEG : 0);
+    int tail_alive = (HT->nsegs > 0 && HT->segs[HT->nsegs-1] != NULL);
+    size_t j = 0;
+    for(size_t s=0; s<HT->nsegs; s++){
+        if(HT->segs[s] != NULL)
+            HT->segs[j++] = HT->segs[s];
+    }
+    HT->nsegs = j;
+    HT->used = tail_alive ? (j-1)*OAC_SEG + tail : j*OAC_SEG;
+    //Se reemplaza sólo el índice
+    freeTableArray(HT->index, HT->size*HT->width);
+    newIndexOAC(HT, newIndex);
+    if(state==RESEED){
+        HT->seed = randomSeed();
+        HT->reseed_floor = 2*HT->occupied_elements;
+        for(size_t e=0; e<HT->used; e++){
+            compact_item *item = itemOAC(HT, e);
+            if(item->rec.bytes != NULL)
+                item->key = keyOAC(HT, &(item->rec));
+        }
+        __atomic_add_fetch(&flood_reseeds, 1, __ATOMIC_RELAXED);
+    }
+    //Se vuelve a colocar cada elemento en el índice con el mismo sondeo que LP
+    for(size_t e=0; e<HT->used; e++){
+        compact_item *item = itemOAC(HT, e);
+        if(item->rec.bytes == NULL)
+            continue;
+        size_t i = hashFunction(item->key, HT->size);
+        size_t step = 0;
+        while(getIndexOAC(HT, i) != IX_EMPTY){
+            step++;
+            i = (i + step) % HT->size;
+        }
+        setIndexOAC(HT, i, e + 2);
+    }
+    HT->index_used = HT->occupied_elements;
+    memRemodelEnd(mark);
+}
+
+/*Función para evaluar si la tabla compacta está llena o vacía (relativamente hablando)*/
+int checkSizeOAC(HTable_OAC *HT, int operation){
+    //Está llena si el índice (con borrados) ya llegó a la mitad. Si la mitad son borrados, basta con reconstruirlo del mismo tamaño
+    if((HT->index_used+1>(HT->size/2))&&(operation==UP)){
+        if(HT->occupied_elements*2 < HT->index_used)
+            return COMPACT;
+        return FULL;
+    }
+    //Al reusar borrados, los números de elemento pueden llegar al límite del ancho antes que el índice a la mitad
+    if((HT->used+3>widthMaxOAC(HT))&&(operation==UP))
+        return COMPACT;
+    //NOTA: Aquí le sumamos el cuadrado de la variable global "hist" (histéresis)
+    //...pero no se reduce si los elementos no caben en la tabla menor (con "hist" grande pasaría antes de tiempo)
+    if((HT->occupied_elements<(HT->size/10 +(hist*hist)))&&(operation==DOWN)&&(HT->index_size>0)
+       &&(HT->occupied_elements+1<=HASH_SIZE[HT->index_size-1]/2)){
+        hist++;
+        return EMPTY;
+    }
+    return 0;
+}
+
+/*Función para encontrar un record en la tabla compacta. En "pos" regresa la posición del índice que lo apunta*/
+compact_item* HTfindRecord_OAC(HTable_OAC *HT, record *rec, size_t *pos){
+    uint32_t key = keyOAC(HT, rec);
+    size_t i = hashFunction(key, HT->size);
+    size_t step = 0;
+    //Sondeo sobre el índice hasta dar con una posición nunca usada. Como en LPProbing, el salto crece en cada colisión (x + i), así
+    //...las llaves que caen juntas no forman un solo bloque enorme
+    while(1){
+        size_t v = getIndexOAC(HT, i);
+        if(v == IX_EMPTY)
+            return NULL;
+        if(v != IX_DUMMY){
+            compact_item *item = itemOAC(HT, v-2);
+            if(item->key == key && checkMatchRecord(&(item->rec), rec)==YES){
+                *pos = i;
+                return item;
+            }
+        }
+        step++;
+        i = (i + step) % HT->size;
+    }
+}
+
+/*Función para dar el lugar del siguiente elemento (al final del último segmento o en uno nuevo)*/
+compact_item* appendOAC(HTable_OAC *HT){
+    size_t s = HT->used>>OAC_SEG_BITS;
+    if(s == HT->nsegs){
+        if(HT->nsegs == HT->segs_cap){
+            size_t cap = (HT->segs_cap == 0) ? 4 : 2*HT->segs_cap;
+            compact_segment **segs = (compact_segment**)memRealloc(MEM_TABLE, HT->segs, sizeof(compact_segment*)*HT->segs_cap,
+                                                                  sizeof(compact_segment*)*cap);
+            if(segs == NULL)
+                return NULL;
+            HT->segs = segs;
+            HT->segs_cap = cap;
+        }
+        compact_segment *seg = (compact_segment*)memMalloc(MEM_TABLE, sizeof(compact_segment));
+        if(seg == NULL)
+            return NULL;
+        memset(seg, 0, sizeof(compact_segment));
+        HT->segs[HT->nsegs++] = seg;
+    }
+    return itemOAC(HT, HT->used);
+}
+
+/*Función para insertar un elemento en la tabla compacta (siempre al final del último segmento)*/
+compact_item* HTinsertRecord_OAC(HTable_OAC *HT, record *rec){
+    size_t pos;
+    //Si el contenido ya estaba, no se vuelve a insertar
+    if(HTfindRecord_OAC(HT, rec, &pos) != NULL)
+        return NULL;
+    int state = checkSizeOAC(HT, UP);
+    if(state != 0)
+        RemodelHTableCap_OAC(HT, state);
+    uint32_t key = keyOAC(HT, rec);
+    compact_item *item = appendOAC(HT);
+    if(item == NULL){
+        fprintf(stderr, "Cannot allocate memory for table.");
+        exit(1);
+    }
+    item->rec.bytes = memMalloc(MEM_KEYS, rec->len);
+    if(item->rec.bytes == NULL){
+        fprintf(stderr, "Cannot allocate memory for element!\n");
+        return NULL;
+    }
+    memcpy(item->rec.bytes, rec->bytes, rec->len);
+    item->rec.len = rec->len;
+    item->key = key;
+    //Buscamos en el índice la primera posición libre (nunca usada o de un borrado)
+    size_t i = hashFunction(key, HT->size);
+    size_t step = 0;
+    while(getIndexOAC(HT, i) > IX_DUMMY){
+        step++;
+        i = (i + step) % HT->size;
+    }
+    if(getIndexOAC(HT, i) == IX_EMPTY)
+        HT->index_used++;
+    setIndexOAC(HT, i, HT->used + 2);
+    HT->segs[HT->used>>OAC_SEG_BITS]->live++;
+    HT->used++;
+    HT->occupied_elements++;
+    //Si el sondeo fue anormalmente largo, se reconstruye el índice con otra semilla (con el mismo límite que checkFloodOA). El
+    //...elemento no se mueve, así que "item" sigue siendo válido
+    if(step > floodLimit(HT->size))
+        HT->flooded = YES;
+    if(floodReseedDue(&HT->flooded, HT->occupied_elements, HT->reseed_floor))
+        RemodelHTableCap_OAC(HT, RESEED);
+    return item;
+}
+
+//Función para borrar un record en la tabla compacta
+void HTdeleteRecordOAC(HTable_OAC *HT, record *rec){
+    size_t pos;
+    compact_item *item = HTfindRecord_OAC(HT, rec, &pos);
+    if(item == NULL)
+        return;
+    //La posición del índice queda como IX_DUMMY y el elemento como hueco. Si el segmento ya está lleno y se quedó sin elementos, se
+    //...libera (su lugar en el arreglo de segmentos se quita al reconstruir el índice)
+    size_t e = getIndexOAC(HT, pos) - 2;
+    setIndexOAC(HT, pos, IX_DUMMY);
+    memFree(MEM_KEYS, item->rec.bytes, item->rec.len);
+    item->rec.bytes = NULL;
+    item->rec.len = 0;
+    size_t s = e>>OAC_SEG_BITS;
+    if(--HT->segs[s]->live == 0 && (s+1)*OAC_SEG <= HT->used){
+        memFree(MEM_TABLE, HT->segs[s], sizeof(compact_segment));
+        HT->segs[s] = NULL;
+    }
+    HT->occupied_elements--;
+    if(checkSizeOAC(HT, DOWN)==EMPTY)
+        RemodelHTableCap_OAC(HT, EMPTY);
+}
+
+/*Función para imprimir la tabla compacta: se recorren los segmentos en orden de inserción (sin visitar posiciones vacías del índice)*/
+void HTprint_OAC(HTable_OAC *HT){
+    for(size_t i=0; i<HT->used; i++){
+        if(HT->segs[i>>OAC_SEG_BITS] == NULL){
+            i |= OAC_SEG-1;             //Segmento liberado: se salta completo
+            continue;
+        }
+        compact_item *item = itemOAC(HT, i);
+        if(item->rec.bytes == NULL)
+            continue;
+        printf("%ld ", i);
+        char *str = (char*)item->rec.bytes;
+        for(size_t j = 0; j<item->rec.len; j++)
+            printf("%c", str[j]);
+        printf("[%u] \n", item->key);
+    }
+}
+
+
+/*..................................................ÉPOCAS................................................................................*/
+/*Recolección por épocas para leer una tabla desde otros hilos sin candados mientras un solo hilo escritor la modifica.
+//...Cada lector anota la época global al entrar a leer y la borra al salir. El escritor, en vez de liberar una tabla o arena
+//...vieja, la "retira" con la época actual y la incrementa: sólo se libera cuando ya no queda ningún lector de esa época o anterior*/
+#define MAX_READERS 64
+
+/*Estructura del lugar de un lector (una línea de caché por lector para que no se estorben entre sí)*/
+typedef struct{
+    uint64_t epoch;             //Época en la que entró a leer (0 = no está leyendo)
+    uint64_t used;              //YES si el lugar ya tiene dueño
+    char pad[64 - 2*sizeof(uint64_t)];
+}epoch_reader;
+
+/*Estructura de un bloque retirado (esperando a que salgan los lectores)*/
+typedef struct{
+    void *ptr;                  //Dirección del bloque
+    size_t bytes;               //Tamaño del bloque (para freeTableArray)
+    uint64_t epoch;             //Época en la que se retiró
+    void (*release)(void *ptr, size_t bytes);   //Función que lo libera
+}epoch_garbage;
+
+//Variables globales de las épocas (la lista de retirados la protege un candado: en la repetición de trazas hay varios escritores)
+epoch_reader epoch_readers[MAX_READERS] __attribute__((aligned(64)));
+uint64_t global_epoch = 1;
+pthread_mutex_t epoch_lock = PTHREAD_MUTEX_INITIALIZER;
+epoch_garbage *epoch_limbo = NULL;
+size_t epoch_limbo_len = 0;
+size_t epoch_limbo_cap = 0;
+size_t epoch_retired = 0;          //Bloques retirados y liberados (para el reporte de los lectores)
+size_t epoch_freed = 0;
+
+/*Función para que un hilo lector obtenga su lugar. Regresa su número (o -1 si ya no hay lugares)*/
+int epochRegister(){
+    for(int r=0; r<MAX_READERS; r++){
+        uint64_t expected = NO;
+        if(__atomic_compare_exchange_n(&epoch_readers[r].used, &expected, YES, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+            return r;
+    }
+    return -1;
+}
+
+/*Función para liberar el lugar de un lector*/
+void epochUnregister(int reader){
+    __atomic_store_n(&epoch_readers[reader].epoch, 0, __ATOMIC_RELEASE);
+    __atomic_store_n(&epoch_readers[reader].used, NO, __ATOMIC_RELEASE);
+}
+
+/*Función para entrar a una sección de lectura: a partir de aquí nada de lo que se lea se libera*/
+static inline void epochEnter(int reader){
+    __atomic_store_n(&epoch_readers[reader].epoch, __atomic_load_n(&global_epoch, __ATOMIC_ACQUIRE), __ATOMIC_RELAXED);
+    //La época debe verse antes de leer el puntero de la tabla (si no, el escritor podría no vernos)
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+/*Función para salir de una sección de lectura*/
+static inline void epochExit(int reader){
+    __atomic_store_n(&epoch_readers[reader].epoch, 0, __ATOMIC_RELEASE);
+}
+
+/*Función (del escritor) para liberar los bloques retirados antes de la época más antigua de los lectores activos*/
+void epochReclaim(){
+    uint64_t oldest = UINT64_MAX;
+    for(int r=0; r<MAX_READERS; r++){
+        uint64_t e = __atomic_load_n(&epoch_readers[r].epoch, __ATOMIC_SEQ_CST);
+        if(e != 0 && e < oldest)
+            oldest = e;
+    }
+    size_t j = 0;
+    pthread_mutex_lock(&epoch_lock);
+    for(size_t i=0; i<epoch_limbo_len; i++){
+        if(epoch_limbo[i].epoch < oldest){
+            epoch_limbo[i].release(epoch_limbo[i].ptr, epoch_limbo[i].bytes);
+            epoch_freed++;
+        }
+        else
+            epoch_limbo[j++] = epoch_limbo[i];
+    }
+    epoch_limbo_len = j;
+    pthread_mutex_unlock(&epoch_lock);
+}
+
+/*Función (del escritor) para retirar un bloque que ya no está publicado. Se libera en cuanto ningún lector pueda tenerlo*/
+void epochRetire(void *ptr, size_t bytes, void (*release)(void *ptr, size_t bytes)){
+    pthread_mutex_lock(&epoch_lock);
+    if(epoch_limbo_len == epoch_limbo_cap){
+        size_t cap = (epoch_limbo_cap == 0) ? 16 : epoch_limbo_cap*2;
+        epoch_garbage *limbo = (epoch_garbage*)realloc(epoch_limbo, sizeof(epoch_garbage)*cap);
+        if(limbo == NULL){
+            fprintf(stderr, "Cannot allocate memory for element!\n");
+            exit(1);
+        }
+        epoch_limbo = limbo;
+        epoch_limbo_cap = cap;
+    }
+    epoch_limbo[epoch_limbo_len].ptr = ptr;
+    epoch_limbo[epoch_limbo_len].bytes = bytes;
+    epoch_limbo[epoch_limbo_len].epoch = __atomic_load_n(&global_epoch, __ATOMIC_RELAXED);
+    epoch_limbo[epoch_limbo_len].release = release;
+    epoch_limbo_len++;
+    epoch_retired++;
+    __atomic_add_fetch(&global_epoch, 1, __ATOMIC_SEQ_CST);
+    pthread_mutex_unlock(&epoch_lock);
+    epochReclaim();
+}
+
+/*..............................................EMPAQUETADA................................................................................*/
+/*Esta variante usa casillas de 12 bytes (en vez del hash_item de 32 bytes más un malloc por contenido): la llave, el
+//...desplazamiento del contenido dentro de un arreglo de bytes compartido por toda la tabla (la "arena") y, en una misma
+//...palabra, la longitud (30 bits) con los bits de estado. Al cambiar de tamaño, la arena se compacta (se quitan los borrados).
+//...Como "meta" se escribe de un solo golpe, otros hilos pueden leer la tabla sin candados con HTreadRecord_OAP (ver ÉPOCAS)*/
+#define PK_LEN_MASK 0x3FFFFFFFu     //Bits de la longitud
+#define PK_VALID (1u<<30)           //Bit de elemento válido
+#define PK_DELETED (1u<<31)         //Bit de elemento borrado (lápida: el sondeo debe seguir)
+
+/*Estructura de una casilla empaquetada (meta = 0 significa que la casilla nunca se ha usado)*/
+typedef struct{
+    uint32_t key;               //La llave del contenido
+    uint32_t offset;            //Desplazamiento del contenido en la arena
+    uint32_t meta;              //Longitud del contenido y bits de estado
+}packed_item;
+
+/*Estructura de la tabla empaquetada*/
+typedef struct{
+    packed_item *table;         //Arreglo de casillas
+    char *arena;                //Bytes de todos los contenidos, uno tras otro
+    size_t arena_len;           //Bytes usados de la arena (incluye los de elementos borrados)
+    size_t arena_cap;           //Capacidad de la arena
+    size_t index_size;          //Índice del tipo de capacidad (arreglo de diferentes tamaños con números impares)
+    size_t size;                //Tamaño del arreglo
+    size_t occupied_elements;   //Cantidad de elementos ocupados en la tabla
+    size_t deleted_elements;    //Cantidad de lápidas en la tabla
+    uint64_t seed;              //Semilla con la que se calculan las llaves
+    size_t reseed_floor;        //No se vuelve a resembrar hasta tener al menos estos elementos (el doble que en el último resiembro)
+    int flooded;                //YES si la última inserción tuvo un recorrido anormalmente largo
+}HTable_OAP;
+
+/*Función para hacer una nueva tabla empaquetada con una arena de "arena_cap" bytes*/
+HTable_OAP* newHTableCap_OAP(size_t index, size_t arena_cap){
+    HTable_OAP *HT = (HTable_OAP*)memMalloc(MEM_TABLE, sizeof(HTable_OAP)*1);
+    if(HT == NULL){
+        fprintf(stderr, "Cannot allocate memory for table.");
+        exit(1);
+    }
+    //Con CALLOC todas las casillas empiezan con meta = 0 (nunca usadas)
+    HT->table = (packed_item*)allocTableArray(HASH_SIZE[index]*sizeof(packed_item));
+    if(arena_cap == 0)
+        arena_cap = 64;
+    HT->arena = (char*)allocTableArrayKind(arena_cap, MEM_KEYS);
+    if(HT->table == NULL || HT->arena == NULL){
+        fprintf(stderr, "Cannot allocate memory for table.");
+        exit(1);
+    }
+    HT->arena_len = 0;
+    HT->arena_cap = arena_cap;
+    HT->size = HASH_SIZE[index];
+    HT->index_size = index;
+    HT->occupied_elements = 0;
+    HT->deleted_elements = 0;
+    HT->seed = tableSeed();
+    HT->reseed_floor = 0;
+    HT->flooded = NO;
+    return HT;
+}
+
+/*Aquí definimos una función para generar una tabla empaquetada con el primer tamaño disponible*/
+HTable_OAP* newHTable_OAP(){
+    return newHTableCap_OAP(0, 0);
+}
+
+/*Función para liberar una arena (con la forma que pide epochRetire)*/
+void freeArenaOAP(void *ptr, size_t bytes){
+    freeTableArrayKind(ptr, bytes, MEM_KEYS);
+}
+
+/*Función para liberar el espacio de toda la tabla empaquetada (los contenidos viven en la arena: no hay que liberarlos uno por uno)*/
+void freeHTable_OAP(HTable_OAP *HT){
+    freeTableArray(HT->table, HT->size*sizeof(packed_item));
+    freeArenaOAP(HT->arena, HT->arena_cap);
+    memFree(MEM_TABLE, HT, sizeof(HTable_OAP));
+}
+
+/*Función con la forma que pide epochRetire para liberar una tabla empaquetada retirada*/
+void releaseHTable_OAP(void *ptr, size_t bytes){
+    (void)bytes;                    //La tabla sabe su propio tamaño
+    freeHTable_OAP((HTable_OAP*)ptr);
+}
+
+/*Función para publicar una tabla nueva en lugar de la anterior. La anterior se retira (los lectores que aún la usan la siguen viendo)*/
+void publishHTable_OAP(HTable_OAP **HT, HTable_OAP *newHT){
+    HTable_OAP *old = *HT;
+    __atomic_store_n(HT, newHT, __ATOMIC_SEQ_CST);
+    epochRetire(old, 0, releaseHTable_OAP);
+}
+
+/*Función para calcular la llave de un contenido con la semilla de la tabla empaquetada*/
+static inline uint32_t keyOAP(HTable_OAP *HT, const void *bytes, size_t len){
+    return seededKey(HT->seed, (const unsigned char*)bytes, len);
+}
+
+/*Función para colocar un contenido (que sabemos que no está) en la primera casilla libre del sondeo lineal*/
+packed_item* placeRecordOAP(HTable_OAP *HT, uint32_t key, void *bytes, size_t len){
+    //El desplazamiento y la longitud se guardan en 32 y 30 bits
+    if(len > PK_LEN_MASK || HT->arena_len + len > UINT32_MAX){
+        fprintf(stderr, "Cannot allocate memory for element!\n");
+        return NULL;
+    }
+    //Si la arena no alcanza, se duplica su capacidad (los desplazamientos siguen siendo válidos). La arena nueva se publica
+    //...y la vieja se retira, pues algún lector puede estar comparando contra ella
+    if(HT->arena_len + len > HT->arena_cap){
+        size_t cap = HT->arena_cap*2;
+        while(cap < HT->arena_len + len)
+            cap*=2;
+        char *arena = (char*)allocTableArrayKind(cap, MEM_KEYS);
+        if(arena == NULL){
+            fprintf(stderr, "Cannot allocate memory for element!\n");
+            return NULL;
+        }
+        memcpy(arena, HT->arena, HT->arena_len);
+        char *old = HT->arena;
+        __atomic_store_n(&HT->arena, arena, __ATOMIC_RELEASE);
+        epochRetire(old, HT->arena_cap, freeArenaOAP);
+        HT->arena_cap = cap;
+    }
+    size_t index = hashFunction(key, HT->size);
+    size_t i = 0;
+    while(HT->table[index].meta & PK_VALID){
+        i++;
+        index = (index + i) % HT->size;
+    }
+    if(i > floodLimit(HT->size))
+        HT->flooded = YES;
+    packed_item *item = &(HT->table[index]);
+    if(item->meta & PK_DELETED)
+        HT->deleted_elements--;
+    //Primero se escriben el contenido, la llave y el desplazamiento; "meta" se publica al final (los lectores la leen primero)
+    memcpy(HT->arena + HT->arena_len, bytes, len);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&item->key, key, __ATOMIC_RELAXED);
+    __atomic_store_n(&item->offset, (uint32_t)HT->arena_len, __ATOMIC_RELAXED);
+    __atomic_store_n(&item->meta, (uint32_t)len | PK_VALID, __ATOMIC_RELEASE);
+    HT->arena_len += len;
+    HT->occupied_elements++;
+    return item;
+}
+
+/*Función para para expandir o reducir espacio (o resembrar con RESEED). La nueva arena sólo copia los contenidos válidos (así se compacta)*/
+/*NOTA: la tabla anterior NO se libera aquí: hay que pasar la nueva a publishHTable_OAP, que retira la anterior*/
+HTable_OAP* RemodelHTableCap_OAP(HTable_OAP *PreviousHT, int state){
+    size_t newIndex = PreviousHT->index_size;
+    if(state==FULL)
+        newIndex+=1;
+    if(state==EMPTY)
+        newIndex-=1;
+    assert(state!=0);
+    size_t mark = memRemodelBegin();
+    //Calculamos cuántos bytes de la arena siguen en uso para reservar la nueva de una vez
+    size_t live = 0;
+    for(size_t i=0; i<PreviousHT->size; i++){
+        if(PreviousHT->table[i].meta & PK_VALID)
+            live += PreviousHT->table[i].meta & PK_LEN_MASK;
+    }
+    HTable_OAP *HT = newHTableCap_OAP(newIndex, live);
+    HT->seed = PreviousHT->seed;
+    HT->reseed_floor = PreviousHT->reseed_floor;
+    if(state==RESEED){
+        HT->seed = randomSeed();
+        HT->reseed_floor = 2*PreviousHT->occupied_elements;
+        __atomic_add_fetch(&flood_reseeds, 1, __ATOMIC_RELAXED);
+    }
+    for(size_t i=0; i<PreviousHT->size; i++){
+        packed_item *aux = &(PreviousHT->table[i]);
+        if(aux->meta & PK_VALID){
+            size_t len = aux->meta & PK_LEN_MASK;
+            uint32_t key = (state==RESEED) ? keyOAP(HT, PreviousHT->arena + aux->offset, len) : aux->key;
+            placeRecordOAP(HT, key, PreviousHT->arena + aux->offset, len);
+        }
+    }
+    HT->flooded = NO;
+    memRemodelEnd(mark);
+    return HT;
+}
+
+/*Función para evaluar si la tabla empaquetada está llena o vacía (relativamente hablando)*/
+int checkSizeOAP(HTable_OAP *HT, int operation){
+    //Las lápidas también alargan el sondeo, así que cuentan para la carga. Si la mayoría son lápidas, basta con reconstruir del mismo tamaño
+    if((HT->occupied_elements + HT->deleted_elements + 1 > (HT->size/2))&&(operation==UP)){
+        if(HT->deleted_elements > HT->occupied_elements)
+            return COMPACT;
+        return FULL;
+    }
+    //NOTA: Aquí le sumamos el cuadrado de la variable global "hist" (histéresis)
+    //...pero no se reduce si los elementos no caben en la tabla menor (con "hist" grande pasaría antes de tiempo)
+    if((HT->occupied_elements<(HT->size/10 +(hist*hist)))&&(operation==DOWN)&&(HT->index_size>0)
+       &&(HT->occupied_elements+1<=HASH_SIZE[HT->index_size-1]/2)){
+        hist++;
+        return EMPTY;
+    }
+    return 0;
+}
+
+/*Función para encontrar un record en la tabla empaquetada*/
+packed_item* HTfindRecord_OAP(HTable_OAP *HT, record *rec){
+    uint32_t key = keyOAP(HT, rec->bytes, rec->len);
+    size_t index = hashFunction(key, HT->size);
+    size_t i = 0;
+    //Sondeo (el mismo de LPProbing: x + i) hasta una casilla nunca usada; sólo se toca la arena si la llave y la longitud coinciden
+    while(HT->table[index].meta != 0){
+        packed_item *item = &(HT->table[index]);
+        if((item->meta & PK_VALID) && item->key == key && (item->meta & PK_LEN_MASK) == rec->len
+            && compareBytes(HT->arena + item->offset, rec->bytes, rec->len)==YES)
+            return item;
+        i++;
+        index = (index + i) % HT->size;
+    }
+    return NULL;
+}
+
+/*Función para insertar un elemento en la tabla empaquetada*/
+packed_item* HTinsertRecord_OAP(HTable_OAP **HT, record *rec){
+    if(HTfindRecord_OAP(*HT, rec) != NULL)
+        return NULL;
+    int state = checkSizeOAP(*HT, UP);
+    if(state != 0)
+        publishHTable_OAP(HT, RemodelHTableCap_OAP(*HT, state));
+    uint32_t key = keyOAP(*HT, rec->bytes, rec->len);
+    packed_item *item = placeRecordOAP(*HT, key, rec->bytes, rec->len);
+    //Si el sondeo fue anormalmente largo, se publica una tabla con otra semilla (con el mismo límite que checkFloodOA)
+    if(item != NULL && floodReseedDue(&(*HT)->flooded, (*HT)->occupied_elements, (*HT)->reseed_floor)){
+        publishHTable_OAP(HT, RemodelHTableCap_OAP(*HT, RESEED));
+        item = HTfindRecord_OAP(*HT, rec);
+    }
+    return item;
+}
+
+//Función para borrar un record en la tabla empaquetada (sus bytes se quedan en la arena hasta la siguiente reconstrucción)
+void HTdeleteRecordOAP(HTable_OAP **HT, record *rec){
+    packed_item *item = HTfindRecord_OAP(*HT, rec);
+    if(item == NULL)
+        return;
+    __atomic_store_n(&item->meta, PK_DELETED, __ATOMIC_RELEASE);
+    (*HT)->occupied_elements--;
+    (*HT)->deleted_elements++;
+    if(checkSizeOAP(*HT, DOWN)==EMPTY)
+        publishHTable_OAP(HT, RemodelHTableCap_OAP(*HT, EMPTY));
+}
+
+/*Función de lectura para otros hilos (cualquier cantidad, sin candados): busca un record en la tabla publicada en "*shared"*/
+/*NOTA: "reader" es el lugar que dio epochRegister. Regresa YES/NO y no una dirección, pues la casilla puede cambiar al salir*/
+int HTreadRecord_OAP(HTable_OAP **shared, record *rec, int reader){
+    int found = NO;
+    epochEnter(reader);
+    HTable_OAP *HT = __atomic_load_n(shared, __ATOMIC_ACQUIRE);
+    //La llave se calcula con la semilla de la tabla publicada (una tabla resembrada llega con otra)
+    uint32_t key = keyOAP(HT, rec->bytes, rec->len);
+    size_t index = hashFunction(key, HT->size);
+    size_t i = 0;
+    while(1){
+        packed_item *item = &(HT->table[index]);
+        uint32_t meta = __atomic_load_n(&item->meta, __ATOMIC_ACQUIRE);
+        if(meta == 0)
+            break;
+        if((meta & PK_VALID) && (meta & PK_LEN_MASK) == rec->len){
+            uint32_t k = __atomic_load_n(&item->key, __ATOMIC_RELAXED);
+            uint32_t offset = __atomic_load_n(&item->offset, __ATOMIC_RELAXED);
+            //Como en un seqlock: si "meta" no cambió, la llave y el desplazamiento leídos corresponden a esa misma longitud
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if(k == key && __atomic_load_n(&item->meta, __ATOMIC_ACQUIRE) == meta){
+                char *arena = __atomic_load_n(&HT->arena, __ATOMIC_ACQUIRE);
+                if(compareBytes(arena + offset, rec->bytes, rec->len)==YES){
+                    found = YES;
+                    break;
+                }
+            }
+        }
+        i++;
+        index = (index + i) % HT->size;
+    }
+    epochExit(reader);
+    return found;
+}
+
+/*Función para imprimir la tabla empaquetada*/
+void HTprint_OAP(HTable_OAP *HT){
+    for(size_t i=0; i<HT->size; i++){
+        printf("%ld ", i);
+        packed_item *item = &(HT->table[i]);
+        if(item->meta & PK_VALID){
+            char *str = HT->arena + item->offset;
+            for(size_t j = 0; j<(item->meta & PK_LEN_MASK); j++)
+                printf("%c", str[j]);
+            printf("[%u] ", item->key);
+        }
+        printf("\n");
+    }
+}
+
+/*Función para imprimir la memoria que usa la tabla empaquetada y cuánto toca por elemento*/
+void HTmemory_OAP(HTable_OAP *HT){
+    size_t bytes = sizeof(HTable_OAP) + HT->size*sizeof(packed_item) + HT->arena_cap;
+    printf("Memoria: %zu bytes (casillas: %zu, arena: %zu de %zu usados)\n", bytes, HT->size*sizeof(packed_item), HT->arena_len, HT->arena_cap);
+    if(HT->occupied_elements > 0)
+        printf("Bytes por elemento: %.2f\n", (double)bytes/HT->occupied_elements);
+}
+
+/*Lectores concurrentes de la tabla empaquetada ("readers=N"): mientras el hilo principal atiende los comandos (insertar, borrar y
+//...redimensionar), N hilos buscan sin parar con HTreadRecord_OAP llaves que se insertaron hace poco. El escritor deja una copia de
+//...cada llave insertada en un anillo (cada casilla con su contador, como en un seqlock) y los lectores toman de ahí sus llaves*/
+#define READ_RING 256
+#define READ_KEY 100
+
+/*Estructura de una casilla del anillo de llaves*/
+typedef struct{
+    uint64_t seq;               //Impar mientras el escritor copia la llave
+    uint32_t len;
+    char bytes[READ_KEY];
+}read_slot;
+
+/*Estructura de un hilo lector (sus contadores son sólo suyos; se suman al terminar)*/
+typedef struct{
+    struct packed_readers *R;
+    pthread_t thread;
+    int reader;                 //Lugar que le dio epochRegister
+    size_t reads;               //Búsquedas hechas
+    size_t hits;                //Búsquedas que encontraron la llave (las demás se borraron después de copiarlas al anillo)
+    size_t retries;             //Copias del anillo que se repitieron porque el escritor estaba cambiando la casilla
+}read_thread;
+
+/*Estructura de los lectores de una tabla empaquetada*/
+typedef struct packed_readers{
+    HTable_OAP **shared;        //Tabla publicada por el escritor
+    read_slot ring[READ_RING];
+    uint64_t next;              //Llaves que se han puesto en el anillo
+    int stop;                   //YES para que los lectores terminen
+    read_thread *threads;
+    int count;                  //No. de hilos lectores
+    uint64_t start;             //Inicio (en ns) para el reporte
+}packed_readers;
+
+/*Función (del escritor) para dejar una copia de una llave insertada en el anillo de los lectores*/
+void publishKeyOAP(packed_readers *R, record *rec){
+    read_slot *slot = &(R->ring[R->next % READ_RING]);
+    size_t len = (rec->len < READ_KEY) ? rec->len : READ_KEY;
+    __atomic_store_n(&slot->seq, slot->seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&slot->len, (uint32_t)len, __ATOMIC_RELAXED);
+    memcpy(slot->bytes, rec->bytes, len);
+    __atomic_store_n(&slot->seq, slot->seq + 1, __ATOMIC_RELEASE);
+    __atomic_store_n(&R->next, R->next + 1, __ATOMIC_RELEASE);
+}
+
+/*Función de cada hilo lector: copia una llave al azar de las últimas del anillo y la busca en la tabla publicada*/
+void* readerLoopOAP(void *arg){
+    read_thread *RT = (read_thread*)arg;
+    packed_readers *R = RT->R;
+    uint64_t x = 0x9E3779B97F4A7C15ULL * (uint64_t)(RT->reader + 1);
+    char bytes[READ_KEY];
+    record rec;
+    rec.bytes = bytes;
+    while(!__atomic_load_n(&R->stop, __ATOMIC_ACQUIRE)){
+        uint64_t n = __atomic_load_n(&R->next, __ATOMIC_ACQUIRE);
+        if(n == 0){
+            sched_yield();
+            continue;
+        }
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        uint64_t back = x % ((n < READ_RING) ? n : READ_RING);
+        read_slot *slot = &(R->ring[(n - 1 - back) % READ_RING]);
+        uint64_t seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+        if(seq & 1){
+            RT->retries++;
+            continue;
+        }
+        rec.len = __atomic_load_n(&slot->len, __ATOMIC_RELAXED);
+        memcpy(bytes, slot->bytes, rec.len);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if(__atomic_load_n(&slot->seq, __ATOMIC_RELAXED) != seq){
+            RT->retries++;
+            continue;
+        }
+        RT->hits += HTreadRecord_OAP(R->shared, &rec, RT->reader);
+        RT->reads++;
+    }
+    return NULL;
+}
+
+/*Función para arrancar "count" hilos lectores sobre la tabla publicada en "*shared". Regresa NULL si no se pudo*/
+packed_readers* startReadersOAP(HTable_OAP **shared, int count){
+    packed_readers *R = (packed_readers*)calloc(1, sizeof(packed_readers));
+    if(R == NULL){
+        fprintf(stderr, "Cannot allocate memory for readers.\n");
+        return NULL;
+    }
+    R->threads = (read_thread*)calloc(count, sizeof(read_thread));
+    if(R->threads == NULL){
+        fprintf(stderr, "Cannot allocate memory for readers.\n");
+        free(R);
+        return NULL;
+    }
+    R->shared = shared;
+    R->start = nowNs();
+    for(int t=0; t<count; t++){
+        R->threads[t].R = R;
+        R->threads[t].reader = epochRegister();
+        if(R->threads[t].reader < 0){
+            fprintf(stderr, "Too many readers (at most %d)\n", MAX_READERS - 1);
+            break;
+        }
+        if(pthread_create(&R->threads[t].thread, NULL, readerLoopOAP, &R->threads[t]) != 0){
+            fprintf(stderr, "Cannot create reader thread\n");
+            epochUnregister(R->threads[t].reader);
+            break;
+        }
+        R->count++;
+    }
+    return R;
+}
+
+/*Función para detener los lectores, imprimir lo que hicieron (y lo que se liberó por épocas) y liberarlos*/
+void stopReadersOAP(packed_readers *R){
+    __atomic_store_n(&R->stop, YES, __ATOMIC_RELEASE);
+    size_t reads = 0, hits = 0, retries = 0;
+    for(int t=0; t<R->count; t++){
+        pthread_join(R->threads[t].thread, NULL);
+        epochUnregister(R->threads[t].reader);
+        reads += R->threads[t].reads;
+        hits += R->threads[t].hits;
+        retries += R->threads[t].retries;
+    }
+    double ms = (nowNs() - R->start)/1e6;
+    printf("Lectores: %d hilos, %zu búsquedas (%zu encontradas, %zu copias repetidas) en %.3f ms, %.0f búsquedas/s\n", R->count, reads,
+           hits, retries, ms, (ms > 0) ? reads*1000.0/ms : 0.0);
+    printf("Épocas: %lu, %zu bloques retirados, %zu liberados, %zu pendientes\n", (unsigned long)global_epoch, epoch_retired,
+           epoch_freed, epoch_limbo_len);
+    free(R->threads);
+    free(R);
+}
+
+/*Función para leer la opción "readers=N" (hilos lectores de la tabla empaquetada)*/
+int parseReadersOption(int *readers, const char *arg){
+    if(strncmp(arg, "readers=", 8)!=0)
+        return NO;
+    *readers = atoi(arg + 8);
+    return YES;
+}
+
+
+/*..............................................COMPARTIDA................................................................................*/
+/*Tabla empaquetada (mismas casillas de 12 bytes) que vive completa en un segmento de memoria compartida POSIX con nombre, para que
+//...varios procesos usen una sola copia: un proceso escritor y cualquier cantidad de procesos lectores. En el segmento no hay
+//...apuntadores, sólo desplazamientos desde su inicio (cada proceso lo mapea en otra dirección): primero el encabezado, luego las
+//...casillas y luego la arena con los contenidos. El segmento nunca se encoge (un lector podría estar leyendo al final).
+//...Consistencia: el escritor hace cada cambio entre dos incrementos del contador "seq" (impar = cambio en curso). El lector lee
+//...el contador, busca, y vuelve a leerlo: si cambió (o era impar), repite la búsqueda. Si el segmento creció, primero lo vuelve a
+//...mapear. Mientras repite no confía en nada de lo que leyó: todos los desplazamientos se revisan contra lo que tiene mapeado*/
+#define SH_MAGIC 0x32535448u        //"HTS2" (la versión anterior, "HTSH", no guardaba la semilla)
+#define SH_MIN_ARENA 4096           //Capacidad mínima de la arena (bytes)
+#define SH_ALIGN 64                 //Alineación de las casillas dentro del segmento (una línea de caché)
+
+/*Estructura del encabezado del segmento compartido*/
+typedef struct{
+    uint32_t magic;             //SH_MAGIC cuando el segmento ya está listo
+    uint32_t writer;            //pid del escritor (0 = ninguno)
+    uint64_t seq;               //Contador del seqlock
+    uint64_t segment_size;      //Bytes del segmento (sólo crece)
+    uint64_t index_size;        //Índice del tipo de capacidad
+    uint64_t size;              //Tamaño del arreglo de casillas
+    uint64_t occupied_elements; //Cantidad de elementos ocupados en la tabla
+    uint64_t deleted_elements;  //Cantidad de lápidas en la tabla
+    uint64_t table_off;         //Desplazamiento de las casillas
+    uint64_t arena_off;         //Desplazamiento de la arena
+    uint64_t arena_len;         //Bytes usados de la arena (incluye los de elementos borrados)
+    uint64_t arena_cap;         //Capacidad de la arena
+    uint64_t seed;              //Semilla con la que se calculan las llaves (los lectores la leen dentro del seqlock)
+    uint64_t reseed_floor;      //No se vuelve a resembrar hasta tener al menos estos elementos (el doble que en el último resiembro)
+}shared_header;
+
+/*Estructura con lo que cada proceso sabe del segmento (esto no se comparte)*/
+typedef struct{
+    shared_header *H;           //Inicio del segmento en este proceso
+    size_t mapped;              //Bytes mapeados
+    int fd;                     //Descriptor del segmento
+    int writer;                 //YES si este proceso es el escritor
+    int flooded;                //YES si la última inserción del escritor tuvo un recorrido anormalmente largo
+}HTable_OAS;
+
+/*Funciones para obtener las casillas y la arena a partir del encabezado*/
+static inline packed_item* tableOAS(shared_header *H){
+    return (packed_item*)((char*)H + H->table_off);
+}
+static inline char* arenaOAS(shared_header *H){
+    return (char*)H + H->arena_off;
+}
+
+/*Funciones del escritor para empezar y terminar un cambio (el contador queda impar mientras tanto)*/
+static inline void beginWriteOAS(shared_header *H){
+    __atomic_store_n(&H->seq, H->seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+static inline void endWriteOAS(shared_header *H){
+    __atomic_store_n(&H->seq, H->seq + 1, __ATOMIC_RELEASE);
+}
+
+/*Función para (volver a) mapear todo el segmento. Regresa NO si no se pudo*/
+int mapSegmentOAS(HTable_OAS *HT, size_t bytes){
+    void *ptr = mmap(NULL, bytes, HT->writer ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, HT->fd, 0);
+    if(ptr == MAP_FAILED){
+        fprintf(stderr, "Cannot map shared segment.\n");
+        return NO;
+    }
+    if(HT->H != NULL)
+        munmap(HT->H, HT->mapped);
+    HT->H = (shared_header*)ptr;
+    HT->mapped = bytes;
+    return YES;
+}
+
+/*Función del escritor para que el segmento tenga al menos "bytes" (se redondea a páginas)*/
+int growSegmentOAS(HTable_OAS *HT, size_t bytes){
+    if(bytes <= HT->mapped)
+        return YES;
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    bytes = ((bytes + page - 1)/page)*page;
+    if(ftruncate(HT->fd, bytes) != 0){
+        fprintf(stderr, "Cannot allocate memory for table.");
+        return NO;
+    }
+    size_t old = HT->mapped;
+    if(mapSegmentOAS(HT, bytes)==NO)
+        return NO;
+    memAdd(MEM_TABLE, bytes - old, bytes - old);
+    __atomic_store_n(&HT->H->segment_size, bytes, __ATOMIC_RELEASE);
+    return YES;
+}
+
+/*Función del escritor para acomodar casillas vacías y una arena vacía con "arena_cap" bytes (hay que estar dentro de un cambio)*/
+int layoutOAS(HTable_OAS *HT, size_t index, size_t arena_cap){
+    size_t table_off = ((sizeof(shared_header) + SH_ALIGN - 1)/SH_ALIGN)*SH_ALIGN;
+    size_t arena_off = table_off + HASH_SIZE[index]*sizeof(packed_item);
+    if(growSegmentOAS(HT, arena_off + arena_cap)==NO)
+        return NO;
+    shared_header *H = HT->H;
+    //La arena llega hasta el final del segmento (si éste ya era más grande, se aprovecha)
+    __atomic_store_n(&H->index_size, index, __ATOMIC_RELAXED);
+    __atomic_store_n(&H->size, HASH_SIZE[index], __ATOMIC_RELAXED);
+    __atomic_store_n(&H->table_off, table_off, __ATOMIC_RELAXED);
+    __atomic_store_n(&H->arena_off, arena_off, __ATOMIC_RELAXED);
+    __atomic_store_n(&H->arena_len, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&H->arena_cap, HT->mapped - arena_off, __ATOMIC_RELAXED);
+    __atomic_store_n(&H->occupied_elements, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&H->deleted_elements, 0, __ATOMIC_RELAXED);
+    memset(tableOAS(H), 0, HASH_SIZE[index]*sizeof(packed_item));
+    return YES;
+}
+
+/*Función para cerrar la tabla compartida en este proceso (el segmento sigue existiendo hasta unlinkHTable_OAS)*/
+void closeHTable_OAS(HTable_OAS *HT){
+    if(HT->H != NULL){
+        if(HT->writer){
+            __atomic_store_n(&HT->H->writer, 0, __ATOMIC_RELEASE);
+            memSub(MEM_TABLE, HT->mapped, HT->mapped);
+        }
+        munmap(HT->H, HT->mapped);
+    }
+    if(HT->fd >= 0)
+        close(HT->fd);
+    memFree(MEM_TABLE, HT, sizeof(HTable_OAS));
+}
+
+/*Función para borrar el nombre del segmento (los procesos que ya lo tienen abierto lo siguen usando)*/
+void unlinkHTable_OAS(const char *name){
+    if(shm_unlink(name) != 0)
+        fprintf(stderr, "Cannot unlink shared segment %s\n", name);
+}
+
+/*Función para abrir (o crear, si es el escritor) la tabla compartida con nombre "name" (p. ej. "/tabla")*/
+HTable_OAS* openHTable_OAS(const char *name, int writer){
+    HTable_OAS *HT = (HTable_OAS*)memMalloc(MEM_TABLE, sizeof(HTable_OAS)*1);
+    if(HT == NULL){
+        fprintf(stderr, "Cannot allocate memory for table.");
+        exit(1);
+    }
+    HT->H = NULL;
+    HT->mapped = 0;
+    HT->writer = writer;
+    HT->flooded = NO;
+    HT->fd = shm_open(name, writer ? (O_RDWR | O_CREAT) : O_RDONLY, 0600);
+    struct stat st;
+    if(HT->fd < 0 || fstat(HT->fd, &st) != 0){
+        fprintf(stderr, "Cannot open shared segment %s\n", name);
+        memFree(MEM_TABLE, HT, sizeof(HTable_OAS));
+        return NULL;
+    }
+    //Un lector espera a que el escritor haya dejado listo el segmento
+    if(!writer){
+        if((size_t)st.st_size < sizeof(shared_header) || mapSegmentOAS(HT, st.st_size)==NO
+           || __atomic_load_n(&HT->H->magic, __ATOMIC_ACQUIRE) != SH_MAGIC){
+            fprintf(stderr, "Shared segment %s is not ready\n", name);
+            closeHTable_OAS(HT);
+            return NULL;
+        }
+        return HT;
+    }
+    //El escritor: si el segmento ya tenía una tabla (y su escritor ya terminó), la sigue usando; si no, la crea
+    int ready = NO;
+    if((size_t)st.st_size >= sizeof(shared_header)){
+        uint32_t pid = 0;
+        if(mapSegmentOAS(HT, st.st_size)==YES)
+            pid = __atomic_load_n(&HT->H->writer, __ATOMIC_ACQUIRE);
+        if(HT->H == NULL || (HT->H->magic == SH_MAGIC && pid != 0 && pid != (uint32_t)getpid() && kill((pid_t)pid, 0) == 0)){
+            if(HT->H != NULL)
+                fprintf(stderr, "Shared segment %s already has a writer (pid %u)\n", name, pid);
+            HT->writer = NO;
+            closeHTable_OAS(HT);
+            return NULL;
+        }
+        ready = (HT->H->magic == SH_MAGIC);
+    }
+    //Desde aquí el segmento cuenta como memoria de este proceso (growSegmentOAS suma lo que crezca)
+    memAdd(MEM_TABLE, HT->mapped, HT->mapped);
+    if(!ready){
+        if(growSegmentOAS(HT, sizeof(shared_header))==NO){
+            closeHTable_OAS(HT);
+            return NULL;
+        }
+        beginWriteOAS(HT->H);
+        if(layoutOAS(HT, 0, SH_MIN_ARENA)==NO){
+            closeHTable_OAS(HT);
+            return NULL;
+        }
+        __atomic_store_n(&HT->H->seed, tableSeed(), __ATOMIC_RELAXED);
+        __atomic_store_n(&HT->H->reseed_floor, 0, __ATOMIC_RELAXED);
+        endWriteOAS(HT->H);
+        __atomic_store_n(&HT->H->magic, SH_MAGIC, __ATOMIC_RELEASE);
+    }
+    __atomic_store_n(&HT->H->writer, (uint32_t)getpid(), __ATOMIC_RELEASE);
+    return HT;
+}
+
+/*Función para calcular la llave de un contenido con la semilla "seed" de la tabla compartida*/
+static inline uint32_t keyOAS(uint64_t seed, const void *bytes, size_t len){
+    return seededKey(seed, (const unsigned char*)bytes, len);
+}
+
+/*Función del escritor para colocar un contenido (que sabemos que no está y que cabe en la arena); hay que estar dentro de un cambio.
+//...Regresa cuántas casillas tuvo que saltar*/
+size_t placeRecordOAS(shared_header *H, uint32_t key, const void *bytes, size_t len){
+    packed_item *table = tableOAS(H);
+    size_t index = hashFunction(key, H->size);
+    size_t i = 0;
+    while(table[index].meta & PK_VALID){
+        i++;
+        index = (index + i) % H->size;
+    }
+    packed_item *item = &(table[index]);
+    if(item->meta & PK_DELETED)
+        __atomic_store_n(&H->deleted_elements, H->deleted_elements - 1, __ATOMIC_RELAXED);
+    memcpy(arenaOAS(H) + H->arena_len, bytes, len);
+    __atomic_store_n(&item->key, key, __ATOMIC_RELAXED);
+    __atomic_store_n(&item->offset, (uint32_t)H->arena_len, __ATOMIC_RELAXED);
+    __atomic_store_n(&item->meta, (uint32_t)len | PK_VALID, __ATOMIC_RELAXED);
+    __atomic_store_n(&H->arena_len, H->arena_len + len, __ATOMIC_RELAXED);
+    __atomic_store_n(&H->occupied_elements, H->occupied_elements + 1, __ATOMIC_RELAXED);
+    return i;
+}
+
+/*Función del escritor para reconstruir la tabla en el mismo segmento con otra capacidad (o la misma, con COMPACT, o con RESEED, que además
+//...cambia la semilla) y una arena en la que quepan "extra" bytes más. Los contenidos válidos se copian antes a memoria privada, pues
+//...la arena se reescribe*/
+int RemodelHTableCap_OAS(HTable_OAS *HT, int state, size_t extra){
+    shared_header *H = HT->H;
+    size_t newIndex = H->index_size;
+    if(state==FULL)
+        newIndex+=1;
+    if(state==EMPTY)
+        newIndex-=1;
+    assert(state!=0);
+    size_t mark = memRemodelBegin();
+    packed_item *table = tableOAS(H);
+    size_t live = 0, n = 0;
+    for(size_t i=0; i<H->size; i++){
+        if(table[i].meta & PK_VALID)
+            live += table[i].meta & PK_LEN_MASK;
+    }
+    packed_item *items = (packed_item*)memMalloc(MEM_NODES, sizeof(packed_item)*(H->occupied_elements + 1));
+    char *bytes = (char*)memMalloc(MEM_KEYS, live + 1);
+    if(items == NULL || bytes == NULL){
+        fprintf(stderr, "Cannot allocate memory for table.");
+        exit(1);
+    }
+    live = 0;
+    for(size_t i=0; i<H->size; i++){
+        if(table[i].meta & PK_VALID){
+            size_t len = table[i].meta & PK_LEN_MASK;
+            memcpy(bytes + live, arenaOAS(H) + table[i].offset, len);
+            items[n] = table[i];
+            items[n].offset = (uint32_t)live;
+            live += len;
+            n++;
+        }
+    }
+    size_t arena_cap = 2*(live + extra);
+    if(arena_cap < SH_MIN_ARENA)
+        arena_cap = SH_MIN_ARENA;
+    beginWriteOAS(HT->H);
+    int ok = layoutOAS(HT, newIndex, arena_cap);
+    if(ok==NO)
+        layoutOAS(HT, H->index_size, live);         //No creció el segmento: el que ya había alcanza para lo que había
+    if(state==RESEED){
+        __atomic_store_n(&HT->H->seed, randomSeed(), __ATOMIC_RELAXED);
+        __atomic_store_n(&HT->H->reseed_floor, 2*n, __ATOMIC_RELAXED);
+        for(size_t i=0; i<n; i++)
+            items[i].key = keyOAS(HT->H->seed, bytes + items[i].offset, items[i].meta & PK_LEN_MASK);
+        __atomic_add_fetch(&flood_reseeds, 1, __ATOMIC_RELAXED);
+    }
+    for(size_t i=0; i<n; i++)
+        placeRecordOAS(HT->H, items[i].key, bytes + items[i].offset, items[i].meta & PK_LEN_MASK);
+    endWriteOAS(HT->H);
+    memFree(MEM_NODES, items, sizeof(packed_item)*(n + 1));
+    memFree(MEM_KEYS, bytes, live + 1);
+    memRemodelEnd(mark);
+    return ok;
+}
+
+/*Función para evaluar si la tabla compartida está llena o vacía (mismas reglas que checkSizeOAP)*/
+int checkSizeOAS(shared_header *H, int operation){
+    if((H->occupied_elements + H->deleted_elements + 1 > (H->size/2))&&(operation==UP)){
+        if(H->deleted_elements > H->occupied_elements)
+            return COMPACT;
+        return FULL;
+    }
+    //NOTA: Aquí le sumamos el cuadrado de la variable global "hist" (histéresis)
+    if((H->occupied_elements<(H->size/10 +(hist*hist)))&&(operation==DOWN)&&(H->index_size>0)
+       &&(H->occupied_elements+1<=HASH_SIZE[H->index_size-1]/2)){
+        hist++;
+        return EMPTY;
+    }
+    return 0;
+}
+
+/*Función del escritor para encontrar un record (el escritor es el único que cambia la tabla, así que no necesita el seqlock)*/
+packed_item* HTfindRecord_OAS(HTable_OAS *HT, record *rec){
+    shared_header *H = HT->H;
+    packed_item *table = tableOAS(H);
+    uint32_t key = keyOAS(H->seed, rec->bytes, rec->len);
+    size_t index = hashFunction(key, H->size);
+    size_t i = 0;
+    while(table[index].meta != 0){
+        packed_item *item = &(table[index]);
+        if((item->meta & PK_VALID) && item->key == key && (item->meta & PK_LEN_MASK) == rec->len
+            && compareBytes(arenaOAS(H) + item->offset, rec->bytes, rec->len)==YES)
+            return item;
+        i++;
+        index = (index + i) % H->size;
+    }
+    return NULL;
+}
+
+/*Función del escritor para insertar un elemento en la tabla compartida*/
+int HTinsertRecord_OAS(HTable_OAS *HT, record *rec){
+    if(rec->len > PK_LEN_MASK || HTfindRecord_OAS(HT, rec) != NULL)
+        return NO;
+    int state = checkSizeOAS(HT->H, UP);
+    if(state != 0 && RemodelHTableCap_OAS(HT, state, rec->len)==NO)
+        return NO;
+    //Si la arena no alcanza, se reconstruye del mismo tamaño con una arena más grande (y sin los contenidos borrados)
+    if(HT->H->arena_len + rec->len > HT->H->arena_cap || HT->H->arena_len + rec->len > UINT32_MAX)
+        RemodelHTableCap_OAS(HT, COMPACT, rec->len);
+    if(HT->H->arena_len + rec->len > HT->H->arena_cap || HT->H->arena_len + rec->len > UINT32_MAX){
+        fprintf(stderr, "Cannot allocate memory for element!\n");
+        return NO;
+    }
+    uint32_t key = keyOAS(HT->H->seed, rec->bytes, rec->len);
+    beginWriteOAS(HT->H);
+    size_t probes = placeRecordOAS(HT->H, key, rec->bytes, rec->len);
+    endWriteOAS(HT->H);
+    //Si el sondeo fue anormalmente largo, se reconstruye con otra semilla (con el mismo límite que checkFloodOA)
+    if(probes > floodLimit(HT->H->size))
+        HT->flooded = YES;
+    if(floodReseedDue(&HT->flooded, HT->H->occupied_elements, HT->H->reseed_floor))
+        RemodelHTableCap_OAS(HT, RESEED, 0);
+    return YES;
+}
+
+//Función del escritor para borrar un record en la tabla compartida (sus bytes se quedan en la arena hasta la siguiente reconstrucción)
+void HTdeleteRecordOAS(HTable_OAS *HT, record *rec){
+    packed_item *item = HTfindRecord_OAS(HT, rec);
+    if(item == NULL)
+        return;
+    shared_header *H = HT->H;
+    beginWriteOAS(H);
+    __atomic_store_n(&item->meta, PK_DELETED, __ATOMIC_RELAXED);
+    __atomic_store_n(&H->occupied_elements, H->occupied_elements - 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&H->deleted_elements, H->deleted_elements + 1, __ATOMIC_RELAXED);
+    endWriteOAS(H);
+    if(checkSizeOAS(H, DOWN)==EMPTY)
+        RemodelHTableCap_OAS(HT, EMPTY, 0);
+}
+
+/*Función para empezar una lectura: espera a que no haya cambio en curso y vuelve a mapear si el segmento creció. Regresa "seq"*/
+uint64_t beginReadOAS(HTable_OAS *HT){
+    while(1){
+        uint64_t seq = __atomic_load_n(&HT->H->seq, __ATOMIC_ACQUIRE);
+        if(seq & 1){
+            sched_yield();
+            continue;
+        }
+        size_t size = __atomic_load_n(&HT->H->segment_size, __ATOMIC_ACQUIRE);
+        if(size > HT->mapped && mapSegmentOAS(HT, size)==NO)
+            exit(1);
+        return seq;
+    }
+}
+
+/*Función para terminar una lectura. Regresa YES si nada cambió desde beginReadOAS (si no, hay que repetirla)*/
+static inline int endReadOAS(HTable_OAS *HT, uint64_t seq){
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&HT->H->seq, __ATOMIC_RELAXED) == seq;
+}
+
+/*Función de lectura para cualquier proceso (sin candados): regresa YES/NO*/
+int HTreadRecord_OAS(HTable_OAS *HT, record *rec){
+    while(1){
+        uint64_t seq = beginReadOAS(HT);
+        shared_header *H = HT->H;
+        int found = NO;
+        //La semilla cambia si el escritor resiembra: se lee dentro del seqlock, así que una llave vieja también hace repetir
+        uint32_t key = keyOAS(__atomic_load_n(&H->seed, __ATOMIC_RELAXED), rec->bytes, rec->len);
+        size_t size = __atomic_load_n(&H->size, __ATOMIC_RELAXED);
+        size_t table_off = __atomic_load_n(&H->table_off, __ATOMIC_RELAXED);
+        size_t arena_off = __atomic_load_n(&H->arena_off, __ATOMIC_RELAXED);
+        //Si lo leído no tiene sentido es que el escritor estaba a la mitad de un cambio: sólo se repite
+        if(size > 0 && table_off + size*sizeof(packed_item) <= arena_off && arena_off <= HT->mapped){
+            packed_item *table = (packed_item*)((char*)H + table_off);
+            size_t index = hashFunction(key, size);
+            for(size_t i=1; i<=size; i++){
+                uint32_t meta = __atomic_load_n(&table[index].meta, __ATOMIC_RELAXED);
+                if(meta == 0)
+                    break;
+                if((meta & PK_VALID) && (meta & PK_LEN_MASK) == rec->len && __atomic_load_n(&table[index].key, __ATOMIC_RELAXED) == key){
+                    size_t offset = __atomic_load_n(&table[index].offset, __ATOMIC_RELAXED);
+                    if(arena_off + offset + rec->len <= HT->mapped
+                       && compareBytes((char*)H + arena_off + offset, rec->bytes, rec->len)==YES){
+                        found = YES;
+                        break;
+                    }
+                }
+                index = (index + i) % size;
+            }
+        }
+        if(endReadOAS(HT, seq))
+            return found;
+    }
+}
+
+/*Función para leer la cantidad de elementos (de forma consistente)*/
+size_t HTcount_OAS(HTable_OAS *HT){
+    while(1){
+        uint64_t seq = beginReadOAS(HT);
+        size_t count = __atomic_load_n(&HT->H->occupied_elements, __ATOMIC_RELAXED);
+        if(endReadOAS(HT, seq))
+            return count;
+    }
+}
+
+/*Función para imprimir la tabla compartida (se copia primero a memoria privada, así la copia es consistente aunque haya escritor)*/
+void HTprint_OAS(HTable_OAS *HT){
+    size_t size, copied;
+    char *copy = NULL;
+    while(1){
+        int ok = NO;
+        uint64_t seq = beginReadOAS(HT);
+        shared_header *H = HT->H;
+        size = __atomic_load_n(&H->size, __ATOMIC_RELAXED);
+        size_t table_off = __atomic_load_n(&H->table_off, __ATOMIC_RELAXED);
+        size_t arena_len = __atomic_load_n(&H->arena_len, __ATOMIC_RELAXED);
+        size_t arena_off = __atomic_load_n(&H->arena_off, __ATOMIC_RELAXED);
+        copied = size*sizeof(packed_item) + arena_len;
+        if(table_off + size*sizeof(packed_item) <= arena_off && arena_off + arena_len <= HT->mapped){
+            free(copy);
+            copy = (char*)malloc(copied + 1);
+            if(copy == NULL){
+                fprintf(stderr, "Cannot allocate memory for table.");
+                return;
+            }
+            memcpy(copy, (char*)H + table_off, size*sizeof(packed_item));
+            memcpy(copy + size*sizeof(packed_item), (char*)H + arena_off, arena_len);
+            ok = YES;
+        }
+        if(endReadOAS(HT, seq) && ok)
+            break;
+    }
+    packed_item *table = (packed_item*)copy;
+    char *arena = copy + size*sizeof(packed_item);
+    for(size_t i=0; i<size; i++){
+        printf("%ld ", i);
+        if((table[i].meta & PK_VALID) && table[i].offset + (table[i].meta & PK_LEN_MASK) <= copied - size*sizeof(packed_item)){
+            for(size_t j = 0; j<(table[i].meta & PK_LEN_MASK); j++)
+                printf("%c", arena[table[i].offset + j]);
+            printf("[%u] ", table[i].key);
+        }
+        printf("\n");
+    }
+    free(copy);
+}
+
+/*Función para leer una opción de la tabla compartida ("shm=/nombre" o "reader"). Regresa YES si el argumento era una*/
+int parseSharedOption(const char **name, int *reader, const char *arg){
+    if(strncmp(arg, "shm=", 4)==0)
+        *name = arg + 4;
+    else if(strcmp(arg, "reader")==0)
+        *reader = YES;
+    else
+        return NO;
+    return YES;
+}
+
+/*Función para imprimir lo que ocupa el segmento compartido*/
+void HTmemory_OAS(HTable_OAS *HT){
+    printf("Segmento compartido: %zu bytes (casillas: %zu, arena: %zu de %zu usados), seq %lu, escritor %u\n", HT->mapped,
+           (size_t)HT->H->size*sizeof(packed_item), (size_t)HT->H->arena_len, (size_t)HT->H->arena_cap,
+           (unsigned long)__atomic_load_n(&HT->H->seq, __ATOMIC_ACQUIRE), __atomic_load_n(&HT->H->writer, __ATOMIC_ACQUIRE));
+}
+
+/*...............................................CONGELADA.................................................................................*/
+/*Cuando los datos se cargan una vez y después sólo se consultan, "freeze" pasa las llaves de la tabla a una forma de sólo lectura: una
+//...función hash perfecta mínima (estilo BBHash) que a cada llave le da un número distinto entre 0 y n-1, y una arena donde las llaves
+//...quedan juntas en ese orden. La función son varios niveles de bits: en cada nivel cada llave que falta cae en un bit (con gamma bits
+//...por llave); las que caen solas encienden su bit y las que chocan pasan al siguiente nivel. El número de una llave es cuántos bits hay
+//...encendidos antes del suyo (con un conteo guardado cada 512 bits). Así, buscar es un hash, unos cuantos bits, un lugar de la arena
+//...y una comparación. Todo vive en un solo bloque sin punteros, así que se puede escribir tal cual a un archivo ("freeze archivo") y
+//...después usarlo mapeado con mmap ("frozen=archivo"). El archivo queda en el orden de bytes de la máquina que lo escribió.
+//...Sólo se congelan las llaves (los acumuladores de la agregación no); "thaw" regresa a una tabla normal*/
+#define MPH_MAGIC 0x3148504d414f5448ULL     //"HTOAMPH1"
+#define MPH_GAMMA 2.0                       //Bits por llave en cada nivel (más bits: menos niveles, función más grande)
+#define MPH_MAX_LEVELS 32                   //Las llaves que siguen chocando después del último nivel se guardan aparte
+#define MPH_BLOCK 512                       //Bits por conteo acumulado
+#define MPH_NONE ((uint64_t)-1)
+
+/*Encabezado del bloque congelado (después vienen los bits, los conteos, los hashes de las llaves aparte, los inicios en la arena y la arena)*/
+typedef struct{
+    uint64_t magic;
+    uint64_t seed;                          //Semilla del hash de las llaves
+    uint64_t count;                         //No. de llaves
+    uint64_t levels;                        //No. de niveles
+    uint64_t bits;                          //Bits de todos los niveles (múltiplo de MPH_BLOCK)
+    uint64_t fallback;                      //Llaves que no quedaron en ningún nivel (van al final de la numeración)
+    uint64_t arena_bytes;
+    uint64_t total_bytes;                   //Tamaño de todo el bloque
+    uint64_t level_start[MPH_MAX_LEVELS+1]; //Primer bit de cada nivel (y al final, "bits")
+}mph_header;
+
+/*Estructura de la tabla congelada (los apuntadores son hacia dentro del bloque)*/
+typedef struct{
+    mph_header *header;
+    uint64_t *words;                        //Bits de todos los niveles
+    uint64_t *ranks;                        //Bits encendidos antes de cada bloque de MPH_BLOCK bits
+    uint64_t *fallback;                     //Hash de cada llave guardada aparte
+    uint64_t *offsets;                      //Inicio de cada llave en la arena (count+1; la última es el final)
+    char *arena;                            //Contenido de las llaves, una tras otra en el orden de la función
+    size_t bytes;                           //Tamaño del bloque
+    int mapped;                             //YES si el bloque es un archivo mapeado
+}HTable_OAF;
+
+/*Función para la posición de un hash dentro del nivel "level" (de "size" bits): se vuelve a mezclar con el nivel y se escala al tamaño
+//...con una multiplicación (sin módulo)*/
+static inline uint64_t mphPosition(uint64_t h, size_t level, uint64_t size){
+    uint64_t x = h + (level + 1)*0x9E3779B97F4A7C15ULL;
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return (uint64_t)(((unsigned __int128)x * size) >> 64);
+}
+
+/*Función para contar los bits encendidos antes de "pos"*/
+static inline uint64_t mphRank(HTable_OAF *F, uint64_t pos){
+    uint64_t rank = F->ranks[pos/MPH_BLOCK];
+    for(uint64_t w = (pos/MPH_BLOCK)*(MPH_BLOCK/64); w < pos/64; w++)
+        rank += __builtin_popcountll(F->words[w]);
+    uint64_t low = pos % 64;
+    if(low != 0)
+        rank += __builtin_popcountll(F->words[pos/64] & ((1ULL << low) - 1));
+    return rank;
+}
+
+/*Función para el número de una llave según su hash (MPH_NONE si no cae en un bit encendido ni está aparte). Si la llave no está en
+//...la tabla puede regresar el número de otra: quien llama compara el contenido*/
+static inline uint64_t mphSlot(HTable_OAF *F, uint64_t h){
+    mph_header *H = F->header;
+    for(size_t level=0; level<H->levels; level++){
+        uint64_t pos = H->level_start[level] + mphPosition(h, level, H->level_start[level+1] - H->level_start[level]);
+        if(F->words[pos/64] & (1ULL << (pos % 64)))
+            return mphRank(F, pos);
+    }
+    return MPH_NONE;
+}
+
+/*Función para colocar los apuntadores de una tabla congelada sobre su bloque*/
+void mphAttach(HTable_OAF *F, void *block, size_t bytes, int mapped){
+    F->header = (mph_header*)block;
+    F->words = (uint64_t*)(F->header + 1);
+    F->ranks = F->words + F->header->bits/64;
+    F->fallback = F->ranks + F->header->bits/MPH_BLOCK;
+    F->offsets = F->fallback + F->header->fallback;
+    F->arena = (char*)(F->offsets + F->header->count + 1);
+    F->bytes = bytes;
+    F->mapped = mapped;
+}
+
+/*Función para el tamaño del bloque (la arena se redondea a 8 bytes para que los archivos midan siempre lo mismo)*/
+static inline size_t mphBlockSize(uint64_t bits, uint64_t fallback, uint64_t count, uint64_t arena_bytes){
+    return sizeof(mph_header) + bits/8 + (bits/MPH_BLOCK)*sizeof(uint64_t) + fallback*sizeof(uint64_t) +
+           (count + 1)*sizeof(uint64_t) + ((arena_bytes + 7) & ~(uint64_t)7);
+}
+
+/*Función para congelar las llaves de una tabla de open addressing (con su semilla). La tabla no se modifica*/
+HTable_OAF* freezeHTable_OA(HTable_OA *HT){
+    //Se juntan los contenidos válidos de las casillas y del stash, con su hash de 64 bits
+    size_t n = 0;
+    record *recs = (record*)malloc(sizeof(record)*(HT->occupied_elements + 1));
+    uint64_t *hashes = (uint64_t*)malloc(sizeof(uint64_t)*(HT->occupied_elements + 1));
+    uint64_t *where = (uint64_t*)malloc(sizeof(uint64_t)*(HT->occupied_elements + 1));      //Bit de cada llave (MPH_NONE = aparte)
+    size_t *pending = (size_t*)malloc(sizeof(size_t)*(HT->occupied_elements + 1));
+    if(recs == NULL || hashes == NULL || where == NULL || pending == NULL){
+        fprintf(stderr, "Cannot allocate memory for frozen table.\n");
+        exit(1);
+    }
+    uint64_t arena_bytes = 0;
+    for(size_t i=0; i<HT->size + HT->stash_len && n < HT->occupied_elements; i++){
+        hash_item *item = (i < HT->size) ? &(HT->table[i]) : &(HT->stash[i - HT->size]);
+        if(item->status != VALID)
+            continue;
+        recs[n] = item->rec;
+        hashes[n] = seededHash64(HT->seed, (unsigned char*)item->rec.bytes, item->rec.len);
+        where[n] = MPH_NONE;
+        pending[n] = n;
+        arena_bytes += item->rec.len;
+        n++;
+    }
+    //Se arman los niveles: cada uno con sus bits "vistos" y "chocados"; las llaves que chocan siguen al siguiente nivel
+    mph_header H;
+    memset(&H, 0, sizeof(H));
+    H.magic = MPH_MAGIC;
+    H.seed = HT->seed;
+    H.count = n;
+    uint64_t *words = NULL;
+    size_t left = n;
+    while(left > 0 && H.levels < MPH_MAX_LEVELS){
+        uint64_t size = (uint64_t)(MPH_GAMMA*left);
+        size = ((size + MPH_BLOCK - 1)/MPH_BLOCK)*MPH_BLOCK;
+        if(size == 0)
+            size = MPH_BLOCK;
+        uint64_t *seen = (uint64_t*)realloc(words, (H.bits + 2*size)/8);
+        if(seen == NULL){
+            fprintf(stderr, "Cannot allocate memory for frozen table.\n");
+            exit(1);
+        }
+        words = seen;
+        seen = words + H.bits/64;
+        uint64_t *collided = seen + size/64;
+        memset(seen, 0, 2*size/8);
+        for(size_t k=0; k<left; k++){
+            uint64_t pos = mphPosition(hashes[pending[k]], H.levels, size);
+            if(seen[pos/64] & (1ULL << (pos % 64)))
+                collided[pos/64] |= 1ULL << (pos % 64);
+            seen[pos/64] |= 1ULL << (pos % 64);
+        }
+        //Se quedan encendidos los bits de una sola llave; las demás pasan al siguiente nivel
+        size_t next = 0;
+        for(size_t k=0; k<left; k++){
+            uint64_t pos = mphPosition(hashes[pending[k]], H.levels, size);
+            if(collided[pos/64] & (1ULL << (pos % 64)))
+                pending[next++] = pending[k];
+            else
+                where[pending[k]] = H.bits + pos;
+        }
+        for(uint64_t w=0; w<size/64; w++)
+            seen[w] &= ~collided[w];
+        H.level_start[H.levels] = H.bits;
+        H.bits += size;
+        H.levels++;
+        left = next;
+    }
+    H.level_start[H.levels] = H.bits;
+    H.fallback = left;
+    H.arena_bytes = arena_bytes;
+    H.total_bytes = mphBlockSize(H.bits, H.fallback, H.count, H.arena_bytes);
+    //Se arma el bloque: encabezado, bits y conteos acumulados
+    void *block = allocTableArray(H.total_bytes);
+    if(block == NULL){
+        fprintf(stderr, "Cannot allocate memory for frozen table.\n");
+        exit(1);
+    }
+    memcpy(block, &H, sizeof(H));
+    HTable_OAF *F = (HTable_OAF*)memMalloc(MEM_TABLE, sizeof(HTable_OAF));
+    if(F == NULL){
+        fprintf(stderr, "Cannot allocate memory for frozen table.\n");
+        exit(1);
+    }
+    mphAttach(F, block, H.total_bytes, NO);
+    if(H.bits > 0)
+        memcpy(F->words, words, H.bits/8);
+    free(words);
+    uint64_t rank = 0;
+    for(uint64_t b=0; b<H.bits/MPH_BLOCK; b++){
+        F->ranks[b] = rank;
+        for(uint64_t w=0; w<MPH_BLOCK/64; w++)
+            rank += __builtin_popcountll(F->words[b*(MPH_BLOCK/64) + w]);
+    }
+    //Cada llave va al lugar de su número (las que quedaron aparte, al final y en el orden de "fallback")
+    uint64_t *slot = (uint64_t*)pending;         //Ya no se usa: aquí queda el número de cada llave
+    size_t apart = 0;
+    for(size_t k=0; k<n; k++){
+        if(where[k] == MPH_NONE){
+            F->fallback[apart] = hashes[k];
+            slot[k] = rank + apart;
+            apart++;
+        }
+        else
+            slot[k] = mphRank(F, where[k]);
+    }
+    //Primero la longitud de cada lugar y después los inicios acumulados; al final se copia el contenido
+    for(size_t k=0; k<n; k++)
+        F->offsets[slot[k] + 1] = recs[k].len;
+    F->offsets[0] = 0;
+    for(size_t i=0; i<n; i++)
+        F->offsets[i+1] += F->offsets[i];
+    for(size_t k=0; k<n; k++)
+        memcpy(F->arena + F->offsets[slot[k]], recs[k].bytes, recs[k].len);
+    free(recs);
+    free(hashes);
+    free(where);
+    free(pending);
+    return F;
+}
+
+/*Función para liberar una tabla congelada (o quitar el mapeo de su archivo)*/
+void freeHTable_OAF(HTable_OAF *F){
+    if(F->mapped){
+        memSub(MEM_TABLE, F->bytes, F->bytes);
+        munmap(F->header, F->bytes);
+    }
+    else
+        freeTableArray(F->header, F->bytes);
+    memFree(MEM_TABLE, F, sizeof(HTable_OAF));
+}
+
+/*Función para buscar un record en la tabla congelada. Regresa YES si está*/
+int HTfindRecord_OAF(HTable_OAF *F, record *rec){
+    uint64_t h = seededHash64(F->header->seed, (unsigned char*)rec->bytes, rec->len);
+    uint64_t slot = mphSlot(F, h);
+    if(slot == MPH_NONE){
+        //Puede ser de las que quedaron aparte (casi nunca hay)
+        uint64_t first = F->header->count - F->header->fallback;
+        for(uint64_t i=0; i<F->header->fallback; i++){
+            if(F->fallback[i] != h)
+                continue;
+            uint64_t len = F->offsets[first+i+1] - F->offsets[first+i];
+            if(len == rec->len && compareBytes(F->arena + F->offsets[first+i], rec->bytes, len)==YES)
+                return YES;
+        }
+        return NO;
+    }
+    uint64_t len = F->offsets[slot+1] - F->offsets[slot];
+    if(len != rec->len)
+        return NO;
+    return compareBytes(F->arena + F->offsets[slot], rec->bytes, len);
+}
+
+/*Función para regresar a una tabla de open addressing con el sondeo "mode" (con la misma semilla)*/
+HTable_OA* thawHTable_OAF(HTable_OAF *F, size_t mode){
+    HTable_OA *HT = newHTable_OA();
+    HT->seed = F->header->seed;
+    for(uint64_t i=0; i<F->header->count; i++){
+        record rec;
+        rec.bytes = F->arena + F->offsets[i];
+        rec.len = F->offsets[i+1] - F->offsets[i];
+        HTinsertRecord_OA(&HT, &rec, mode);
+    }
+    return HT;
+}
+
+/*Función para imprimir la tabla congelada (cada llave en su número)*/
+void HTprint_OAF(HTable_OAF *F){
+    for(uint64_t i=0; i<F->header->count; i++){
+        printf("%lu ", (unsigned long)i);
+        fwrite(F->arena + F->offsets[i], 1, F->offsets[i+1] - F->offsets[i], stdout);
+        printf("\n");
+    }
+}
+
+/*Función para imprimir el tamaño de la tabla congelada*/
+void HTstats_OAF(HTable_OAF *F){
+    mph_header *H = F->header;
+    printf("Congelada: %lu llaves, %lu niveles (%lu aparte), %.2f bits por llave en la función, arena %lu bytes, total %zu bytes%s\n",
+           (unsigned long)H->count, (unsigned long)H->levels, (unsigned long)H->fallback,
+           (H->count > 0) ? (double)(H->bits + (H->bits/MPH_BLOCK)*64)/H->count : 0.0, (unsigned long)H->arena_bytes, F->bytes,
+           F->mapped ? " (mapeada)" : "");
+}
+
+/*Función para escribir el bloque de la tabla congelada a un archivo. Regresa NO si no se pudo*/
+int writeHTable_OAF(HTable_OAF *F, const char *path){
+    FILE *file = fopen(path, "wb");
+    if(file == NULL){
+        fprintf(stderr, "Cannot open %s\n", path);
+        return NO;
+    }
+    size_t written = fwrite(F->header, 1, F->bytes, file);
+    if(fclose(file) != 0 || written != F->bytes){
+        fprintf(stderr, "Cannot write %s\n", path);
+        return NO;
+    }
+    return YES;
+}
+
+/*Función para usar una tabla congelada desde un archivo (mapeado de sólo lectura; las páginas se leen conforme se consultan).
+//...Regresa NULL si el archivo no es una tabla congelada válida*/
+HTable_OAF* openHTable_OAF(const char *path){
+    int fd = open(path, O_RDONLY);
+    if(fd < 0){
+        fprintf(stderr, "Cannot open %s\n", path);
+        return NULL;
+    }
+    struct stat st;
+    if(fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(mph_header)){
+        fprintf(stderr, "Not a frozen table: %s\n", path);
+        close(fd);
+        return NULL;
+    }
+    size_t bytes = (size_t)st.st_size;
+    void *block = mmap(NULL, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(block == MAP_FAILED){
+        fprintf(stderr, "Cannot map %s\n", path);
+        return NULL;
+    }
+    //Se revisa que el encabezado cuadre con el tamaño del archivo antes de usar cualquier apuntador
+    mph_header *H = (mph_header*)block;
+    int valid = (H->magic == MPH_MAGIC && H->levels <= MPH_MAX_LEVELS && H->bits % MPH_BLOCK == 0 && H->fallback <= H->count &&
+                 H->count < bytes && H->bits/8 < bytes && H->arena_bytes < bytes && H->total_bytes == bytes &&
+                 mphBlockSize(H->bits, H->fallback, H->count, H->arena_bytes) == bytes && H->level_start[H->levels] == H->bits);
+    for(uint64_t level=0; valid && level<H->levels; level++)
+        valid = (H->level_start[level] < H->level_start[level+1]);
+    HTable_OAF *F = NULL;
+    if(valid){
+        F = (HTable_OAF*)memMalloc(MEM_TABLE, sizeof(HTable_OAF));
+        if(F == NULL){
+            fprintf(stderr, "Cannot allocate memory for frozen table.\n");
+            exit(1);
+        }
+        mphAttach(F, block, bytes, YES);
+        valid = (F->offsets[0] == 0 && F->offsets[H->count] == H->arena_bytes);
+        for(uint64_t i=0; valid && i<H->count; i++)
+            valid = (F->offsets[i] <= F->offsets[i+1]);
+        //Los conteos acumulados deben cuadrar con los bits (así ningún número se sale de la arena)
+        uint64_t rank = 0;
+        for(uint64_t b=0; valid && b<H->bits/MPH_BLOCK; b++){
+            valid = (F->ranks[b] == rank);
+            for(uint64_t w=0; w<MPH_BLOCK/64; w++)
+                rank += __builtin_popcountll(F->words[b*(MPH_BLOCK/64) + w]);
+        }
+        valid = valid && (rank == H->count - H->fallback);
+        if(!valid)
+            memFree(MEM_TABLE, F, sizeof(HTable_OAF));
+    }
+    if(!valid){
+        fprintf(stderr, "Not a frozen table: %s\n", path);
+        munmap(block, bytes);
+        return NULL;
+    }
+    //Las consultas tocan lugares al azar: no sirve que el kernel lea de más alrededor de cada una
+    madvise(block, bytes, MADV_RANDOM);
+    memAdd(MEM_TABLE, bytes, bytes);
+    return F;
+}
+
+/*Función para leer la opción "frozen=archivo" (empezar con una tabla congelada desde un archivo). Regresa YES si era ésa*/
+int parseFrozenOption(const char **path, const char *arg){
+    if(strncmp(arg, "frozen=", 7)!=0)
+        return NO;
+    *path = arg + 7;
+    return YES;
+}
+
+/*Función para saber si un comando es de la tabla congelada*/
+int isFreezeCommand(const char *command){
+    return (strcmp("freeze", command)==0 || strcmp("thaw", command)==0);
+}
+
+/*Función para atender los comandos con la tabla congelada: "freeze [archivo]" congela "HT" (y la deja vacía), "thaw" la regresa a open
+//...addressing y, mientras está congelada, "find", "count" y "print" se contestan con ella y lo que modifica se rechaza. Regresa NO si el
+//...comando lo debe atender la tabla normal*/
+int frozenCommandOA(HTable_OAF **F, HTable_OA **HT, char *command, char *number, size_t mode){
+    if(strcmp("freeze", command)==0){
+        if(*F == NULL){
+            struct timespec start, end;
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            *F = freezeHTable_OA(*HT);
+            clock_gettime(CLOCK_MONOTONIC, &end);
+            freeHTable_OA(*HT);
+            *HT = newHTable_OA();
+            printf("Congelar: %.3f ms\n", (end.tv_sec - start.tv_sec)*1e3 + (end.tv_nsec - start.tv_nsec)/1e6);
+        }
+        //"freeze archivo" también escribe el bloque (se puede pedir de nuevo con la tabla ya congelada)
+        if(number[0] != ' ' && number[0] != '\0')
+            writeHTable_OAF(*F, number);
+        HTstats_OAF(*F);
+        return YES;
+    }
+    if(*F == NULL)
+        return (strcmp("thaw", command)==0);
+    if(strcmp("thaw", command)==0){
+        freeHTable_OA(*HT);
+        *HT = thawHTable_OAF(*F, mode);
+        freeHTable_OAF(*F);
+        *F = NULL;
+        return YES;
+    }
+    if(strcmp("find", command)==0){
+        record rec;
+        rec.bytes = number;
+        rec.len = strlen(number);
+        if(HTfindRecord_OAF(*F, &rec)==YES)
+            printf("Encontrado: %s\n", number);
+        else
+            printf("No encontrado: %s\n", number);
+        return YES;
+    }
+    if(strcmp("count", command)==0){
+        printf("Elementos ocupados: %lu\n", (unsigned long)(*F)->header->count);
+        return YES;
+    }
+    if(strcmp("print", command)==0){
+        HTprint_OAF(*F);
+        return YES;
+    }
+    if(strcmp("insert", command)==0 || strcmp("delete", command)==0 || strcmp("load", command)==0 || setOperationCode(command) != 0 ||
+       isAggCommand(command)){
+        fprintf(stderr, "The table is frozen (use thaw to modify it)\n");
+        return YES;
+    }
+    return NO;
+}
+
+/*............................................LLAVES ENTERAS..............................................................................*/
+/*Cuando las llaves son números, no hace falta guardar records ni calcular adler32 sobre su texto: la llave misma (uint32_t o uint64_t)
+//...se guarda en el arreglo, se mezcla con una función de enteros y no se reserva memoria por elemento. En vez de bytes de estado, dos
+//...valores de la llave marcan la casilla vacía y la borrada (si alguien inserta justo esos valores, se guardan aparte en banderas).
+//...Las tablas se generan con una macro para cada ancho de llave y cada sondeo: la función de mezcla y la del sondeo se le pasan a la macro
+//...(son "políticas" fijas al compilar), así que quedan en línea dentro del ciclo de sondeo y no se arrastra "mode" por cada llamada*/
+#define NOT_FOUND ((size_t)-1)
+
+/*Estructura con las operaciones de una tabla de llaves enteras ya generada (para elegirla una vez con "mode" y el ancho de llave)*/
+typedef struct{
+    void* (*create)();
+    void (*destroy)(void *HT);
+    int (*insert)(void **HT, uint64_t key);
+    int (*remove)(void **HT, uint64_t key);
+    int (*find)(void *HT, uint64_t key);
+    void (*forEach)(void *HT, void (*fn)(uint64_t key, void *ctx), void *ctx);
+    void (*print)(void *HT);
+    size_t (*count)(void *HT);
+    uint64_t max_key;           //Llave más grande que cabe
+}int_table_ops;
+
+/*Macro que genera la tabla de llaves enteras "HTable_OA<S>" con llaves del tipo KEY_T mezcladas con MIX (con la semilla de la tabla) y
+//...sondeo PROBE*/
+#define DEFINE_HTABLE_OA_INT(S, KEY_T, MIX, PROBE)                                                                                           \
+typedef struct{                                                                                                                         \
+    KEY_T *keys;                /*Arreglo de llaves (EMPTY_##S = casilla vacía, DELETED_##S = casilla borrada)*/                       \
+    size_t index_size;          /*Índice del tipo de capacidad*/                                                                        \
+    size_t size;                /*Tamaño del arreglo*/                                                                                  \
+    size_t occupied_elements;   /*Cantidad de elementos ocupados (incluye los de las banderas)*/                                        \
+    size_t deleted_elements;    /*Casillas borradas (el sondeo debe seguir en ellas)*/                                                  \
+    char has_empty;             /*YES si la llave EMPTY_##S está en la tabla*/                                                          \
+    char has_deleted;           /*YES si la llave DELETED_##S está en la tabla*/                                                        \
+    uint64_t seed;              /*Semilla con la que se mezclan las llaves*/                                                            \
+    int sip;                    /*YES si ya se resembró y las llaves pasan por SipHash*/                                                \
+    size_t reseed_floor;        /*No se vuelve a resembrar hasta tener al menos estos elementos*/                                       \
+    int flooded;                /*YES si la última inserción tuvo un recorrido anormalmente largo*/                                     \
+}HTable_OA##S;                                                                                                                          \
+                                                                                                                                        \
+static const KEY_T EMPTY_##S = (KEY_T)-1;                                                                                               \
+static const KEY_T DELETED_##S = (KEY_T)-2;                                                                                             \
+                                                                                                                                        \
+/*Función para hacer una nueva tabla de llaves enteras*/                                                                                \
+HTable_OA##S* newHTableCap_OA##S(size_t index){                                                                                         \
+    HTable_OA##S *HT = (HTable_OA##S*)memMalloc(MEM_TABLE, sizeof(HTable_OA##S)*1);                                                     \
+    if(HT == NULL){                                                                                                                     \
+        fprintf(stderr, "Cannot allocate memory for table.");                                                                           \
+        exit(1);                                                                                                                        \
+    }                                                                                                                                   \
+    HT->keys = (KEY_T*)allocTableArray(HASH_SIZE[index]*sizeof(KEY_T));                                                                 \
+    if(HT->keys == NULL){                                                                                                               \
+        fprintf(stderr, "Cannot allocate memory for table.");                                                                           \
+        exit(1);                                                                                                                        \
+    }                                                                                                                                   \
+    memset(HT->keys, 0xFF, HASH_SIZE[index]*sizeof(KEY_T));       /*Todas las casillas empiezan como EMPTY_##S*/                        \
+    HT->size = HASH_SIZE[index];                                                                                                        \
+    HT->index_size = index;                                                                                                             \
+    HT->occupied_elements = 0;                                                                                                          \
+    HT->deleted_elements = 0;                                                                                                           \
+    HT->has_empty = NO;                                                                                                                 \
+    HT->has_deleted = NO;                                                                                                               \
+    HT->seed = tableSeed();                                                                                                             \
+    HT->sip = NO;                                                                                                                       \
+    HT->reseed_floor = 0;                                                                                                               \
+    HT->flooded = NO;                                                                                                                   \
+    return HT;                                                                                                                          \
+}                                                                                                                                       \
+                                                                                                                                        \
+HTable_OA##S* newHTable_OA##S(){                                                                                                        \
+    return newHTableCap_OA##S(0);                                                                                                       \
+}                                                                                                                                       \
+                                                                                                                                        \
+void freeHTable_OA##S(HTable_OA##S *HT){                                                                                                \
+    freeTableArray(HT->keys, HT->size*sizeof(KEY_T));                                                                                   \
+    memFree(MEM_TABLE, HT, sizeof(HTable_OA##S));                                                                                       \
+}                                                                                                                                       \
+                                                                                                                                        \
+/*Función para buscar la casilla de una llave (que no sea EMPTY_##S ni DELETED_##S). Regresa NOT_FOUND si no está*/                     \
+size_t locateKey_OA##S(HTable_OA##S *HT, KEY_T key){                                                                          \
+    uint64_t hash = MIX(HT->seed, HT->sip, key);                                                                                        \
+    size_t index = hash % HT->size;                                                                                                     \
+    size_t i = 0;                                                                                                                       \
+    while(HT->keys[index] != EMPTY_##S){                                                                                                \
+        if(HT->keys[index] == key)                                                                                                      \
+            return index;                                                                                                               \
+        i++;                                                                                                                            \
+        index = PROBE(index, i, hash, HT->size, HT->index_size);                                                                        \
+    }                                                                                                                                   \
+    return NOT_FOUND;                                                                                                                   \
+}                                                                                                                                       \
+                                                                                                                                        \
+/*Función para colocar una llave que no está en la tabla (sin revisar el tamaño; marca la tabla si el sondeo fue muy largo)*/           \
+void placeKey_OA##S(HTable_OA##S *HT, KEY_T key){                                                                             \
+    uint64_t hash = MIX(HT->seed, HT->sip, key);                                                                                        \
+    size_t index = hash % HT->size;                                                                                                     \
+    size_t i = 0;                                                                                                                       \
+    while(HT->keys[index] != EMPTY_##S && HT->keys[index] != DELETED_##S){                                                              \
+        i++;                                                                                                                            \
+        index = PROBE(index, i, hash, HT->size, HT->index_size);                                                                        \
+    }                                                                                                                                   \
+    if(i > floodLimit(HT->size))                                                                                                        \
+        HT->flooded = YES;                                                                                                              \
+    if(HT->keys[index] == DELETED_##S)                                                                                                  \
+        HT->deleted_elements--;                                                                                                         \
+    HT->keys[index] = key;                                                                                                              \
+    HT->occupied_elements++;                                                                                                            \
+}                                                                                                                                       \
+                                                                                                                                        \
+/*Función para expandir, reducir, sólo limpiar de borrados (COMPACT) o resembrar (RESEED) la tabla*/                                    \
+HTable_OA##S* RemodelHTableCap_OA##S(HTable_OA##S *PreviousHT, int state){                                                    \
+    size_t newIndex = PreviousHT->index_size;                                                                                           \
+    if(state==FULL)                                                                                                                     \
+        newIndex+=1;                                                                                                                    \
+    if(state==EMPTY)                                                                                                                    \
+        newIndex-=1;                                                                                                                    \
+    assert(state!=0);                                                                                                                   \
+    size_t mark = memRemodelBegin();                                                                                                    \
+    HTable_OA##S *HT = newHTableCap_OA##S(newIndex);                                                                                    \
+    HT->seed = PreviousHT->seed;                                                                                                        \
+    HT->sip = PreviousHT->sip;                                                                                                          \
+    HT->reseed_floor = PreviousHT->reseed_floor;                                                                                        \
+    if(state==RESEED){                                  /*Otra semilla, y desde ahora con SipHash*/                                     \
+        HT->seed = randomSeed();                                                                                                        \
+        HT->sip = YES;                                                                                                                  \
+        HT->reseed_floor = 2*PreviousHT->occupied_elements;                                                                             \
+        __atomic_add_fetch(&flood_reseeds, 1, __ATOMIC_RELAXED);                                                                        \
+    }                                                                                                                                   \
+    for(size_t i=0; i<PreviousHT->size; i++){                                                                                           \
+        KEY_T key = PreviousHT->keys[i];                                                                                                \
+        if(key != EMPTY_##S && key != DELETED_##S)                                                                                      \
+            placeKey_OA##S(HT, key);                                                                                                    \
+    }                                                                                                                                   \
+    HT->has_empty = PreviousHT->has_empty;                                                                                              \
+    HT->has_deleted = PreviousHT->has_deleted;                                                                                          \
+    HT->occupied_elements += HT->has_empty + HT->has_deleted;                                                                           \
+    freeHTable_OA##S(PreviousHT);                                                                                                       \
+    memRemodelEnd(mark);                                                                                                                \
+    return HT;                                                                                                                          \
+}                                                                                                                                       \
+                                                                                                                                        \
+/*Función para evaluar si la tabla está llena o vacía (los borrados cuentan para la carga, como en la tabla empaquetada)*/              \
+int checkSizeOA##S(HTable_OA##S *HT, int operation){                                                                                    \
+    if((HT->occupied_elements + HT->deleted_elements + 1 > (HT->size/2))&&(operation==UP)){                                             \
+        if(HT->deleted_elements > HT->occupied_elements)                                                                                \
+            return COMPACT;                                                                                                             \
+        return FULL;                                                                                                                    \
+    }                                                                                                                                   \
+    if((HT->occupied_elements<(HT->size/10 +(hist*hist)))&&(operation==DOWN)&&(HT->index_size>0)){                                      \
+        hist++;                                                                                                                         \
+        return EMPTY;                                                                                                                   \
+    }                                                                                                                                   \
+    return 0;                                                                                                                           \
+}                                                                                                                                       \
+                                                                                                                                        \
+/*Función para buscar una llave. Regresa YES o NO*/                                                                                     \
+int HTfindKey_OA##S(HTable_OA##S *HT, KEY_T key){                                                                             \
+    if(key == EMPTY_##S)                                                                                                                \
+        return HT->has_empty;                                                                                                           \
+    if(key == DELETED_##S)                                                                                                              \
+        return HT->has_deleted;                                                                                                         \
+    return (locateKey_OA##S(HT, key) != NOT_FOUND) ? YES : NO;                                                                    \
+}                                                                                                                                       \
+                                                                                                                                        \
+/*Función para insertar una llave. Regresa YES si no estaba*/                                                                           \
+int HTinsertKey_OA##S(HTable_OA##S **HT, KEY_T key){                                                                          \
+    if(HTfindKey_OA##S(*HT, key) == YES)                                                                                          \
+        return NO;                                                                                                                      \
+    if(key == EMPTY_##S || key == DELETED_##S){                                                                                         \
+        if(key == EMPTY_##S)                                                                                                            \
+            (*HT)->has_empty = YES;                                                                                                     \
+        else                                                                                                                            \
+            (*HT)->has_deleted = YES;                                                                                                   \
+        (*HT)->occupied_elements++;                                                                                                     \
+        return YES;                                                                                                                     \
+    }                                                                                                                                   \
+    int state = checkSizeOA##S(*HT, UP);                                                                                                \
+    if(state != 0)                                                                                                                      \
+        (*HT) = RemodelHTableCap_OA##S(*HT, state);                                                                               \
+    placeKey_OA##S(*HT, key);                                                                                                     \
+    if(floodReseedDue(&(*HT)->flooded, (*HT)->occupied_elements, (*HT)->reseed_floor))                                                  \
+        (*HT) = RemodelHTableCap_OA##S(*HT, RESEED);                                                                                    \
+    return YES;                                                                                                                         \
+}                                                                                                                                       \
+                                                                                                                                        \
+/*Función para borrar una llave. Regresa YES si estaba*/                                                                                \
+int HTdeleteKey_OA##S(HTable_OA##S **HT, KEY_T key){                                                                          \
+    if(key == EMPTY_##S || key == DELETED_##S){                                                                                         \
+        char *flag = (key == EMPTY_##S) ? &(*HT)->has_empty : &(*HT)->has_deleted;                                                      \
+        if(*flag == NO)                                                                                                                 \
+            return NO;                                                                                                                  \
+        *flag = NO;                                                                                                                     \
+        (*HT)->occupied_elements--;                                                                                                     \
+        return YES;                                                                                                                     \
+    }                                                                                                                                   \
+    size_t index = locateKey_OA##S(*HT, key);                                                                                     \
+    if(index == NOT_FOUND)                                                                                                              \
+        return NO;                                                                                                                      \
+    (*HT)->keys[index] = DELETED_##S;                                                                                                   \
+    (*HT)->occupied_elements--;                                                                                                         \
+    (*HT)->deleted_elements++;                                                                                                          \
+    if(checkSizeOA##S(*HT, DOWN)==EMPTY)                                                                                                \
+        (*HT) = RemodelHTableCap_OA##S(*HT, EMPTY);                                                                               \
+    return YES;                                                                                                                         \
+}                                                                                                                                       \
+                                                                                                                                        \
+/*Función para recorrer todas las llaves (sirve para pasarlas a otra tabla)*/                                                           \
+void HTforEachKey_OA##S(HTable_OA##S *HT, void (*fn)(uint64_t key, void *ctx), void *ctx){                                              \
+    for(size_t i=0; i<HT->size; i++){                                                                                                   \
+        if(HT->keys[i] != EMPTY_##S && HT->keys[i] != DELETED_##S)                                                                      \
+            fn((uint64_t)HT->keys[i], ctx);                                                                                             \
+    }                                                                                                                                   \
+    if(HT->has_empty)                                                                                                                   \
+        fn((uint64_t)EMPTY_##S, ctx);                                                                                                   \
+    if(HT->has_deleted)                                                                                                                 \
+        fn((uint64_t)DELETED_##S, ctx);                                                                                                 \
+}                                                                                                                                       \
+                                                                                                                                        \
+/*Función para imprimir la tabla (cada llave con su mezcla entre corchetes, como la llave adler de los records)*/                        \
+void HTprint_OA##S(HTable_OA##S *HT){                                                                                                   \
+    for(size_t i=0; i<HT->size; i++){                                                                                                   \
+        printf("%ld ", i);                                                                                                              \
+        if(HT->keys[i] != EMPTY_##S && HT->keys[i] != DELETED_##S)                                                                      \
+            printf("%llu[%llu] ", (unsigned long long)HT->keys[i], (unsigned long long)MIX(HT->seed, HT->sip, HT->keys[i]));                                \
+        printf("\n");                                                                                                                   \
+    }                                                                                                                                   \
+    if(HT->has_empty || HT->has_deleted){                                                                                               \
+        printf("especiales ");                                                                                                          \
+        if(HT->has_empty)                                                                                                               \
+            printf("%llu[%llu] ", (unsigned long long)EMPTY_##S, (unsigned long long)MIX(HT->seed, HT->sip, EMPTY_##S));                                    \
+        if(HT->has_deleted)                                                                                                             \
+            printf("%llu[%llu] ", (unsigned long long)DELETED_##S, (unsigned long long)MIX(HT->seed, HT->sip, DELETED_##S));                                \
+        printf("\n");                                                                                                                   \
+    }                                                                                                                                   \
+}                                                                                                                                       \
+                                                                                                                                        \
+/*Operaciones de esta tabla para int_table_ops (sólo convierten los tipos; la tabla misma no sabe de ellas)*/                           \
+static void* opCreate_OA##S(){ return newHTable_OA##S(); }                                                                              \
+static void opDestroy_OA##S(void *HT){ freeHTable_OA##S((HTable_OA##S*)HT); }                                                           \
+static int opInsert_OA##S(void **HT, uint64_t key){ return HTinsertKey_OA##S((HTable_OA##S**)HT, (KEY_T)key); }                         \
+static int opRemove_OA##S(void **HT, uint64_t key){ return HTdeleteKey_OA##S((HTable_OA##S**)HT, (KEY_T)key); }                         \
+static int opFind_OA##S(void *HT, uint64_t key){ return HTfindKey_OA##S((HTable_OA##S*)HT, (KEY_T)key); }                               \
+static void opForEach_OA##S(void *HT, void (*fn)(uint64_t key, void *ctx), void *ctx){ HTforEachKey_OA##S((HTable_OA##S*)HT, fn, ctx); }\
+static void opPrint_OA##S(void *HT){ HTprint_OA##S((HTable_OA##S*)HT); }                                                                \
+static size_t opCount_OA##S(void *HT){ return ((HTable_OA##S*)HT)->occupied_elements; }                                                 \
+const int_table_ops INT_OPS_OA##S = {opCreate_OA##S, opDestroy_OA##S, opInsert_OA##S, opRemove_OA##S, opFind_OA##S,                     \
+                                     opForEach_OA##S, opPrint_OA##S, opCount_OA##S, (KEY_T)-1};
+
+DEFINE_HTABLE_OA_INT(32LP, uint32_t, seededMix32, probeLP)
+DEFINE_HTABLE_OA_INT(32QP, uint32_t, seededMix32, probeQP)
+DEFINE_HTABLE_OA_INT(32DH, uint32_t, seededMix32, probeDH)
+DEFINE_HTABLE_OA_INT(64LP, uint64_t, seededMix64, probeLP)
+DEFINE_HTABLE_OA_INT(64QP, uint64_t, seededMix64, probeQP)
+DEFINE_HTABLE_OA_INT(64DH, uint64_t, seededMix64, probeDH)
+
+/*Tablas generadas según el ancho de llave ([0] = 32 bits, [1] = 64 bits) y el modo (LP, QP o DH)*/
+const int_table_ops *INT_OPS_OA[2][4] = {
+    {NULL, &INT_OPS_OA32LP, &INT_OPS_OA32QP, &INT_OPS_OA32DH},
+    {NULL, &INT_OPS_OA64LP, &INT_OPS_OA64QP, &INT_OPS_OA64DH}
+};
+
+/*Estructura de una tabla de llaves enteras junto con sus operaciones*/
+typedef struct{
+    const int_table_ops *ops;   //NULL si ya se pasó todo a la tabla de records
+    void *HT;
+}int_table;
+
+/*Estructura con la tabla de llaves enteras que usa el programa mientras todas las llaves sean números*/
+typedef struct{
+    int_table table;            //Tabla actual (empieza con llaves de 32 bits)
+    const int_table_ops *wide;  //Operaciones de la tabla de 64 bits con el mismo sondeo
+    int mode;                   //Tipo de sondeo (para pasar las llaves a la tabla de records)
+}int_tables_OA;
+
+/*Funciones para pasar una llave de una tabla entera a otra más ancha o a la tabla de records*/
+void moveKeyToIntTable(uint64_t key, void *ctx){
+    int_table *T = (int_table*)ctx;
+    T->ops->insert(&T->HT, key);
+}
+typedef struct{
+    HTable_OA **HT;
+    int mode;
+}move_ctx_OA;
+void moveKeyToOA(uint64_t key, void *ctx){
+    move_ctx_OA *move = (move_ctx_OA*)ctx;
+    char number[21];
+    record rec;
+    rec.bytes = number;
+    rec.len = (size_t)sprintf(number, "%llu", (unsigned long long)key);
+    HTinsertRecord_OA(move->HT, &rec, move->mode);
+}
+
+/*Función para empezar con la tabla de llaves de 32 bits (el sondeo se elige aquí una sola vez)*/
+void initIntTablesOA(int_tables_OA *IT, int mode){
+    IT->mode = mode;
+    IT->table.ops = INT_OPS_OA[0][mode];
+    IT->table.HT = IT->table.ops->create();
+    IT->wide = INT_OPS_OA[1][mode];
+}
+
+/*Función para liberar la tabla entera (si todavía se usa)*/
+void freeIntTablesOA(int_tables_OA *IT){
+    if(IT->table.ops != NULL)
+        IT->table.ops->destroy(IT->table.HT);
+    IT->table.ops = NULL;
+    IT->table.HT = NULL;
+}
+
+/*Función para atender un comando con las tablas enteras. Regresa NO si el comando lo debe atender la tabla de records "HT"*/
+/*NOTA: la primera inserción de algo que no es número (o la primera operación de conjuntos, de agregación o "freeze") pasa todo a la
+//...tabla de records; una llave de más de 32 bits pasa a la de 64*/
+int intCommandOA(int_tables_OA *IT, HTable_OA **HT, char *command, char *number){
+    int_table *T = &IT->table;
+    if(T->ops == NULL)
+        return NO;
+    //Las operaciones de conjuntos, las de agregación, las de congelar y las de lotes son sobre la tabla de records, así que antes se pasan
+    //...ahí todas las llaves
+    if(setOperationCode(command) != 0 || isAggCommand(command) || isFreezeCommand(command) || isBatchCommand(command)){
+        move_ctx_OA move = {HT, IT->mode};
+        T->ops->forEach(T->HT, moveKeyToOA, &move);
+        freeIntTablesOA(IT);
+        return NO;
+    }
+    int insert = (strcmp("insert", command)==0);
+    if(insert || strcmp("delete", command)==0){
+        uint64_t key;
+        if(parseIntKey(number, &key)==NO){
+            if(!insert)
+                return YES;             //Lo que no es número no puede estar en las tablas enteras
+            move_ctx_OA move = {HT, IT->mode};
+            T->ops->forEach(T->HT, moveKeyToOA, &move);
+            freeIntTablesOA(IT);
+            return NO;
+        }
+        if(key > T->ops->max_key){
+            if(!insert)
+                return YES;
+            int_table wide = {IT->wide, IT->wide->create()};
+            T->ops->forEach(T->HT, moveKeyToIntTable, &wide);
+            T->ops->destroy(T->HT);
+            *T = wide;
+        }
+        if(insert)
+            T->ops->insert(&T->HT, key);
+        else
+            T->ops->remove(&T->HT, key);
+        return YES;
+    }
+    if(strcmp("find", command)==0){
+        //Lo que no es número (o no cabe en la tabla actual) no puede estar en las tablas enteras
+        uint64_t key;
+        if(parseIntKey(number, &key)==YES && key <= T->ops->max_key && T->ops->find(T->HT, key)==YES)
+            printf("Encontrado: %s\n", number);
+        else
+            printf("No encontrado: %s\n", number);
+        return YES;
+    }
+    if(strcmp("print", command)==0){
+        T->ops->print(T->HT);
+        return YES;
+    }
+    if(strcmp("count", command)==0){
+        printf("Elementos ocupados: %ld\n", T->ops->count(T->HT));
+        return YES;
+    }
+    return NO;
+}
+
+/*...............................................TRAZAS..................................................................................*/
+/*La grabación y la repetición de trazas están en ht_common.c; aquí sólo van los motores de cada tabla*/
+
+/*Motores de la repetición: LP, QP, DH y HS comparten la tabla HTable_OA (con el modo); la compacta y la empaquetada tienen la suya*/
+void* replayCreate_OA(size_t mode){
+    (void)mode;
+    return newHTable_OA();
+}
+void replayDestroy_OA(void *HT){
+    freeHTable_OA((HTable_OA*)HT);
+}
+void replayInsert_OA(void **HT, record *rec, size_t mode){
+    HTinsertRecord_OA((HTable_OA**)HT, rec, mode);
+}
+void replayDelete_OA(void **HT, record *rec, size_t mode){
+    HTdeleteRecordOA((HTable_OA**)HT, rec, mode);
+}
+void replayFind_OA(void **HT, record *rec, size_t mode){
+    HTfindRecord_OA((HTable_OA**)HT, rec, mode);
+}
+size_t replayCount_OA(void *HT){
+    return ((HTable_OA*)HT)->occupied_elements;
+}
+const replay_engine REPLAY_OA = {replayCreate_OA, replayDestroy_OA, replayInsert_OA, replayDelete_OA, replayFind_OA, replayCount_OA};
+
+void* replayCreate_OAC(size_t mode){
+    (void)mode;
+    return newHTable_OAC();
+}
+void replayDestroy_OAC(void *HT){
+    freeHTable_OAC((HTable_OAC*)HT);
+}
+void replayInsert_OAC(void **HT, record *rec, size_t mode){
+    (void)mode;
+    HTinsertRecord_OAC((HTable_OAC*)*HT, rec);
+}
+void replayDelete_OAC(void **HT, record *rec, size_t mode){
+    (void)mode;
+    HTdeleteRecordOAC((HTable_OAC*)*HT, rec);
+}
+void replayFind_OAC(void **HT, record *rec, size_t mode){
+    (void)mode;
+    size_t pos;
+    HTfindRecord_OAC((HTable_OAC*)*HT, rec, &pos);
+}
+size_t replayCount_OAC(void *HT){
+    return ((HTable_OAC*)HT)->occupied_elements;
+}
+const replay_engine REPLAY_OAC = {replayCreate_OAC, replayDestroy_OAC, replayInsert_OAC, replayDelete_OAC, replayFind_OAC, replayCount_OAC};
+
+void* replayCreate_OAP(size_t mode){
+    (void)mode;
+    return newHTable_OAP();
+}
+void replayDestroy_OAP(void *HT){
+    freeHTable_OAP((HTable_OAP*)HT);
+}
+void replayInsert_OAP(void **HT, record *rec, size_t mode){
+    (void)mode;
+    HTinsertRecord_OAP((HTable_OAP**)HT, rec);
+}
+void replayDelete_OAP(void **HT, record *rec, size_t mode){
+    (void)mode;
+    HTdeleteRecordOAP((HTable_OAP**)HT, rec);
+}
+void replayFind_OAP(void **HT, record *rec, size_t mode){
+    (void)mode;
+    HTfindRecord_OAP((HTable_OAP*)*HT, rec);
+}
+size_t replayCount_OAP(void *HT){
+    return ((HTable_OAP*)HT)->occupied_elements;
+}
+const replay_engine REPLAY_OAP = {replayCreate_OAP, replayDestroy_OAP, replayInsert_OAP, replayDelete_OAP, replayFind_OAP, replayCount_OAP};
+
+/*...............................................VENCIMIENTO (TTL).........................................................................*/
+/*En modo TTL ("ttl=ms") los elementos pueden vencer: "insert llave [ms]" lo guarda con ese TTL (o con el de la opción; 0 = no vence) y si
+//...ya estaba sólo se le cambia el vencimiento. El vencimiento va en el lugar del acumulador (así Remodel lo conserva) y una rueda de
+//...tiempos jerárquica (4 niveles de 64 casillas, un tick por ms) lleva lo que va a vencer. Cada operación avanza la rueda y quita a lo
+//...más TTL_BUDGET vencidos (trabajo acotado); mientras tanto las búsquedas ya toman a los vencidos como ausentes. Los vencidos se quitan
+//...como los borrados (con lápida) pero la tabla se revisa una sola vez por tanda, así una ola de vencimientos no provoca un Remodel tras
+//...otro. "advance ms" adelanta el reloj del TTL (para probar sin esperar)*/
+
+/*Función para insertar un record con vencimiento ("ttl" en ns; 0 = no vence). Si ya estaba, sólo se le pone el nuevo vencimiento*/
+void HTinsertRecordTTL_OA(HTable_OA **HT, record *rec, size_t mode, timer_wheel *W, uint64_t ttl){
+    uint32_t key = keyOA(*HT, rec);
+    //Con delta 0 el upsert no cambia nada si ya estaba
+    hash_item *item = upsertKeyOA(HT, key, rec, 0, mode);
+    if(item == NULL)
+        return;
+    item->expires = (ttl != 0) ? ttlNow(W) + ttl : 0;
+    if(ttl != 0)
+        wheelSchedule(W, rec, item->expires);
+    checkFloodOA(HT, mode);
+}
+
+/*Función para buscar un record en modo TTL (los vencidos cuentan como ausentes aunque todavía no se quiten). Regresa YES si está*/
+int HTfindRecordTTL_OA(HTable_OA **HT, record *rec, size_t mode, timer_wheel *W){
+    hash_item *item = HTfindRecord_OA(HT, rec, mode);
+    if(item == NULL || ttlExpired(W, item->expires))
+        return NO;
+    return YES;
+}
+
+/*Función para avanzar la rueda y quitar de la tabla a lo más TTL_BUDGET vencidos. Un aviso sólo vale si el elemento sigue con ese mismo
+//...vencimiento (si se borró o se volvió a insertar, se descarta). El tamaño se revisa al final de la tanda, no con cada elemento*/
+void ttlTick_OA(HTable_OA **HT, size_t mode, timer_wheel *W){
+    wheelAdvance(W);
+    size_t removed = 0;
+    timer_node *node;
+    for(size_t n=0; n<TTL_BUDGET && (node = wheelPopDue(W)) != NULL; n++){
+        record rec;
+        rec.bytes = node->bytes;
+        rec.len = node->len;
+        hash_item *item = HTfindRecord_OA(HT, &rec, mode);
+        if(item != NULL && item->expires == node->deadline && removeRecordOA(HT, &rec, mode)==YES){
+            (*HT)->occupied_elements--;
+            removed++;
+        }
+        else
+            W->stale++;
+        freeTimerNode(node);
+    }
+    W->expired += removed;
+    if(removed > 0 && checkSizeOA(*HT, DOWN)==EMPTY && (*HT)->index_size>0)
+        (*HT)=RemodelHTableCap_OA(*HT, EMPTY, mode);
+}
+
+/*...............................................CICLO DE COMANDOS.........................................................................*/
+/*Operaciones de cada estrategia para el ciclo de comandos (runCommands). LP, QP, DH y HS (con o sin TTL) comparten "commands_OA"; la
+//...caché, la adaptativa y la compacta usan su propia tabla como "T"; la empaquetada y la compartida llevan además su lector o su nombre*/
+
+/*Estructura con lo que necesita el ciclo de LP, QP, DH y HS*/
+typedef struct{
+    HTable_OA *HT;
+    size_t mode;
+    int_tables_OA IT;           //Tablas de llaves enteras (IT.table.ops es NULL si no se usan)
+    resize_worker RW;           //Redimensión en segundo plano ("bg")
+    int background;
+    int agg;                    //YES con la opción "agg" (comandos de agregación; "insert" suma 1)
+    int threads;                //Hilos de las operaciones de conjuntos y de agregación
+    HTable_OA *other;           //Otra tabla (con el mismo sondeo) para las operaciones de conjuntos; se lee con "load archivo"
+    HTable_OAF *frozen;         //Tabla congelada (con "freeze" o desde "frozen=archivo"); mientras exista, contesta las consultas
+    timer_wheel W;              //Rueda del TTL (sólo con "ttl=ms")
+}commands_OA;
+
+/*Comandos propios de LP, QP, DH y HS: los de las tablas enteras, congelar, conjuntos, lotes y agregación*/
+int commandOA(void *T, char *buffer, char *command, char *number){
+    commands_OA *C = (commands_OA*)T;
+    if(intCommandOA(&C->IT, &C->HT, command, number)==YES)
+        return YES;
+    if(isFreezeCommand(command) && C->background)     //Se congela (o se descongela) la tabla ya redimensionada
+        swapResizedOA(&C->RW, &C->HT, YES);
+    if(frozenCommandOA(&C->frozen, &C->HT, command, number, C->mode)==YES)
+        return YES;
+    if(strcmp("load", command)==0 || setOperationCode(command) != 0){     //Operaciones de conjuntos (con "threads=N" hilos)
+        if(C->background)
+            swapResizedOA(&C->RW, &C->HT, YES);
+        setCommandOA(&C->HT, &C->other, command, number, C->mode, C->threads);
+        return YES;
+    }
+    if(isBatchCommand(command)){                    //Inserción o búsqueda por lotes desde un archivo
+        if(C->background)
+            swapResizedOA(&C->RW, &C->HT, YES);
+        batchCommandOA(&C->HT, command, number, C->mode);
+        return YES;
+    }
+    if(isAggCommand(command)){                      //Agregación (sólo con la opción "agg")
+        if(C->agg)
+            aggCommandOA(&C->HT, buffer, command, number, C->mode, C->threads);
+        else
+            fprintf(stderr, "Aggregation needs the agg option\n");
+        return YES;
+    }
+    return NO;
+}
+void insertOA(void *T, record *rec, const char *extra){
+    commands_OA *C = (commands_OA*)T;
+    (void)extra;
+    if(C->agg)
+        HTupsertAdd_OA(&C->HT, rec, 1, C->mode);
+    else if(C->background)
+        HTinsertRecord_OABG(&C->RW, &C->HT, rec);
+    else
+        HTinsertRecord_OA(&C->HT, rec, C->mode);
+}
+void removeOA(void *T, record *rec){
+    commands_OA *C = (commands_OA*)T;
+    if(C->background)
+        HTdeleteRecordOABG(&C->RW, &C->HT, rec);
+    else
+        HTdeleteRecordOA(&C->HT, rec, C->mode);
+}
+int findOA(void *T, record *rec){
+    commands_OA *C = (commands_OA*)T;
+    if(C->background)
+        return HTfindRecord_OABG(&C->RW, &C->HT, rec);
+    return (HTfindRecord_OA(&C->HT, rec, C->mode) != NULL) ? YES : NO;
+}
+void printOA(void *T){
+    commands_OA *C = (commands_OA*)T;
+    if(C->background)
+        swapResizedOA(&C->RW, &C->HT, YES);
+    HTprint_OA(C->HT);
+}
+size_t countOA(void *T){
+    return ((commands_OA*)T)->HT->occupied_elements;
+}
+void destroyOA(void *T){
+    commands_OA *C = (commands_OA*)T;
+    freeResizeOA(&C->RW, &C->HT);
+    freeIntTablesOA(&C->IT);
+    if(C->other != NULL)
+        freeHTable_OA(C->other);
+    if(C->frozen != NULL)
+        freeHTable_OAF(C->frozen);
+    freeHTable_OA(C->HT);
+}
+const command_ops COMMANDS_OA = {commandOA, insertOA, removeOA, findOA, printOA, countOA, NULL, destroyOA};
+
+/*Con TTL: antes de cada comando se avanza la rueda y se quitan algunos vencidos; "advance ms" adelanta el reloj*/
+int commandTTL_OA(void *T, char *buffer, char *command, char *number){
+    commands_OA *C = (commands_OA*)T;
+    (void)buffer;
+    ttlTick_OA(&C->HT, C->mode, &C->W);
+    if(strcmp("advance", command)==0){
+        C->W.offset += strtoull(number, NULL, 10)*1000000ULL;
+        return YES;
+    }
+    return NO;
+}
+void insertTTL_OA(void *T, record *rec, const char *extra){     //"insert llave [ms]"
+    commands_OA *C = (commands_OA*)T;
+    HTinsertRecordTTL_OA(&C->HT, rec, C->mode, &C->W, (extra[0] != '\0') ? strtoull(extra, NULL, 10)*1000000ULL : C->W.ttl);
+}
+int findTTL_OA(void *T, record *rec){
+    commands_OA *C = (commands_OA*)T;
+    return HTfindRecordTTL_OA(&C->HT, rec, C->mode, &C->W);
+}
+void statsTTL_OA(void *T){
+    ttlStats(&((commands_OA*)T)->W);
+}
+void destroyTTL_OA(void *T){
+    commands_OA *C = (commands_OA*)T;
+    ttlStats(&C->W);
+    freeTimerWheel(&C->W);
+    freeHTable_OA(C->HT);
+}
+const command_ops COMMANDS_TTL_OA = {commandTTL_OA, insertTTL_OA, removeOA, findTTL_OA, printOA, countOA, statsTTL_OA, destroyTTL_OA};
+
+/*Caché (la tabla no crece y se desaloja con el reloj)*/
+void insertOAK(void *T, record *rec, const char *extra){
+    (void)extra;
+    HTinsertRecord_OAK((HTable_OAK*)T, rec);
+}
+void removeOAK(void *T, record *rec){
+    HTdeleteRecordOAK((HTable_OAK*)T, rec);
+}
+int findOAK(void *T, record *rec){
+    return HTfindRecord_OAK((HTable_OAK*)T, rec);
+}
+void printOAK(void *T){
+    HTprint_OA(((HTable_OAK*)T)->HT);
+}
+size_t countOAK(void *T){
+    return ((HTable_OAK*)T)->HT->occupied_elements;
+}
+void statsOAK(void *T){
+    HTstats_OAK((HTable_OAK*)T);
+}
+void destroyOAK(void *T){
+    HTstats_OAK((HTable_OAK*)T);
+    freeHTable_OAK((HTable_OAK*)T);
+}
+const command_ops COMMANDS_OAK = {NULL, insertOAK, removeOAK, findOAK, printOAK, countOAK, statsOAK, destroyOAK};
+
+/*Tabla adaptativa ("mode" sólo es el sondeo con el que empieza)*/
+void insertOAD(void *T, record *rec, const char *extra){
+    (void)extra;
+    HTinsertRecord_OAD((HTable_OAD*)T, rec);
+}
+void removeOAD(void *T, record *rec){
+    HTdeleteRecordOAD((HTable_OAD*)T, rec);
+}
+int findOAD(void *T, record *rec){
+    return HTfindRecord_OAD((HTable_OAD*)T, rec);
+}
+void printOAD(void *T){
+    HTprint_OA(((HTable_OAD*)T)->HT);
+}
+size_t countOAD(void *T){
+    return ((HTable_OAD*)T)->HT->occupied_elements;
+}
+void statsOAD(void *T){
+    HTstats_OAD((HTable_OAD*)T);
+}
+void destroyOAD(void *T){
+    HTstats_OAD((HTable_OAD*)T);
+    freeHTable_OAD((HTable_OAD*)T);
+}
+const command_ops COMMANDS_OAD = {NULL, insertOAD, removeOAD, findOAD, printOAD, countOAD, statsOAD, destroyOAD};
+
+/*Tabla compacta ordenada*/
+void insertOAC(void *T, record *rec, const char *extra){
+    (void)extra;
+    HTinsertRecord_OAC((HTable_OAC*)T, rec);
+}
+void removeOAC(void *T, record *rec){
+    HTdeleteRecordOAC((HTable_OAC*)T, rec);
+}
+int findOAC(void *T, record *rec){
+    size_t pos;
+    return (HTfindRecord_OAC((HTable_OAC*)T, rec, &pos) != NULL) ? YES : NO;
+}
+void printOAC(void *T){
+    HTprint_OAC((HTable_OAC*)T);
+}
+size_t countOAC(void *T){
+    return ((HTable_OAC*)T)->occupied_elements;
+}
+void destroyOAC(void *T){
+    freeHTable_OAC((HTable_OAC*)T);
+}
+const command_ops COMMANDS_OAC = {NULL, insertOAC, removeOAC, findOAC, printOAC, countOAC, NULL, destroyOAC};
+
+/*Tabla empaquetada: "find" va por el camino de lectura sin candados (con el lugar de lector del hilo principal). Con "readers=N" hay
+//...además N hilos lectores que buscan las llaves que se van insertando*/
+typedef struct{
+    HTable_OAP *HT;
+    int reader;
+    packed_readers *R;          //Hilos lectores (NULL si no hay)
+}commands_OAP;
+void insertOAP(void *T, record *rec, const char *extra){
+    commands_OAP *C = (commands_OAP*)T;
+    (void)extra;
+    HTinsertRecord_OAP(&C->HT, rec);
+    if(C->R != NULL)
+        publishKeyOAP(C->R, rec);
+}
+void removeOAP(void *T, record *rec){
+    HTdeleteRecordOAP(&((commands_OAP*)T)->HT, rec);
+}
+int findOAP(void *T, record *rec){
+    commands_OAP *C = (commands_OAP*)T;
+    return HTreadRecord_OAP(&C->HT, rec, C->reader);
+}
+void printOAP(void *T){
+    HTprint_OAP(((commands_OAP*)T)->HT);
+}
+size_t countOAP(void *T){
+    return ((commands_OAP*)T)->HT->occupied_elements;
+}
+void statsOAP(void *T){
+    HTmemory_OAP(((commands_OAP*)T)->HT);
+}
+void destroyOAP(void *T){
+    commands_OAP *C = (commands_OAP*)T;
+    if(C->R != NULL)
+        stopReadersOAP(C->R);
+    epochUnregister(C->reader);
+    epochReclaim();
+    freeHTable_OAP(C->HT);
+}
+const command_ops COMMANDS_OAP = {NULL, insertOAP, removeOAP, findOAP, printOAP, countOAP, statsOAP, destroyOAP};
+
+/*Tabla compartida: un lector sólo puede buscar, contar e imprimir; "unlink" borra el nombre del segmento (los que ya lo tienen abierto
+//...lo siguen usando)*/
+typedef struct{
+    HTable_OAS *HT;
+    const char *name;
+}commands_OAS;
+int commandOAS(void *T, char *buffer, char *command, char *number){
+    commands_OAS *C = (commands_OAS*)T;
+    (void)buffer;
+    (void)number;
+    if((strcmp("insert", command)==0 || strcmp("delete", command)==0 || strcmp("unlink", command)==0) && !C->HT->writer){
+        printf("Sólo el escritor puede cambiar la tabla\n");
+        return YES;
+    }
+    if(strcmp("unlink", command)==0){
+        unlinkHTable_OAS(C->name);
+        return YES;
+    }
+    return NO;
+}
+void insertOAS(void *T, record *rec, const char *extra){
+    (void)extra;
+    HTinsertRecord_OAS(((commands_OAS*)T)->HT, rec);
+}
+void removeOAS(void *T, record *rec){
+    HTdeleteRecordOAS(((commands_OAS*)T)->HT, rec);
+}
+int findOAS(void *T, record *rec){
+    return HTreadRecord_OAS(((commands_OAS*)T)->HT, rec);
+}
+void printOAS(void *T){
+    HTprint_OAS(((commands_OAS*)T)->HT);
+}
+size_t countOAS(void *T){
+    return HTcount_OAS(((commands_OAS*)T)->HT);
+}
+void statsOAS(void *T){
+    HTmemory_OAS(((commands_OAS*)T)->HT);
+}
+void destroyOAS(void *T){
+    closeHTable_OAS(((commands_OAS*)T)->HT);
+}
+const command_ops COMMANDS_OAS = {commandOAS, insertOAS, removeOAS, findOAS, printOAS, countOAS, statsOAS, destroyOAS};
+
+//************************************INT MAIN********************************************************************************************
+int main(int argc, char **argv){
+    size_t mode;
+    //Aquí se elige manualmente el tipo de sondeo a emplear (LP = Lineal Proubing, QP = Quadratic Proubing, DH = Double Hashing, HS = Hopscotch, CO = Compacta ordenada, PK = Empaquetada y SH = Compartida)
+    if(argc == 1){
+        printf("Bienvenid@. Eliga la estrategia (1 = Lineal Proubing, 2 = Quadratic Proubing, 3 = Double Hashing, 4 = Hopscotch, 5 = Compacta ordenada, 6 = Empaquetada y 7 = Compartida): ");
+        scanf("%ld", &mode);
+    }
+    else{
+        mode = atoi(argv[1]);
+    }
+    //Después del modo, cada argumento es una opción ("clave=valor" o una palabra) y pueden ir en cualquier orden: las de traza
+    //...("record=archivo", "replay=archivo", "threads=N", "timed" y "perf"; "threads=N" también es el No. de hilos de las operaciones de
+    //...conjuntos), las de la tabla compartida ("shm=/nombre" y "reader" para abrirla como lector), las de la caché ("cache=N",
+    //..."cachemem=bytes" y "evict=clock" o "evict=slru"), la del TTL ("ttl=ms"), la de la tabla adaptativa ("adapt" o "adapt=archivo"), la de la congelada
+    //...("frozen=archivo"), "bg" para redimensionar en segundo plano (sólo LP, QP y DH), la de los hilos lectores de la empaquetada
+    //...("readers=N"), la de la agregación ("agg") y la política de memoria para los arreglos grandes (p. ej. "huge,prefault")
+    trace_options TO = {NULL, NULL, 1, NO};
+    const char *shm_name = "/HT_OA";
+    int shm_reader = NO;
+    size_t cache_entries = 0, cache_bytes = 0;
+    int cache_policy = CLOCK;
+    int ttl = NO;
+    uint64_t ttl_ms = 0;
+    int adapt = NO;
+    const char *adapt_log = NULL;
+    const char *frozen_path = NULL;
+    int background = NO;
+    int agg = NO;
+    int readers = 0;
+    for(int i=2; i<argc; i++){
+        if(parseTraceOption(&TO, argv[i])==NO && parseSharedOption(&shm_name, &shm_reader, argv[i])==NO &&
+           parseCacheOption(&cache_entries, &cache_bytes, &cache_policy, argv[i])==NO && parseTTLOption(&ttl, &ttl_ms, argv[i])==NO &&
+           parseAdaptOption(&adapt, &adapt_log, argv[i])==NO && parseFrozenOption(&frozen_path, argv[i])==NO &&
+           parseBackgroundOption(&background, argv[i])==NO && parseReadersOption(&readers, argv[i])==NO && parseAggOption(&agg, argv[i])==NO &&
+           parseAllocPolicy(argv[i])==NO)
+            fprintf(stderr, "Unknown option: %s\n", argv[i]);
+    }
+    background = background && (mode==LP || mode==QP || mode==DH);
+    if(mode!=LP && mode!=QP && mode!=DH && mode!=HS && mode!=CO && mode!=PK && mode!=SH)
+        return 0;
+    if(readers > 0 && (mode!=PK || TO.replay != NULL)){
+        fprintf(stderr, "Concurrent readers are only available for the packed table (without replay)\n");
+        return 1;
+    }
+    //Con "replay=archivo" no se leen comandos: se repite la traza con la estrategia elegida y se termina (la compartida no se repite)
+    if(TO.replay != NULL && mode==SH){
+        fprintf(stderr, "Replay is not available for the shared table\n");
+        return 1;
+    }
+    if(TO.replay != NULL){
+        int status = replayTrace(&TO, (mode==CO) ? &REPLAY_OAC : ((mode==PK) ? &REPLAY_OAP : &REPLAY_OA), mode);
+        epochReclaim();
+        return status;
+    }
+    int cache = (cache_entries != 0 || cache_bytes != 0);
+    if(cache && mode!=LP && mode!=QP && mode!=DH && mode!=HS){
+        fprintf(stderr, "Cache mode is only available for LP, QP, DH and HS\n");
+        return 1;
+    }
+    if(ttl && (cache || (mode!=LP && mode!=QP && mode!=DH && mode!=HS))){
+        fprintf(stderr, "TTL mode is only available for LP, QP, DH and HS (without cache)\n");
+        return 1;
+    }
+    if(adapt && (cache || ttl || (mode!=LP && mode!=QP && mode!=DH && mode!=HS))){
+        fprintf(stderr, "Adaptive mode is only available for LP, QP, DH and HS (without cache or TTL)\n");
+        return 1;
+    }
+    if(frozen_path != NULL && (cache || ttl || adapt || (mode!=LP && mode!=QP && mode!=DH && mode!=HS))){
+        fprintf(stderr, "Frozen tables are only available for LP, QP, DH and HS (without cache, TTL or adaptive mode)\n");
+        return 1;
+    }
+    if(agg && (cache || ttl || adapt || frozen_path != NULL || (mode!=LP && mode!=QP && mode!=DH && mode!=HS))){
+        fprintf(stderr, "Aggregation is only available for LP, QP, DH and HS (without cache, TTL, adaptive mode or frozen tables)\n");
+        return 1;
+    }
+    trace_writer TW;
+    openTraceWriter(&TW, TO.record);
+    //Cada estrategia sólo escoge sus operaciones y su tabla; el ciclo de comandos es el mismo para todas (runCommands)
+    commands_OA C;
+    commands_OAP P;
+    commands_OAS S;
+    const command_ops *ops = &COMMANDS_OA;
+    void *T = &C;
+    if(cache){
+        ops = &COMMANDS_OAK;
+        T = newHTable_OAK(mode, cache_entries, cache_bytes, cache_policy);
+    }
+    else if(adapt){
+        ops = &COMMANDS_OAD;
+        T = newHTable_OAD(mode, adapt_log);
+    }
+    else if(mode==CO){
+        ops = &COMMANDS_OAC;
+        T = newHTable_OAC();
+    }
+    else if(mode==PK){
+        P.HT = newHTable_OAP();
+        P.reader = epochRegister();
+        P.R = (readers > 0) ? startReadersOAP(&P.HT, readers) : NULL;
+        ops = &COMMANDS_OAP;
+        T = &P;
+    }
+    else if(mode==SH){
+        S.HT = openHTable_OAS(shm_name, !shm_reader);
+        if(S.HT == NULL)
+            return 1;
+        S.name = shm_name;
+        ops = &COMMANDS_OAS;
+        T = &S;
+    }
+    else{
+        C.HT = newHTable_OA();
+        C.mode = mode;
+        //La redimensión en segundo plano no lleva los acumuladores en su bitácora, así que no va con agregación
+        C.background = background && !agg;
+        C.agg = agg;
+        C.threads = TO.threads;
+        C.other = NULL;
+        C.frozen = NULL;
+        initResizeWorker(&C.RW, mode, copyResizeOA, replayResizeOA);
+        //Mientras todas las llaves sean números se usan las tablas de llaves enteras (con el mismo sondeo; no con hopscotch, "bg", TTL,
+        //...agregación ni la tabla congelada)
+        C.IT.table.ops = NULL;
+        C.IT.table.HT = NULL;
+        if(ttl){
+            initTimerWheel(&C.W, ttl_ms);
+            C.background = NO;
+            ops = &COMMANDS_TTL_OA;
+        }
+        else if(frozen_path != NULL){
+            C.frozen = openHTable_OAF(frozen_path);
+            if(C.frozen == NULL)
+                return 1;
+            HTstats_OAF(C.frozen);
+        }
+        else if(!background && !agg && (mode==LP || mode==QP || mode==DH))
+            initIntTablesOA(&C.IT, mode);
     }
-    freeHTable_OA(HT);
-    printf("Gracias!\n"); 
-    printf("Contador auxiliar: %d\n", aux);	
+    runCommands(ops, T, &TW);
+    printf("Gracias!\n");
+    printf("Contador auxiliar: %d\n", aux);
     return 0;
 }
 
@@ -1,12 +1,6 @@
 //Esta es una biblioteca con una estructura que implementa una tabla hash como Separate Chaining
 
-#include <stdio.h>
-#include <stdlib.h>
-#include <stdint.h>
-#include <assert.h>
-#include <string.h>
-//#include <math.h>
-#include <time.h>
+#include "ht_common.h"
 
 //NOTA 1: El tipo size_t facilita el trabajo con variables que solo almacenan valores enteros positivos (size_t es el tamaño máximo que
 //...maneja la computadora)
@@ -16,48 +10,21 @@
 //NOTA 4: "assert()" evalúa si lo que está dentro de los paréntesis es non-zero (TRUE) o zero (FALSE). Si es cero, manda mensaje de
 //..error por stderr y termina la ejecución del programa
 
-//Definimos macros (cuando el PC compile, YES lo traduce a 1 y NO a 0... no son variables globales)
-#define YES 1
-#define NO 0
-#define VALID 1
-#define NOTVALID 0
-#define DELETED NOTVALID
-#define MAX_64 2147483647
-#define FULL 2
-#define EMPTY 1
-#define UP 1
-#define DOWN 0
+//Macros propias de Separate Chaining (las comunes están en ht_common.h)
 #define LL 1
 #define AR 0
 
-//En este arreglo se contienen los números primos menores a cada potencia de 2 (hasta 2^16)
-const uint32_t HASH_SIZE[] = {5, 23, 127, 251, 509, 1021, 2039, 4093, 8191, 16381, 32749, 65521, 131071, 262139, 524287, 1048573, 2097143, 4194301, 8388593, 16777213, 33554393, 67108859, 134217689, 268435399, 536870909, 1073741789, 2147483647, 4294967291};
-
-//Constante de ADLER
-const uint32_t MOD_ADLER = 65521;
-
 //Variable Global para la histéresis (tolerancia para rehash down en casos donde el usuario inserte y borre alternadamente)
-int hist = 0;
+//...Es una por hilo: en la repetición de trazas cada hilo tiene su propia tabla
+__thread int hist = 0;
 
-/*Función generador de llaves*/
-uint32_t adler32(unsigned char *data, size_t len) {
-    uint32_t a = 1, b = 0;
-    size_t index;
-
-    //Process each byte of the data in order
-    for (index = 0; index < len; ++index){
-        a = (a + data[index]) % MOD_ADLER;
-        b = (b + a) % MOD_ADLER;
-    }
-    return (b << 16) | a; //Aquí se recorre b 16 bits a la izquierda y después cada bit de b se opera OR con el respectivo bit de a
+//Bytes que se reservan de más al final de cada contenido guardado en la tabla. Normalmente es 0; en modo TTL ahí se guarda el
+//...vencimiento del elemento (ver VENCIMIENTO), así los chunks siguen midiendo una línea de caché
+size_t content_extra = 0;
+static inline size_t contentSize(size_t len){
+    return len + content_extra;
 }
 
-/*Estructura tipo record para incluir la longitud de cadena y los bytes de una información (como un stream de datos, con un puntero al inicio y de ahí sabemos la longitud)*/
-typedef struct{
-    void *bytes;                //El "void" es para que podamos decir que es un puntero de cualquier tipo de datos
-    size_t len;                 //Longitud del contenido
-}record;
-
 /*Estos será el tipo de estructura de un elemento de una tabla hash*/
 typedef struct {
     record rec;                 //Contenido a guardar en la posición de la tabla
@@ -66,19 +33,27 @@ typedef struct {
     uint32_t key;               //La llave del contenido
 } hash_item;                    //Nombre
 
-/*Estructura para cada lista ligada en cada posición de la tabla hash*/
+/*Estructura para cada "chunk" de la lista en cada posición de la tabla hash*/
+/*NOTA: en vez de un nodo por elemento, cada chunk guarda CHUNK_SLOTS elementos y mide una línea de caché (64 bytes en 64 bits):
+//...primero las huellas (un byte por elemento, 0 = espacio libre), luego las longitudes, los punteros al contenido y al final
+//...el link al siguiente chunk. Al buscar, se comparan las 4 huellas de un golpe y sólo se toca el contenido si coinciden*/
+#define CHUNK_SLOTS 4
 struct LinkedList_Hash{         //Definición de la estructura
-    hash_item elem;             //Contenido del nodo de la lista
-    struct LinkedList_Hash *next;    //Link (dirección) del siguiente nodo
+    uint8_t fp[CHUNK_SLOTS];    //Huellas de las llaves (0 = espacio libre)
+    uint32_t n;                 //En la cabeza: No. de espacios reservados en toda la lista (en los demás chunks no se usa)
+    uint32_t lens[CHUNK_SLOTS]; //Longitudes de los contenidos
+    void *bytes[CHUNK_SLOTS];   //Direcciones de los contenidos
+    struct LinkedList_Hash *next;    //Link (dirección) del siguiente chunk
 };
 
-typedef struct LinkedList_Hash LLHash; //Definimos un tipo de datos "LLHash" el cual es una estructura LinkedList (recuerda el ejemplo de analogía de int con misInts) -> Cada LLHash es un elemento de una lista ligada
+typedef struct LinkedList_Hash LLHash; //Definimos un tipo de datos "LLHash" el cual es una estructura LinkedList (recuerda el ejemplo de analogía de int con misInts) -> Cada LLHash es un chunk de una lista ligada
 
 /*Aquí definiremos la cabeza de un elemento de la tabla hash*/
-typedef struct{
-    size_t n;                  //No. de elementos en la lista ligada
-    LLHash *next;              //Dirección del primer nodo de lista ligada conectada a la cabeza
-}LLHead;                       //Nombre
+//NOTA: la cabeza ES el primer chunk (va incrustado en el arreglo de cabezas), así que casi todas las búsquedas tocan una sola línea de caché
+typedef LLHash LLHead;         //Nombre
+
+//Tamaño de línea de caché al que se alinean las cabezas y los chunks
+#define CACHE_LINE 64
 
 
 /*Aquí definimos la estructura de una tabla hash como tal (arreglo de cabezas LLHead)*/
@@ -87,11 +62,29 @@ typedef struct{
     size_t index_size;          //Índice del tipo de capacidad (arreglo de diferentes tamaños con números impares)
     size_t size;                //Tamaño del arreglo
     size_t occupied_elements;   //Cantidad de elementos ocupados en la tabla
+    uint64_t seed;              //Semilla de las llaves (ver LLAVES CON SEMILLA)
+    size_t reseed_floor;        //No se vuelve a resembrar hasta tener al menos estos elementos (el doble que en el último resiembro)
+    int flooded;                //YES si la última inserción recorrió una lista anormalmente larga
 }HTable_SC;
 
+/*Función para reservar memoria alineada a la línea de caché e inicializada en 0 (como CALLOC). "kind" es el uso que se contabiliza*/
+void* callocCacheLine(size_t count, size_t size, int kind){
+    //Los arreglos grandes siguen la política de memoria (mmap ya viene alineado a página y en 0)
+    if(usesTableMapping(count*size))
+        return allocTableArrayKind(count*size, kind);
+    //aligned_alloc pide que el tamaño total sea múltiplo de la alineación (lo que se agrega cuenta como holgura)
+    size_t total = ((count*size + CACHE_LINE - 1)/CACHE_LINE)*CACHE_LINE;
+    void *ptr = aligned_alloc(CACHE_LINE, total);
+    if(ptr != NULL){
+        memset(ptr, 0, total);
+        memAdd(kind, count*size, malloc_usable_size(ptr));
+    }
+    return ptr;
+}
+
 /*Realiza una nueva tabla definiendo su tamaño, su índice y se realiza un malloc para apartar memoria. Regresa la dirección de donde empieza la tabla*/
 HTable_SC* newHTableCap_SC(size_t index){
-    HTable_SC *HT = (HTable_SC*)malloc(sizeof(HTable_SC)*1);    //Reserva memoria para una tabla
+    HTable_SC *HT = (HTable_SC*)memMalloc(MEM_TABLE, sizeof(HTable_SC)*1);    //Reserva memoria para una tabla
     if(HT == NULL){                                             //Si HT es NULL, MALLOC no pudo reservar más memoria
         fprintf(stderr, "Cannot allocate memory for table.");
         exit(1);
@@ -99,14 +92,21 @@ HTable_SC* newHTableCap_SC(size_t index){
     //Si llegamos aquí, entonces sí se pudo reservar memoria
     HT->size = HASH_SIZE[index];
     HT->index_size = index;                                   //Marcar (con llamada a 0) en el primer elemento
-    HT->table = (LLHead*)calloc(HT->size, sizeof(LLHead));    //CALLOC reserva memoria para todo un arreglo inicializando en 0 cada uno de sus elementos
-    //La tabla ya está inicializada porque usamos CALLOC; son dos vaiables a inicializar: n y el puntero de next (Deben ser cero y NULL)
+    HT->table = (LLHead*)callocCacheLine(HT->size, sizeof(LLHead), MEM_TABLE);    //Reserva memoria alineada para todo el arreglo inicializando en 0 cada uno de sus elementos
+    //La tabla ya está inicializada en 0: huellas en 0 (espacios libres), punteros en NULL y n en 0
     if(HT->table == NULL){
         fprintf(stderr, "Cannot allocate memory for table.");
         exit(1);
     }
+    //Cada cabeza ya trae reservados los espacios de su chunk incrustado
+    for(size_t i=0; i<HT->size; i++){
+        HT->table[i].n = CHUNK_SLOTS;
+    }
     //Inicializamos en 0 la cantidad de elementos ocupados (apenas es nueva la tabla)
     HT->occupied_elements = 0;
+    HT->seed = tableSeed();
+    HT->reseed_floor = 0;
+    HT->flooded = NO;
     return HT;
 }
 
@@ -115,19 +115,29 @@ HTable_SC* newHTable_SC(){
     return newHTableCap_SC(0);
 }
 
-/*Función que libera todo elemento de la lista ligada de una cabeza*/
+/*Función para calcular la llave de un record con la semilla de la tabla*/
+static inline uint32_t keySC(HTable_SC *HT, record *rec){
+    return seededKey(HT->seed, (unsigned char*)rec->bytes, rec->len);
+}
+
+/*Función que libera el contenido de un chunk*/
+void freeLLHashSlots(LLHash *chunk){
+    for(size_t s=0; s<CHUNK_SLOTS; s++){
+        //Sólo los espacios ocupados tienen contenido reservado
+        if(chunk->fp[s] != 0)
+            memFree(MEM_KEYS, chunk->bytes[s], contentSize(chunk->lens[s]));
+    }
+}
+
+/*Función que libera todo chunk de la lista ligada de una cabeza*/
 void freeLLHashItem(LLHash *item){
-    //Parte que termina la recursividad: si el próximo elemento de la lista (de la cabeza) es nulo, regresa
-    if(item == NULL){
-        return;
+    //Se recorre la lista con un ciclo (los chunks ya son pocos, pero así no depende de la pila)
+    while(item != NULL){
+        LLHash *next = item->next;
+        freeLLHashSlots(item);      //Liberar espacio del contenido
+        memFree(MEM_NODES, item, sizeof(LLHash));      //Liberar espacio del chunk actual
+        item = next;
     }
-    //Recursividad: manda a llamar la función de todos los elementos hasta llegar a nulo
-    freeLLHashItem(item->next);
-    //Cuando la recursividad acaba, aquí sigue la ejecución
-    assert(item != NULL);       //Asegurar que en efecto, el item NO es null (sino para dejar de ejecutar)
-    free(item->elem.rec.bytes); //Liberar espacio del contenido
-    free(item);                 //Liberar espacio del elemento actual
-    
 }
 
 
@@ -135,23 +145,59 @@ void freeLLHashItem(LLHash *item){
 void freeHTable_SC(HTable_SC *HT){
     //Se libera cabeza por cabeza
     for(size_t i=0; i<HT->size; i++){
-        //Llamada a función que libera espacios de cabeza
+        //Llamada a funciones que liberan el chunk incrustado y los chunks conectados a la cabeza
+        freeLLHashSlots(&(HT->table[i]));
         freeLLHashItem(HT->table[i].next);
     }
     assert(HT->table != NULL);//"Asegúrate de que el arreglo de cabezas no es nulo"
-    free(HT->table);
+    freeTableArray(HT->table, HT->size*sizeof(LLHead));
     assert(HT != NULL);//"Asegúrate de que la tabla hash no es nula"
-    free(HT);
+    memFree(MEM_TABLE, HT, sizeof(HTable_SC));
 }
 
-
 //Funcion para sacar el módulo de una llave
 static inline size_t hashFunction(uint32_t key, size_t hashSize){ //static inline hace que el compilador tome el argumento y opere hashFunction sin considerarla como funcion
     return key % hashSize;
 }
 
-/*Prototipo de la función para insertar (y así poder usarla en la función de expandir la tabla)*/
-hash_item* HTinsertRecord_SC(HTable_SC **HT, record *rec);
+/*Función para la lista más larga que se tolera al insertar: como las listas de esta tabla son largas a propósito (sólo crece cuando los
+//...espacios reservados llegan al cuadrado del tamaño), al límite de floodLimit se le suma 4 veces el largo promedio de una lista*/
+static inline size_t chainLimit(size_t occupied, size_t size){
+    return floodLimit(size) + 4*(occupied/size);
+}
+
+/*Prototipo de la función para enlazar un contenido ya reservado (y así poder usarla en la función de expandir la tabla)*/
+LLHash* linkRecordSC(HTable_SC *HT, uint32_t key, void *bytes, size_t len);
+
+/*Estructura de un contenido que se mueve a otra tabla (Remodel y cambios de forma): el puntero y la longitud y, si sale de una lista, el
+//...chunk y el espacio de donde sale (para marcarlo como libre ya que quedó en la tabla nueva)*/
+typedef struct{
+    void *bytes;
+    size_t len;
+    LLHash *chunk;
+    size_t slot;
+}moved_item_SC;
+
+/*Función para calcular por lotes (ver HASH POR LOTES) las llaves de "n" contenidos que se mueven (a lo más HASH_BATCH)*/
+void movedKeysSC(uint64_t seed, moved_item_SC *items, size_t n, uint32_t *keys){
+    const unsigned char *data[HASH_BATCH];
+    size_t len[HASH_BATCH] = {0};
+    for(size_t i=0; i<n; i++){
+        data[i] = (const unsigned char*)items[i].bytes;
+        len[i] = items[i].len;
+    }
+    seededKeyBatch(seed, data, len, n, keys);
+}
+
+/*Función para enlazar en "HT" un lote de contenidos que salen de las listas de otra tabla (el espacio viejo se marca como libre)*/
+void linkMovedSC(HTable_SC *HT, moved_item_SC *items, size_t n){
+    uint32_t keys[HASH_BATCH];
+    movedKeysSC(HT->seed, items, n, keys);
+    for(size_t i=0; i<n; i++){
+        if(linkRecordSC(HT, keys[i], items[i].bytes, items[i].len) != NULL)
+            items[i].chunk->fp[items[i].slot] = 0;
+    }
+}
 
 /*Función para para expandir o reducir espacio: reserva memoria y reacomoda el contenido de una tabla ya existente*/
 HTable_SC* RemodelHTableCap_SC(HTable_SC *PreviousHT, int state){
@@ -166,20 +212,46 @@ HTable_SC* RemodelHTableCap_SC(HTable_SC *PreviousHT, int state){
     //Aquí aseguramos que state no sea 0. Si es así, entonces hubo un erro al mandar llamar la función sin necesidad
     //...(la tabla no está ni llena ni vacía)
     assert(state!=0);
-    //Creamos una nueva tabla con el nuevo índice
+    size_t mark = memRemodelBegin();
+    //Creamos una nueva tabla con el nuevo índice (y la misma semilla; con RESEED, del mismo tamaño y con otra semilla)
     HTable_SC *HT = newHTableCap_SC(newIndex);
-    //Aquí se insertará cada elemento de la tabla antigua a la nueva
+    HT->seed = PreviousHT->seed;
+    HT->reseed_floor = PreviousHT->reseed_floor;
+    if(state==RESEED){
+        HT->seed = randomSeed();
+        HT->reseed_floor = 2*PreviousHT->occupied_elements;
+        __atomic_add_fetch(&flood_reseeds, 1, __ATOMIC_RELAXED);
+    }
+    //Aquí se pasa cada elemento de la tabla antigua a la nueva. El contenido no se copia: se mueve el puntero y se marca el espacio
+    //...viejo como libre (así al liberar la tabla antigua no se libera el contenido, y se conservan los bytes extra del final).
+    //...Las listas sólo guardan huellas, así que las llaves se vuelven a calcular, de HASH_BATCH en HASH_BATCH
+    moved_item_SC batch[HASH_BATCH];
+    size_t n = 0;
     for(size_t i=0; i< ((PreviousHT->size)); i++){
-        LLHash *aux = PreviousHT->table[i].next;
+        LLHash *aux = &(PreviousHT->table[i]);
         while(aux!=NULL){
-            //Si el estado es NOTVALID, es porque ya estaba borrado. Por lo tanto no se vuelve a insertar
-            if(aux->elem.status==VALID)
-                HTinsertRecord_SC(&HT, &aux->elem.rec);
+            for(size_t j=0; j<CHUNK_SLOTS; j++){
+                //Si la huella es 0, el espacio estaba libre (o ya estaba borrado). Por lo tanto no se vuelve a insertar
+                if(aux->fp[j] != 0){
+                    batch[n].bytes = aux->bytes[j];
+                    batch[n].len = aux->lens[j];
+                    batch[n].chunk = aux;
+                    batch[n].slot = j;
+                    if(++n == HASH_BATCH){
+                        linkMovedSC(HT, batch, n);
+                        n = 0;
+                    }
+                }
+            }
             aux = aux->next;
         }
     }
+    linkMovedSC(HT, batch, n);
+    //Las listas que se recorrieron al reacomodar no cuentan como inserciones
+    HT->flooded = NO;
     //Liberamos el espacio de la tabla antigua
     freeHTable_SC(PreviousHT);
+    memRemodelEnd(mark);
     //Regresamos la nueva tabla (con el contenido incluído)
     return HT;
 }
@@ -187,7 +259,7 @@ HTable_SC* RemodelHTableCap_SC(HTable_SC *PreviousHT, int state){
 /*Función para evaluar si la tabla está vacía o llena*/
 //NOTA: "operation" indica si se mandó llamar la función para insertar ("UP") o para borrar ("DOWN") elementos
 int checkSize(HTable_SC *HT, int operation){
-    //Se suma la cantidad de elementos en total de la tabla (se suman los elementos por cabeza en el siguiente ciclo)
+    //Se suma la cantidad de espacios reservados en total de la tabla (se suman los espacios por cabeza en el siguiente ciclo)
     size_t sum = 0;
     for(size_t i=0; i< ((HT->size)); i++){
         sum += HT->table[i].n;
@@ -214,186 +286,238 @@ int checkSize(HTable_SC *HT, int operation){
 }
 
 //************************************FUNCIONES PARA LAS OPERACIONES BÁSICASS********************************************************************************************
-/*Función para checar los bytes entre dos contenidos y ver si son iguales o no*/
-int checkMatchRecord(record *A, record *B){
-    //Si la longitud de A y B son diferentes, de antemano ya sabemos que no son iguales
-    if(A->len != B->len)
-        return NO;
-    unsigned char *pA = (unsigned char*)A->bytes;            // Este "(unsigned char*)" es lo que conocemos como un untpype cast
-    unsigned char *pB = (unsigned char*)B->bytes;
-    //Si uno de los bytes es diferente entre sí de A y B, entonces no son iguales
-    for(size_t i=0; i<A->len; i++){
-        if(pA[i] != pB[i])
-            return NO;
-    }
-    //Si A y B pasaron las pruebas anteriores, entonces sí son iguales
-    return YES;
+
+/*Función para calcular la huella (1 byte, nunca 0) de una llave; usa bits distintos a los del módulo de la cabeza*/
+static inline uint8_t fingerprintSC(uint32_t key){
+    uint8_t fp = (uint8_t)((key * 2654435761u) >> 24);
+    return (fp != 0) ? fp : 1;
 }
 
-/*Función para encontrar elementos según su llave. Regresa el puntero de un Hash Item (búsqueda robusta)*/
-hash_item *HTfindkey_SC(HTable_SC **HT, uint32_t key){
-    size_t index = hashFunction(key, (*HT)->size);
-    LLHash *current = (*HT)->table[index].next;         //Current es un LLHash (un elemento de la lista ligada de una cabeza)
+/*Función que regresa una máscara con el bit alto encendido en cada byte de las huellas de un chunk igual a "fp"*/
+//NOTA: el truco puede encender de más algún byte después de una coincidencia, por eso siempre se verifica la huella
+static inline uint32_t matchFingerprints(LLHash *chunk, uint8_t fp){
+    uint32_t word;
+    memcpy(&word, chunk->fp, CHUNK_SLOTS);
+    uint32_t x = word ^ (fp * 0x01010101u);
+    return (x - 0x01010101u) & ~x & 0x80808080u;
+}
+
+/*Función para encontrar un record en la lista que empieza en "current" (el chunk incrustado en su cabeza). Regresa el chunk donde está
+//...el contenido y su posición en "slot"*/
+LLHash *findChainSC(LLHash *current, uint32_t key, record *rec, size_t *slot){
+    uint8_t fp = fingerprintSC(key);
     while(current != NULL){
-        if(current->elem.key == key){                   //Buscar a lo largo de una lista ligada el elemento asociado a la llave de interés
-            return &(current->elem);                    //Regresa NO la dirección, sino el elemento
+        uint32_t mask = matchFingerprints(current, fp);
+        //Sólo se revisan los contenidos cuyas huellas coinciden
+        while(mask != 0){
+            size_t s = __builtin_ctz(mask)/8;
+            if(current->fp[s] == fp && current->lens[s] == rec->len && compareBytes(current->bytes[s], rec->bytes, rec->len)==YES){
+                *slot = s;
+                return current;
+            }
+            mask &= mask - 1;
         }
-        current = current->next;                        //Siguiente nodo de la lista ligada
+        current = current->next;                        //Siguiente chunk de la lista ligada
     }
     return NULL;                                        //Si la ejecución llega hasta aquí, no se encontró nada con la llave
 }
 
-/*Función para encontrar el contenido (record) de un elemento en una tabla Hash según una llave (búsqueda preliminar)*/
-hash_item* HTfindRecord_SC(HTable_SC **HT, record *rec){               //El const char es para que la función no altere la dirección de record
-    uint32_t key = adler32((unsigned char*)rec->bytes, rec->len);               //Encuentro la llave asociada a record (una cadena de longitud "len")
-    hash_item *item = HTfindkey_SC(HT, key);            //Regrésame la dirección del item asociada a la llave
-    //Si el item es nulo, simplemente no hay contenido
-    if(item == NULL)
-        return NULL;
-    //Si se encuentra el contenido correspondiente, entonces regresa la dirección del contenido
-    if(checkMatchRecord(rec, &(item->rec))==YES)
-        return item;
-    //Si no es nulo, entonces vamos a buscar
-    //Esto evalúa si hay match entre dos records a una misma llave
-    //Si encuentro un record diferente con la misma llave, hay que buscar con mayor resolución (búsqueda más exhaustiva)
+/*Función para encontrar elementos según su llave. Regresa el chunk donde está el contenido y su posición en "slot" (búsqueda robusta)*/
+LLHash *HTfindkey_SC(HTable_SC **HT, uint32_t key, record *rec, size_t *slot){
     size_t index = hashFunction(key, (*HT)->size);
-    LLHash *current = (*HT)->table[index].next;         //Current es un LLHash (un elemento de la lista ligada de una cabeza)
-    while(current != NULL){
-        //En el siguiente IF se evalúa la primera condición por mejorar el rendimiento: es más fácil evaluar, y si truena, ya no es necesario hacer la siguiente evaluación
-        if(current->elem.key == key && checkMatchRecord(rec, &(current->elem.rec))==YES){                   //Buscar a lo largo de una lista ligada el elemento asociado a la llave de interés
-            if(current->elem.status == VALID)
-            return &(current->elem);
+    return findChainSC(&((*HT)->table[index]), key, rec, slot);     //Empezamos por el chunk incrustado en la cabeza
+}
+
+/*Función para encontrar el contenido (record) de un elemento en una tabla Hash. Regresa el chunk y la posición en "slot"*/
+LLHash* HTfindRecord_SC(HTable_SC **HT, record *rec, size_t *slot){               //El const char es para que la función no altere la dirección de record
+    uint32_t key = keySC(*HT, rec);               //Encuentro la llave asociada a record (con la semilla de la tabla)
+    return HTfindkey_SC(HT, key, rec, slot);
+}
+
+/*Función para enlazar en la lista de "head" un contenido que ya está reservado (sin copiarlo), con su huella ya calculada. En "walked"
+//...regresa cuántos espacios ocupados se recorrieron. Regresa el chunk donde quedó (o NULL si no se pudo reservar un chunk nuevo)*/
+LLHash* linkChainSC(LLHead *head, uint8_t fp, void *bytes, size_t len, size_t *walked){
+    size_t slot;
+    //Buscamos el primer espacio libre (huella 0) a lo largo de la lista, empezando por la cabeza
+    LLHash *current = head;
+    *walked = 0;
+    while(1){
+        uint32_t mask = matchFingerprints(current, 0);
+        while(mask != 0){
+            slot = __builtin_ctz(mask)/8;
+            if(current->fp[slot] == 0)
+                break;
+            mask &= mask - 1;
         }
-        current = current->next;                        //Siguiente nodo de la lista ligada
+        if(mask != 0)
+            break;
+        //Este es el caso para cuando llegamos al último chunk (todos sus espacios ya estaban ocupados): creamos uno nuevo
+        if(current->next == NULL){
+            current->next = (LLHash*)callocCacheLine(1, sizeof(LLHash), MEM_NODES);
+            if(current->next == NULL){
+                fprintf(stderr, "Cannot allocate memory for element!\n");
+                return NULL;
+            }
+            //Aumentamos el contador de espacios reservados en la lista de la cabeza
+            head->n += CHUNK_SLOTS;
+        }
+        //Si aun no llegamos a un espacio libre, continuamos con el que sigue
+        current = current->next;
+        *walked += CHUNK_SLOTS;
     }
-    return NULL;                                        //Si la ejecución llega hasta aquí, no se encontró nada con la llave
+    //Inserta el elemento aquí
+    current->fp[slot] = fp;
+    current->lens[slot] = (uint32_t)len;
+    current->bytes[slot] = bytes;
+    return current;
+}
+
+/*Función para enlazar en la tabla un contenido que ya está reservado (sin copiarlo), con su llave ya calculada. Regresa el chunk
+//...donde quedó (o NULL si no se pudo reservar un chunk nuevo; en ese caso el contenido sigue siendo de quien llamó)*/
+LLHash* linkRecordSC(HTable_SC *HT, uint32_t key, void *bytes, size_t len){
+    //Sacamos el módulo de la llave
+    size_t index = hashFunction(key, HT->size);
+    size_t walked;
+    LLHash *current = linkChainSC(&(HT->table[index]), fingerprintSC(key), bytes, len, &walked);
+    if(current == NULL)
+        return NULL;
+    //Si la lista ya es más larga de lo que se tolera, la tabla se marca (la revisa checkFloodSC)
+    if(walked > chainLimit(HT->occupied_elements, HT->size))
+        HT->flooded = YES;
+    //Incrementamos en 1 el contador de elementos ocupados en la tabla
+    HT->occupied_elements++;
+    return current;
+}
+
+/*Función para colocar un contenido que se sabe que no está en la tabla, con su llave ya calculada (sin revisar si hay que expandirla)*/
+LLHash* placeRecordSC(HTable_SC *HT, uint32_t key, record *rec){
+    //Reservamos y copiamos el contenido (los bytes extra del final empiezan en 0)
+    void *bytes = memMalloc(MEM_KEYS, contentSize(rec->len));        // OJO: Aquí apenas se reserva la memoria necesaria para copiar el contenido
+    if(bytes == NULL){
+        fprintf(stderr, "Cannot allocate memory for element!\n");
+        return NULL;
     }
+    memcpy(bytes, rec->bytes, rec->len);
+    memset((char*)bytes + rec->len, 0, content_extra);
+    LLHash *chunk = linkRecordSC(HT, key, bytes, rec->len);
+    if(chunk == NULL)
+        memFree(MEM_KEYS, bytes, contentSize(rec->len));
+    return chunk;
+}
+
+/*Función para revisar si la última inserción recorrió una lista anormalmente larga. Si es así se cuenta y, si la tabla ya tiene el doble
+//...de elementos que en su último resiembro, se reconstruye con otra semilla. Regresa YES si se reconstruyó*/
+int checkFloodSC(HTable_SC **HT){
+    if(!floodReseedDue(&(*HT)->flooded, (*HT)->occupied_elements, (*HT)->reseed_floor))
+        return NO;
+    (*HT) = RemodelHTableCap_SC(*HT, RESEED);
+    return YES;
+}
 
+/*Función para introducir un contenido con su llave ya calculada sin revisar si hay que expandir la tabla (sí se revisa la lista más larga)*/
+LLHash* insertKeySC(HTable_SC **HT, uint32_t key, record *rec){
+    //Vemos si el contenido ya está (la misma llave sirve para buscarlo y para colocarlo)
+    size_t slot;
+    LLHash *chunk = HTfindkey_SC(HT, key, rec, &slot);
+    //Si es diferente de nulo, significa que ya estaba
+    if(chunk != NULL){
+        return chunk;
+    }
 
+    //Si ese chunk es NULO, entonces no estaba el dato guardado previamente
+    chunk = placeRecordSC(*HT, key, rec);
+    //Si hubo que resembrar, el contenido ya está en otro chunk
+    if(chunk != NULL && checkFloodSC(HT)==YES)
+        chunk = HTfindRecord_SC(HT, rec, &slot);
+    return chunk;
+}
 
-/*Función para introducir un contenido (Record) en la tabla. Regresará la dirección de dónde se insertó el nuevo contenido*/
-hash_item* HTinsertRecord_SC(HTable_SC **HT, record *rec){
+/*Función para introducir un contenido con su llave ya calculada (con la semilla actual de la tabla; expandir la tabla la conserva)*/
+LLHash* HTinsertRecordKey_SC(HTable_SC **HT, uint32_t key, record *rec){
     //Primeramente vamos a ver si la tabla tiene un tamaño grande. Si es así, la expandemos
     if(checkSize(*HT, UP)==FULL){
         (*HT)=RemodelHTableCap_SC(*HT, checkSize(*HT, UP));
         //printf("Cambiamos el tamaño");
     }
-    //Vemos si el contenido ya está
-    hash_item *item = HTfindRecord_SC(HT, rec);
-    //Si es diferente de nulo, significa que ya estaba
-    if(item != NULL){
-        return item;
-    }
+    return insertKeySC(HT, key, rec);
+}
 
-    //Si ese item es NULO, entonces no estaba el dato guardado previamente. Calculemos pues la llave
-    uint32_t key = adler32((unsigned char*)rec->bytes, rec->len);
-    //Sacamos el módulo de la llave
-    size_t index = hashFunction(key, (*HT)->size);
-    //Si la ejecución llega hasta este punto, tenemos la garantía de que no había ese dato ya existente previamente
-    LLHash *list = (*HT)->table[index].next;            //Aquí declaramos un elemento de lista (conectada a la cabeza correspondiente)
-    //Si el primer elemento de la lista es nulo (no habíamos insertado nada ahí), se reserva memoria y se inserta el elemento ahí
-    if(list == NULL){
-        list = (LLHash*)malloc(sizeof(LLHash)*1);
-        //Si no se logra, seguirá siendo NULL
-        if(list == NULL){
-            fprintf(stderr, "Cannot allocate memory for element!\n");
-            return NULL;
-        }
+/*Función para introducir un contenido (Record) en la tabla. Regresará el chunk donde quedó el nuevo contenido*/
+LLHash* HTinsertRecord_SC(HTable_SC **HT, record *rec){
+    return HTinsertRecordKey_SC(HT, keySC(*HT, rec), rec);
+}
 
-        //Inserta el elemento aquí
-        list->next = NULL;
-        list->elem.key = key;
-        list->elem.status = VALID;
-        list->elem.rec.bytes = malloc((rec->len));        // OJO: Aquí apenas se reserva la memoria necesaria para copiar el contenido
-        //Colocamos lo siguiente en caso de que no se haya podido reservar memoria
-        if(list->elem.rec.bytes == NULL){
-            fprintf(stderr, "Cannot allocate memory for element!\n");
-            return NULL;
-        }
-        list->elem.rec.len = rec->len;
-        //La siguiente función es para copiar directamente el contenido a un destino con esta forma: (destino, remitente, tamaño)
-        //OJO: En el destinatario debe caber lo de la fuente.
-        memcpy(list->elem.rec.bytes, rec->bytes, rec->len);
-        //Ahora sí, ligamos este nuevo "list" a la cabeza donde queremos insertar el elemento
-        (*HT)->table[index].next = list;
-        //Aumentamos el contador de elementos en uno (conteo de elementos conectados a la cabeza)
-        (*HT)->table[index].n++;
-        //Incrementamos en 1 el contador de elementos ocupados en la tabla
-        (*HT)->occupied_elements++;
-        return &(list->elem);
-    }
-    //Si la ejecución llega a esta parte, la lista ligada ya tenía su primer elemento ocupado
-    LLHash *current = list;
-    while(current != NULL){
-        //Este es para ingresar un elemento donde había un NOT VALID, no al final de la lista
-        if(current->elem.status == NOTVALID){
-            current->elem.key = key;
-            current->elem.status = VALID;
-            //Ahora, asegura que los bytes a reservar sí existen (y no es un puntero nulo)
-            assert(current->elem.rec.bytes != NULL);
-            //Si en este elemento "desocupado" que encontramos tiene el suficiente espacio para almacenar el nuevo dato, lo colocamos ahí
-            if(rec->len > current->elem.rec.len){
-                //Aquí vamos a usar realloc: realloc("puntero del bloque de memoria reservado previamente", "espacio a recolocar ahí")
-                current->elem.rec.bytes = realloc(current->elem.rec.bytes, rec->len);
-                if(current->elem.rec.bytes == NULL){
-                    fprintf(stderr, "Cannot allocate memory for element!\n");
-                   return NULL;
-                }
-            //Aquí se indica el nuevo tamaño ocupado en el elemento
-            current->elem.rec.len = rec->len;
-            //Aquí se almacena el record
-            memcpy(current->elem.rec.bytes, rec->bytes, rec->len);
-            //Aumentamos el contador de elementos en uno (conteo de elementos conecados a la cabeza)
-            (*HT)->table[index].n++;
-
-            //Aumentamos el contador de elementos ocupados en uno
-            (*HT)->occupied_elements++;
-            //printf("Se inserto2");
-            return &(current->elem);
-            }
-        }
-        //Este es el caso para cuando llegamos al último elemento (los demás ya estaban ocupados)
-        if(current->next == NULL) break;
-        //Si aun no llegamos al último elemento, continuamos con el que sigue
-        current = current->next;
+/*Función para calcular por lotes las llaves de "n" records (a lo más HASH_BATCH)*/
+void recordKeysSC(uint64_t seed, record *recs, size_t n, uint32_t *keys){
+    const unsigned char *data[HASH_BATCH];
+    size_t len[HASH_BATCH] = {0};
+    for(size_t i=0; i<n; i++){
+        data[i] = (const unsigned char*)recs[i].bytes;
+        len[i] = recs[i].len;
     }
-    //Si llegamos hasta el último elemento y no se pudo colocar el contenido en un espacio reservado, lo ponemos al final de la lista ligada
-    //...(creamos un nuevo elemento desde cero)
+    seededKeyBatch(seed, data, len, n, keys);
+}
 
-    current->next = (LLHash*)malloc(sizeof(LLHash)*1);
-    if(current->next == NULL){
-        fprintf(stderr, "Cannot allocate memory for element!\n");
-        return NULL;
-    }
-    current->next->elem.key = key;
-    current->next->elem.status = VALID;
-    current->next->elem.rec.bytes = malloc(rec->len);
-    if(current->next->elem.rec.bytes == NULL){
-        fprintf(stderr, "Cannot allocate memory for element!\n");
-        return NULL;
+/*Función para insertar "n" records por lotes. Regresa cuántos se insertaron (los que ya estaban no cuentan)*/
+size_t HTinsertBatch_SC(HTable_SC **HT, record *recs, size_t n){
+    uint32_t keys[HASH_BATCH];
+    size_t inserted = 0;
+    for(size_t base=0; base<n; base+=HASH_BATCH){
+        size_t m = (n - base < HASH_BATCH) ? n - base : HASH_BATCH;
+        uint64_t seed = (*HT)->seed;
+        recordKeysSC(seed, recs + base, m, keys);
+        for(size_t i=0; i<m; i++)
+            __builtin_prefetch(&(*HT)->table[hashFunction(keys[i], (*HT)->size)]);
+        for(size_t i=0; i<m; i++){
+            //Si la tabla se resembró a medio lote, las llaves que faltan se recalculan una por una
+            uint32_t key = ((*HT)->seed == seed) ? keys[i] : keySC(*HT, &recs[base+i]);
+            size_t before = (*HT)->occupied_elements;
+            HTinsertRecordKey_SC(HT, key, &recs[base+i]);
+            if((*HT)->occupied_elements > before)
+                inserted++;
+        }
     }
-    current->next->elem.rec.len = rec->len;
-    memcpy(current->next->elem.rec.bytes, rec->bytes, rec->len);
-    //strcpy(current->next->elem.rec.bytes, rec->bytes);
-    current->next->next = NULL;
-    //Aumentamos el contador de elementos en uno (conteo de elementos conecados a la cabeza)
-    (*HT)->table[index].n++;
-    //Aumentamos el contador de elementos ocupados en uno
-    (*HT)->occupied_elements++;
-    return &(current->next->elem);
+    return inserted;
 }
 
-/*Función para borrar un elemento de la tabla*/
-void HTdeleteRecord(HTable_SC **HT, record *rec){
+/*Función para buscar "n" records por lotes. Regresa cuántos estaban*/
+size_t HTfindBatch_SC(HTable_SC **HT, record *recs, size_t n){
+    uint32_t keys[HASH_BATCH];
+    size_t hits = 0, slot;
+    for(size_t base=0; base<n; base+=HASH_BATCH){
+        size_t m = (n - base < HASH_BATCH) ? n - base : HASH_BATCH;
+        recordKeysSC((*HT)->seed, recs + base, m, keys);
+        for(size_t i=0; i<m; i++)
+            __builtin_prefetch(&(*HT)->table[hashFunction(keys[i], (*HT)->size)]);
+        for(size_t i=0; i<m; i++){
+            if(HTfindkey_SC(HT, keys[i], &recs[base+i], &slot) != NULL)
+                hits++;
+        }
+    }
+    return hits;
+}
+/*Función para quitar un elemento de la tabla sin revisar si hay que reducirla. Regresa YES si estaba*/
+int removeRecordSC(HTable_SC **HT, record *rec){
     //Primero se busca el elemento (para ver si ya estaba dentro)...
-    hash_item *item = HTfindRecord_SC(HT, rec);
+    size_t slot;
+    LLHash *chunk = HTfindRecord_SC(HT, rec, &slot);
     //Si la función anterior no se encontró, se regresará un NULL. Si es así, simplemente termina la función (nada por borrar)
-    if(item == NULL)
-        return;
-    //Si en efecto ya estaba el elemento presente en la tabla, simplemente le asignamos "NOTVALID"
-    item->status = NOTVALID;
+    if(chunk == NULL)
+        return NO;
+    //Si en efecto ya estaba el elemento presente en la tabla, liberamos su contenido y marcamos el espacio como libre (huella 0)
+    memFree(MEM_KEYS, chunk->bytes[slot], contentSize(chunk->lens[slot]));
+    chunk->bytes[slot] = NULL;
+    chunk->lens[slot] = 0;
+    chunk->fp[slot] = 0;
     //Decrementamos el contador de elementos ocupados en uno
     (*HT)->occupied_elements--;
+    return YES;
+}
+
+/*Función para borrar un elemento de la tabla*/
+void HTdeleteRecord(HTable_SC **HT, record *rec){
+    if(removeRecordSC(HT, rec)==NO)
+        return;
     //Finalmente vamos a ver si la tabla tiene muchos elementos sin ocupar. Si es así, la reducimos
     if(checkSize(*HT, DOWN)==EMPTY){
         if((*HT)->index_size>0)
@@ -421,9 +545,19 @@ void HTprintItem_SC(hash_item *item){
 void HTprint_SC(HTable_SC *HT){
     for(size_t i=0; i<HT->size; i++){
         printf("%ld ", i);
-        LLHash *current = HT->table[i].next;
+        LLHash *current = &(HT->table[i]);
         while(current != NULL){
-            HTprintItem_SC(&(current->elem));
+            for(size_t s=0; s<CHUNK_SLOTS; s++){
+                if(current->fp[s] == 0)
+                    continue;
+                //Los chunks no guardan la llave completa, así que se vuelve a calcular para imprimirla
+                hash_item item;
+                item.rec.bytes = current->bytes[s];
+                item.rec.len = current->lens[s];
+                item.status = VALID;
+                item.key = keySC(HT, &(item.rec));
+                HTprintItem_SC(&item);
+            }
             current = current->next;
         }
     printf("\n");
@@ -431,11 +565,29 @@ void HTprint_SC(HTable_SC *HT){
 }
 /*..................................................ARRAYS..........................................................................*/
 /*Aquí definiremos la cabeza de un elemento de la tabla hash*/
+/*NOTA: el arreglo de cada cabeza está guardado como "estructura de arreglos" en un solo bloque de memoria:
+//...primero las "cap" llaves contiguas, luego los "cap" punteros al contenido y al final las "cap" longitudes.
+//...Así, al buscar sólo se recorren las llaves (de 4 en 4 con SSE2) sin brincar entre punteros y longitudes*/
 typedef struct{
-    size_t len;                   //No. de elementos en el arreglo
-    hash_item *elem;              //Dirección del primer elemento del arreglo
+    size_t len;                   //No. de elementos en el arreglo (todos válidos: al borrar se recorre el último a su lugar)
+    size_t cap;                   //Capacidad reservada del arreglo (se duplica cada vez que se llena)
+    uint32_t *keys;               //Dirección del bloque (empieza con el arreglo de llaves)
 }AHead;                           //Nombre
 
+//Valor que regresan las búsquedas en arreglos cuando no encuentran nada
+#define NOT_FOUND ((size_t)-1)
+
+/*Funciones para obtener los arreglos paralelos de contenidos y longitudes a partir del bloque de una cabeza*/
+static inline void** AHeadBytes(AHead *head){
+    return (void**)(head->keys + head->cap);
+}
+static inline size_t* AHeadLens(AHead *head){
+    return (size_t*)(AHeadBytes(head) + head->cap);
+}
+//Tamaño en bytes del bloque de una cabeza con capacidad "cap"
+static inline size_t AHeadBlockSize(size_t cap){
+    return cap*(sizeof(uint32_t) + sizeof(void*) + sizeof(size_t));
+}
 
 /*Aquí definimos la estructura de una tabla hash como tal (arreglo de cabezas LLHead)*/
 typedef struct{
@@ -443,32 +595,34 @@ typedef struct{
     size_t index_size;          //Índice del tipo de capacidad (arreglo de diferentes tamaños con números impares)
     size_t size;                //Tamaño del arreglo
     size_t occupied_elements;   //Cantidad de elementos ocupados en la tabla
+    uint64_t seed;              //Semilla de las llaves (ver LLAVES CON SEMILLA)
+    size_t reseed_floor;        //No se vuelve a resembrar hasta tener al menos estos elementos (el doble que en el último resiembro)
+    int flooded;                //YES si la última inserción cayó en un arreglo anormalmente largo
 }HTable_SCA;
 
 /*Función para hacer una nueva tabla Hash con arreglos*/
 HTable_SCA* newHTableCap_SCA(size_t index){
     //Reservamos memoria para la tabla Hash
-    HTable_SCA *HT = (HTable_SCA*)malloc(sizeof(HTable_SCA)*1);    //Reserva memoria para una tabla
+    HTable_SCA *HT = (HTable_SCA*)memMalloc(MEM_TABLE, sizeof(HTable_SCA)*1);    //Reserva memoria para una tabla
     if(HT == NULL){                                                //Si HT es NULL, MALLOC no pudo reservar más memoria
         fprintf(stderr, "Cannot allocate memory for table.");
         exit(1);
     }
-    //Reservamos memoria para el arreglo de cabezas
-    HT->table = (AHead*)malloc(sizeof(AHead)*HASH_SIZE[index]);     //Reserva memoria para un arreglo
+    //Reservamos memoria para el arreglo de cabezas. Con CALLOC todas empiezan vacías (len = cap = 0 y sin bloque);
+    //...el bloque de cada cabeza se reserva hasta su primera inserción
+    HT->table = (AHead*)allocTableArray(HASH_SIZE[index]*sizeof(AHead));     //Reserva memoria para un arreglo (según la política de memoria)
     if(HT->table == NULL){                                          //Si table es NULL, MALLOC no pudo reservar más memoria
         fprintf(stderr, "Cannot allocate memory for table.");
         exit(1);
     }
-    //Inicializamos todas las cabezas con arreglos (tamaño inicial = 1)
-    for(size_t i=0; i<HASH_SIZE[index]; i++){
-        HT->table[i].elem = calloc(1,sizeof(hash_item)*1);      //Aquí se crean los "subarreglos"
-        HT->table[i].len = 1;
-    }
     //Si llegamos aquí, entonces sí se pudo reservar memoria
     HT->size = HASH_SIZE[index];
     HT->index_size = index;                                   //Indicar el índice de tamaño
     //Inicializamos en 0 la cantidad de elementos ocupados en total(apenas es nueva la tabla)
     HT->occupied_elements = 0;
+    HT->seed = tableSeed();
+    HT->reseed_floor = 0;
+    HT->flooded = NO;
     return HT;
     }
 
@@ -478,15 +632,19 @@ HTable_SCA* newHTable_SCA(){
     return newHTableCap_SCA(0);
 }
 
+/*Función para calcular la llave de un record con la semilla de la tabla con arreglos*/
+static inline uint32_t keySCA(HTable_SCA *HT, record *rec){
+    return seededKey(HT->seed, (unsigned char*)rec->bytes, rec->len);
+}
+
 /*Función que libera todo contenido en el arreglo de una cabeza*/
-void freeLLHashItemSCA(hash_item *item, size_t len){
-    //Parte que termina la recursividad: si el próximo elemento de la lista (de la cabeza) es nulo, regresa
-    for(size_t i=0; i<len; i++){
-        if(item[i].rec.bytes == NULL){
-            return;
-        }
+void freeLLHashItemSCA(AHead *head){
+    void **bytes = AHeadBytes(head);
+    //Se libera el contenido de cada elemento y después el bloque de la cabeza
+    for(size_t i=0; i<head->len; i++){
+        memFree(MEM_KEYS, bytes[i], contentSize(AHeadLens(head)[i]));
     }
-    free(item);                   //Se libera el elemento del arreglo
+    memFree(MEM_NODES, head->keys, AHeadBlockSize(head->cap));
     return;
 }
 
@@ -495,16 +653,52 @@ void freeLLHashItemSCA(hash_item *item, size_t len){
 void freeHTable_SCA(HTable_SCA *HT){
     //Se libera cabeza por cabeza
     for(size_t i=0; i<HT->size; i++){
-        freeLLHashItemSCA(HT->table[i].elem, HT->table[i].len);
+        freeLLHashItemSCA(&(HT->table[i]));
     }
     assert(HT->table != NULL);//"Asegúrate de que el arreglo de cabezas no es nulo"
-    free(HT->table);
+    freeTableArray(HT->table, HT->size*sizeof(AHead));
     assert(HT != NULL);//"Asegúrate de que la tabla hash no es nula"
-    free(HT);
+    memFree(MEM_TABLE, HT, sizeof(HTable_SCA));
+}
+
+/*Prototipo para poder usar la función que agranda el arreglo de una cabeza en la función "Remodel"*/
+int growAHead(AHead *head);
+
+/*Función para poner al final del arreglo de "head" un contenido que ya está reservado (sin copiarlo). Regresa NO si no se pudo agrandar*/
+int appendHeadSCA(AHead *head, uint32_t key, void *bytes, size_t len){
+    if(head->len == head->cap && growAHead(head) == NO)
+        return NO;
+    head->keys[head->len] = key;
+    AHeadBytes(head)[head->len] = bytes;
+    AHeadLens(head)[head->len] = len;
+    head->len++;
+    return YES;
+}
+
+/*Función para poner al final del arreglo de su cabeza un contenido que viene de otra tabla (sin copiarlo). Regresa NO si no se pudo
+//...agrandar el arreglo (el contenido sigue siendo de quien llamó)*/
+int appendMovedSCA(HTable_SCA *HT, uint32_t key, void *bytes, size_t len){
+    if(appendHeadSCA(&(HT->table[hashFunction(key, HT->size)]), key, bytes, len) == NO)
+        return NO;
+    HT->occupied_elements++;
+    return YES;
 }
 
-/*Prototipo para poder usar la función de insertar en la función "Remodel"*/
-void HTinsertRecord_SCA(HTable_SCA **HT, record *rec);
+/*Función para poner en "HT" un lote de contenidos que vienen de otra tabla, con sus llaves calculadas por lotes. Si salen de una lista,
+//...su espacio se marca como libre (lo que no cabe se queda en la lista y se libera con ella); si salen de un arreglo, lo que no cabe
+//...se libera*/
+void appendBatchSCA(HTable_SCA *HT, moved_item_SC *items, size_t n){
+    uint32_t keys[HASH_BATCH];
+    movedKeysSC(HT->seed, items, n, keys);
+    for(size_t i=0; i<n; i++){
+        if(appendMovedSCA(HT, keys[i], items[i].bytes, items[i].len) == YES){
+            if(items[i].chunk != NULL)
+                items[i].chunk->fp[items[i].slot] = 0;
+        }
+        else if(items[i].chunk == NULL)
+            memFree(MEM_KEYS, items[i].bytes, contentSize(items[i].len));
+    }
+}
 
 /*Función para para expandir espacio: reserva memoria y reacomoda el contenido de una tabla ya existente*/
 HTable_SCA* RemodelHTableCap_SCA(HTable_SCA *PreviousHT, int state){
@@ -519,19 +713,42 @@ HTable_SCA* RemodelHTableCap_SCA(HTable_SCA *PreviousHT, int state){
     //Aquí aseguramos que state no sea 0. Si es así, entonces hubo un erro al mandar llamar la función sin necesidad
     //...(DETENTE si la tabla no está ni llena ni vacía)
     assert(state!=0);
-    //Creamos una nueva tabla con el nuevo índice
+    size_t mark = memRemodelBegin();
+    //Creamos una nueva tabla con el nuevo índice (y la misma semilla; con RESEED, del mismo tamaño y con otra semilla)
     HTable_SCA *HT = newHTableCap_SCA(newIndex);
-    //Aquí se insertará cada elemento de la tabla antigua a la nueva
+    HT->seed = PreviousHT->seed;
+    HT->reseed_floor = PreviousHT->reseed_floor;
+    if(state==RESEED){
+        HT->seed = randomSeed();
+        HT->reseed_floor = 2*PreviousHT->occupied_elements;
+        __atomic_add_fetch(&flood_reseeds, 1, __ATOMIC_RELAXED);
+    }
+    //Aquí se pasa cada elemento de la tabla antigua a la nueva. Se reutiliza la llave guardada (al resembrar se calculan por lotes) y el
+    //...contenido no se copia: se mueve el puntero y se vacía la cabeza vieja (así al liberar la tabla antigua no se libera el contenido)
+    moved_item_SC batch[HASH_BATCH];
+    size_t n = 0;
     for(size_t i=0; i< ((PreviousHT->size)); i++){
-        for(size_t j=0; j< (PreviousHT->table[i].len); j++){
-            hash_item aux = PreviousHT->table[i].elem[j];
-            //Si el estado es NOTVALID, es porque ya estaba borrado. Por lo tanto no se vuelve a insertar
-            if(aux.status==VALID)
-                HTinsertRecord_SCA(&HT, &aux.rec);
+        AHead *head = &(PreviousHT->table[i]);
+        for(size_t j=0; j< head->len; j++){
+            if(HT->seed != PreviousHT->seed){
+                batch[n].bytes = AHeadBytes(head)[j];
+                batch[n].len = AHeadLens(head)[j];
+                batch[n].chunk = NULL;
+                if(++n == HASH_BATCH){
+                    appendBatchSCA(HT, batch, n);
+                    n = 0;
+                }
+                continue;
+            }
+            if(appendMovedSCA(HT, head->keys[j], AHeadBytes(head)[j], AHeadLens(head)[j]) == NO)
+                memFree(MEM_KEYS, AHeadBytes(head)[j], contentSize(AHeadLens(head)[j]));
         }
+        head->len = 0;
     }
+    appendBatchSCA(HT, batch, n);
     //Liberamos el espacio de la tabla antigua
     freeHTable_SCA(PreviousHT);
+    memRemodelEnd(mark);
     //Regresamos la nueva tabla (con el contenido incluído)
     return HT;
 }
@@ -544,16 +761,12 @@ int checkSizeSCA(HTable_SCA *HT, int operation){
         return FULL;}
     if(operation==UP)
 	return 0;
-    /*for(size_t i=0; i<HT->size; i++){
-        if(HT->table[i].non_vacancies == HT->size && operation == UP)
-            return FULL;
-    }*/
-    //Ahora, se evalúa si la cantidad total de elementos ocupados es menor que el cuarto de los elementos. Si es así,
+    //Ahora, se evalúa si la cantidad total de elementos ocupados es menor que el cuarto de los espacios reservados. Si es así,
     //...indicamos que está "vacía".
     //NOTA: Aquí le sumamos el cuadrado de la variable global "hist" (histéresis)
     size_t sum = 0;
     for(size_t i=0; i<HT->size; i++){
-        sum += HT->table[i].len;
+        sum += HT->table[i].cap;
     }
     if((HT->occupied_elements<((sum/4)+(hist*hist)))&&(operation==DOWN)){
 
@@ -565,130 +778,227 @@ int checkSizeSCA(HTable_SCA *HT, int operation){
     return 0;
 }
 
-/*Función para encontrar una llave en una tabla Hash con arreglos*/
-hash_item* HTfindkey_SCA(HTable_SCA **HT, uint32_t key){
+/*Función para buscar, a partir de "start", la siguiente posición del arreglo de llaves igual a "key". Regresa "len" si no hay*/
+static inline size_t scanKeysSCA(const uint32_t *keys, size_t start, size_t len, uint32_t key){
+    size_t i = start;
+#if defined(__SSE2__)
+    //Se comparan 4 llaves a la vez; la máscara tiene un bit por cada llave igual
+    __m128i k = _mm_set1_epi32((int)key);
+    for(; i+4<=len; i+=4){
+        __m128i block = _mm_loadu_si128((const __m128i*)(keys+i));
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(block, k)));
+        if(mask != 0)
+            return i + __builtin_ctz(mask);
+    }
+#endif
+    //Las llaves restantes (o todas, si no hay SSE2) se revisan una por una
+    for(; i<len; i++){
+        if(keys[i] == key)
+            return i;
+    }
+    return len;
+}
+
+/*Función para encontrar una llave en una tabla Hash con arreglos. Regresa su posición en el arreglo de la cabeza (o NOT_FOUND)*/
+size_t HTfindkey_SCA(HTable_SCA **HT, uint32_t key){
     //Aplicamos la función Hash
     size_t index = hashFunction(key, (*HT)->size);
-    //Buscamos la llave entre todos los elementos (comparando los valores con la que acabamos de encontrar)
-    for(size_t i=0; i<(*HT)->table[index].len; i++){
-        hash_item item = (*HT)->table[index].elem[i];
-    //Si la llave se encontró (y si no se ha marcado como "borrado"), se regresa el contenido
-        if(item.status == VALID && item.key == key )
-            return (&(*HT)->table[index].elem[i]);
-        }
-    //Si no se encontró, regresa NULL
-    return NULL;
+    AHead *head = &((*HT)->table[index]);
+    //Buscamos la llave entre todas las llaves contiguas de la cabeza
+    size_t i = scanKeysSCA(head->keys, 0, head->len, key);
+    if(i < head->len)
+        return i;
+    //Si no se encontró, regresa NOT_FOUND
+    return NOT_FOUND;
+}
+
+/*Función para encontrar un record, con su llave ya calculada, en el arreglo de una cabeza. Regresa su posición (o NOT_FOUND)*/
+size_t findHeadSCA(AHead *head, uint32_t key, record *rec){
+    //Varios records pueden tener la misma llave, así que se revisa el contenido de cada coincidencia
+    for(size_t i = scanKeysSCA(head->keys, 0, head->len, key); i < head->len; i = scanKeysSCA(head->keys, i+1, head->len, key)){
+        record aux;
+        aux.bytes = AHeadBytes(head)[i];
+        aux.len = AHeadLens(head)[i];
+        if(checkMatchRecord(rec, &aux)==YES)
+            return i;
+    }
+    return NOT_FOUND;
+}
+
+/*Función para encontrar un record, con su llave ya calculada, en una tabla Hash con arreglos. Regresa su posición en el arreglo de la
+//...cabeza (o NOT_FOUND)*/
+size_t HTfindRecordKey_SCA(HTable_SCA *HT, uint32_t key, record *rec){
+    size_t index = hashFunction(key, HT->size);
+    return findHeadSCA(&(HT->table[index]), key, rec);
 }
 
-/*Función para encontrar un record en una tabla Hash con arreglos*/
-hash_item* HTfindRecord_SCA(HTable_SCA **HT, record *rec){
+/*Función para encontrar un record en una tabla Hash con arreglos. Regresa su posición en el arreglo de la cabeza (o NOT_FOUND)*/
+size_t HTfindRecord_SCA(HTable_SCA **HT, record *rec){
     //Se calcula la llave de acuerdo al contenido
-    uint32_t key = adler32((unsigned char*)rec->bytes, rec->len);               //Encuentro la llave asociada a record (una cadena de longitud "len")
-    hash_item *item = HTfindkey_SCA(HT, key);
-    if(item == NULL)
-        return NULL;
-    if(checkMatchRecord(rec, &(item->rec))==YES)
-        return item;
-    return NULL;
-    //Se manda llamar la función de encontrar llave
-    //return HTfindkey_SCA(HT, key);
+    uint32_t key = keySCA(*HT, rec);               //Encuentro la llave asociada a record (con la semilla de la tabla)
+    return HTfindRecordKey_SCA(*HT, key, rec);
 }
 
-/*Función para insertar un elemento en una tabla hash con arreglos*/
-void HTinsertRecord_SCA(HTable_SCA **HT, record *rec){
+/*Función para duplicar la capacidad del arreglo de una cabeza (se copian los tres arreglos paralelos a un bloque nuevo)*/
+int growAHead(AHead *head){
+    size_t cap = (head->cap == 0) ? 2 : head->cap*2;
+    uint32_t *keys = (uint32_t*)memMalloc(MEM_NODES, AHeadBlockSize(cap));
+    if(keys == NULL){
+        fprintf(stderr, "Cannot allocate memory for element!\n");
+        return NO;
+    }
+    AHead newHead;
+    newHead.len = head->len;
+    newHead.cap = cap;
+    newHead.keys = keys;
+    //Colocamos todo el contenido del AHead en su nueva versión
+    if(head->len > 0){
+        memcpy(newHead.keys, head->keys, head->len*sizeof(uint32_t));
+        memcpy(AHeadBytes(&newHead), AHeadBytes(head), head->len*sizeof(void*));
+        memcpy(AHeadLens(&newHead), AHeadLens(head), head->len*sizeof(size_t));
+    }
+    //Liberamos el bloque de la versión anterior y ponemos la nueva donde corresponde
+    memFree(MEM_NODES, head->keys, AHeadBlockSize(head->cap));
+    *head = newHead;
+    return YES;
+}
+
+/*Función para colocar un record que se sabe que no está en la tabla, con su llave ya calculada (sin revisar si hay que expandirla)*/
+void placeRecordSCA(HTable_SCA *HT, uint32_t key, record *rec){
+    size_t index = hashFunction(key, HT->size);
+    AHead *head = &(HT->table[index]);
+    //Si el arreglo de la cabeza está lleno, se duplica su capacidad (así llenar una cabeza de k elementos cuesta O(k) copias)
+    if(head->len == head->cap){
+        if(growAHead(head) == NO)
+            return;
+    }
+    //Colocamos el nuevo elemento al final del arreglo (los bytes extra del final empiezan en 0)
+    void *bytes = memMalloc(MEM_KEYS, contentSize(rec->len));     //Aquí apenas reservamos memoria
+    if(bytes == NULL){
+        fprintf(stderr, "Cannot allocate memory for element!\n");
+        return;
+    }
+    memcpy(bytes, rec->bytes, rec->len);
+    memset((char*)bytes + rec->len, 0, content_extra);
+    head->keys[head->len] = key;
+    AHeadBytes(head)[head->len] = bytes;
+    AHeadLens(head)[head->len] = rec->len;
+    head->len++;
+    //Aumentamos el contador de elementos ocupados en uno
+    HT->occupied_elements++;
+    //Si el arreglo ya es más largo de lo que se tolera, la tabla se marca (la revisa checkFloodSCA)
+    if(head->len > chainLimit(HT->occupied_elements, HT->size))
+        HT->flooded = YES;
+    return;
+    }
+
+/*Función para revisar si la última inserción cayó en un arreglo anormalmente largo (igual que checkFloodSC). Regresa YES si se
+//...reconstruyó la tabla*/
+int checkFloodSCA(HTable_SCA **HT){
+    if(!floodReseedDue(&(*HT)->flooded, (*HT)->occupied_elements, (*HT)->reseed_floor))
+        return NO;
+    (*HT) = RemodelHTableCap_SCA(*HT, RESEED);
+    return YES;
+}
+
+/*Función para insertar un elemento con su llave ya calculada sin revisar si hay que expandir la tabla (sí se revisa el arreglo más largo)*/
+void insertKeySCA(HTable_SCA **HT, uint32_t key, record *rec){
+    //Usando la función para encontrar un record, se evalúa si ya estaba el contenido en la tabla
+    if(HTfindRecordKey_SCA(*HT, key, rec) != NOT_FOUND)
+        return;
+    //Si la ejecución llega hasta aquí, el contenido no estaba presente.
+    placeRecordSCA(*HT, key, rec);
+    checkFloodSCA(HT);
+}
+
+/*Función para insertar un elemento con su llave ya calculada (con la semilla actual de la tabla; expandir la tabla la conserva)*/
+void HTinsertRecordKey_SCA(HTable_SCA **HT, uint32_t key, record *rec){
     //Primeramente vamos a ver si la tabla tiene un tamaño grande. Si es así, la expandemos
     if(checkSizeSCA(*HT, UP)==FULL){
         (*HT)=RemodelHTableCap_SCA(*HT, checkSizeSCA(*HT, UP));
         //printf("Cambiamos el tamaño");
     }
-    //Se calcula la llave
-    uint32_t key = adler32(rec->bytes, rec->len);
-    //Usando la función para encontrar una llave, se evalúa si lo que regresa es nulo o no (si no lo es, quiere decir que ya estaba el contenido...
-    //... en la tabla)
-    if(HTfindRecord_SCA(HT, rec) != NULL)
-        return;
-    //Si la ejecución llega hasta aquí, el contenido no estaba presente.
-    //Primero se intenta insertar en un espacio desocupado (donde se había marcado como borrado a un elemento)
-    size_t index = hashFunction(key, (*HT)->size);
-    //En el AHead que corresponde, se busca entre los elementos de su arreglo algún espacio disponible
-    for( size_t i=0; i<(*HT)->table[index].len; i++ ){
-        hash_item *item = &((*HT)->table[index].elem[i]);
-        if(item->status == NOTVALID){
-            //Si estaba disponible, veamos si su contenido era nulo. Si no es así, reservamos para moverlo ahí ahí. Si era nulo, reservamos memoria desde 0
-            //if(item->rec.bytes != NULL)
-            //    item->rec.bytes =  realloc(item->rec.bytes, rec->len);
-            //else
-            item->rec.bytes = malloc(rec->len);
-            item->rec.len = rec->len;
-            //Agregamos la llave y marcamos como válido
-            item->key = key;
-            item->status = VALID;
-            //Copiamos el contenido ahí
-            strcpy(item->rec.bytes, rec->bytes);
-            //Aumentamos el contador del total de elementos ocupados en uno
-            (*HT)->occupied_elements++;
-            size_t hasel = (*HT)->size;
-            return;
+    insertKeySCA(HT, key, rec);
+}
+
+/*Función para insertar un elemento en una tabla hash con arreglos*/
+void HTinsertRecord_SCA(HTable_SCA **HT, record *rec){
+    HTinsertRecordKey_SCA(HT, keySCA(*HT, rec), rec);
+}
+
+/*Función para insertar "n" records por lotes en una tabla con arreglos. Regresa cuántos se insertaron*/
+size_t HTinsertBatch_SCA(HTable_SCA **HT, record *recs, size_t n){
+    uint32_t keys[HASH_BATCH];
+    size_t inserted = 0;
+    for(size_t base=0; base<n; base+=HASH_BATCH){
+        size_t m = (n - base < HASH_BATCH) ? n - base : HASH_BATCH;
+        uint64_t seed = (*HT)->seed;
+        recordKeysSC(seed, recs + base, m, keys);
+        for(size_t i=0; i<m; i++)
+            __builtin_prefetch(&(*HT)->table[hashFunction(keys[i], (*HT)->size)]);
+        for(size_t i=0; i<m; i++){
+            //Si la tabla se resembró a medio lote, las llaves que faltan se recalculan una por una
+            uint32_t key = ((*HT)->seed == seed) ? keys[i] : keySCA(*HT, &recs[base+i]);
+            size_t before = (*HT)->occupied_elements;
+            HTinsertRecordKey_SCA(HT, key, &recs[base+i]);
+            if((*HT)->occupied_elements > before)
+                inserted++;
         }
     }
-    //Si no hubo un espacio disponible, se "renueva" el AHead (añadiendo el nuevo elemento en el siguiente espacio del arreglo)
-    AHead newHead;
-    newHead.elem = malloc(sizeof(hash_item)*((*HT)->table[index].len+1));
-    newHead.len = (*HT)->table[index].len+1;
-    //Colocamos todo el contenido del AHhead en su nueva versión
-    for( size_t i=0; i<(*HT)->table[index].len; i++ ){
-        newHead.elem[i].key = (*HT)->table[index].elem[i].key;
-        newHead.elem[i].status = (*HT)->table[index].elem[i].status;
-        newHead.elem[i].rec = (*HT)->table[index].elem[i].rec;
-        newHead.elem[i].len = newHead.len;
-    }
-    //Colocamos ahora el nuevo elemento con el record a insertar
-    newHead.elem[(*HT)->table[index].len].key = key;
-    newHead.elem[(*HT)->table[index].len].status = VALID;
-    newHead.elem[(*HT)->table[index].len].rec.bytes = malloc(rec->len); //Aquí apenas reservamos memoria
-    newHead.elem[(*HT)->table[index].len].rec.len = rec->len; //Aquí definimos la longitud
-    //Aquí ya copiamos el record en el nuevo elemento a usar de la tabla
-    strcpy(newHead.elem[(*HT)->table[index].len].rec.bytes, rec->bytes);
-    //Mantenemos el resto de los elementos como disponibles
-    for( size_t i=(*HT)->table[index].len+1; i<newHead.len; i++ ){
-        newHead.elem[i].key = 0;
-        newHead.elem[i].status = NOTVALID;
-        newHead.elem[i].rec.bytes = NULL;
-        newHead.elem[i].rec.len = 0;
-        newHead.elem[i].len = newHead.len;
-    }
-    //Liberamos el espacio de la versión anterior
-    free((*HT)->table[index].elem);
-    //Ponemos esta nueva versión de AHead donde corresponde
-    (*HT)->table[index] = newHead;
-    //Aumentamos el contador de elementos ocupados en uno
-    (*HT)->occupied_elements++;
-    return;
+    return inserted;
+}
+
+/*Función para buscar "n" records por lotes en una tabla con arreglos. Regresa cuántos estaban*/
+size_t HTfindBatch_SCA(HTable_SCA **HT, record *recs, size_t n){
+    uint32_t keys[HASH_BATCH];
+    size_t hits = 0;
+    for(size_t base=0; base<n; base+=HASH_BATCH){
+        size_t m = (n - base < HASH_BATCH) ? n - base : HASH_BATCH;
+        recordKeysSC((*HT)->seed, recs + base, m, keys);
+        for(size_t i=0; i<m; i++)
+            __builtin_prefetch(&(*HT)->table[hashFunction(keys[i], (*HT)->size)]);
+        for(size_t i=0; i<m; i++){
+            if(HTfindRecordKey_SCA(*HT, keys[i], &recs[base+i]) != NOT_FOUND)
+                hits++;
+        }
     }
+    return hits;
+}
+
+/*Función para quitar la posición "i" del arreglo de una cabeza, recorriendo el último elemento a su lugar (no libera el contenido)*/
+static inline void removeHeadSCA(AHead *head, size_t i){
+    head->len--;
+    head->keys[i] = head->keys[head->len];
+    AHeadBytes(head)[i] = AHeadBytes(head)[head->len];
+    AHeadLens(head)[i] = AHeadLens(head)[head->len];
+}
+
+/*Función para quitar un record de una tabla hash con arreglos sin revisar si hay que reducirla. Regresa YES si estaba*/
+int removeRecordSCA(HTable_SCA **HT, record *rec){
+    //Primero se busca el record. Si no está, regresa a main
+    size_t i = HTfindRecord_SCA(HT, rec);
+    if(i == NOT_FOUND)
+        return NO;
+    uint32_t key = keySCA(*HT, rec);
+    size_t index = hashFunction(key, (*HT)->size);
+    AHead *head = &((*HT)->table[index]);
+    //Liberamos su contenido y recorremos el último elemento a su lugar (así el arreglo queda sin huecos)
+    memFree(MEM_KEYS, AHeadBytes(head)[i], contentSize(AHeadLens(head)[i]));
+    removeHeadSCA(head, i);
+    //Decrementamos el contador del total de elementos ocupados en uno
+    (*HT)->occupied_elements--;
+    return YES;
+}
 
 //Función para borrar un record en una tabla hash con arreglos
 void HTdeleteRecordSCA(HTable_SCA **HT, record *rec){
-    uint32_t key = adler32(rec->bytes, rec->len);
-    //Primero se busca la llave. Si era nulo, entonces no estaba (regresa a main)
-    if(HTfindkey_SCA(HT, key) == NULL)
+    if(removeRecordSCA(HT, rec)==NO)
         return;
-    //Si estaba la llave, se calcula la posición donde está (en el arreglo de cabezas) y se hace un barrido hasta dar con la llave
-    size_t index = hashFunction(key, (*HT)->size);
-    for( size_t i=0; i<(*HT)->table[index].len; i++ ){
-        hash_item item = (*HT)->table[index].elem[i];
-        if( item.status == VALID && item.key == key ){
-            //Cuando se encuentra con la llave, se marca como "borrado"
-            (*HT)->table[index].elem[i].status = NOTVALID;
-            //Decrementamos el contador del total de elementos ocupados en uno
-            (*HT)->occupied_elements--;
-            //Finalmente vamos a ver si la tabla tiene muchos elementos sin ocupar. Si es así, la reducimos
-            if(checkSizeSCA(*HT, DOWN)==EMPTY){
-                if((*HT)->index_size>0){
-                    (*HT)=RemodelHTableCap_SCA(*HT, checkSizeSCA(*HT, DOWN));
-                    //printf("Cambiamos el tamaño");
-                }
-            }
-            return;
+    //Finalmente vamos a ver si la tabla tiene muchos elementos sin ocupar. Si es así, la reducimos
+    if(checkSizeSCA(*HT, DOWN)==EMPTY){
+        if((*HT)->index_size>0){
+            (*HT)=RemodelHTableCap_SCA(*HT, checkSizeSCA(*HT, DOWN));
+            //printf("Cambiamos el tamaño");
         }
     }
 }
@@ -697,104 +1007,3047 @@ void HTdeleteRecordSCA(HTable_SCA **HT, record *rec){
 void HTprint_SCA(HTable_SCA *HT){
     for(size_t i=0; i<HT->size; i++){
         printf("%ld ", i);
-        for(size_t j=0; j<HT->table[i].len; j++)
-            HTprintItem_SC(&(HT->table[i].elem[j]));
+        AHead *head = &(HT->table[i]);
+        for(size_t j=0; j<head->len; j++){
+            hash_item item;
+            item.rec.bytes = AHeadBytes(head)[j];
+            item.rec.len = AHeadLens(head)[j];
+            item.status = VALID;
+            item.key = head->keys[j];
+            HTprintItem_SC(&item);
+        }
             printf("\n");
         }
     printf("\n");
     }
 
-//************************************INT MAIN********************************************************************************************
-int main(int argc, char **argv){
-    //Aquí se elige manualmente el tipo de estrategia (LL = Linked lists, A = Arrays)
-    int mode;
-    if(argc == 1){
-        printf("Bienvenid@. Eliga la estrategia (1 = Linked lists, 0 = Arrays): ");
-        scanf("%d", &mode);
+/*......................................OPERACIONES DE CONJUNTOS.........................................................................*/
+/*Unión, intersección y diferencia entre dos tablas de la misma estrategia, ya sea sólo contando o generando una tabla nueva. La tabla que
+//...se recorre se reparte por rangos de cabezas entre varios hilos ("threads=N"); como la cabeza es la llave módulo el tamaño, a cada hilo
+//...le toca un rango de llaves. Con arreglos cada elemento se busca en la otra tabla con la llave que ya tiene guardada; los chunks de las
+//...listas sólo guardan la huella, así que ahí la llave se calcula una vez por elemento recorrido y se reutiliza para buscar y colocar.
+//...Los hilos sólo leen las dos tablas y juntan los elementos del resultado; al final ya se sabe cuántos son, así que la tabla del
+//...resultado se reserva desde el principio con esa capacidad y se llena sin pasar por checkSize (no hay Remodel a media operación)*/
+#define SET_UNION 1
+#define SET_INTERSECT 2
+#define SET_DIFF 3
+
+const char *SET_NAMES[] = {"", "Unión", "Intersección", "Diferencia"};
+
+/*Estructura de un elemento del resultado (el contenido apunta dentro de las tablas de origen)*/
+typedef struct{
+    uint32_t key;
+    record rec;
+}set_item_SC;
+
+/*Estructura de cada hilo de una operación de conjuntos*/
+typedef struct{
+    pthread_t thread;
+    int mode;                   //LL o AR
+    void *scan;                 //Tabla que se recorre
+    void *probe;                //Tabla donde se busca cada elemento (NULL = quedarse con todos)
+    int keep;                   //YES: quedarse con los que están en "probe"; NO: con los que no están
+    int collect;                //NO si sólo se cuenta
+    size_t begin;               //Rango de cabezas de "scan"
+    size_t end;
+    set_item_SC *out;
+    size_t n_out;
+    size_t cap_out;
+}set_worker_SC;
+
+/*Función para obtener la semilla de una tabla de cualquiera de las dos estrategias*/
+static inline uint64_t tableSeedSC(void *HT, int mode){
+    return (mode==LL) ? ((HTable_SC*)HT)->seed : ((HTable_SCA*)HT)->seed;
+}
+
+/*Función para obtener la llave de un elemento (calculada con la semilla "seed") en la tabla HT (sólo se recalcula si las semillas difieren)*/
+static inline uint32_t itemKeySC(void *HT, int mode, set_item_SC *item, uint64_t seed){
+    uint64_t own = tableSeedSC(HT, mode);
+    return (own == seed) ? item->key : seededKey(own, (unsigned char*)item->rec.bytes, item->rec.len);
+}
+
+/*Función para saber si un record (con su llave ya calculada con la semilla "seed") está en una tabla de la estrategia "mode"*/
+static inline int containsItemSC(void *HT, int mode, set_item_SC *item, uint64_t seed){
+    uint32_t key = itemKeySC(HT, mode, item, seed);
+    if(mode==LL){
+        size_t slot;
+        HTable_SC *T = (HTable_SC*)HT;
+        return (HTfindkey_SC(&T, key, &(item->rec), &slot) != NULL);
     }
-    else{
-        mode = atoi(argv[1]);
+    return (HTfindRecordKey_SCA((HTable_SCA*)HT, key, &(item->rec)) != NOT_FOUND);
+}
+
+/*Función para decidir si un elemento va en el resultado y, si es así, agregarlo a la lista del hilo*/
+void setKeepItemSC(set_worker_SC *W, set_item_SC *item){
+    if(W->probe != NULL && containsItemSC(W->probe, W->mode, item, tableSeedSC(W->scan, W->mode)) != W->keep)
+        return;
+    if(W->collect){
+        if(W->n_out == W->cap_out){
+            size_t cap = (W->cap_out == 0) ? 64 : W->cap_out*2;
+            set_item_SC *out = (set_item_SC*)realloc(W->out, sizeof(set_item_SC)*cap);
+            if(out == NULL){
+                fprintf(stderr, "Cannot allocate memory for set operation.\n");
+                exit(1);
+            }
+            W->out = out;
+            W->cap_out = cap;
+        }
+        W->out[W->n_out] = *item;
     }
-    switch(mode)
-    {
-    case LL:
-        HTable_SC *HT = newHTable_SC();
-        record rec;
-        char buffer[100];
-        while(fgets(buffer, 100, stdin) != NULL){
-                char command[100] = " ";
-                char number[100] = " ";
-                sscanf(buffer, "%s %s", command, number);     //Recuerda usar el espacio para separar
-                rec.bytes = number;
-                rec.len = strlen(number);
-                if(strcmp("insert", command)==0){               //Insertar
-                    HTinsertRecord_SC(&HT, &rec);
-                    continue;
-                }
-                if(strcmp("delete", command)==0){               //Borrar
-                    HTdeleteRecord(&HT, &rec);
-                    continue;
-                }
-                if(strcmp("stop", command)==0){                 //Parar (crea un ciclo infinito para medir memoria en servidor)
-                    size_t i = 0;
-                    while(i<1){
-                        continue;}
-                    continue;
-                }
-                if(strcmp("print", command)==0){                //Imprimir
-                    HTprint_SC(HT);
-                    continue;
+    W->n_out++;
+}
+
+/*Función que ejecuta cada hilo: recorre las cabezas de su rango*/
+void* setWorkerSC(void *arg){
+    set_worker_SC *W = (set_worker_SC*)arg;
+    set_item_SC item;
+    for(size_t i=W->begin; i<W->end; i++){
+        if(W->mode==LL){
+            LLHash *current = &(((HTable_SC*)W->scan)->table[i]);
+            while(current != NULL){
+                for(size_t s=0; s<CHUNK_SLOTS; s++){
+                    if(current->fp[s] == 0)
+                        continue;
+                    item.rec.bytes = current->bytes[s];
+                    item.rec.len = current->lens[s];
+                    item.key = keySC((HTable_SC*)W->scan, &(item.rec));
+                    setKeepItemSC(W, &item);
                 }
-                if(strcmp("count", command)==0){              //Imprimir no. de elementos en la tabla
-                    printf("Elementos ocupados: %ld\n", HT->occupied_elements);
-		    continue;
-		}
-	        if(strcmp("exit", command)==0){                 //Salir
-                    break;}
-        }
-        freeHTable_SC(HT);
+                current = current->next;
+            }
+        }
+        else{
+            AHead *head = &(((HTable_SCA*)W->scan)->table[i]);
+            for(size_t j=0; j<head->len; j++){
+                item.key = head->keys[j];
+                item.rec.bytes = AHeadBytes(head)[j];
+                item.rec.len = AHeadLens(head)[j];
+                setKeepItemSC(W, &item);
+            }
+        }
+    }
+    return NULL;
+}
+
+/*Funciones para obtener el tamaño y el No. de elementos de una tabla de cualquiera de las dos estrategias*/
+static inline size_t tableSizeSC(void *HT, int mode){
+    return (mode==LL) ? ((HTable_SC*)HT)->size : ((HTable_SCA*)HT)->size;
+}
+static inline size_t tableCountSC(void *HT, int mode){
+    return (mode==LL) ? ((HTable_SC*)HT)->occupied_elements : ((HTable_SCA*)HT)->occupied_elements;
+}
+
+/*Función para recorrer "scan" con "threads" hilos (el primero es el hilo actual); cada uno deja su parte del resultado en W[t]*/
+void runSetWorkersSC(set_worker_SC *W, int threads, int mode, void *scan, void *probe, int keep, int collect){
+    size_t size = tableSizeSC(scan, mode);
+    for(int t=0; t<threads; t++){
+        W[t].mode = mode;
+        W[t].scan = scan;
+        W[t].probe = probe;
+        W[t].keep = keep;
+        W[t].collect = collect;
+        W[t].begin = size*t/threads;
+        W[t].end = size*(t+1)/threads;
+        W[t].out = NULL;
+        W[t].n_out = 0;
+        W[t].cap_out = 0;
+    }
+    W[0].thread = pthread_self();
+    for(int t=1; t<threads; t++){
+        if(pthread_create(&W[t].thread, NULL, setWorkerSC, &W[t]) != 0){
+            //Si no se pudo crear el hilo, su rango se recorre aquí mismo
+            setWorkerSC(&W[t]);
+            W[t].thread = pthread_self();
+        }
+    }
+    setWorkerSC(&W[0]);
+    for(int t=1; t<threads; t++){
+        if(!pthread_equal(W[t].thread, pthread_self()))
+            pthread_join(W[t].thread, NULL);
+    }
+}
+
+/*Función para calcular "A op B" con "threads" hilos. Regresa el No. de elementos del resultado y, si "result" no es NULL, deja ahí
+//...una tabla nueva (de la estrategia "mode") con ellos. A y B no se modifican*/
+size_t HTsetOperation_SC(void *A, void *B, int op, int mode, int threads, void **result){
+    if(threads < 1)
+        threads = 1;
+    int collect = (result != NULL) ? YES : NO;
+    set_worker_SC *W = (set_worker_SC*)calloc(2*threads, sizeof(set_worker_SC));
+    if(W == NULL){
+        fprintf(stderr, "Cannot allocate memory for set operation.\n");
+        exit(1);
+    }
+    int passes = 1;
+    switch (op)
+    {
+    case SET_UNION:
+        //Todos los de A y los de B que no están en A
+        runSetWorkersSC(W, threads, mode, A, NULL, YES, collect);
+        runSetWorkersSC(W+threads, threads, mode, B, A, NO, collect);
+        passes = 2;
         break;
-    case AR:
-        HTable_SCA *HT2 = newHTable_SCA();
-        record rec2;
-        char buffer2[100];
-        while(fgets(buffer2, 100, stdin) != NULL){
-                char command[100] = " ";
-                char number[100] = " ";
-                sscanf(buffer2, "%s %s", command, number);     //Recuerda usar el espacio para separar
-                //char Data0[21];
-                rec2.bytes = number;
-                rec2.len = strlen(number);
-                if(strcmp("insert", command)==0){
-                    HTinsertRecord_SCA(&HT2, &rec2);
-                    continue;
-                }
-                if(strcmp("delete", command)==0){
-                    HTdeleteRecordSCA(&HT2, &rec2);
-                    continue;
+    case SET_INTERSECT:
+        //Se recorre la tabla con menos elementos y se busca en la otra
+        if(tableCountSC(A, mode) <= tableCountSC(B, mode))
+            runSetWorkersSC(W, threads, mode, A, B, YES, collect);
+        else
+            runSetWorkersSC(W, threads, mode, B, A, YES, collect);
+        break;
+    case SET_DIFF:
+        runSetWorkersSC(W, threads, mode, A, B, NO, collect);
+        break;
+    default:
+        free(W);
+        return 0;
+    }
+    size_t count = 0;
+    for(int t=0; t<passes*threads; t++)
+        count += W[t].n_out;
+    if(collect){
+        //La capacidad del resultado es la menor en la que "count" elementos no llenan la tabla (los límites de checkSize y checkSizeSCA;
+        //...con listas también cuentan los espacios del chunk incrustado en cada cabeza)
+        size_t index = 0;
+        while(index+1 < sizeof(HASH_SIZE)/sizeof(HASH_SIZE[0])){
+            size_t size = HASH_SIZE[index];
+            size_t needed = (mode==LL) ? count + CHUNK_SLOTS*size : count;
+            if(size*size > needed)
+                break;
+            index++;
+        }
+        //El resultado usa la semilla de A (a sus elementos no hay que recalcularles la llave)
+        if(mode==LL){
+            HTable_SC *HT = newHTableCap_SC(index);
+            HT->seed = tableSeedSC(A, mode);
+            for(int t=0; t<passes*threads; t++){
+                uint64_t seed = tableSeedSC(W[t].scan, mode);
+                for(size_t i=0; i<W[t].n_out; i++)
+                    placeRecordSC(HT, itemKeySC(HT, mode, &(W[t].out[i]), seed), &(W[t].out[i].rec));
+            }
+            *result = HT;
+        }
+        else{
+            HTable_SCA *HT = newHTableCap_SCA(index);
+            HT->seed = tableSeedSC(A, mode);
+            for(int t=0; t<passes*threads; t++){
+                uint64_t seed = tableSeedSC(W[t].scan, mode);
+                for(size_t i=0; i<W[t].n_out; i++)
+                    placeRecordSCA(HT, itemKeySC(HT, mode, &(W[t].out[i]), seed), &(W[t].out[i].rec));
+            }
+            *result = HT;
+        }
+    }
+    for(int t=0; t<passes*threads; t++)
+        free(W[t].out);
+    free(W);
+    return count;
+}
+
+/*Función para saber si un comando es una operación de conjuntos (regresa su tipo o 0)*/
+int setOperationCode(const char *command){
+    if(strcmp("union", command)==0)
+        return SET_UNION;
+    if(strcmp("intersect", command)==0)
+        return SET_INTERSECT;
+    if(strcmp("diff", command)==0)
+        return SET_DIFF;
+    return 0;
+}
+
+/*Funciones para crear y liberar una tabla de cualquiera de las dos estrategias*/
+void* newHTableMode_SC(int mode){
+    if(mode==LL)
+        return newHTable_SC();
+    return newHTable_SCA();
+}
+void freeHTableMode_SC(void *HT, int mode){
+    if(mode==LL)
+        freeHTable_SC((HTable_SC*)HT);
+    else
+        freeHTable_SCA((HTable_SCA*)HT);
+}
+
+/*Función para leer la otra tabla de las operaciones de conjuntos desde un archivo de comandos (sólo se atienden "insert" y "delete")*/
+void* loadHTable_SC(const char *path, int mode){
+    FILE *file = fopen(path, "r");
+    if(file == NULL){
+        fprintf(stderr, "Cannot open %s\n", path);
+        return NULL;
+    }
+    void *HT = newHTableMode_SC(mode);
+    char buffer[100];
+    while(fgets(buffer, 100, file) != NULL){
+        char command[100] = " ";
+        char number[100] = " ";
+        sscanf(buffer, "%99s %99s", command, number);
+        record rec;
+        rec.bytes = number;
+        rec.len = strlen(number);
+        if(strcmp("insert", command)==0){
+            if(mode==LL)
+                HTinsertRecord_SC((HTable_SC**)&HT, &rec);
+            else
+                HTinsertRecord_SCA((HTable_SCA**)&HT, &rec);
+        }
+        if(strcmp("delete", command)==0){
+            if(mode==LL)
+                HTdeleteRecord((HTable_SC**)&HT, &rec);
+            else
+                HTdeleteRecordSCA((HTable_SCA**)&HT, &rec);
+        }
+    }
+    fclose(file);
+    return HT;
+}
+
+/*Función para atender los comandos de conjuntos. "load archivo" lee la otra tabla; "union", "intersect" y "diff" la combinan con "HT"
+//...(con "count" sólo se cuenta; si no, el resultado reemplaza a "HT"). Regresa NO si el comando no es de conjuntos*/
+int setCommandSC(void **HT, void **other, int mode, char *command, char *number, int threads){
+    if(strcmp("load", command)==0){
+        void *loaded = loadHTable_SC(number, mode);
+        if(loaded != NULL){
+            if(*other != NULL)
+                freeHTableMode_SC(*other, mode);
+            *other = loaded;
+        }
+        return YES;
+    }
+    int op = setOperationCode(command);
+    if(op == 0)
+        return NO;
+    //Sin "load" la otra tabla está vacía
+    if(*other == NULL)
+        *other = newHTableMode_SC(mode);
+    int count_only = (strcmp("count", number)==0);
+    void *result = NULL;
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    size_t count = HTsetOperation_SC(*HT, *other, op, mode, threads, count_only ? NULL : &result);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    if(result != NULL){
+        freeHTableMode_SC(*HT, mode);
+        *HT = result;
+    }
+    printf("%s: %zu elementos (%.3f ms, %d hilos)\n", SET_NAMES[op], count,
+           (end.tv_sec - start.tv_sec)*1e3 + (end.tv_nsec - start.tv_nsec)/1e6, (threads < 1) ? 1 : threads);
+    return YES;
+}
+
+/*Función para saber si un comando es de lotes*/
+int isBatchCommand(const char *command){
+    return strcmp("insertall", command)==0 || strcmp("findall", command)==0;
+}
+
+/*Función para insertar o buscar un lote en cualquiera de las dos estrategias. Regresa cuántos se insertaron (o cuántos estaban)*/
+size_t runBatchSC(void **HT, int mode, int insert, record *recs, size_t n){
+    if(mode==LL)
+        return insert ? HTinsertBatch_SC((HTable_SC**)HT, recs, n) : HTfindBatch_SC((HTable_SC**)HT, recs, n);
+    return insert ? HTinsertBatch_SCA((HTable_SCA**)HT, recs, n) : HTfindBatch_SCA((HTable_SCA**)HT, recs, n);
+}
+
+/*Función para atender "insertall archivo" y "findall archivo" en las dos estrategias: inserta o busca por lotes (HASH_BATCH a la vez)
+//...las llaves de un archivo (de cada línea se toma la última palabra). Regresa NO si el comando no es de lotes*/
+int batchCommandSC(void **HT, int mode, char *command, char *number){
+    if(!isBatchCommand(command))
+        return NO;
+    int insert = (strcmp("insertall", command)==0);
+    FILE *file = fopen(number, "r");
+    if(file == NULL){
+        fprintf(stderr, "Cannot open %s\n", number);
+        return YES;
+    }
+    char (*keys)[100] = (char(*)[100])memMalloc(MEM_NODES, HASH_BATCH*100);
+    if(keys == NULL){
+        fprintf(stderr, "Cannot allocate memory for batch!\n");
+        fclose(file);
+        return YES;
+    }
+    record recs[HASH_BATCH];
+    char line[200];
+    size_t n = 0, total = 0, done = 0;
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    while(fgets(line, sizeof(line), file) != NULL){
+        char first[100] = "", second[100] = "";
+        int words = sscanf(line, "%99s %99s", first, second);
+        if(words < 1)
+            continue;
+        strcpy(keys[n], (words == 2) ? second : first);
+        recs[n].bytes = keys[n];
+        recs[n].len = strlen(keys[n]);
+        if(++n == HASH_BATCH){
+            done += runBatchSC(HT, mode, insert, recs, n);
+            total += n;
+            n = 0;
+        }
+    }
+    done += runBatchSC(HT, mode, insert, recs, n);
+    total += n;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("%s: %zu de %zu (%.3f ms)\n", insert ? "Insertados" : "Encontrados", done, total,
+           (end.tv_sec - start.tv_sec)*1e3 + (end.tv_nsec - start.tv_nsec)/1e6);
+    memFree(MEM_NODES, keys, HASH_BATCH*100);
+    fclose(file);
+    return YES;
+}
+
+/*............................................LLAVES ENTERAS..............................................................................*/
+/*Cuando las llaves son números, no hace falta guardar records ni calcular adler32 sobre su texto: cada cabeza guarda directamente un
+//...arreglo de llaves (uint32_t o uint64_t), mezcladas con una función de enteros y sin reservar memoria por elemento.
+//...Las tablas se generan con una macro para cada ancho de llave*/
+
+/*Macro que genera la tabla de llaves enteras "HTable_SC<S>" con llaves del tipo KEY_T mezcladas con MIX (con la semilla de la tabla)*/
+#define DEFINE_HTABLE_SC_INT(S, KEY_T, MIX)                                                                                             \
+typedef struct{                                                                                                                         \
+    uint32_t len;               /*No. de llaves en el arreglo (al borrar se recorre la última a su lugar)*/                            \
+    uint32_t cap;               /*Capacidad reservada (se duplica cada vez que se llena)*/                                             \
+    KEY_T *keys;                /*Arreglo de llaves*/                                                                                   \
+}IHead##S;                                                                                                                              \
+                                                                                                                                        \
+typedef struct{                                                                                                                         \
+    IHead##S *table;            /*Arreglo de cabezas*/                                                                                  \
+    size_t index_size;          /*Índice del tipo de capacidad*/                                                                        \
+    size_t size;                /*Tamaño del arreglo*/                                                                                  \
+    size_t occupied_elements;   /*Cantidad de elementos ocupados en la tabla*/                                                          \
+    size_t reserved_elements;   /*Suma de las capacidades de las cabezas (para no recorrerlas al borrar)*/                              \
+    uint64_t seed;              /*Semilla con la que se mezclan las llaves*/                                                            \
+    int sip;                    /*YES si ya se resembró y las llaves pasan por SipHash*/                                                \
+    size_t reseed_floor;        /*No se vuelve a resembrar hasta tener al menos estos elementos*/                                       \
+    int flooded;                /*YES si la última inserción cayó en un arreglo anormalmente largo*/                                    \
+}HTable_SC##S;                                                                                                                          \
+                                                                                                                                        \
+/*Función para hacer una nueva tabla de llaves enteras (con CALLOC todas las cabezas empiezan vacías)*/                                 \
+HTable_SC##S* newHTableCap_SC##S(size_t index){                                                                                         \
+    HTable_SC##S *HT = (HTable_SC##S*)memMalloc(MEM_TABLE, sizeof(HTable_SC##S)*1);                                                     \
+    if(HT == NULL){                                                                                                                     \
+        fprintf(stderr, "Cannot allocate memory for table.");                                                                           \
+        exit(1);                                                                                                                        \
+    }                                                                                                                                   \
+    HT->table = (IHead##S*)allocTableArray(HASH_SIZE[index]*sizeof(IHead##S));                                                          \
+    if(HT->table == NULL){                                                                                                              \
+        fprintf(stderr, "Cannot allocate memory for table.");                                                                           \
+        exit(1);                                                                                                                        \
+    }                                                                                                                                   \
+    HT->size = HASH_SIZE[index];                                                                                                        \
+    HT->index_size = index;                                                                                                             \
+    HT->occupied_elements = 0;                                                                                                          \
+    HT->reserved_elements = 0;                                                                                                          \
+    HT->seed = tableSeed();                                                                                                             \
+    HT->sip = NO;                                                                                                                       \
+    HT->reseed_floor = 0;                                                                                                               \
+    HT->flooded = NO;                                                                                                                   \
+    return HT;                                                                                                                          \
+}                                                                                                                                       \
+                                                                                                                                        \
+HTable_SC##S* newHTable_SC##S(){                                                                                                        \
+    return newHTableCap_SC##S(0);                                                                                                       \
+}                                                                                                                                       \
+                                                                                                                                        \
+void freeHTable_SC##S(HTable_SC##S *HT){                                                                                                \
+    for(size_t i=0; i<HT->size; i++)                                                                                                    \
+        memFree(MEM_NODES, HT->table[i].keys, HT->table[i].cap*sizeof(KEY_T));                                                          \
+    freeTableArray(HT->table, HT->size*sizeof(IHead##S));                                                                               \
+    memFree(MEM_TABLE, HT, sizeof(HTable_SC##S));                                                                                       \
+}                                                                                                                                       \
+                                                                                                                                        \
+/*Función para colocar una llave que no está en la tabla (sin revisar el tamaño; marca la tabla si el arreglo ya es muy largo)*/        \
+void placeKey_SC##S(HTable_SC##S *HT, KEY_T key){                                                                                       \
+    IHead##S *head = &(HT->table[MIX(HT->seed, HT->sip, key) % HT->size]);                                                              \
+    if(head->len == head->cap){                                                                                                         \
+        uint32_t cap = (head->cap == 0) ? 2 : head->cap*2;                                                                              \
+        KEY_T *keys = (KEY_T*)memRealloc(MEM_NODES, head->keys, head->cap*sizeof(KEY_T), cap*sizeof(KEY_T));                            \
+        if(keys == NULL){                                                                                                               \
+            fprintf(stderr, "Cannot allocate memory for element!\n");                                                                   \
+            return;                                                                                                                     \
+        }                                                                                                                               \
+        HT->reserved_elements += cap - head->cap;                                                                                       \
+        head->keys = keys;                                                                                                              \
+        head->cap = cap;                                                                                                                \
+    }                                                                                                                                   \
+    if(head->len > chainLimit(HT->occupied_elements, HT->size))                                                                         \
+        HT->flooded = YES;                                                                                                              \
+    head->keys[head->len++] = key;                                                                                                      \
+    HT->occupied_elements++;                                                                                                            \
+}                                                                                                                                       \
+                                                                                                                                        \
+/*Función para expandir, reducir o resembrar (RESEED) la tabla*/                                                                        \
+HTable_SC##S* RemodelHTableCap_SC##S(HTable_SC##S *PreviousHT, int state){                                                              \
+    size_t newIndex = PreviousHT->index_size;                                                                                           \
+    if(state==FULL)                                                                                                                     \
+        newIndex+=1;                                                                                                                    \
+    if(state==EMPTY)                                                                                                                    \
+        newIndex-=1;                                                                                                                    \
+    assert(state!=0);                                                                                                                   \
+    size_t mark = memRemodelBegin();                                                                                                    \
+    HTable_SC##S *HT = newHTableCap_SC##S(newIndex);                                                                                    \
+    HT->seed = PreviousHT->seed;                                                                                                        \
+    HT->sip = PreviousHT->sip;                                                                                                          \
+    HT->reseed_floor = PreviousHT->reseed_floor;                                                                                        \
+    if(state==RESEED){                                  /*Otra semilla, y desde ahora con SipHash*/                                     \
+        HT->seed = randomSeed();                                                                                                        \
+        HT->sip = YES;                                                                                                                  \
+        HT->reseed_floor = 2*PreviousHT->occupied_elements;                                                                             \
+        __atomic_add_fetch(&flood_reseeds, 1, __ATOMIC_RELAXED);                                                                        \
+    }                                                                                                                                   \
+    for(size_t i=0; i<PreviousHT->size; i++){                                                                                           \
+        IHead##S *head = &(PreviousHT->table[i]);                                                                                       \
+        for(uint32_t j=0; j<head->len; j++)                                                                                             \
+            placeKey_SC##S(HT, head->keys[j]);                                                                                          \
+    }                                                                                                                                   \
+    freeHTable_SC##S(PreviousHT);                                                                                                       \
+    memRemodelEnd(mark);                                                                                                                \
+    return HT;                                                                                                                          \
+}                                                                                                                                       \
+                                                                                                                                        \
+/*Función para evaluar si la tabla está llena o vacía (mismas reglas que checkSizeSCA)*/                                                \
+int checkSizeSC##S(HTable_SC##S *HT, int operation){                                                                                    \
+    if((HT->occupied_elements>((HT->size)*(HT->size)))&&(operation==UP))                                                                \
+        return FULL;                                                                                                                    \
+    if((HT->occupied_elements<((HT->reserved_elements/4)+(hist*hist)))&&(operation==DOWN)&&(HT->index_size>0)){                         \
+        hist++;                                                                                                                         \
+        return EMPTY;                                                                                                                   \
+    }                                                                                                                                   \
+    return 0;                                                                                                                           \
+}                                                                                                                                       \
+                                                                                                                                        \
+/*Función para buscar una llave. Regresa su posición en el arreglo de su cabeza o NOT_FOUND*/                                           \
+size_t HTfindKey_SC##S(HTable_SC##S *HT, KEY_T key){                                                                                    \
+    IHead##S *head = &(HT->table[MIX(HT->seed, HT->sip, key) % HT->size]);                                                              \
+    for(uint32_t j=0; j<head->len; j++){                                                                                                \
+        if(head->keys[j] == key)                                                                                                        \
+            return j;                                                                                                                   \
+    }                                                                                                                                   \
+    return NOT_FOUND;                                                                                                                   \
+}                                                                                                                                       \
+                                                                                                                                        \
+/*Función para insertar una llave. Regresa YES si no estaba*/                                                                           \
+int HTinsertKey_SC##S(HTable_SC##S **HT, KEY_T key){                                                                                    \
+    if(HTfindKey_SC##S(*HT, key) != NOT_FOUND)                                                                                          \
+        return NO;                                                                                                                      \
+    if(checkSizeSC##S(*HT, UP)==FULL)                                                                                                   \
+        (*HT) = RemodelHTableCap_SC##S(*HT, FULL);                                                                                      \
+    placeKey_SC##S(*HT, key);                                                                                                           \
+    if(floodReseedDue(&(*HT)->flooded, (*HT)->occupied_elements, (*HT)->reseed_floor))                                                  \
+        (*HT) = RemodelHTableCap_SC##S(*HT, RESEED);                                                                                    \
+    return YES;                                                                                                                         \
+}                                                                                                                                       \
+                                                                                                                                        \
+/*Función para borrar una llave. Regresa YES si estaba*/                                                                                \
+int HTdeleteKey_SC##S(HTable_SC##S **HT, KEY_T key){                                                                                    \
+    size_t j = HTfindKey_SC##S(*HT, key);                                                                                               \
+    if(j == NOT_FOUND)                                                                                                                  \
+        return NO;                                                                                                                      \
+    IHead##S *head = &((*HT)->table[MIX((*HT)->seed, (*HT)->sip, key) % (*HT)->size]);                                                  \
+    head->keys[j] = head->keys[--head->len];                                                                                            \
+    (*HT)->occupied_elements--;                                                                                                         \
+    if(checkSizeSC##S(*HT, DOWN)==EMPTY)                                                                                                \
+        (*HT) = RemodelHTableCap_SC##S(*HT, EMPTY);                                                                                     \
+    return YES;                                                                                                                         \
+}                                                                                                                                       \
+                                                                                                                                        \
+/*Función para recorrer todas las llaves (sirve para pasarlas a otra tabla)*/                                                           \
+void HTforEachKey_SC##S(HTable_SC##S *HT, void (*fn)(uint64_t key, void *ctx), void *ctx){                                              \
+    for(size_t i=0; i<HT->size; i++){                                                                                                   \
+        IHead##S *head = &(HT->table[i]);                                                                                               \
+        for(uint32_t j=0; j<head->len; j++)                                                                                             \
+            fn((uint64_t)head->keys[j], ctx);                                                                                           \
+    }                                                                                                                                   \
+}                                                                                                                                       \
+                                                                                                                                        \
+/*Función para imprimir la tabla (cada llave con su mezcla entre corchetes, como la llave adler de los records)*/                        \
+void HTprint_SC##S(HTable_SC##S *HT){                                                                                                   \
+    for(size_t i=0; i<HT->size; i++){                                                                                                   \
+        printf("%ld ", i);                                                                                                              \
+        IHead##S *head = &(HT->table[i]);                                                                                               \
+        for(uint32_t j=0; j<head->len; j++)                                                                                             \
+            printf("%llu[%llu] ", (unsigned long long)head->keys[j], (unsigned long long)MIX(HT->seed, HT->sip, head->keys[j]));                           \
+        printf("\n");                                                                                                                   \
+    }                                                                                                                                   \
+    printf("\n");                                                                                                                       \
+}
+
+DEFINE_HTABLE_SC_INT(32, uint32_t, seededMix32)
+DEFINE_HTABLE_SC_INT(64, uint64_t, seededMix64)
+
+/*Estructura con las tablas de llaves enteras que usa el programa mientras todas las llaves sean números*/
+typedef struct{
+    int width;                  //32 o 64 según la llave más grande vista; 0 si ya se pasó todo a la tabla de records
+    HTable_SC32 *HT32;
+    HTable_SC64 *HT64;
+}int_tables_SC;
+
+/*Funciones para pasar una llave de una tabla entera a otra más ancha o a una tabla de records (de listas o de arreglos)*/
+void moveKeyToSC64(uint64_t key, void *ctx){
+    HTinsertKey_SC64((HTable_SC64**)ctx, key);
+}
+void moveKeyToSC(uint64_t key, void *ctx){
+    char number[21];
+    record rec;
+    rec.bytes = number;
+    rec.len = (size_t)sprintf(number, "%llu", (unsigned long long)key);
+    HTinsertRecord_SC((HTable_SC**)ctx, &rec);
+}
+void moveKeyToSCA(uint64_t key, void *ctx){
+    char number[21];
+    record rec;
+    rec.bytes = number;
+    rec.len = (size_t)sprintf(number, "%llu", (unsigned long long)key);
+    HTinsertRecord_SCA((HTable_SCA**)ctx, &rec);
+}
+
+/*Función para empezar con la tabla de llaves de 32 bits*/
+void initIntTablesSC(int_tables_SC *IT){
+    IT->width = 32;
+    IT->HT32 = newHTable_SC32();
+    IT->HT64 = NULL;
+}
+
+/*Función para liberar las tablas enteras (si todavía se usan)*/
+void freeIntTablesSC(int_tables_SC *IT){
+    if(IT->HT32 != NULL)
+        freeHTable_SC32(IT->HT32);
+    if(IT->HT64 != NULL)
+        freeHTable_SC64(IT->HT64);
+    IT->HT32 = NULL;
+    IT->HT64 = NULL;
+    IT->width = 0;
+}
+
+/*Función para atender un comando con las tablas enteras. Regresa NO si el comando lo debe atender la tabla de records*/
+/*NOTA: la primera inserción de algo que no es número (o la primera operación de conjuntos) pasa todas las llaves con "move" a la tabla
+//...de records "HT";
+//...una llave de más de 32 bits pasa todo a la tabla de 64*/
+int intCommandSC(int_tables_SC *IT, char *command, char *number, void (*move)(uint64_t key, void *ctx), void *HT){
+    if(IT->width == 0)
+        return NO;
+    //Las operaciones de conjuntos y las de lotes son sobre la tabla de records, así que antes se pasan ahí todas las llaves
+    if(setOperationCode(command) != 0 || isBatchCommand(command)){
+        if(IT->width == 32)
+            HTforEachKey_SC32(IT->HT32, move, HT);
+        else
+            HTforEachKey_SC64(IT->HT64, move, HT);
+        freeIntTablesSC(IT);
+        return NO;
+    }
+    int insert = (strcmp("insert", command)==0);
+    if(insert || strcmp("delete", command)==0){
+        uint64_t key;
+        if(parseIntKey(number, &key)==NO){
+            if(!insert)
+                return YES;             //Lo que no es número no puede estar en las tablas enteras
+            if(IT->width == 32)
+                HTforEachKey_SC32(IT->HT32, move, HT);
+            else
+                HTforEachKey_SC64(IT->HT64, move, HT);
+            freeIntTablesSC(IT);
+            return NO;
+        }
+        if(IT->width == 32 && key > UINT32_MAX){
+            if(!insert)
+                return YES;
+            IT->HT64 = newHTable_SC64();
+            HTforEachKey_SC32(IT->HT32, moveKeyToSC64, &IT->HT64);
+            freeHTable_SC32(IT->HT32);
+            IT->HT32 = NULL;
+            IT->width = 64;
+        }
+        if(IT->width == 32){
+            if(insert)
+                HTinsertKey_SC32(&IT->HT32, (uint32_t)key);
+            else
+                HTdeleteKey_SC32(&IT->HT32, (uint32_t)key);
+        }
+        else{
+            if(insert)
+                HTinsertKey_SC64(&IT->HT64, key);
+            else
+                HTdeleteKey_SC64(&IT->HT64, key);
+        }
+        return YES;
+    }
+    if(strcmp("find", command)==0){
+        //Lo que no es número (o no cabe en la tabla actual) no puede estar en las tablas enteras
+        uint64_t key;
+        int found = NO;
+        if(parseIntKey(number, &key)==YES){
+            if(IT->width == 32)
+                found = (key <= UINT32_MAX && HTfindKey_SC32(IT->HT32, (uint32_t)key) != NOT_FOUND);
+            else
+                found = (HTfindKey_SC64(IT->HT64, key) != NOT_FOUND);
+        }
+        if(found)
+            printf("Encontrado: %s\n", number);
+        else
+            printf("No encontrado: %s\n", number);
+        return YES;
+    }
+    if(strcmp("print", command)==0){
+        if(IT->width == 32)
+            HTprint_SC32(IT->HT32);
+        else
+            HTprint_SC64(IT->HT64);
+        return YES;
+    }
+    if(strcmp("count", command)==0){
+        printf("Elementos ocupados: %ld\n", (IT->width == 32) ? IT->HT32->occupied_elements : IT->HT64->occupied_elements);
+        return YES;
+    }
+    return NO;
+}
+
+/*...............................................TRAZAS..................................................................................*/
+/*La grabación y la repetición de trazas están en ht_common.c; aquí sólo van los motores de cada tabla*/
+
+/*Motores de la repetición: listas ligadas (LL) y arreglos (AR)*/
+void* replayCreate_SC(size_t mode){
+    (void)mode;
+    return newHTable_SC();
+}
+void replayDestroy_SC(void *HT){
+    freeHTable_SC((HTable_SC*)HT);
+}
+void replayInsert_SC(void **HT, record *rec, size_t mode){
+    (void)mode;
+    HTinsertRecord_SC((HTable_SC**)HT, rec);
+}
+void replayDelete_SC(void **HT, record *rec, size_t mode){
+    (void)mode;
+    HTdeleteRecord((HTable_SC**)HT, rec);
+}
+void replayFind_SC(void **HT, record *rec, size_t mode){
+    (void)mode;
+    size_t slot;
+    HTfindRecord_SC((HTable_SC**)HT, rec, &slot);
+}
+size_t replayCount_SC(void *HT){
+    return ((HTable_SC*)HT)->occupied_elements;
+}
+const replay_engine REPLAY_SC = {replayCreate_SC, replayDestroy_SC, replayInsert_SC, replayDelete_SC, replayFind_SC, replayCount_SC};
+
+void* replayCreate_SCA(size_t mode){
+    (void)mode;
+    return newHTable_SCA();
+}
+void replayDestroy_SCA(void *HT){
+    freeHTable_SCA((HTable_SCA*)HT);
+}
+void replayInsert_SCA(void **HT, record *rec, size_t mode){
+    (void)mode;
+    HTinsertRecord_SCA((HTable_SCA**)HT, rec);
+}
+void replayDelete_SCA(void **HT, record *rec, size_t mode){
+    (void)mode;
+    HTdeleteRecordSCA((HTable_SCA**)HT, rec);
+}
+void replayFind_SCA(void **HT, record *rec, size_t mode){
+    (void)mode;
+    HTfindRecord_SCA((HTable_SCA**)HT, rec);
+}
+size_t replayCount_SCA(void *HT){
+    return ((HTable_SCA*)HT)->occupied_elements;
+}
+const replay_engine REPLAY_SCA = {replayCreate_SCA, replayDestroy_SCA, replayInsert_SCA, replayDelete_SCA, replayFind_SCA, replayCount_SCA};
+
+/*...............................................ADAPTATIVA.................................................................................*/
+/*Con la opción "adapt" (o "adapt=archivo" para guardar el registro en un archivo; si no, va a stderr) la tabla escoge sola si guarda
+//...sus cubetas como listas ligadas de chunks (LL) o como arreglos (AR); la estrategia del primer argumento sólo es con la que empieza.
+//...Una de cada ADAPT_SAMPLE operaciones se mide en la cubeta de su llave: cuántos elementos tiene, cuántos espacios tiene reservados (en
+//...las listas, los huecos que dejan los borrados alargan el recorrido) y cuántas líneas de caché recorrió la búsqueda. Cada vez que la
+//...tabla se redimensiona se predice el costo de las dos formas con esos datos (líneas por operación: en la lista cada chunk es un salto
+//...de puntero; en el arreglo se lee la cabeza y después las llaves seguidas, 16 por línea, que el prefetcher ya trae) y la predicción
+//...de la forma actual se corrige con lo que de verdad se midió. Si la otra cuesta a lo más ADAPT_SWITCH de la actual, la tabla nueva se
+//...pasa a la otra forma moviendo los punteros (sin copiar contenidos). Cada decisión se escribe en el registro con sus datos*/
+#define ADAPT_SAMPLE 16                 //Se mide una de cada tantas operaciones
+#define ADAPT_MIN_SAMPLES 32            //Muestras mínimas para decidir
+#define ADAPT_SWITCH 0.85               //Sólo se cambia de forma si la otra cuesta a lo más esto de la actual
+#define ADAPT_SEQ 0.25                  //Costo de una línea leída en secuencia respecto a un salto de puntero
+
+/*Estructura de la tabla adaptativa*/
+typedef struct{
+    void *HT;
+    int mode;                       //Forma actual (LL o AR)
+    FILE *log;                      //Registro de decisiones
+    size_t index_size;              //Índice de tamaño visto en la última operación (si cambia, hubo redimensión)
+    size_t ops;                     //Operaciones (para escoger las que se miden)
+    size_t samples;
+    size_t hits;                    //Operaciones medidas cuyo record sí estaba
+    double elements;                //Suma de los elementos de las cubetas medidas
+    double reserved;                //Suma de los espacios reservados de las cubetas medidas (sólo con listas)
+    double observed;                //Suma de las líneas recorridas por las búsquedas medidas
+    double fill;                    //Última proporción de espacios ocupados que se midió en las listas (1 si nunca se ha medido)
+    size_t resizes;
+    size_t switches;
+}HTable_SCD;
+
+/*Función para leer la opción "adapt" o "adapt=archivo". Regresa YES si era ésa*/
+int parseAdaptOption(int *adapt, const char **log, const char *arg){
+    if(strcmp(arg, "adapt")==0)
+        *adapt = YES;
+    else if(strncmp(arg, "adapt=", 6)==0){
+        *adapt = YES;
+        *log = arg + 6;
+    }
+    else
+        return NO;
+    return YES;
+}
+
+/*Función para crear una tabla adaptativa que empieza con la forma "mode"*/
+HTable_SCD* newHTable_SCD(int mode, const char *log){
+    HTable_SCD *A = (HTable_SCD*)memMalloc(MEM_TABLE, sizeof(HTable_SCD));
+    if(A == NULL){
+        fprintf(stderr, "Cannot allocate memory for table.");
+        exit(1);
+    }
+    memset(A, 0, sizeof(HTable_SCD));
+    A->HT = newHTableMode_SC(mode);
+    A->mode = mode;
+    A->fill = 1;
+    A->log = stderr;
+    if(log != NULL && (A->log = fopen(log, "w")) == NULL){
+        fprintf(stderr, "Cannot open %s\n", log);
+        A->log = stderr;
+    }
+    return A;
+}
+
+/*Función para liberar la tabla adaptativa (y cerrar su registro)*/
+void freeHTable_SCD(HTable_SCD *A){
+    if(A->log != stderr)
+        fclose(A->log);
+    freeHTableMode_SC(A->HT, A->mode);
+    memFree(MEM_TABLE, A, sizeof(HTable_SCD));
+}
+
+/*Función para medir la cubeta de un record: suma sus elementos, sus espacios reservados y las líneas que recorre su búsqueda*/
+void adaptSampleSC(HTable_SCD *A, record *rec){
+    if(++A->ops % ADAPT_SAMPLE != 0)
+        return;
+    uint32_t key = seededKey(tableSeedSC(A->HT, A->mode), (unsigned char*)rec->bytes, rec->len);
+    int hit = NO;
+    double lines = 0;
+    size_t elements = 0;
+    if(A->mode==LL){
+        HTable_SC *HT = (HTable_SC*)A->HT;
+        LLHead *head = &(HT->table[hashFunction(key, HT->size)]);
+        size_t slot;
+        LLHash *found = HTfindkey_SC(&HT, key, rec, &slot);
+        for(LLHash *chunk = head; chunk != NULL; chunk = chunk->next){
+            if(!hit)
+                lines++;                //Hasta encontrarlo (o hasta el final) se salta de chunk en chunk
+            if(chunk == found)
+                hit = YES;
+            for(size_t s=0; s<CHUNK_SLOTS; s++)
+                elements += (chunk->fp[s] != 0);
+        }
+        A->reserved += head->n;
+    }
+    else{
+        HTable_SCA *HT = (HTable_SCA*)A->HT;
+        AHead *head = &(HT->table[hashFunction(key, HT->size)]);
+        size_t i = HTfindRecordKey_SCA(HT, key, rec);
+        hit = (i != NOT_FOUND);
+        size_t scanned = hit ? i + 1 : head->len;
+        //La cabeza es un salto; las llaves se leen en secuencia (y si estaba, su puntero está en otra parte del bloque)
+        lines = 1 + ADAPT_SEQ*((scanned + 15)/16) + (hit ? 1 : 0);
+        elements = head->len;
+    }
+    A->samples++;
+    A->hits += hit;
+    A->elements += elements;
+    A->observed += lines;
+}
+
+/*Función para predecir las líneas por operación de una forma con "L" elementos por cubeta (medidos desde las operaciones), una
+//...proporción "fill" de espacios ocupados en las listas y una proporción "hit" de búsquedas exitosas*/
+double adaptCostSC(int mode, double L, double fill, double hit){
+    if(mode==LL){
+        //Una búsqueda fallida recorre todos los chunks; una exitosa, la mitad (al menos el de la cabeza)
+        double chunks = L/(CHUNK_SLOTS*fill);
+        if(chunks < 1)
+            chunks = 1;
+        return hit*(chunks + 1)/2 + (1 - hit)*chunks;
+    }
+    return 1 + ADAPT_SEQ*(hit*(L/2 + 16)/16 + (1 - hit)*(L + 15)/16) + hit;
+}
+
+/*Función para pasar una tabla de listas a arreglos del mismo tamaño (se mueven los punteros; las llaves se vuelven a calcular con la
+//...misma semilla)*/
+HTable_SCA* convertToSCA(HTable_SC *PreviousHT){
+    size_t mark = memRemodelBegin();
+    HTable_SCA *HT = newHTableCap_SCA(PreviousHT->index_size);
+    HT->seed = PreviousHT->seed;
+    HT->reseed_floor = PreviousHT->reseed_floor;
+    //Las listas sólo guardan huellas, así que las llaves se calculan por lotes (si no se puede agrandar un arreglo, el contenido se
+    //...queda en la lista y se libera con ella)
+    moved_item_SC batch[HASH_BATCH];
+    size_t n = 0;
+    for(size_t i=0; i<PreviousHT->size; i++){
+        for(LLHash *chunk = &(PreviousHT->table[i]); chunk != NULL; chunk = chunk->next){
+            for(size_t s=0; s<CHUNK_SLOTS; s++){
+                if(chunk->fp[s] == 0)
+                    continue;
+                batch[n].bytes = chunk->bytes[s];
+                batch[n].len = chunk->lens[s];
+                batch[n].chunk = chunk;
+                batch[n].slot = s;
+                if(++n == HASH_BATCH){
+                    appendBatchSCA(HT, batch, n);
+                    n = 0;
+                }
+            }
+        }
+    }
+    appendBatchSCA(HT, batch, n);
+    freeHTable_SC(PreviousHT);
+    memRemodelEnd(mark);
+    return HT;
+}
+
+/*Función para pasar una tabla de arreglos a listas del mismo tamaño (se mueven los punteros y se reutilizan las llaves y la semilla)*/
+HTable_SC* convertToSC(HTable_SCA *PreviousHT){
+    size_t mark = memRemodelBegin();
+    HTable_SC *HT = newHTableCap_SC(PreviousHT->index_size);
+    HT->seed = PreviousHT->seed;
+    HT->reseed_floor = PreviousHT->reseed_floor;
+    for(size_t i=0; i<PreviousHT->size; i++){
+        AHead *head = &(PreviousHT->table[i]);
+        //Lo que no se pueda enlazar se recorre al principio del arreglo, para que se libere con la tabla antigua
+        size_t kept = 0;
+        for(size_t j=0; j<head->len; j++){
+            if(linkRecordSC(HT, head->keys[j], AHeadBytes(head)[j], AHeadLens(head)[j]) != NULL)
+                continue;
+            head->keys[kept] = head->keys[j];
+            AHeadBytes(head)[kept] = AHeadBytes(head)[j];
+            AHeadLens(head)[kept] = AHeadLens(head)[j];
+            kept++;
+        }
+        head->len = kept;
+    }
+    HT->flooded = NO;
+    freeHTable_SCA(PreviousHT);
+    memRemodelEnd(mark);
+    return HT;
+}
+
+/*Función para decidir la forma después de una redimensión (la tabla ya tiene su tamaño nuevo)*/
+void adaptResizeSC(HTable_SCD *A, size_t old_index){
+    int old_mode = A->mode;
+    size_t index = (A->mode==LL) ? ((HTable_SC*)A->HT)->index_size : ((HTable_SCA*)A->HT)->index_size;
+    A->resizes++;
+    fprintf(A->log, "redimensión %zu: %s %u -> %u (elementos %zu); ", A->resizes, (index > old_index) ? "crece" : "se reduce",
+            HASH_SIZE[old_index], HASH_SIZE[index], tableCountSC(A->HT, A->mode));
+    if(A->samples < ADAPT_MIN_SAMPLES){
+        fprintf(A->log, "medido %s: %zu muestras (pocas, no se decide); forma %s\n", (A->mode==LL) ? "LL" : "AR", A->samples,
+                (A->mode==LL) ? "LL" : "AR");
+    }
+    else{
+        //Los elementos por cubeta se escalan al tamaño nuevo (las mismas llaves se reparten entre más o menos cubetas)
+        double L = (A->elements/A->samples)*HASH_SIZE[old_index]/HASH_SIZE[index];
+        double hit = (double)A->hits/A->samples;
+        if(A->mode==LL && A->reserved > 0)
+            A->fill = A->elements/A->reserved;
+        double measured = A->observed/A->samples;
+        //La predicción de la forma actual se corrige con lo medido (con los datos de antes de redimensionar)
+        double L_old = A->elements/A->samples;
+        double kappa = measured/adaptCostSC(A->mode, L_old, A->fill, hit);
+        double cost[2];
+        cost[A->mode] = kappa*adaptCostSC(A->mode, L, A->fill, hit);
+        //Al convertir, las listas quedan compactas; si ya eran listas, siguen con los huecos que se midieron
+        cost[!A->mode] = adaptCostSC(!A->mode, L, (A->mode==LL) ? A->fill : 1, hit);
+        if(cost[!A->mode] < ADAPT_SWITCH*cost[A->mode]){
+            if(A->mode==LL)
+                A->HT = convertToSCA((HTable_SC*)A->HT);
+            else
+                A->HT = convertToSC((HTable_SCA*)A->HT);
+            A->mode = !A->mode;
+            A->switches++;
+        }
+        fprintf(A->log, "medido %s: %zu muestras, %.1f elementos por cubeta, %.0f%% ocupado en listas, %.0f%% aciertos, %.2f líneas/op "
+                "(kappa %.2f); predicción LL=%.2f AR=%.2f; forma %s -> %s\n", (old_mode==LL) ? "LL" : "AR", A->samples, L_old,
+                100*A->fill, 100*hit, measured, kappa, cost[LL], cost[AR], (old_mode==LL) ? "LL" : "AR", (A->mode==LL) ? "LL" : "AR");
+    }
+    fflush(A->log);
+    A->samples = 0;
+    A->hits = 0;
+    A->elements = 0;
+    A->reserved = 0;
+    A->observed = 0;
+}
+
+/*Función para revisar después de cada operación si la tabla se redimensionó (y entonces decidir la forma)*/
+static inline void adaptCheckSC(HTable_SCD *A){
+    size_t index = (A->mode==LL) ? ((HTable_SC*)A->HT)->index_size : ((HTable_SCA*)A->HT)->index_size;
+    if(index != A->index_size){
+        adaptResizeSC(A, A->index_size);
+        A->index_size = index;
+    }
+}
+
+/*Funciones para insertar, borrar y buscar en la tabla adaptativa*/
+void HTinsertRecord_SCD(HTable_SCD *A, record *rec){
+    adaptSampleSC(A, rec);
+    if(A->mode==LL)
+        HTinsertRecord_SC((HTable_SC**)&A->HT, rec);
+    else
+        HTinsertRecord_SCA((HTable_SCA**)&A->HT, rec);
+    adaptCheckSC(A);
+}
+void HTdeleteRecordSCD(HTable_SCD *A, record *rec){
+    adaptSampleSC(A, rec);
+    if(A->mode==LL)
+        HTdeleteRecord((HTable_SC**)&A->HT, rec);
+    else
+        HTdeleteRecordSCA((HTable_SCA**)&A->HT, rec);
+    adaptCheckSC(A);
+}
+int HTfindRecord_SCD(HTable_SCD *A, record *rec){
+    adaptSampleSC(A, rec);
+    if(A->mode==LL){
+        size_t slot;
+        return (HTfindRecord_SC((HTable_SC**)&A->HT, rec, &slot) != NULL) ? YES : NO;
+    }
+    return (HTfindRecord_SCA((HTable_SCA**)&A->HT, rec) != NOT_FOUND) ? YES : NO;
+}
+
+/*Función para imprimir el estado de la tabla adaptativa*/
+void HTstats_SCD(HTable_SCD *A){
+    printf("Adaptativa: forma %s, %zu redimensiones, %zu cambios de forma\n", (A->mode==LL) ? "LL" : "AR", A->resizes, A->switches);
+}
+
+/*..............................................HASH LINEAL...............................................................................*/
+/*Con la opción "linear" la tabla de listas (1) o de arreglos (0) crece con hashing lineal en vez de con Remodel. Hay dos niveles de la
+//...función hash (los bits bajos de la llave: LH_BASE << level cubetas y el doble) y un puntero de división ("split"): las cubetas antes
+//...del puntero ya se partieron y usan el nivel siguiente. Cuando el promedio de elementos por cubeta pasa de LH_MAX_LOAD sólo se parte
+//...la cubeta del puntero: lo que tiene encendido el siguiente bit de su llave pasa a una cubeta nueva al final, y el puntero avanza
+//...(al terminar el nivel, el nivel sube y el puntero vuelve a 0). Al borrar, si el promedio baja de LH_MIN_LOAD, la última cubeta se
+//...junta con la que la creó. Así la capacidad crece de cubeta en cubeta, las listas se mantienen cortas y nunca se rehace la tabla
+//...completa (salvo al resembrar por una lista anormalmente larga). Los contenidos sólo cambian de cubeta moviendo su puntero. Las
+//...cabezas viven en segmentos de LH_SEGMENT cabezas que nunca se mueven: al crecer se agrega un segmento y cuando el directorio de
+//...segmentos se llena se duplica (sólo se copian sus punteros). Las listas sólo guardan la huella, así que al partir una cubeta sus
+//...llaves se vuelven a calcular por lotes (ver HASH POR LOTES); los arreglos ya las tienen guardadas*/
+#define LH_BASE 16                          //Cubetas con las que empieza la tabla (potencia de 2)
+#define LH_SEGMENT_BITS 8
+#define LH_SEGMENT (1 << LH_SEGMENT_BITS)   //Cabezas por segmento
+#define LH_MAX_LOAD 4                       //Se parte una cubeta cuando el promedio de elementos por cubeta pasa de esto
+#define LH_MIN_LOAD 1                       //Se junta la última cubeta cuando el promedio baja de esto
+
+/*Estructura de la tabla con hashing lineal*/
+typedef struct{
+    void **segments;            //Directorio de segmentos (cada uno es un arreglo de LH_SEGMENT cabezas LLHead o AHead)
+    size_t segment_count;       //Segmentos reservados
+    size_t directory_cap;       //Capacidad del directorio
+    size_t level;               //Nivel actual: al empezarlo hay LH_BASE << level cubetas
+    size_t split;               //Siguiente cubeta por partir
+    size_t buckets;             //Cubetas en uso (LH_BASE << level más split)
+    size_t occupied_elements;   //Cantidad de elementos ocupados en la tabla
+    size_t splits;              //Cubetas partidas
+    size_t merges;              //Cubetas juntadas
+    int mode;                   //Forma de las cubetas (LL o AR)
+    uint64_t seed;              //Semilla de las llaves (ver LLAVES CON SEMILLA)
+    size_t reseed_floor;        //No se vuelve a resembrar hasta tener al menos estos elementos
+    int flooded;                //YES si la última inserción cayó en una cubeta anormalmente larga
+}HTable_SCL;
+
+/*Función para leer la opción "linear". Regresa YES si era ésa*/
+int parseLinearOption(int *linear, const char *arg){
+    if(strcmp(arg, "linear")!=0)
+        return NO;
+    *linear = YES;
+    return YES;
+}
+
+/*Función para el tamaño de una cabeza según la forma de las cubetas*/
+static inline size_t headSizeSCL(int mode){
+    return (mode==LL) ? sizeof(LLHead) : sizeof(AHead);
+}
+
+/*Función para sacar la cubeta de una llave: con el nivel actual y, si esa cubeta ya se partió, con el siguiente*/
+static inline size_t bucketSCL(HTable_SCL *HT, uint32_t key){
+    size_t bucket = key & ((LH_BASE << HT->level) - 1);
+    if(bucket < HT->split)
+        bucket = key & ((LH_BASE << (HT->level+1)) - 1);
+    return bucket;
+}
+
+/*Función para obtener la cabeza de una cubeta (su segmento y su posición dentro de él)*/
+static inline void* headSCL(HTable_SCL *HT, size_t bucket){
+    return (char*)HT->segments[bucket >> LH_SEGMENT_BITS] + (bucket & (LH_SEGMENT-1))*headSizeSCL(HT->mode);
+}
+
+/*Función para calcular la llave de un record con la semilla de la tabla*/
+static inline uint32_t keySCL(HTable_SCL *HT, record *rec){
+    return seededKey(HT->seed, (unsigned char*)rec->bytes, rec->len);
+}
+
+/*Función para agregar un segmento de cabezas vacías al final (si el directorio está lleno, se duplica). Regresa NO si no se pudo*/
+int addSegmentSCL(HTable_SCL *HT){
+    if(HT->segment_count == HT->directory_cap){
+        size_t cap = (HT->directory_cap == 0) ? 4 : 2*HT->directory_cap;
+        void **segments = (void**)memRealloc(MEM_TABLE, HT->segments, HT->directory_cap*sizeof(void*), cap*sizeof(void*));
+        if(segments == NULL){
+            fprintf(stderr, "Cannot allocate memory for table.\n");
+            return NO;
+        }
+        HT->segments = segments;
+        HT->directory_cap = cap;
+    }
+    void *segment = callocCacheLine(LH_SEGMENT, headSizeSCL(HT->mode), MEM_TABLE);
+    if(segment == NULL){
+        fprintf(stderr, "Cannot allocate memory for table.\n");
+        return NO;
+    }
+    //Cada cabeza de lista ya trae reservados los espacios de su chunk incrustado
+    if(HT->mode==LL){
+        for(size_t i=0; i<LH_SEGMENT; i++)
+            ((LLHead*)segment)[i].n = CHUNK_SLOTS;
+    }
+    HT->segments[HT->segment_count++] = segment;
+    return YES;
+}
+
+/*Función para reservar los segmentos de una tabla con "buckets" cubetas (sin salir si no se puede: la tabla se queda sin memoria)*/
+void reserveSegmentsSCL(HTable_SCL *HT){
+    while(HT->segment_count*LH_SEGMENT < HT->buckets){
+        if(addSegmentSCL(HT) == NO)
+            exit(1);
+    }
+}
+
+/*Función para hacer una nueva tabla con hashing lineal con cubetas de la forma "mode"*/
+HTable_SCL* newHTable_SCL(int mode){
+    HTable_SCL *HT = (HTable_SCL*)memMalloc(MEM_TABLE, sizeof(HTable_SCL));
+    if(HT == NULL){
+        fprintf(stderr, "Cannot allocate memory for table.");
+        exit(1);
+    }
+    memset(HT, 0, sizeof(HTable_SCL));
+    HT->mode = mode;
+    HT->buckets = LH_BASE;
+    HT->seed = tableSeed();
+    HT->flooded = NO;
+    reserveSegmentsSCL(HT);
+    return HT;
+}
+
+/*Función para liberar los segmentos y el directorio de una tabla (el contenido de las cubetas ya se liberó o se movió)*/
+void freeSegmentsSCL(HTable_SCL *HT){
+    for(size_t i=0; i<HT->segment_count; i++)
+        freeTableArray(HT->segments[i], LH_SEGMENT*headSizeSCL(HT->mode));
+    memFree(MEM_TABLE, HT->segments, HT->directory_cap*sizeof(void*));
+    HT->segments = NULL;
+    HT->segment_count = 0;
+    HT->directory_cap = 0;
+}
+
+/*Función para liberar la tabla con hashing lineal (cubeta por cubeta)*/
+void freeHTable_SCL(HTable_SCL *HT){
+    for(size_t b=0; b<HT->buckets; b++){
+        if(HT->mode==LL){
+            LLHead *head = (LLHead*)headSCL(HT, b);
+            freeLLHashSlots(head);
+            freeLLHashItem(head->next);
+        }
+        else
+            freeLLHashItemSCA((AHead*)headSCL(HT, b));
+    }
+    freeSegmentsSCL(HT);
+    memFree(MEM_TABLE, HT, sizeof(HTable_SCL));
+}
+
+/*Función para liberar los chunks de una lista que ya no tienen contenido (todos menos el incrustado en la cabeza)*/
+void freeChainChunksSCL(LLHash *chunk){
+    while(chunk != NULL){
+        LLHash *next = chunk->next;
+        memFree(MEM_NODES, chunk, sizeof(LLHash));
+        chunk = next;
+    }
+}
+
+/*Función para recorrer los contenidos de una lista hacia el principio (sin cambiar su orden) y liberar los chunks del final que quedaron
+//...vacíos (después de partir una cubeta la lista tiene huecos)*/
+void packChainSCL(LLHead *head){
+    LLHash *dest = head, *last = head;
+    size_t ds = 0;
+    for(LLHash *src = head; src != NULL; src = src->next){
+        for(size_t s=0; s<CHUNK_SLOTS; s++){
+            if(src->fp[s] == 0)
+                continue;
+            if(src != dest || s != ds){
+                dest->fp[ds] = src->fp[s];
+                dest->lens[ds] = src->lens[s];
+                dest->bytes[ds] = src->bytes[s];
+                src->fp[s] = 0;
+                src->lens[s] = 0;
+                src->bytes[s] = NULL;
+            }
+            last = dest;
+            if(++ds == CHUNK_SLOTS){
+                dest = dest->next;
+                ds = 0;
+            }
+        }
+    }
+    //Los chunks después del último contenido quedaron vacíos
+    for(LLHash *chunk = last->next; chunk != NULL; chunk = chunk->next)
+        head->n -= CHUNK_SLOTS;
+    freeChainChunksSCL(last->next);
+    last->next = NULL;
+}
+
+/*Función para poner en su cubeta un contenido que ya está reservado (sin copiarlo), con su llave ya calculada. Regresa NO si no se pudo
+//...(el contenido sigue siendo de quien llamó)*/
+int linkRecordSCL(HTable_SCL *HT, uint32_t key, void *bytes, size_t len){
+    void *head = headSCL(HT, bucketSCL(HT, key));
+    size_t walked;
+    if(HT->mode==LL){
+        if(linkChainSC((LLHead*)head, fingerprintSC(key), bytes, len, &walked) == NULL)
+            return NO;
+    }
+    else{
+        if(appendHeadSCA((AHead*)head, key, bytes, len) == NO)
+            return NO;
+        walked = ((AHead*)head)->len - 1;
+    }
+    //Si la cubeta ya es más larga de lo que se tolera, la tabla se marca (la revisa checkFloodSCL)
+    if(walked > chainLimit(HT->occupied_elements, HT->buckets))
+        HT->flooded = YES;
+    HT->occupied_elements++;
+    return YES;
+}
+
+/*Función para poner en "HT" un lote de contenidos con sus llaves calculadas por lotes (lo que no cabe se libera)*/
+void linkBatchSCL(HTable_SCL *HT, moved_item_SC *items, size_t n){
+    uint32_t keys[HASH_BATCH];
+    movedKeysSC(HT->seed, items, n, keys);
+    for(size_t i=0; i<n; i++){
+        if(linkRecordSCL(HT, keys[i], items[i].bytes, items[i].len) == NO)
+            memFree(MEM_KEYS, items[i].bytes, contentSize(items[i].len));
+    }
+}
+
+/*Función para reconstruir la tabla con otra semilla y el mismo número de cubetas. Es lo único que rehace la tabla completa*/
+void reseedSCL(HTable_SCL *HT){
+    size_t mark = memRemodelBegin();
+    HTable_SCL old = *HT;
+    HT->segments = NULL;
+    HT->segment_count = 0;
+    HT->directory_cap = 0;
+    reserveSegmentsSCL(HT);
+    HT->seed = randomSeed();
+    HT->reseed_floor = 2*old.occupied_elements;
+    HT->occupied_elements = 0;
+    __atomic_add_fetch(&flood_reseeds, 1, __ATOMIC_RELAXED);
+    //Se mueven los punteros de HASH_BATCH en HASH_BATCH; de las listas viejas sólo quedan los chunks por liberar
+    moved_item_SC batch[HASH_BATCH];
+    size_t n = 0;
+    for(size_t b=0; b<old.buckets; b++){
+        if(old.mode==LL){
+            for(LLHash *aux = (LLHead*)headSCL(&old, b); aux != NULL; aux = aux->next){
+                for(size_t s=0; s<CHUNK_SLOTS; s++){
+                    if(aux->fp[s] == 0)
+                        continue;
+                    batch[n].bytes = aux->bytes[s];
+                    batch[n].len = aux->lens[s];
+                    batch[n].chunk = NULL;
+                    if(++n == HASH_BATCH){
+                        linkBatchSCL(HT, batch, n);
+                        n = 0;
+                    }
                 }
-                if(strcmp("print", command)==0){
-                    HTprint_SCA(HT2);
+            }
+        }
+        else{
+            AHead *head = (AHead*)headSCL(&old, b);
+            for(size_t j=0; j<head->len; j++){
+                batch[n].bytes = AHeadBytes(head)[j];
+                batch[n].len = AHeadLens(head)[j];
+                batch[n].chunk = NULL;
+                if(++n == HASH_BATCH){
+                    linkBatchSCL(HT, batch, n);
+                    n = 0;
+                }
+            }
+        }
+    }
+    linkBatchSCL(HT, batch, n);
+    //Las cubetas que se recorrieron al reacomodar no cuentan como inserciones
+    HT->flooded = NO;
+    for(size_t b=0; b<old.buckets; b++){
+        if(old.mode==LL)
+            freeChainChunksSCL(((LLHead*)headSCL(&old, b))->next);
+        else
+            memFree(MEM_NODES, ((AHead*)headSCL(&old, b))->keys, AHeadBlockSize(((AHead*)headSCL(&old, b))->cap));
+    }
+    freeSegmentsSCL(&old);
+    memRemodelEnd(mark);
+}
+
+/*Función para revisar si la última inserción cayó en una cubeta anormalmente larga (igual que checkFloodSC). Regresa YES si se
+//...reconstruyó la tabla*/
+int checkFloodSCL(HTable_SCL *HT){
+    if(!floodReseedDue(&HT->flooded, HT->occupied_elements, HT->reseed_floor))
+        return NO;
+    reseedSCL(HT);
+    return YES;
+}
+
+/*Función para partir una lista: lo que tiene encendido "bit" en su llave pasa a la lista de "to" y la lista de "from" se compacta*/
+void splitChainSCL(HTable_SCL *HT, LLHead *from, LLHead *to, size_t bit){
+    moved_item_SC batch[HASH_BATCH];
+    uint32_t keys[HASH_BATCH];
+    size_t n = 0;
+    for(LLHash *aux = from; aux != NULL; aux = aux->next){
+        for(size_t s=0; s<CHUNK_SLOTS; s++){
+            if(aux->fp[s] != 0){
+                batch[n].bytes = aux->bytes[s];
+                batch[n].len = aux->lens[s];
+                batch[n].chunk = aux;
+                batch[n].slot = s;
+                n++;
+            }
+            //El lote se procesa al llenarse o al terminar la lista
+            if(n < HASH_BATCH && (aux->next != NULL || s+1 < CHUNK_SLOTS))
+                continue;
+            movedKeysSC(HT->seed, batch, n, keys);
+            for(size_t i=0; i<n; i++){
+                if((keys[i] & bit) == 0)
                     continue;
+                size_t walked;
+                if(linkChainSC(to, fingerprintSC(keys[i]), batch[i].bytes, batch[i].len, &walked) == NULL){
+                    memFree(MEM_KEYS, batch[i].bytes, contentSize(batch[i].len));
+                    HT->occupied_elements--;
                 }
-                if(strcmp("stop", command)==0){                 //Parar (crea un ciclo infinito para medir memoria en servidor)
-                    size_t i = 0;
-                    while(i<1){
-                        continue;}
+                batch[i].chunk->fp[batch[i].slot] = 0;
+                batch[i].chunk->lens[batch[i].slot] = 0;
+                batch[i].chunk->bytes[batch[i].slot] = NULL;
+            }
+            n = 0;
+        }
+    }
+    packChainSCL(from);
+}
+
+/*Función para partir un arreglo: lo que tiene encendido "bit" en su llave pasa al arreglo de "to" y lo demás se recorre sin huecos*/
+void splitHeadSCL(HTable_SCL *HT, AHead *from, AHead *to, size_t bit){
+    size_t kept = 0;
+    for(size_t i=0; i<from->len; i++){
+        uint32_t key = from->keys[i];
+        void *bytes = AHeadBytes(from)[i];
+        size_t len = AHeadLens(from)[i];
+        if(key & bit){
+            if(appendHeadSCA(to, key, bytes, len) == NO){
+                memFree(MEM_KEYS, bytes, contentSize(len));
+                HT->occupied_elements--;
+            }
+            continue;
+        }
+        from->keys[kept] = key;
+        AHeadBytes(from)[kept] = bytes;
+        AHeadLens(from)[kept] = len;
+        kept++;
+    }
+    from->len = kept;
+}
+
+/*Función para partir la cubeta del puntero de división. Su compañera es la cubeta nueva del final (la del puntero más el tamaño del nivel)*/
+void splitBucketSCL(HTable_SCL *HT){
+    size_t half = LH_BASE << HT->level;
+    size_t bucket = HT->split;
+    size_t buddy = bucket + half;
+    if((buddy >> LH_SEGMENT_BITS) >= HT->segment_count && addSegmentSCL(HT) == NO)
+        return;
+    //Primero se avanza el puntero (así la cubeta nueva ya es la de las llaves con el bit del nivel encendido)
+    HT->buckets++;
+    if(++HT->split == half){
+        HT->level++;
+        HT->split = 0;
+    }
+    if(HT->mode==LL)
+        splitChainSCL(HT, (LLHead*)headSCL(HT, bucket), (LLHead*)headSCL(HT, buddy), half);
+    else
+        splitHeadSCL(HT, (AHead*)headSCL(HT, bucket), (AHead*)headSCL(HT, buddy), half);
+    HT->splits++;
+}
+
+/*Función para juntar la última cubeta con su compañera (la que se partió para crearla) y regresar el puntero de división*/
+void mergeBucketSCL(HTable_SCL *HT){
+    if(HT->split == 0){
+        HT->level--;
+        HT->split = LH_BASE << HT->level;
+    }
+    HT->split--;
+    HT->buckets--;
+    size_t bucket = HT->split;
+    size_t last = HT->buckets;
+    if(HT->mode==LL){
+        LLHead *from = (LLHead*)headSCL(HT, last);
+        LLHead *to = (LLHead*)headSCL(HT, bucket);
+        for(LLHash *aux = from; aux != NULL; aux = aux->next){
+            for(size_t s=0; s<CHUNK_SLOTS; s++){
+                if(aux->fp[s] == 0)
                     continue;
+                size_t walked;
+                if(linkChainSC(to, aux->fp[s], aux->bytes[s], aux->lens[s], &walked) == NULL){
+                    memFree(MEM_KEYS, aux->bytes[s], contentSize(aux->lens[s]));
+                    HT->occupied_elements--;
                 }
-                if(strcmp("count", command)==0){              //Imprimir no. de elementos en la tabla
-		    printf("Elementos ocupados: %ld\n", HT2->occupied_elements);
-		    continue;}
-		
-	        if(strcmp("exit", command)==0){
-                    break;}
-        }
-        freeHTable_SCA(HT2);
-        break;
-    default:
-        break;
+            }
+        }
+        //La cabeza de la cubeta vieja queda vacía (como en un segmento nuevo)
+        freeChainChunksSCL(from->next);
+        memset(from, 0, sizeof(LLHead));
+        from->n = CHUNK_SLOTS;
+    }
+    else{
+        AHead *from = (AHead*)headSCL(HT, last);
+        AHead *to = (AHead*)headSCL(HT, bucket);
+        //Si la compañera está vacía, se queda con el bloque de la cubeta vieja (sin copiar nada)
+        if(to->len == 0){
+            memFree(MEM_NODES, to->keys, AHeadBlockSize(to->cap));
+            *to = *from;
+        }
+        else{
+            for(size_t j=0; j<from->len; j++){
+                if(appendHeadSCA(to, from->keys[j], AHeadBytes(from)[j], AHeadLens(from)[j]) == NO){
+                    memFree(MEM_KEYS, AHeadBytes(from)[j], contentSize(AHeadLens(from)[j]));
+                    HT->occupied_elements--;
+                }
+            }
+            memFree(MEM_NODES, from->keys, AHeadBlockSize(from->cap));
+        }
+        memset(from, 0, sizeof(AHead));
+    }
+    HT->merges++;
+    //Se deja a lo más un segmento vacío al final (así no se reserva y libera uno cada vez que se cruza su orilla)
+    if(HT->segment_count > 1 && (HT->segment_count-1)*LH_SEGMENT >= HT->buckets + LH_SEGMENT){
+        HT->segment_count--;
+        freeTableArray(HT->segments[HT->segment_count], LH_SEGMENT*headSizeSCL(HT->mode));
+    }
+}
+
+/*Función para encontrar un record, con su llave ya calculada, en la tabla con hashing lineal. Regresa YES si está*/
+int HTfindRecordKey_SCL(HTable_SCL *HT, uint32_t key, record *rec){
+    void *head = headSCL(HT, bucketSCL(HT, key));
+    if(HT->mode==LL){
+        size_t slot;
+        return (findChainSC((LLHash*)head, key, rec, &slot) != NULL) ? YES : NO;
+    }
+    return (findHeadSCA((AHead*)head, key, rec) != NOT_FOUND) ? YES : NO;
+}
+
+/*Función para encontrar un record en la tabla con hashing lineal. Regresa YES si está*/
+int HTfindRecord_SCL(HTable_SCL *HT, record *rec){
+    return HTfindRecordKey_SCL(HT, keySCL(HT, rec), rec);
+}
+
+/*Función para introducir un record en la tabla con hashing lineal (si el promedio por cubeta pasa de LH_MAX_LOAD, se parte una cubeta)*/
+void HTinsertRecord_SCL(HTable_SCL *HT, record *rec){
+    uint32_t key = keySCL(HT, rec);
+    if(HTfindRecordKey_SCL(HT, key, rec)==YES)
+        return;
+    //Reservamos y copiamos el contenido (los bytes extra del final empiezan en 0)
+    void *bytes = memMalloc(MEM_KEYS, contentSize(rec->len));
+    if(bytes == NULL){
+        fprintf(stderr, "Cannot allocate memory for element!\n");
+        return;
+    }
+    memcpy(bytes, rec->bytes, rec->len);
+    memset((char*)bytes + rec->len, 0, content_extra);
+    if(linkRecordSCL(HT, key, bytes, rec->len) == NO){
+        memFree(MEM_KEYS, bytes, contentSize(rec->len));
+        return;
+    }
+    if(checkFloodSCL(HT)==YES)
+        return;
+    if(HT->occupied_elements > LH_MAX_LOAD*HT->buckets)
+        splitBucketSCL(HT);
+}
+
+/*Función para borrar un record de la tabla con hashing lineal (si el promedio por cubeta baja de LH_MIN_LOAD, se junta una cubeta)*/
+void HTdeleteRecordSCL(HTable_SCL *HT, record *rec){
+    uint32_t key = keySCL(HT, rec);
+    void *head = headSCL(HT, bucketSCL(HT, key));
+    if(HT->mode==LL){
+        size_t slot;
+        LLHash *chunk = findChainSC((LLHash*)head, key, rec, &slot);
+        if(chunk == NULL)
+            return;
+        memFree(MEM_KEYS, chunk->bytes[slot], contentSize(chunk->lens[slot]));
+        chunk->bytes[slot] = NULL;
+        chunk->lens[slot] = 0;
+        chunk->fp[slot] = 0;
+    }
+    else{
+        size_t i = findHeadSCA((AHead*)head, key, rec);
+        if(i == NOT_FOUND)
+            return;
+        memFree(MEM_KEYS, AHeadBytes((AHead*)head)[i], contentSize(AHeadLens((AHead*)head)[i]));
+        removeHeadSCA((AHead*)head, i);
+    }
+    HT->occupied_elements--;
+    if(HT->buckets > LH_BASE && HT->occupied_elements < LH_MIN_LOAD*HT->buckets)
+        mergeBucketSCL(HT);
+}
+
+/*Función para imprimir la tabla con hashing lineal (cubeta por cubeta, igual que las tablas de su forma)*/
+void HTprint_SCL(HTable_SCL *HT){
+    for(size_t b=0; b<HT->buckets; b++){
+        printf("%ld ", b);
+        hash_item item;
+        item.status = VALID;
+        if(HT->mode==LL){
+            for(LLHash *current = (LLHead*)headSCL(HT, b); current != NULL; current = current->next){
+                for(size_t s=0; s<CHUNK_SLOTS; s++){
+                    if(current->fp[s] == 0)
+                        continue;
+                    item.rec.bytes = current->bytes[s];
+                    item.rec.len = current->lens[s];
+                    item.key = keySCL(HT, &(item.rec));
+                    HTprintItem_SC(&item);
+                }
+            }
+        }
+        else{
+            AHead *head = (AHead*)headSCL(HT, b);
+            for(size_t j=0; j<head->len; j++){
+                item.rec.bytes = AHeadBytes(head)[j];
+                item.rec.len = AHeadLens(head)[j];
+                item.key = head->keys[j];
+                HTprintItem_SC(&item);
+            }
+        }
+        printf("\n");
+    }
+}
+
+/*Función para imprimir el estado de la tabla con hashing lineal (con la cubeta más larga, que debe quedarse acotada)*/
+void HTstats_SCL(HTable_SCL *HT){
+    size_t longest = 0;
+    for(size_t b=0; b<HT->buckets; b++){
+        size_t count = 0;
+        if(HT->mode==LL){
+            for(LLHash *current = (LLHead*)headSCL(HT, b); current != NULL; current = current->next){
+                for(size_t s=0; s<CHUNK_SLOTS; s++)
+                    count += (current->fp[s] != 0);
+            }
+        }
+        else
+            count = ((AHead*)headSCL(HT, b))->len;
+        if(count > longest)
+            longest = count;
+    }
+    printf("Lineal: %zu cubetas (nivel %zu, división en %zu), %zu segmentos, %zu divisiones, %zu juntadas, cubeta más larga %zu (promedio %.2f)\n",
+           HT->buckets, HT->level, HT->split, HT->segment_count, HT->splits, HT->merges, longest, (double)HT->occupied_elements/HT->buckets);
+}
+
+/*..........................................EXTENSIBLE EN DISCO...........................................................................*/
+/*Tabla para conjuntos más grandes que la memoria (estrategia 2): hashing extensible sobre páginas de cubeta de tamaño fijo (4, 8 o 16 KB;
+//..."page=bytes") en un archivo mapeado con mmap ("file=ruta"). Un directorio en memoria de 2^profundidad entradas apunta a las páginas;
+//...cuando una página se llena sólo ésa se parte en dos según el siguiente bit de sus llaves (y si su profundidad ya era la del
+//...directorio, éste se duplica). Nunca se rehace la tabla completa (salvo al resembrar, abajo). Como el directorio usa los bits bajos,
+//...la llave se calcula con SipHash y una semilla que se guarda en el encabezado del archivo. Cada página guarda su profundidad local y su patrón de bits, así que al volver a abrir el archivo el directorio se
+//...reconstruye sin haberlo guardado. Para que la memoria residente no crezca con el archivo hay una caché pequeña de páginas
+//...("cachepages=N", con reloj): cuando una página sale de la caché se le avisa al kernel que ya no se necesita (MADV_DONTNEED; lo que se
+//...haya escrito se queda en el archivo). Las búsquedas por lotes ("findall archivo") piden de antemano las páginas de todo el lote
+//...(MADV_WILLNEED) antes de buscar. Lo que aquí equivale a una lista demasiado larga es partir una página y que todo se quede del mismo
+//...lado (con llaves al azar eso casi nunca pasa): si ocurre, o si el directorio ya no se puede duplicar, el archivo se reescribe con
+//...otra semilla (con los mismos límites que las demás tablas, ver floodReseedDue)*/
+#define EH 2
+#define EH_MAGIC 0x32454348u            //"HCE2" (la versión anterior, "HCE1", no guardaba la semilla)
+#define EH_MIN_PAGE 4096
+#define EH_MAX_PAGE 16384
+#define EH_SEGMENT_PAGES 1024           //El archivo se mapea por segmentos de páginas (al crecer, las páginas ya mapeadas no se mueven)
+#define EH_MAX_DEPTH 30                 //Profundidad máxima del directorio
+#define EH_BATCH 64                     //Records por lote en las búsquedas con prefetch
+#define EH_ENTRY_HEADER 6               //Cada elemento de una página: llave (4 bytes), longitud (2 bytes) y después el contenido
+#define EH_FLOOD_MIN 16                 //Elementos que debe tener una página para que partirla sin separar nada cuente como detección
+
+/*Encabezado del archivo (ocupa la primera página)*/
+typedef struct{
+    uint32_t magic;
+    uint32_t page_size;
+    uint64_t pages;                 //Páginas usadas del archivo (contando ésta)
+    uint64_t occupied_elements;
+    uint64_t seed;                  //Semilla con la que se calculan las llaves
+    uint64_t reseed_floor;          //No se vuelve a resembrar hasta tener al menos estos elementos (el doble que en el último resiembro)
+}eh_file_header;
+
+/*Encabezado de cada página de cubeta (después vienen sus elementos, uno tras otro)*/
+typedef struct{
+    uint32_t depth;                 //Profundidad local
+    uint32_t pattern;               //Los "depth" bits bajos que comparten todas sus llaves
+    uint32_t count;                 //No. de elementos en la página
+    uint32_t used;                  //Bytes ocupados después del encabezado
+}eh_page;
+
+/*Caché de páginas residentes (reloj)*/
+typedef struct{
+    uint32_t *pages;                //Página en cada posición del reloj
+    uint8_t *ref;                   //Bit de referencia de cada posición
+    uint32_t *where;                //Por cada página del archivo: su posición en la caché más 1 (0 = no está)
+    size_t capacity;
+    size_t n;
+    size_t hand;
+    size_t hits;
+    size_t misses;
+    size_t evictions;
+    size_t prefetches;
+}eh_cache;
+
+/*Aquí definimos la estructura de la tabla extensible*/
+typedef struct{
+    int fd;                         //Archivo de las páginas
+    size_t page_size;
+    uint8_t **segments;             //Segmentos mapeados del archivo
+    size_t n_segments;
+    eh_file_header *header;         //Encabezado del archivo (al principio del primer segmento)
+    uint32_t *directory;            //No. de página de cada entrada del directorio
+    uint32_t depth;                 //Profundidad global (el directorio tiene 2^depth entradas)
+    size_t occupied_elements;       //Cantidad de elementos ocupados en la tabla
+    size_t splits;                  //Páginas partidas
+    size_t doublings;               //Veces que se duplicó el directorio
+    int flooded;                    //YES si la última inserción partió una página sin separar nada (o no pudo partirla)
+    eh_cache cache;
+}HTable_SCE;
+
+/*Opciones de la tabla extensible*/
+typedef struct{
+    const char *path;
+    size_t page_size;
+    size_t cache_pages;
+}eh_options;
+
+/*Función para leer una opción de la tabla extensible ("file=ruta", "page=bytes" o "cachepages=N"). Regresa YES si era una*/
+int parseDiskOption(eh_options *EO, const char *arg){
+    if(strncmp(arg, "file=", 5)==0)
+        EO->path = arg + 5;
+    else if(strncmp(arg, "page=", 5)==0){
+        char *end;
+        EO->page_size = (size_t)strtoull(arg + 5, &end, 10);
+        if(*end == 'K' || *end == 'k')
+            EO->page_size <<= 10;
+    }
+    else if(strncmp(arg, "cachepages=", 11)==0)
+        EO->cache_pages = (size_t)strtoull(arg + 11, NULL, 10);
+    else
+        return NO;
+    return YES;
+}
+
+/*Función para obtener la dirección de una página*/
+static inline eh_page* ehPage(HTable_SCE *HT, uint32_t page){
+    return (eh_page*)(HT->segments[page/EH_SEGMENT_PAGES] + (size_t)(page%EH_SEGMENT_PAGES)*HT->page_size);
+}
+
+/*Función para calcular la llave de un record en la tabla extensible (con la semilla del archivo)*/
+static inline uint32_t ehKey(HTable_SCE *HT, record *rec){
+    return seededKey(HT->header->seed, (const unsigned char*)rec->bytes, rec->len);
+}
+
+/*Función para encontrar la página de una llave (según sus bits bajos)*/
+static inline uint32_t ehDirectory(HTable_SCE *HT, uint32_t key){
+    return HT->directory[key & (((uint32_t)1 << HT->depth) - 1)];
+}
+
+/*Función para mapear un segmento más del archivo (lo agranda si hace falta). Regresa NO si no se pudo*/
+int ehMapSegment(HTable_SCE *HT){
+    size_t seg_bytes = EH_SEGMENT_PAGES*HT->page_size;
+    size_t s = HT->n_segments;
+    struct stat st;
+    if(fstat(HT->fd, &st) != 0)
+        return NO;
+    if((size_t)st.st_size < (s+1)*seg_bytes && ftruncate(HT->fd, (off_t)((s+1)*seg_bytes)) != 0){
+        fprintf(stderr, "Cannot grow table file\n");
+        return NO;
+    }
+    uint8_t *segment = (uint8_t*)mmap(NULL, seg_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, HT->fd, (off_t)(s*seg_bytes));
+    if(segment == MAP_FAILED){
+        fprintf(stderr, "Cannot map table file\n");
+        return NO;
+    }
+    //Las cubetas se leen al azar: no sirve que el kernel lea de más alrededor de cada una
+    madvise(segment, seg_bytes, MADV_RANDOM);
+    //Se agrandan el arreglo de segmentos y el de posiciones en la caché (una entrada por página)
+    uint8_t **segments = (uint8_t**)memMalloc(MEM_TABLE, (s+1)*sizeof(uint8_t*));
+    uint32_t *where = (uint32_t*)memMalloc(MEM_TABLE, (s+1)*EH_SEGMENT_PAGES*sizeof(uint32_t));
+    if(segments == NULL || where == NULL){
+        fprintf(stderr, "Cannot allocate memory for table.");
+        exit(1);
+    }
+    if(s > 0){
+        memcpy(segments, HT->segments, s*sizeof(uint8_t*));
+        memcpy(where, HT->cache.where, s*EH_SEGMENT_PAGES*sizeof(uint32_t));
+    }
+    memset(where + s*EH_SEGMENT_PAGES, 0, EH_SEGMENT_PAGES*sizeof(uint32_t));
+    memFree(MEM_TABLE, HT->segments, s*sizeof(uint8_t*));
+    memFree(MEM_TABLE, HT->cache.where, s*EH_SEGMENT_PAGES*sizeof(uint32_t));
+    segments[s] = segment;
+    HT->segments = segments;
+    HT->cache.where = where;
+    HT->n_segments++;
+    return YES;
+}
+
+/*Función para tomar una página nueva del final del archivo. Regresa su número (0 si no se pudo: la página 0 es el encabezado)*/
+uint32_t ehNewPage(HTable_SCE *HT){
+    uint64_t page = HT->header->pages;
+    if(page >= UINT32_MAX)
+        return 0;
+    if(page >= HT->n_segments*EH_SEGMENT_PAGES && ehMapSegment(HT)==NO)
+        return 0;
+    HT->header->pages++;
+    memset(ehPage(HT, (uint32_t)page), 0, sizeof(eh_page));
+    return (uint32_t)page;
+}
+
+/*Función para marcar el uso de una página en la caché. Si no estaba, entra en lugar de la que señale el reloj (ésa se suelta)*/
+void ehTouch(HTable_SCE *HT, uint32_t page){
+    eh_cache *C = &(HT->cache);
+    if(C->where[page] != 0){
+        C->ref[C->where[page]-1] = YES;
+        C->hits++;
+        return;
+    }
+    C->misses++;
+    size_t slot;
+    if(C->n < C->capacity)
+        slot = C->n++;
+    else{
+        //La manecilla avanza quitando bits de referencia hasta encontrar una página que no se usó en la última vuelta
+        while(C->ref[C->hand] == YES){
+            C->ref[C->hand] = NO;
+            C->hand = (C->hand + 1) % C->capacity;
+        }
+        slot = C->hand;
+        C->hand = (C->hand + 1) % C->capacity;
+        madvise(ehPage(HT, C->pages[slot]), HT->page_size, MADV_DONTNEED);
+        C->where[C->pages[slot]] = 0;
+        C->evictions++;
+    }
+    C->pages[slot] = page;
+    C->ref[slot] = YES;
+    C->where[page] = (uint32_t)slot + 1;
+}
+
+/*Función para reconstruir el directorio a partir de la profundidad y el patrón de cada página (al volver a abrir un archivo)*/
+void ehRebuildDirectory(HTable_SCE *HT){
+    HT->depth = 0;
+    for(uint32_t p=1; p<HT->header->pages; p++){
+        if(ehPage(HT, p)->depth > HT->depth)
+            HT->depth = ehPage(HT, p)->depth;
+    }
+    size_t entries = (size_t)1 << HT->depth;
+    HT->directory = (uint32_t*)memMalloc(MEM_TABLE, entries*sizeof(uint32_t));
+    if(HT->directory == NULL){
+        fprintf(stderr, "Cannot allocate memory for table.");
+        exit(1);
+    }
+    //Cada página ocupa todas las entradas cuyos bits bajos son su patrón
+    for(uint32_t p=1; p<HT->header->pages; p++){
+        eh_page *page = ehPage(HT, p);
+        for(size_t i = page->pattern; i < entries; i += (size_t)1 << page->depth)
+            HT->directory[i] = p;
+    }
+    //Se leyeron todos los encabezados: se sueltan las páginas para empezar con la caché vacía
+    for(size_t s=0; s<HT->n_segments; s++)
+        madvise(HT->segments[s], EH_SEGMENT_PAGES*HT->page_size, MADV_DONTNEED);
+}
+
+/*Función para abrir (o crear) una tabla extensible en el archivo "path". Si el archivo ya tenía una, se sigue con su contenido*/
+HTable_SCE* newHTable_SCE(const char *path, size_t page_size, size_t cache_pages){
+    HTable_SCE *HT = (HTable_SCE*)memMalloc(MEM_TABLE, sizeof(HTable_SCE));
+    if(HT == NULL){
+        fprintf(stderr, "Cannot allocate memory for table.");
+        exit(1);
+    }
+    memset(HT, 0, sizeof(HTable_SCE));
+    HT->fd = open(path, O_RDWR | O_CREAT, 0644);
+    if(HT->fd < 0){
+        fprintf(stderr, "Cannot open table file %s\n", path);
+        exit(1);
+    }
+    //Si el archivo ya tiene una tabla, se usa su tamaño de página
+    eh_file_header old;
+    int reopen = (pread(HT->fd, &old, sizeof(old), 0) == (ssize_t)sizeof(old) && old.magic == EH_MAGIC);
+    if(reopen)
+        page_size = old.page_size;
+    if(page_size < EH_MIN_PAGE || page_size > EH_MAX_PAGE || (page_size & (page_size - 1)) != 0){
+        fprintf(stderr, "Page size must be 4096, 8192 or 16384 bytes\n");
+        exit(1);
+    }
+    HT->page_size = page_size;
+    //Se mapean los segmentos que ya tenga el archivo (al menos uno)
+    do{
+        if(ehMapSegment(HT)==NO)
+            exit(1);
+    }while(reopen && HT->n_segments*EH_SEGMENT_PAGES < old.pages);
+    HT->header = (eh_file_header*)HT->segments[0];
+    HT->cache.capacity = (cache_pages > 0) ? cache_pages : 1;
+    HT->cache.pages = (uint32_t*)memMalloc(MEM_TABLE, HT->cache.capacity*sizeof(uint32_t));
+    HT->cache.ref = (uint8_t*)memMalloc(MEM_TABLE, HT->cache.capacity);
+    if(HT->cache.pages == NULL || HT->cache.ref == NULL){
+        fprintf(stderr, "Cannot allocate memory for table.");
+        exit(1);
+    }
+    if(reopen){
+        ehRebuildDirectory(HT);
+        HT->occupied_elements = HT->header->occupied_elements;
+        return HT;
+    }
+    //Archivo nuevo: encabezado y una sola página de profundidad 0 (el directorio tiene una entrada)
+    HT->header->magic = EH_MAGIC;
+    HT->header->page_size = (uint32_t)page_size;
+    HT->header->pages = 1;
+    HT->header->occupied_elements = 0;
+    HT->header->seed = tableSeed();
+    HT->header->reseed_floor = 0;
+    HT->directory = (uint32_t*)memMalloc(MEM_TABLE, sizeof(uint32_t));
+    if(HT->directory == NULL){
+        fprintf(stderr, "Cannot allocate memory for table.");
+        exit(1);
+    }
+    HT->directory[0] = ehNewPage(HT);
+    HT->depth = 0;
+    HT->occupied_elements = 0;
+    return HT;
+}
+
+/*Función para cerrar la tabla extensible (el contenido se queda en el archivo)*/
+void freeHTable_SCE(HTable_SCE *HT){
+    size_t seg_bytes = EH_SEGMENT_PAGES*HT->page_size;
+    for(size_t s=0; s<HT->n_segments; s++)
+        munmap(HT->segments[s], seg_bytes);
+    close(HT->fd);
+    memFree(MEM_TABLE, HT->directory, ((size_t)1 << HT->depth)*sizeof(uint32_t));
+    memFree(MEM_TABLE, HT->segments, HT->n_segments*sizeof(uint8_t*));
+    memFree(MEM_TABLE, HT->cache.where, HT->n_segments*EH_SEGMENT_PAGES*sizeof(uint32_t));
+    memFree(MEM_TABLE, HT->cache.pages, HT->cache.capacity*sizeof(uint32_t));
+    memFree(MEM_TABLE, HT->cache.ref, HT->cache.capacity);
+    memFree(MEM_TABLE, HT, sizeof(HTable_SCE));
+}
+
+/*Función para buscar un record en una página. Regresa el desplazamiento de su elemento (NOT_FOUND si no está)*/
+size_t ehFindInPage(eh_page *page, uint32_t key, record *rec){
+    uint8_t *data = (uint8_t*)(page + 1);
+    size_t offset = 0;
+    for(uint32_t i=0; i<page->count; i++){
+        uint32_t k;
+        uint16_t len;
+        memcpy(&k, data + offset, sizeof(uint32_t));
+        memcpy(&len, data + offset + sizeof(uint32_t), sizeof(uint16_t));
+        //Primero se compara la llave y sólo si coincide se revisa el contenido
+        if(k == key && len == rec->len && compareBytes(data + offset + EH_ENTRY_HEADER, rec->bytes, len)==YES)
+            return offset;
+        offset += EH_ENTRY_HEADER + len;
+    }
+    return NOT_FOUND;
+}
+
+/*Función para partir una página llena: los elementos con el siguiente bit de su llave encendido se pasan a una página nueva. Si la
+//...página ya tenía la profundidad del directorio, primero se duplica el directorio. Regresa NO si no se pudo (y marca la tabla)*/
+int ehSplit(HTable_SCE *HT, uint32_t p){
+    if(ehPage(HT, p)->depth == HT->depth){
+        if(HT->depth >= EH_MAX_DEPTH){
+            HT->flooded = YES;
+            return NO;
+        }
+        //La mitad nueva del directorio es una copia de la vieja (cada página queda apuntada el doble de veces)
+        size_t entries = (size_t)1 << HT->depth;
+        uint32_t *directory = (uint32_t*)memMalloc(MEM_TABLE, 2*entries*sizeof(uint32_t));
+        if(directory == NULL){
+            fprintf(stderr, "Cannot allocate memory for table.");
+            return NO;
+        }
+        memcpy(directory, HT->directory, entries*sizeof(uint32_t));
+        memcpy(directory + entries, HT->directory, entries*sizeof(uint32_t));
+        memFree(MEM_TABLE, HT->directory, entries*sizeof(uint32_t));
+        HT->directory = directory;
+        HT->depth++;
+        HT->doublings++;
+    }
+    uint32_t q = ehNewPage(HT);
+    if(q == 0)
+        return NO;
+    ehTouch(HT, q);
+    eh_page *page = ehPage(HT, p);
+    eh_page *other = ehPage(HT, q);
+    uint32_t bit = (uint32_t)1 << page->depth;
+    page->depth++;
+    other->depth = page->depth;
+    other->pattern = page->pattern | bit;
+    //Se reparten los elementos (la página vieja se compacta en su lugar)
+    uint8_t *data = (uint8_t*)(page + 1);
+    uint8_t *dest = (uint8_t*)(other + 1);
+    size_t offset = 0, kept = 0;
+    uint32_t count = page->count, kept_count = 0;
+    for(uint32_t i=0; i<count; i++){
+        uint32_t k;
+        uint16_t len;
+        memcpy(&k, data + offset, sizeof(uint32_t));
+        memcpy(&len, data + offset + sizeof(uint32_t), sizeof(uint16_t));
+        size_t bytes = EH_ENTRY_HEADER + len;
+        if(k & bit){
+            memcpy(dest + other->used, data + offset, bytes);
+            other->used += bytes;
+            other->count++;
+        }
+        else{
+            memmove(data + kept, data + offset, bytes);
+            kept += bytes;
+            kept_count++;
+        }
+        offset += bytes;
+    }
+    page->used = kept;
+    page->count = kept_count;
+    if(count >= EH_FLOOD_MIN && (kept_count == 0 || kept_count == count))
+        HT->flooded = YES;
+    //Las entradas del directorio con el patrón de la página nueva ahora apuntan a ella
+    for(size_t i = other->pattern; i < ((size_t)1 << HT->depth); i += (size_t)1 << other->depth)
+        HT->directory[i] = q;
+    HT->splits++;
+    return YES;
+}
+
+/*Función para colocar un record con su llave ya calculada (si ya estaba no hace nada). Regresa NO si su página no se pudo partir*/
+int ehPlace(HTable_SCE *T, uint32_t key, record *rec){
+    size_t room = T->page_size - sizeof(eh_page);
+    while(1){
+        uint32_t p = ehDirectory(T, key);
+        ehTouch(T, p);
+        eh_page *page = ehPage(T, p);
+        if(ehFindInPage(page, key, rec) != NOT_FOUND)
+            return YES;
+        //Si cabe, se agrega al final de la página
+        if(page->used + EH_ENTRY_HEADER + rec->len <= room){
+            uint8_t *entry = (uint8_t*)(page + 1) + page->used;
+            uint16_t len = (uint16_t)rec->len;
+            memcpy(entry, &key, sizeof(uint32_t));
+            memcpy(entry + sizeof(uint32_t), &len, sizeof(uint16_t));
+            memcpy(entry + EH_ENTRY_HEADER, rec->bytes, rec->len);
+            page->used += EH_ENTRY_HEADER + rec->len;
+            page->count++;
+            T->occupied_elements++;
+            T->header->occupied_elements = T->occupied_elements;
+            return YES;
+        }
+        //Si no, se parte sólo esta página y se vuelve a intentar (puede que todo se haya quedado del mismo lado)
+        if(ehSplit(T, p)==NO)
+            return NO;
+    }
+}
+
+/*Función para reescribir todo el archivo con otra semilla: los elementos se copian a memoria privada, el archivo vuelve a tener una
+//...sola página (las demás se reutilizan al partir) y se vuelven a colocar con sus llaves nuevas*/
+void ehReseed(HTable_SCE *T){
+    size_t mark = memRemodelBegin();
+    size_t bytes = 0;
+    for(uint32_t p=1; p<T->header->pages; p++)
+        bytes += ehPage(T, p)->used;
+    uint8_t *copy = (uint8_t*)memMalloc(MEM_NODES, bytes + 1);
+    if(copy == NULL){
+        fprintf(stderr, "Cannot allocate memory for table.");
+        exit(1);
+    }
+    bytes = 0;
+    for(uint32_t p=1; p<T->header->pages; p++){
+        eh_page *page = ehPage(T, p);
+        memcpy(copy + bytes, page + 1, page->used);
+        bytes += page->used;
+    }
+    //Se vacían el directorio, la caché y el archivo
+    memFree(MEM_TABLE, T->directory, ((size_t)1 << T->depth)*sizeof(uint32_t));
+    T->directory = (uint32_t*)memMalloc(MEM_TABLE, sizeof(uint32_t));
+    if(T->directory == NULL){
+        fprintf(stderr, "Cannot allocate memory for table.");
+        exit(1);
+    }
+    for(size_t i=0; i<T->cache.n; i++)
+        T->cache.where[T->cache.pages[i]] = 0;
+    T->cache.n = 0;
+    T->cache.hand = 0;
+    size_t elements = T->occupied_elements;
+    T->header->pages = 1;
+    T->header->seed = randomSeed();
+    T->header->reseed_floor = 2*elements;
+    T->directory[0] = ehNewPage(T);
+    T->depth = 0;
+    T->occupied_elements = 0;
+    //Se vuelven a colocar con la semilla nueva
+    for(size_t offset = 0; offset < bytes; ){
+        uint16_t len;
+        memcpy(&len, copy + offset + sizeof(uint32_t), sizeof(uint16_t));
+        record rec;
+        rec.bytes = copy + offset + EH_ENTRY_HEADER;
+        rec.len = len;
+        if(ehPlace(T, ehKey(T, &rec), &rec)==NO)
+            fprintf(stderr, "Cannot split bucket page any further\n");
+        offset += EH_ENTRY_HEADER + len;
+    }
+    T->flooded = NO;
+    memFree(MEM_NODES, copy, bytes + 1);
+    __atomic_add_fetch(&flood_reseeds, 1, __ATOMIC_RELAXED);
+    memRemodelEnd(mark);
+}
+
+/*Función para insertar un record en la tabla extensible*/
+void HTinsertRecord_SCE(HTable_SCE **HT, record *rec){
+    HTable_SCE *T = *HT;
+    size_t room = T->page_size - sizeof(eh_page);
+    if(rec->len > UINT16_MAX || EH_ENTRY_HEADER + rec->len > room){
+        fprintf(stderr, "Record too large for a bucket page\n");
+        return;
+    }
+    int placed = ehPlace(T, ehKey(T, rec), rec);
+    //Si una página se partió sin separar nada (o ya no se pudo partir), se reescribe el archivo con otra semilla
+    if(floodReseedDue(&T->flooded, T->occupied_elements, T->header->reseed_floor)){
+        ehReseed(T);
+        if(placed==NO)
+            placed = ehPlace(T, ehKey(T, rec), rec);
+    }
+    if(placed==NO)
+        fprintf(stderr, "Cannot split bucket page any further\n");
+}
+
+/*Función para buscar un record en la tabla extensible. Regresa YES si está*/
+int HTfindRecord_SCE(HTable_SCE **HT, record *rec){
+    uint32_t key = ehKey(*HT, rec);
+    uint32_t p = ehDirectory(*HT, key);
+    ehTouch(*HT, p);
+    return (ehFindInPage(ehPage(*HT, p), key, rec) != NOT_FOUND) ? YES : NO;
+}
+
+/*Función para buscar un lote de records (a lo más EH_BATCH): primero se calculan todas las llaves y se le piden al kernel las páginas que
+//...no están en la caché, y después se busca cada uno (así las lecturas del disco se traslapan). Regresa cuántos se encontraron*/
+size_t HTfindBatch_SCE(HTable_SCE *HT, record *recs, size_t n){
+    uint32_t keys[EH_BATCH];
+    uint32_t pages[EH_BATCH];
+    for(size_t i=0; i<n; i++){
+        keys[i] = ehKey(HT, &recs[i]);
+        pages[i] = ehDirectory(HT, keys[i]);
+        if(HT->cache.where[pages[i]] == 0){
+            madvise(ehPage(HT, pages[i]), HT->page_size, MADV_WILLNEED);
+            HT->cache.prefetches++;
+        }
+    }
+    size_t found = 0;
+    for(size_t i=0; i<n; i++){
+        ehTouch(HT, pages[i]);
+        if(ehFindInPage(ehPage(HT, pages[i]), keys[i], &recs[i]) != NOT_FOUND)
+            found++;
+    }
+    return found;
+}
+
+/*Función para borrar un record de la tabla extensible (los elementos de después se recorren; las páginas no se juntan)*/
+void HTdeleteRecordSCE(HTable_SCE **HT, record *rec){
+    HTable_SCE *T = *HT;
+    uint32_t key = ehKey(T, rec);
+    uint32_t p = ehDirectory(T, key);
+    ehTouch(T, p);
+    eh_page *page = ehPage(T, p);
+    size_t offset = ehFindInPage(page, key, rec);
+    if(offset == NOT_FOUND)
+        return;
+    uint8_t *data = (uint8_t*)(page + 1);
+    size_t bytes = EH_ENTRY_HEADER + rec->len;
+    memmove(data + offset, data + offset + bytes, page->used - offset - bytes);
+    page->used -= bytes;
+    page->count--;
+    T->occupied_elements--;
+    T->header->occupied_elements = T->occupied_elements;
+}
+
+/*Función para imprimir la tabla extensible (página por página)*/
+void HTprint_SCE(HTable_SCE *HT){
+    for(uint32_t p=1; p<HT->header->pages; p++){
+        printf("%u ", p);
+        ehTouch(HT, p);
+        eh_page *page = ehPage(HT, p);
+        uint8_t *data = (uint8_t*)(page + 1);
+        size_t offset = 0;
+        for(uint32_t i=0; i<page->count; i++){
+            hash_item item;
+            uint16_t len;
+            memcpy(&item.key, data + offset, sizeof(uint32_t));
+            memcpy(&len, data + offset + sizeof(uint32_t), sizeof(uint16_t));
+            item.rec.bytes = data + offset + EH_ENTRY_HEADER;
+            item.rec.len = len;
+            item.status = VALID;
+            HTprintItem_SC(&item);
+            offset += EH_ENTRY_HEADER + len;
+        }
+        printf("\n");
+    }
+}
+
+/*Función para imprimir los datos de las páginas y de la caché*/
+void HTstats_SCE(HTable_SCE *HT){
+    printf("Páginas: %lu de %zu bytes, profundidad %u, %zu divisiones, directorio duplicado %zu veces\n",
+           (unsigned long)HT->header->pages, HT->page_size, HT->depth, HT->splits, HT->doublings);
+    printf("Caché de páginas: %zu de %zu, %zu aciertos, %zu fallos, %zu soltadas, %zu pedidas por adelantado\n", HT->cache.n,
+           HT->cache.capacity, HT->cache.hits, HT->cache.misses, HT->cache.evictions, HT->cache.prefetches);
+}
+
+/*Función para buscar por lotes las llaves de un archivo ("findall archivo"; de cada línea se toma la última palabra)*/
+void findAllSCE(HTable_SCE *HT, const char *path){
+    FILE *file = fopen(path, "r");
+    if(file == NULL){
+        fprintf(stderr, "Cannot open %s\n", path);
+        return;
+    }
+    char (*keys)[100] = (char(*)[100])memMalloc(MEM_NODES, EH_BATCH*100);
+    if(keys == NULL){
+        fprintf(stderr, "Cannot allocate memory for batch!\n");
+        fclose(file);
+        return;
+    }
+    record recs[EH_BATCH];
+    char line[200];
+    size_t n = 0, total = 0, found = 0;
+    uint64_t start = nowNs();
+    while(fgets(line, sizeof(line), file) != NULL){
+        char first[100] = "", second[100] = "";
+        int words = sscanf(line, "%99s %99s", first, second);
+        if(words < 1)
+            continue;
+        strcpy(keys[n], (words == 2) ? second : first);
+        recs[n].bytes = keys[n];
+        recs[n].len = strlen(keys[n]);
+        if(++n == EH_BATCH){
+            found += HTfindBatch_SCE(HT, recs, n);
+            total += n;
+            n = 0;
+        }
+    }
+    found += HTfindBatch_SCE(HT, recs, n);
+    total += n;
+    printf("Encontrados: %zu de %zu (%.3f ms)\n", found, total, (double)(nowNs() - start)/1e6);
+    memFree(MEM_NODES, keys, EH_BATCH*100);
+    fclose(file);
+}
+
+/*...............................................VENCIMIENTO (TTL).........................................................................*/
+/*En modo TTL ("ttl=ms") los elementos pueden vencer: "insert llave [ms]" lo guarda con ese TTL (o con el de la opción; 0 = no vence) y si
+//...ya estaba sólo se le cambia el vencimiento. Como los chunks ya ocupan su línea de caché completa, el vencimiento va en 8 bytes que se
+//...reservan al final de cada contenido (content_extra); Remodel mueve los contenidos sin copiarlos, así que se conserva. Una rueda de
+//...tiempos jerárquica (4 niveles de 64 casillas, un tick por ms) lleva lo que va a vencer. Cada operación avanza la rueda y quita a lo
+//...más TTL_BUDGET vencidos (trabajo acotado); mientras tanto las búsquedas ya toman a los vencidos como ausentes. Los vencidos se sacan
+//...de su lista o arreglo sin revisar el tamaño uno por uno: se revisa una vez por tanda (checkSize recorre todas las cabezas), así una
+//...ola de vencimientos no provoca un Remodel tras otro. "advance ms" adelanta el reloj del TTL (para probar sin esperar)*/
+
+/*Funciones para leer y escribir el vencimiento guardado al final de un contenido (sólo en modo TTL)*/
+static inline uint64_t contentDeadline(void *bytes, size_t len){
+    uint64_t deadline;
+    memcpy(&deadline, (char*)bytes + len, sizeof(uint64_t));
+    return deadline;
+}
+static inline void setContentDeadline(void *bytes, size_t len, uint64_t deadline){
+    memcpy((char*)bytes + len, &deadline, sizeof(uint64_t));
+}
+
+/*Función para encontrar el contenido guardado de un record en cualquiera de las dos estrategias (NULL si no está)*/
+void* findContentSC(void **HT, int mode, record *rec){
+    if(mode==LL){
+        size_t slot;
+        LLHash *chunk = HTfindRecord_SC((HTable_SC**)HT, rec, &slot);
+        return (chunk != NULL) ? chunk->bytes[slot] : NULL;
+    }
+    HTable_SCA *HT2 = *(HTable_SCA**)HT;
+    uint32_t key = keySCA(HT2, rec);
+    size_t i = HTfindRecordKey_SCA(HT2, key, rec);
+    if(i == NOT_FOUND)
+        return NULL;
+    return AHeadBytes(&(HT2->table[hashFunction(key, HT2->size)]))[i];
+}
+
+/*Función para insertar un record con vencimiento ("ttl" en ns; 0 = no vence). Si ya estaba, sólo se le pone el nuevo vencimiento*/
+void HTinsertRecordTTL_SC(void **HT, int mode, record *rec, timer_wheel *W, uint64_t ttl){
+    if(mode==LL)
+        HTinsertRecord_SC((HTable_SC**)HT, rec);
+    else
+        HTinsertRecord_SCA((HTable_SCA**)HT, rec);
+    void *bytes = findContentSC(HT, mode, rec);
+    if(bytes == NULL)
+        return;
+    uint64_t deadline = (ttl != 0) ? ttlNow(W) + ttl : 0;
+    setContentDeadline(bytes, rec->len, deadline);
+    if(ttl != 0)
+        wheelSchedule(W, rec, deadline);
+}
+
+/*Función para buscar un record en modo TTL (los vencidos cuentan como ausentes aunque todavía no se quiten). Regresa YES si está*/
+int HTfindRecordTTL_SC(void **HT, int mode, record *rec, timer_wheel *W){
+    void *bytes = findContentSC(HT, mode, rec);
+    if(bytes == NULL || ttlExpired(W, contentDeadline(bytes, rec->len)))
+        return NO;
+    return YES;
+}
+
+/*Función para borrar un record en cualquiera de las dos estrategias*/
+void HTdeleteRecordTTL_SC(void **HT, int mode, record *rec){
+    if(mode==LL)
+        HTdeleteRecord((HTable_SC**)HT, rec);
+    else
+        HTdeleteRecordSCA((HTable_SCA**)HT, rec);
+}
+
+/*Función para avanzar la rueda y quitar de la tabla a lo más TTL_BUDGET vencidos. Un aviso sólo vale si el elemento sigue con ese mismo
+//...vencimiento (si se borró o se volvió a insertar, se descarta). El tamaño se revisa al final de la tanda, no con cada elemento*/
+void ttlTick_SC(void **HT, int mode, timer_wheel *W){
+    wheelAdvance(W);
+    size_t removed = 0;
+    timer_node *node;
+    for(size_t n=0; n<TTL_BUDGET && (node = wheelPopDue(W)) != NULL; n++){
+        record rec;
+        rec.bytes = node->bytes;
+        rec.len = node->len;
+        void *bytes = findContentSC(HT, mode, &rec);
+        if(bytes != NULL && contentDeadline(bytes, rec.len) == node->deadline){
+            if(mode==LL)
+                removeRecordSC((HTable_SC**)HT, &rec);
+            else
+                removeRecordSCA((HTable_SCA**)HT, &rec);
+            removed++;
+        }
+        else
+            W->stale++;
+        freeTimerNode(node);
+    }
+    W->expired += removed;
+    if(removed == 0)
+        return;
+    if(mode==LL){
+        HTable_SC **HT1 = (HTable_SC**)HT;
+        if((*HT1)->index_size>0 && checkSize(*HT1, DOWN)==EMPTY)
+            (*HT1)=RemodelHTableCap_SC(*HT1, EMPTY);
+    }
+    else{
+        HTable_SCA **HT2 = (HTable_SCA**)HT;
+        if((*HT2)->index_size>0 && checkSizeSCA(*HT2, DOWN)==EMPTY)
+            (*HT2)=RemodelHTableCap_SCA(*HT2, EMPTY);
+    }
+}
+
+/*...............................................AGREGACIÓN...............................................................................*/
+/*Con la opción "agg" cada contenido lleva al final (content_extra, como el vencimiento del TTL) un acumulador: "add llave [delta]" lo
+//...suma con una sola búsqueda (la llave se calcula una vez y, si no estaba, el contenido se coloca con ese valor) y "get llave" lo
+//...imprime. "aggload archivo" reparte el archivo entre varios hilos ("threads=N"): cada uno preagrega en sus propias tablas, una por
+//...partición, y después cada hilo junta una partición de todos los demás (igual que en Open Addressing). Remodel mueve los contenidos
+//...sin copiarlos, así que el acumulador se conserva*/
+
+/*Funciones para leer y sumar el acumulador que va después de los "len" bytes de un contenido*/
+static inline int64_t contentAcc(void *bytes, size_t len){
+    int64_t acc;
+    memcpy(&acc, (char*)bytes + len, sizeof(acc));
+    return acc;
+}
+static inline void addContentAcc(void *bytes, size_t len, int64_t delta){
+    int64_t acc = contentAcc(bytes, len) + delta;
+    memcpy((char*)bytes + len, &acc, sizeof(acc));
+}
+
+/*Función para sumar "delta" al acumulador de un record con su llave ya calculada. Si no estaba, se coloca con acumulador "delta".
+//...Regresa el contenido guardado (NULL si no se pudo)*/
+void* upsertKeySC(void **HT, int mode, uint32_t key, record *rec, int64_t delta){
+    void *bytes = NULL;
+    if(mode==LL){
+        HTable_SC **HT1 = (HTable_SC**)HT;
+        //Primero se expande la tabla si hace falta (así la búsqueda y la colocación usan la misma cabeza)
+        if(checkSize(*HT1, UP)==FULL)
+            (*HT1)=RemodelHTableCap_SC(*HT1, FULL);
+        size_t slot;
+        LLHash *chunk = HTfindkey_SC(HT1, key, rec, &slot);
+        if(chunk == NULL){
+            chunk = placeRecordSC(*HT1, key, rec);
+            //El contenido quedó en el chunk que regresó: sólo se revisan sus huellas para saber en qué posición
+            if(chunk != NULL)
+                findChainSC(chunk, key, rec, &slot);
+        }
+        if(chunk != NULL)
+            bytes = chunk->bytes[slot];
+        checkFloodSC(HT1);
+    }
+    else{
+        HTable_SCA **HT2 = (HTable_SCA**)HT;
+        if(checkSizeSCA(*HT2, UP)==FULL)
+            (*HT2)=RemodelHTableCap_SCA(*HT2, FULL);
+        AHead *head = &((*HT2)->table[hashFunction(key, (*HT2)->size)]);
+        size_t i = HTfindRecordKey_SCA(*HT2, key, rec);
+        if(i == NOT_FOUND){
+            size_t before = head->len;
+            placeRecordSCA(*HT2, key, rec);
+            i = (head->len > before) ? before : NOT_FOUND;
+        }
+        if(i != NOT_FOUND)
+            bytes = AHeadBytes(head)[i];
+        checkFloodSCA(HT2);
+    }
+    //Si hubo que resembrar, el contenido está en otra cabeza pero es el mismo (no se copia)
+    if(bytes != NULL)
+        addContentAcc(bytes, rec->len, delta);
+    return bytes;
+}
+
+/*Función para sumar "delta" al acumulador de un record (upsert_add)*/
+void* HTupsertAdd_SC(void **HT, int mode, record *rec, int64_t delta){
+    uint32_t key = (mode==LL) ? keySC(*(HTable_SC**)HT, rec) : keySCA(*(HTable_SCA**)HT, rec);
+    return upsertKeySC(HT, mode, key, rec, delta);
+}
+
+/*Función para leer el acumulador de un record. Regresa NO si no está*/
+int HTgetAccumulator_SC(void **HT, int mode, record *rec, int64_t *acc){
+    void *bytes = findContentSC(HT, mode, rec);
+    if(bytes == NULL)
+        return NO;
+    *acc = contentAcc(bytes, rec->len);
+    return YES;
+}
+
+/*Función para poner la semilla de una tabla de cualquiera de las dos estrategias (sólo en una tabla vacía)*/
+static inline void setTableSeedSC(void *HT, int mode, uint64_t seed){
+    if(mode==LL)
+        ((HTable_SC*)HT)->seed = seed;
+    else
+        ((HTable_SCA*)HT)->seed = seed;
+}
+
+/*Estructura de cada hilo de la agregación en paralelo*/
+typedef struct{
+    pthread_t thread;
+    int mode;
+    const char *begin;          //Líneas del archivo que le tocan a este hilo
+    const char *end;
+    size_t partitions;
+    void **local;               //Una tabla de preagregación por partición
+    uint64_t seed;              //Semilla de la tabla principal
+    size_t lines;               //Líneas que sí sumaron algo
+    void *all;                  //Todos los hilos (para juntar la partición "id")
+    int id;
+    int threads;
+}agg_worker_SC;
+
+/*Primera fase: cada hilo preagrega sus líneas en sus tablas locales*/
+void* aggBuildWorkerSC(void *arg){
+    agg_worker_SC *W = (agg_worker_SC*)arg;
+    char line[AGG_LINE];
+    char number[AGG_KEY];
+    record rec;
+    int64_t delta;
+    const char *p = W->begin;
+    while(p < W->end){
+        const char *eol = memchr(p, '\n', W->end - p);
+        size_t len = (eol != NULL) ? (size_t)(eol - p) : (size_t)(W->end - p);
+        if(len >= sizeof(line))
+            len = sizeof(line) - 1;
+        memcpy(line, p, len);
+        line[len] = '\0';
+        p = (eol != NULL) ? eol + 1 : W->end;
+        if(parseAggLine(line, &rec, number, &delta)==NO)
+            continue;
+        //La partición sale de la llave con la semilla de la tabla principal (la de todas las tablas locales, salvo que alguna se resiembre)
+        uint32_t key = seededKey(W->seed, (unsigned char*)rec.bytes, rec.len);
+        void **local = &(W->local[aggPartition(key, W->partitions)]);
+        uint64_t own = tableSeedSC(*local, W->mode);
+        upsertKeySC(local, W->mode, (own == W->seed) ? key : seededKey(own, (unsigned char*)rec.bytes, rec.len), &rec, delta);
+        W->lines++;
+    }
+    return NULL;
+}
+
+/*Función para sumar todos los contenidos (con su acumulador) de "source" en "HT". Con listas la llave se vuelve a calcular (los chunks
+//...sólo guardan la huella); con arreglos sólo si las semillas difieren*/
+void mergeAccumulatorsSC(void **HT, int mode, void *source){
+    record rec;
+    if(mode==LL){
+        HTable_SC *S = (HTable_SC*)source;
+        for(size_t i=0; i<S->size; i++){
+            for(LLHash *current = &(S->table[i]); current != NULL; current = current->next){
+                for(size_t s=0; s<CHUNK_SLOTS; s++){
+                    if(current->fp[s] == 0)
+                        continue;
+                    rec.bytes = current->bytes[s];
+                    rec.len = current->lens[s];
+                    upsertKeySC(HT, mode, keySC(*(HTable_SC**)HT, &rec), &rec, contentAcc(rec.bytes, rec.len));
+                }
+            }
+        }
+        return;
+    }
+    HTable_SCA *S = (HTable_SCA*)source;
+    for(size_t i=0; i<S->size; i++){
+        AHead *head = &(S->table[i]);
+        for(size_t j=0; j<head->len; j++){
+            rec.bytes = AHeadBytes(head)[j];
+            rec.len = AHeadLens(head)[j];
+            HTable_SCA *T = *(HTable_SCA**)HT;
+            uint32_t key = (T->seed == S->seed) ? head->keys[j] : keySCA(T, &rec);
+            upsertKeySC(HT, mode, key, &rec, contentAcc(rec.bytes, rec.len));
+        }
+    }
+}
+
+/*Segunda fase: el hilo "id" junta en la tabla del primer hilo su partición de todos los demás*/
+void* aggMergeWorkerSC(void *arg){
+    agg_worker_SC *W = (agg_worker_SC*)arg;
+    agg_worker_SC *all = (agg_worker_SC*)W->all;
+    for(int t=1; t<W->threads; t++){
+        mergeAccumulatorsSC(&(all[0].local[W->id]), W->mode, all[t].local[W->id]);
+        freeHTableMode_SC(all[t].local[W->id], W->mode);
+        all[t].local[W->id] = NULL;
+    }
+    return NULL;
+}
+
+/*Función para correr una fase en todos los hilos (el primero es el hilo actual)*/
+void runAggWorkersSC(agg_worker_SC *W, int threads, void* (*phase)(void *arg)){
+    W[0].thread = pthread_self();
+    for(int t=1; t<threads; t++){
+        if(pthread_create(&W[t].thread, NULL, phase, &W[t]) != 0){
+            //Si no se pudo crear el hilo, su parte se hace aquí mismo
+            phase(&W[t]);
+            W[t].thread = pthread_self();
+        }
+    }
+    phase(&W[0]);
+    for(int t=1; t<threads; t++){
+        if(!pthread_equal(W[t].thread, pthread_self()))
+            pthread_join(W[t].thread, NULL);
+    }
+}
+
+/*Función para agregar un archivo completo en "HT" con "threads" hilos. Regresa el No. de líneas que sumaron algo*/
+size_t HTaggregateFile_SC(void **HT, int mode, const char *path, int threads){
+    FILE *file = fopen(path, "rb");
+    if(file == NULL){
+        fprintf(stderr, "Cannot open %s\n", path);
+        return 0;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char *data = (char*)malloc((size > 0) ? (size_t)size : 1);
+    if(data == NULL){
+        fprintf(stderr, "Cannot allocate memory for aggregation.\n");
+        fclose(file);
+        return 0;
+    }
+    size_t n = fread(data, 1, (size > 0) ? (size_t)size : 0, file);
+    fclose(file);
+    if(threads < 1)
+        threads = 1;
+    agg_worker_SC *W = (agg_worker_SC*)calloc(threads, sizeof(agg_worker_SC));
+    if(W == NULL){
+        fprintf(stderr, "Cannot allocate memory for aggregation.\n");
+        exit(1);
+    }
+    //Se reparte el archivo en pedazos del mismo tamaño, recorridos hasta el siguiente fin de línea
+    uint64_t seed = tableSeedSC(*HT, mode);
+    const char *p = data;
+    for(int t=0; t<threads; t++){
+        const char *end = data + n*(t+1)/threads;
+        if(end < p)
+            end = p;
+        while(end < data + n && end > data && end[-1] != '\n')
+            end++;
+        W[t].mode = mode;
+        W[t].begin = p;
+        W[t].end = end;
+        W[t].partitions = threads;
+        W[t].id = t;
+        W[t].threads = threads;
+        W[t].all = W;
+        W[t].local = (void**)malloc(sizeof(void*)*threads);
+        if(W[t].local == NULL){
+            fprintf(stderr, "Cannot allocate memory for aggregation.\n");
+            exit(1);
+        }
+        W[t].seed = seed;
+        for(int q=0; q<threads; q++){
+            W[t].local[q] = newHTableMode_SC(mode);
+            setTableSeedSC(W[t].local[q], mode, seed);
+        }
+        p = end;
+    }
+    runAggWorkersSC(W, threads, aggBuildWorkerSC);
+    runAggWorkersSC(W, threads, aggMergeWorkerSC);
+    //Las particiones no comparten llaves: sólo se pasan a la tabla principal
+    size_t lines = 0;
+    for(int t=0; t<threads; t++)
+        lines += W[t].lines;
+    for(int q=0; q<threads; q++){
+        mergeAccumulatorsSC(HT, mode, W[0].local[q]);
+        freeHTableMode_SC(W[0].local[q], mode);
+    }
+    for(int t=0; t<threads; t++)
+        free(W[t].local);
+    free(W);
+    free(data);
+    return lines;
+}
+
+/*Función para atender los comandos de agregación: "add llave [delta]", "get llave" y "aggload archivo". Regresa NO si no es uno de ellos*/
+int aggCommandSC(void **HT, int mode, const char *buffer, char *command, char *number, int threads){
+    record rec;
+    rec.bytes = number;
+    rec.len = strlen(number);
+    if(strcmp("add", command)==0){
+        char key[AGG_KEY];
+        int64_t delta;
+        if(parseAggLine(buffer, &rec, key, &delta)==YES)
+            HTupsertAdd_SC(HT, mode, &rec, delta);
+        return YES;
+    }
+    if(strcmp("get", command)==0){
+        int64_t acc;
+        if(HTgetAccumulator_SC(HT, mode, &rec, &acc)==YES)
+            printf("%s: %lld\n", number, (long long)acc);
+        else
+            printf("No encontrado: %s\n", number);
+        return YES;
+    }
+    if(strcmp("aggload", command)==0){
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        size_t lines = HTaggregateFile_SC(HT, mode, number, threads);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        printf("Agregación: %zu líneas, %zu llaves (%.3f ms, %d hilos)\n", lines, tableCountSC(*HT, mode),
+               (end.tv_sec - start.tv_sec)*1e3 + (end.tv_nsec - start.tv_nsec)/1e6, (threads < 1) ? 1 : threads);
+        return YES;
+    }
+    return NO;
+}
+
+/*.....................................REDIMENSIÓN EN SEGUNDO PLANO......................................................................*/
+/*Lo propio de las listas y los arreglos para la redimensión en segundo plano (el hilo, la bitácora y la opción "bg" están en ht_common).
+//...A diferencia de Remodel, el hilo copia los contenidos en vez de moverlos, porque la tabla vieja se sigue usando mientras tanto. Como
+//...una lista o un arreglo siempre admite uno más, la redimensión se agenda cuando checkSize (o checkSizeSCA) dice que la tabla está
+//...llena o vacía, y mientras el hilo copia se sigue insertando en la vieja sin revisar su tamaño (así tampoco se recorren sus cabezas)*/
+
+/*Función para copiar en "HT" un lote de contenidos de otra tabla, con sus llaves calculadas por lotes (la otra tabla conserva los suyos)*/
+void copyBatchSC(HTable_SC *HT, moved_item_SC *items, size_t n){
+    uint32_t keys[HASH_BATCH];
+    movedKeysSC(HT->seed, items, n, keys);
+    for(size_t i=0; i<n; i++){
+        void *bytes = memMalloc(MEM_KEYS, contentSize(items[i].len));
+        if(bytes == NULL){
+            fprintf(stderr, "Cannot allocate memory for element!\n");
+            return;
+        }
+        memcpy(bytes, items[i].bytes, contentSize(items[i].len));
+        if(linkRecordSC(HT, keys[i], bytes, items[i].len) == NULL)
+            memFree(MEM_KEYS, bytes, contentSize(items[i].len));
+    }
+}
+
+/*Función del hilo para copiar las cabezas [start, end) de la tabla vieja a la nueva*/
+void copyResizeSC(resize_worker *RW, size_t start, size_t end){
+    if(RW->mode==LL){
+        HTable_SC *source = (HTable_SC*)RW->source;
+        HTable_SC *target = (HTable_SC*)RW->target;
+        int flooded = target->flooded;
+        moved_item_SC batch[HASH_BATCH];
+        size_t n = 0;
+        for(size_t i=start; i<end; i++){
+            for(LLHash *aux = &(source->table[i]); aux!=NULL; aux = aux->next){
+                for(size_t j=0; j<CHUNK_SLOTS; j++){
+                    if(aux->fp[j] == 0)
+                        continue;
+                    batch[n].bytes = aux->bytes[j];
+                    batch[n].len = aux->lens[j];
+                    if(++n == HASH_BATCH){
+                        copyBatchSC(target, batch, n);
+                        n = 0;
+                    }
+                }
+            }
+        }
+        copyBatchSC(target, batch, n);
+        //Como en Remodel, las listas que se recorrieron al copiar no cuentan como inserciones
+        target->flooded = flooded;
+        return;
+    }
+    //Con arreglos la tabla nueva tiene la misma semilla, así que se reutiliza la llave guardada
+    HTable_SCA *source = (HTable_SCA*)RW->source;
+    HTable_SCA *target = (HTable_SCA*)RW->target;
+    for(size_t i=start; i<end; i++){
+        AHead *head = &(source->table[i]);
+        for(size_t j=0; j<head->len; j++){
+            size_t len = AHeadLens(head)[j];
+            void *bytes = memMalloc(MEM_KEYS, contentSize(len));
+            if(bytes == NULL){
+                fprintf(stderr, "Cannot allocate memory for element!\n");
+                return;
+            }
+            memcpy(bytes, AHeadBytes(head)[j], contentSize(len));
+            if(appendMovedSCA(target, head->keys[j], bytes, len) == NO)
+                memFree(MEM_KEYS, bytes, contentSize(len));
+        }
+    }
+}
+
+/*Función para colocar un record sin revisar el tamaño de la tabla ni la lista más larga (la tabla vieja no se puede reconstruir mientras
+//...el hilo la copia, y la nueva se revisa al quedar en su lugar). Regresa YES si el record no estaba*/
+int placeNewSC(void *HT, int mode, record *rec){
+    if(mode==LL){
+        HTable_SC *L = (HTable_SC*)HT;
+        size_t slot;
+        uint32_t key = keySC(L, rec);
+        if(HTfindkey_SC(&L, key, rec, &slot) != NULL)
+            return NO;
+        return (placeRecordSC(L, key, rec) != NULL) ? YES : NO;
+    }
+    HTable_SCA *A = (HTable_SCA*)HT;
+    uint32_t key = keySCA(A, rec);
+    if(HTfindRecordKey_SCA(A, key, rec) != NOT_FOUND)
+        return NO;
+    size_t before = A->occupied_elements;
+    placeRecordSCA(A, key, rec);
+    return (A->occupied_elements > before) ? YES : NO;
+}
+
+/*Función para quitar un record de una tabla de cualquiera de las dos estrategias sin revisar si hay que reducirla. Regresa YES si estaba*/
+int removeModeSC(void **HT, int mode, record *rec){
+    if(mode==LL)
+        return removeRecordSC((HTable_SC**)HT, rec);
+    return removeRecordSCA((HTable_SCA**)HT, rec);
+}
+
+/*Función del hilo para aplicar una operación de la bitácora a la tabla nueva*/
+void replayResizeSC(resize_worker *RW, record *rec, int operation){
+    if(operation == UP)
+        placeNewSC(RW->target, RW->mode, rec);
+    else
+        removeModeSC(&RW->target, RW->mode, rec);
+}
+
+/*Función para agendar una redimensión (sólo se crea la tabla nueva vacía, con la misma semilla, y el hilo; no se copia nada aquí)*/
+void scheduleResizeSC(resize_worker *RW, void **HT, int state){
+    size_t newIndex = (RW->mode==LL) ? ((HTable_SC*)*HT)->index_size : ((HTable_SCA*)*HT)->index_size;
+    if(state==FULL)
+        newIndex+=1;
+    if(state==EMPTY)
+        newIndex-=1;
+    void *target;
+    if(RW->mode==LL){
+        HTable_SC *T = newHTableCap_SC(newIndex);
+        T->seed = ((HTable_SC*)*HT)->seed;
+        T->reseed_floor = ((HTable_SC*)*HT)->reseed_floor;
+        target = T;
+    }
+    else{
+        HTable_SCA *T = newHTableCap_SCA(newIndex);
+        T->seed = ((HTable_SCA*)*HT)->seed;
+        T->reseed_floor = ((HTable_SCA*)*HT)->reseed_floor;
+        target = T;
+    }
+    if(startResizeWorker(RW, *HT, target, tableSizeSC(*HT, RW->mode))==YES)
+        return;
+    //Si no se pudo crear el hilo, se redimensiona aquí mismo como siempre
+    freeHTableMode_SC(target, RW->mode);
+    if(RW->mode==LL)
+        (*HT) = RemodelHTableCap_SC((HTable_SC*)*HT, state);
+    else
+        (*HT) = RemodelHTableCap_SCA((HTable_SCA*)*HT, state);
+}
+
+/*Función para cambiar la tabla vieja por la nueva si el hilo ya terminó. Con "wait" se espera a que termine*/
+void swapResizedSC(resize_worker *RW, void **HT, int wait){
+    if(finishResizeWorker(RW, wait)==NO)
+        return;
+    (*HT) = RW->target;
+    freeHTableMode_SC(RW->source, RW->mode);
+    RW->source = NULL;
+    RW->target = NULL;
+}
+
+/*Función para insertar con redimensión en segundo plano*/
+void HTinsertRecord_SCBG(resize_worker *RW, void **HT, record *rec){
+    swapResizedSC(RW, HT, NO);
+    if(resizePhase(RW) == RS_IDLE){
+        int state = (RW->mode==LL) ? checkSize((HTable_SC*)*HT, UP) : checkSizeSCA((HTable_SCA*)*HT, UP);
+        if(state==FULL)
+            scheduleResizeSC(RW, HT, FULL);
+        if(resizePhase(RW) == RS_IDLE){
+            if(RW->mode==LL)
+                insertKeySC((HTable_SC**)HT, keySC((HTable_SC*)*HT, rec), rec);
+            else
+                insertKeySCA((HTable_SCA**)HT, keySCA((HTable_SCA*)*HT, rec), rec);
+            return;
+        }
+    }
+    pthread_mutex_lock(&RW->lock);
+    //Si el hilo acaba de terminar, la bitácora ya no se aplicaría: se cambia de tabla y se inserta en la nueva
+    if(RW->phase != RS_BUILDING){
+        pthread_mutex_unlock(&RW->lock);
+        HTinsertRecord_SCBG(RW, HT, rec);
+        return;
+    }
+    if(placeNewSC(*HT, RW->mode, rec)==YES)
+        logResizeOp(RW, rec, UP);
+    pthread_mutex_unlock(&RW->lock);
+}
+
+/*Función para borrar con redimensión en segundo plano*/
+void HTdeleteRecord_SCBG(resize_worker *RW, void **HT, record *rec){
+    swapResizedSC(RW, HT, NO);
+    if(resizePhase(RW) == RS_IDLE){
+        if(removeModeSC(HT, RW->mode, rec)==NO)
+            return;
+        int state = (RW->mode==LL) ? checkSize((HTable_SC*)*HT, DOWN) : checkSizeSCA((HTable_SCA*)*HT, DOWN);
+        size_t index = (RW->mode==LL) ? ((HTable_SC*)*HT)->index_size : ((HTable_SCA*)*HT)->index_size;
+        if(state==EMPTY && index>0)
+            scheduleResizeSC(RW, HT, EMPTY);
+        return;
+    }
+    pthread_mutex_lock(&RW->lock);
+    if(RW->phase != RS_BUILDING){
+        pthread_mutex_unlock(&RW->lock);
+        HTdeleteRecord_SCBG(RW, HT, rec);
+        return;
+    }
+    if(removeModeSC(HT, RW->mode, rec)==YES)
+        logResizeOp(RW, rec, DOWN);
+    pthread_mutex_unlock(&RW->lock);
+}
+
+/*Función para buscar con redimensión en segundo plano (mientras el hilo copia, la tabla vieja sigue teniendo todo). Regresa YES si está*/
+int HTfindRecord_SCBG(resize_worker *RW, void **HT, record *rec){
+    swapResizedSC(RW, HT, NO);
+    int building = (resizePhase(RW) != RS_IDLE);
+    if(building)
+        pthread_mutex_lock(&RW->lock);
+    size_t slot;
+    int found = (RW->mode==LL) ? (HTfindRecord_SC((HTable_SC**)HT, rec, &slot) != NULL) : (HTfindRecord_SCA((HTable_SCA**)HT, rec) != NOT_FOUND);
+    if(building)
+        pthread_mutex_unlock(&RW->lock);
+    return found ? YES : NO;
+}
+
+/*Función para terminar: espera a la redimensión pendiente (si la hay) y libera la bitácora*/
+void freeResizeSC(resize_worker *RW, void **HT){
+    swapResizedSC(RW, HT, YES);
+    freeResizeWorker(RW);
+}
+
+/*...............................................CICLO DE COMANDOS.........................................................................*/
+/*Operaciones de cada estrategia para el ciclo de comandos (runCommands). Las listas y los arreglos (con o sin TTL) comparten "commands_SC";
+//...la adaptativa, la de hashing lineal y la extensible en disco usan su propia tabla como "T"*/
+
+/*Estructura con lo que necesita el ciclo de las listas y los arreglos*/
+typedef struct{
+    void *HT;
+    int mode;
+    int_tables_SC IT;           //Tablas de llaves enteras (IT.width es 0 si no se usan)
+    int threads;                //Hilos de las operaciones de conjuntos
+    void *other;                //Otra tabla (de la misma estrategia) para las operaciones de conjuntos; se lee con "load archivo"
+    int agg;                    //YES si los contenidos llevan acumulador ("agg")
+    resize_worker RW;           //Redimensión en segundo plano ("bg")
+    int background;
+    timer_wheel W;              //Rueda del TTL (sólo con "ttl=ms")
+}commands_SC;
+
+/*Comandos propios de las listas y los arreglos: los de las tablas enteras, conjuntos, lotes y agregación*/
+int commandSC(void *T, char *buffer, char *command, char *number){
+    commands_SC *C = (commands_SC*)T;
+    //Con "bg", los comandos que no son insert, delete o find trabajan sobre la tabla ya redimensionada
+    if(C->background && strcmp("insert", command)!=0 && strcmp("delete", command)!=0 && strcmp("find", command)!=0)
+        swapResizedSC(&C->RW, &C->HT, YES);
+    if(isAggCommand(command)){                      //Agregación (sólo si los contenidos tienen dónde llevar el acumulador)
+        if(C->agg)
+            aggCommandSC(&C->HT, C->mode, buffer, command, number, C->threads);
+        else
+            fprintf(stderr, "Aggregation needs the agg option\n");
+        return YES;
+    }
+    if(intCommandSC(&C->IT, command, number, (C->mode==LL) ? moveKeyToSC : moveKeyToSCA, &C->HT)==YES)
+        return YES;
+    if(setCommandSC(&C->HT, &C->other, C->mode, command, number, C->threads)==YES)     //Operaciones de conjuntos
+        return YES;
+    if(batchCommandSC(&C->HT, C->mode, command, number)==YES)       //Inserción o búsqueda por lotes desde un archivo
+        return YES;
+    return NO;
+}
+void insertSC(void *T, record *rec, const char *extra){
+    commands_SC *C = (commands_SC*)T;
+    (void)extra;
+    if(C->agg)
+        HTupsertAdd_SC(&C->HT, C->mode, rec, 1);
+    else if(C->background)
+        HTinsertRecord_SCBG(&C->RW, &C->HT, rec);
+    else if(C->mode==LL)
+        HTinsertRecord_SC((HTable_SC**)&C->HT, rec);
+    else
+        HTinsertRecord_SCA((HTable_SCA**)&C->HT, rec);
+}
+void removeSC(void *T, record *rec){
+    commands_SC *C = (commands_SC*)T;
+    if(C->background)
+        HTdeleteRecord_SCBG(&C->RW, &C->HT, rec);
+    else if(C->mode==LL)
+        HTdeleteRecord((HTable_SC**)&C->HT, rec);
+    else
+        HTdeleteRecordSCA((HTable_SCA**)&C->HT, rec);
+}
+int findSC(void *T, record *rec){
+    commands_SC *C = (commands_SC*)T;
+    if(C->background)
+        return HTfindRecord_SCBG(&C->RW, &C->HT, rec);
+    if(C->mode==LL){
+        size_t slot;
+        return (HTfindRecord_SC((HTable_SC**)&C->HT, rec, &slot) != NULL) ? YES : NO;
+    }
+    return (HTfindRecord_SCA((HTable_SCA**)&C->HT, rec) != NOT_FOUND) ? YES : NO;
+}
+void printSC(void *T){
+    commands_SC *C = (commands_SC*)T;
+    if(C->background)
+        swapResizedSC(&C->RW, &C->HT, YES);
+    if(C->mode==LL)
+        HTprint_SC((HTable_SC*)C->HT);
+    else
+        HTprint_SCA((HTable_SCA*)C->HT);
+}
+size_t countSC(void *T){
+    commands_SC *C = (commands_SC*)T;
+    return tableCountSC(C->HT, C->mode);
+}
+void destroySC(void *T){
+    commands_SC *C = (commands_SC*)T;
+    freeResizeSC(&C->RW, &C->HT);
+    if(C->other != NULL)
+        freeHTableMode_SC(C->other, C->mode);
+    freeIntTablesSC(&C->IT);
+    freeHTableMode_SC(C->HT, C->mode);
+}
+const command_ops COMMANDS_SC = {commandSC, insertSC, removeSC, findSC, printSC, countSC, NULL, destroySC};
+
+/*Con TTL: antes de cada comando se avanza la rueda y se quitan algunos vencidos; "advance ms" adelanta el reloj*/
+int commandTTL_SC(void *T, char *buffer, char *command, char *number){
+    commands_SC *C = (commands_SC*)T;
+    (void)buffer;
+    ttlTick_SC(&C->HT, C->mode, &C->W);
+    if(strcmp("advance", command)==0){
+        C->W.offset += strtoull(number, NULL, 10)*1000000ULL;
+        return YES;
+    }
+    return NO;
+}
+void insertTTL_SC(void *T, record *rec, const char *extra){     //"insert llave [ms]"
+    commands_SC *C = (commands_SC*)T;
+    HTinsertRecordTTL_SC(&C->HT, C->mode, rec, &C->W, (extra[0] != '\0') ? strtoull(extra, NULL, 10)*1000000ULL : C->W.ttl);
+}
+void removeTTL_SC(void *T, record *rec){
+    commands_SC *C = (commands_SC*)T;
+    HTdeleteRecordTTL_SC(&C->HT, C->mode, rec);
+}
+int findTTL_SC(void *T, record *rec){
+    commands_SC *C = (commands_SC*)T;
+    return HTfindRecordTTL_SC(&C->HT, C->mode, rec, &C->W);
+}
+void statsTTL_SC(void *T){
+    ttlStats(&((commands_SC*)T)->W);
+}
+void destroyTTL_SC(void *T){
+    commands_SC *C = (commands_SC*)T;
+    ttlStats(&C->W);
+    freeTimerWheel(&C->W);
+    freeHTableMode_SC(C->HT, C->mode);
+}
+const command_ops COMMANDS_TTL_SC = {commandTTL_SC, insertTTL_SC, removeTTL_SC, findTTL_SC, printSC, countSC, statsTTL_SC, destroyTTL_SC};
+
+/*Tabla adaptativa ("mode" sólo es la forma con la que empieza)*/
+void insertSCD(void *T, record *rec, const char *extra){
+    (void)extra;
+    HTinsertRecord_SCD((HTable_SCD*)T, rec);
+}
+void removeSCD(void *T, record *rec){
+    HTdeleteRecordSCD((HTable_SCD*)T, rec);
+}
+int findSCD(void *T, record *rec){
+    return HTfindRecord_SCD((HTable_SCD*)T, rec);
+}
+void printSCD(void *T){
+    HTable_SCD *A = (HTable_SCD*)T;
+    if(A->mode==LL)
+        HTprint_SC((HTable_SC*)A->HT);
+    else
+        HTprint_SCA((HTable_SCA*)A->HT);
+}
+size_t countSCD(void *T){
+    HTable_SCD *A = (HTable_SCD*)T;
+    return tableCountSC(A->HT, A->mode);
+}
+void statsSCD(void *T){
+    HTstats_SCD((HTable_SCD*)T);
+}
+void destroySCD(void *T){
+    HTstats_SCD((HTable_SCD*)T);
+    freeHTable_SCD((HTable_SCD*)T);
+}
+const command_ops COMMANDS_SCD = {NULL, insertSCD, removeSCD, findSCD, printSCD, countSCD, statsSCD, destroySCD};
+
+/*Tabla con hashing lineal ("mode" es la forma de sus cubetas)*/
+void insertSCL(void *T, record *rec, const char *extra){
+    (void)extra;
+    HTinsertRecord_SCL((HTable_SCL*)T, rec);
+}
+void removeSCL(void *T, record *rec){
+    HTdeleteRecordSCL((HTable_SCL*)T, rec);
+}
+int findSCL(void *T, record *rec){
+    return HTfindRecord_SCL((HTable_SCL*)T, rec);
+}
+void printSCL(void *T){
+    HTprint_SCL((HTable_SCL*)T);
+}
+size_t countSCL(void *T){
+    return ((HTable_SCL*)T)->occupied_elements;
+}
+void statsSCL(void *T){
+    HTstats_SCL((HTable_SCL*)T);
+}
+void destroySCL(void *T){
+    HTstats_SCL((HTable_SCL*)T);
+    freeHTable_SCL((HTable_SCL*)T);
+}
+const command_ops COMMANDS_SCL = {NULL, insertSCL, removeSCL, findSCL, printSCL, countSCL, statsSCL, destroySCL};
+
+/*Tabla extensible en disco (sus datos se quedan en el archivo al salir); "findall archivo" busca por lotes las llaves de un archivo*/
+int commandSCE(void *T, char *buffer, char *command, char *number){
+    (void)buffer;
+    if(strcmp("findall", command)==0){
+        findAllSCE(*(HTable_SCE**)T, number);
+        return YES;
+    }
+    return NO;
+}
+void insertSCE(void *T, record *rec, const char *extra){
+    (void)extra;
+    HTinsertRecord_SCE((HTable_SCE**)T, rec);
+}
+void removeSCE(void *T, record *rec){
+    HTdeleteRecordSCE((HTable_SCE**)T, rec);
+}
+int findSCE(void *T, record *rec){
+    return HTfindRecord_SCE((HTable_SCE**)T, rec);
+}
+void printSCE(void *T){
+    HTprint_SCE(*(HTable_SCE**)T);
+}
+size_t countSCE(void *T){
+    return (*(HTable_SCE**)T)->occupied_elements;
+}
+void statsSCE(void *T){
+    HTstats_SCE(*(HTable_SCE**)T);
+}
+void destroySCE(void *T){
+    HTstats_SCE(*(HTable_SCE**)T);
+    freeHTable_SCE(*(HTable_SCE**)T);
+}
+const command_ops COMMANDS_SCE = {commandSCE, insertSCE, removeSCE, findSCE, printSCE, countSCE, statsSCE, destroySCE};
+
+//************************************INT MAIN********************************************************************************************
+int main(int argc, char **argv){
+    //Aquí se elige manualmente el tipo de estrategia (LL = Linked lists, A = Arrays)
+    int mode;
+    if(argc == 1){
+        printf("Bienvenid@. Eliga la estrategia (1 = Linked lists, 0 = Arrays, 2 = Extensible en disco): ");
+        scanf("%d", &mode);
+    }
+    else{
+        mode = atoi(argv[1]);
+    }
+    //Después del modo, cada argumento es una opción ("clave=valor" o una palabra) y pueden ir en cualquier orden: las de traza
+    //...("record=archivo", "replay=archivo", "threads=N", "timed" y "perf"; "threads=N" también es el No. de hilos de las operaciones de
+    //...conjuntos), la del TTL ("ttl=ms"), las de la tabla extensible en disco ("file=ruta", "page=bytes" y "cachepages=N"), la de la
+    //...tabla adaptativa ("adapt" o "adapt=archivo"), la del hashing lineal ("linear"), la de la agregación ("agg"), la de la redimensión
+    //...en segundo plano ("bg", sólo listas y arreglos sin TTL ni agregación) y la política de memoria para los arreglos grandes (p. ej.
+    //..."huge,prefault")
+    trace_options TO = {NULL, NULL, 1, NO};
+    int ttl = NO;
+    uint64_t ttl_ms = 0;
+    eh_options EO = {"HT_SCE.db", EH_MIN_PAGE, 256};
+    int adapt = NO;
+    const char *adapt_log = NULL;
+    int linear = NO;
+    int agg = NO;
+    int background = NO;
+    for(int i=2; i<argc; i++){
+        if(parseTraceOption(&TO, argv[i])==NO && parseDiskOption(&EO, argv[i])==NO && parseTTLOption(&ttl, &ttl_ms, argv[i])==NO &&
+           parseAdaptOption(&adapt, &adapt_log, argv[i])==NO && parseLinearOption(&linear, argv[i])==NO && parseAggOption(&agg, argv[i])==NO &&
+           parseBackgroundOption(&background, argv[i])==NO && parseAllocPolicy(argv[i])==NO)
+            fprintf(stderr, "Unknown option: %s\n", argv[i]);
+    }
+    //Con "replay=archivo" no se leen comandos: se repite la traza con la estrategia elegida y se termina
+    if(TO.replay != NULL){
+        if(mode!=LL && mode!=AR)
+            return 0;
+        return replayTrace(&TO, (mode==LL) ? &REPLAY_SC : &REPLAY_SCA, mode);
+    }
+    if(adapt && (ttl || (mode!=LL && mode!=AR))){
+        fprintf(stderr, "Adaptive mode is only available for linked lists and arrays (without TTL)\n");
+        return 1;
+    }
+    if(linear && (adapt || ttl || (mode!=LL && mode!=AR))){
+        fprintf(stderr, "Linear hashing is only available for linked lists and arrays (without TTL or adaptive mode)\n");
+        return 1;
+    }
+    if(agg && (adapt || linear || ttl || (mode!=LL && mode!=AR))){
+        fprintf(stderr, "Aggregation is only available for linked lists and arrays (without TTL, adaptive mode or linear hashing)\n");
+        return 1;
+    }
+    trace_writer TW;
+    openTraceWriter(&TW, TO.record);
+    //Se eligen las operaciones del ciclo de comandos según la estrategia y las opciones
+    commands_SC C;
+    HTable_SCE *E;
+    const command_ops *ops = &COMMANDS_SC;
+    void *T = &C;
+    if(adapt){
+        ops = &COMMANDS_SCD;
+        T = newHTable_SCD(mode, adapt_log);
+    }
+    else if(linear){
+        ops = &COMMANDS_SCL;
+        T = newHTable_SCL(mode);
+    }
+    else if(mode==EH){
+        E = newHTable_SCE(EO.path, EO.page_size, EO.cache_pages);
+        ops = &COMMANDS_SCE;
+        T = &E;
+    }
+    else if(mode==LL || mode==AR){
+        C.HT = newHTableMode_SC(mode);
+        C.mode = mode;
+        C.threads = TO.threads;
+        C.other = NULL;
+        C.agg = agg;
+        //La redimensión en segundo plano no lleva en su bitácora el vencimiento ni el acumulador, así que no va con TTL ni con agregación
+        C.background = background && !ttl && !agg;
+        initResizeWorker(&C.RW, mode, copyResizeSC, replayResizeSC);
+        //Mientras todas las llaves sean números se usan las tablas de llaves enteras (en cualquiera de las dos estrategias; no con TTL
+        //...ni con agregación, que no tienen dónde llevar el vencimiento o el acumulador, ni con "bg")
+        C.IT.width = 0;
+        C.IT.HT32 = NULL;
+        C.IT.HT64 = NULL;
+        if(ttl){
+            content_extra = sizeof(uint64_t);               //Cada contenido lleva su vencimiento al final
+            initTimerWheel(&C.W, ttl_ms);
+            ops = &COMMANDS_TTL_SC;
+        }
+        else if(agg)
+            content_extra = sizeof(int64_t);                //Cada contenido lleva su acumulador al final
+        else if(!C.background)
+            initIntTablesSC(&C.IT);
+    }
+    else{
+        closeTraceWriter(&TW);
+        printf("Gracias!\n");
+        return 0;
     }
+    runCommands(ops, T, &TW);
     printf("Gracias!\n");
     return 0;
 }
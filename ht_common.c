@@ -0,0 +1,1398 @@
+//Funciones comunes de las tablas hash (ver ht_common.h)
+#include "ht_common.h"
+
+//En este arreglo se contienen los números primos menores a cada potencia de 2 (hasta 2^16)
+const uint32_t HASH_SIZE[HASH_SIZES] = {5, 23, 127, 251, 509, 1021, 2039, 4093, 8191, 16381, 32749, 65521, 131071, 262139, 524287, 1048573, 2097143, 4194301, 8388593, 16777213, 33554393, 67108859, 134217689, 268435399, 536870909, 1073741789, 2147483647, 4294967291};
+
+//Constante de ADLER
+const uint32_t MOD_ADLER = 65521;
+
+/*..........................................CONTADORES DE HARDWARE.......................................................................*/
+const char *PERF_KIND_NAMES[PERF_KINDS] = {"", "insert", "delete", "find", "Remodel"};
+const char *PERF_EVENT_NAMES[PERF_EVENTS] = {"instrucciones", "ciclos", "fallos de caché", "fallos de salto", "fallos de TLB"};
+const uint32_t PERF_EVENT_TYPES[PERF_EVENTS] = {PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE};
+const uint64_t PERF_EVENT_CONFIGS[PERF_EVENTS] = {PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES, PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)};
+
+//Variables globales de los contadores
+int perf_enabled = NO;
+__thread perf_group perf_thread;
+uint64_t perf_totals[PERF_KINDS][PERF_EVENTS];
+size_t perf_ops[PERF_KINDS];
+int perf_available[PERF_EVENTS];        //YES si algún hilo pudo abrir ese contador
+
+/*Función para abrir el grupo de contadores del hilo actual (si alguno no existe en este procesador, se sigue sin él)*/
+void perfOpen(){
+    perf_group *P = &perf_thread;
+    P->tried = YES;
+    P->leader = -1;
+    P->n = 0;
+    for(int e=0; e<PERF_EVENTS; e++){
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_EVENT_TYPES[e];
+        attr.config = PERF_EVENT_CONFIGS[e];
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP;
+        attr.disabled = (P->leader == -1);
+        P->fd[e] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, P->leader, 0);
+        if(P->fd[e] < 0){
+            P->fd[e] = -1;
+            continue;
+        }
+        if(P->leader == -1)
+            P->leader = P->fd[e];
+        P->n++;
+        __atomic_store_n(&perf_available[e], YES, __ATOMIC_RELAXED);
+    }
+    //El aviso sólo se da una vez (aunque cada hilo lo intente)
+    static int warned = NO;
+    if(P->leader == -1){
+        if(__atomic_exchange_n(&warned, YES, __ATOMIC_RELAXED) == NO)
+            fprintf(stderr, "Cannot open performance counters (perf_event_paranoid?)\n");
+        return;
+    }
+    ioctl(P->leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(P->leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+/*Función para pasar las sumas del hilo actual a los totales y cerrar sus contadores*/
+void perfFlush(){
+    perf_group *P = &perf_thread;
+    for(int k=0; k<PERF_KINDS; k++){
+        for(int e=0; e<PERF_EVENTS; e++)
+            __atomic_add_fetch(&perf_totals[k][e], P->local[k][e], __ATOMIC_RELAXED);
+        __atomic_add_fetch(&perf_ops[k], P->ops[k], __ATOMIC_RELAXED);
+    }
+    memset(P->local, 0, sizeof(P->local));
+    memset(P->ops, 0, sizeof(P->ops));
+    if(P->tried){
+        for(int e=0; e<PERF_EVENTS; e++){
+            if(P->fd[e] != -1)
+                close(P->fd[e]);
+        }
+    }
+    P->tried = NO;
+}
+
+/*Función para imprimir los contadores por operación de cada tipo (ya pasados a los totales)*/
+void perfReport(){
+    if(!perf_enabled)
+        return;
+    int any = NO;
+    for(int e=0; e<PERF_EVENTS; e++)
+        any |= perf_available[e];
+    if(!any){
+        printf("Contadores por operación: no disponibles\n");
+        return;
+    }
+    printf("Contadores por operación:");
+    for(int e=0; e<PERF_EVENTS; e++){
+        if(perf_available[e])
+            printf(" %s |", PERF_EVENT_NAMES[e]);
+    }
+    printf(" IPC\n");
+    for(int k=1; k<PERF_KINDS; k++){
+        if(perf_ops[k] == 0)
+            continue;
+        printf("%s (%zu):", PERF_KIND_NAMES[k], perf_ops[k]);
+        for(int e=0; e<PERF_EVENTS; e++){
+            if(perf_available[e])
+                printf(" %.2f |", (double)perf_totals[k][e]/perf_ops[k]);
+        }
+        if(perf_available[0] && perf_available[1] && perf_totals[k][1] > 0)
+            printf(" %.2f", (double)perf_totals[k][0]/perf_totals[k][1]);
+        printf("\n");
+    }
+}
+
+/*..........................................CONTABILIDAD DE MEMORIA......................................................................*/
+//Variables globales de la contabilidad (se actualizan con atómicas: el hilo de redimensión también reserva)
+size_t mem_bytes[MEM_KINDS];
+size_t mem_current = 0;         //Suma de todos los tipos (incluida la holgura)
+size_t mem_peak = 0;            //Máximo de mem_current
+size_t mem_allocated = 0;       //Total reservado desde el inicio (sólo crece)
+size_t mem_remodel_bytes = 0;   //Reservado durante los Remodel
+size_t mem_remodels = 0;        //No. de Remodel
+//Lo que ha reservado el hilo actual y sus Remodel (la repetición de trazas los usa para su línea de tiempo)
+__thread size_t mem_thread_allocated = 0;
+__thread size_t mem_thread_remodels = 0;
+
+/*Funciones como malloc, realloc y free que además llevan la cuenta (free necesita los mismos bytes que se pidieron)*/
+void* memMalloc(int kind, size_t bytes){
+    void *ptr = malloc(bytes);
+    if(ptr != NULL)
+        memAdd(kind, bytes, malloc_usable_size(ptr));
+    return ptr;
+}
+void* memRealloc(int kind, void *ptr, size_t old_bytes, size_t new_bytes){
+    size_t old_real = (ptr != NULL) ? malloc_usable_size(ptr) : 0;
+    void *new_ptr = realloc(ptr, new_bytes);
+    if(new_ptr == NULL)
+        return NULL;
+    if(ptr != NULL)
+        memSub(kind, old_bytes, old_real);
+    memAdd(kind, new_bytes, malloc_usable_size(new_ptr));
+    return new_ptr;
+}
+void memFree(int kind, void *ptr, size_t bytes){
+    if(ptr == NULL)
+        return;
+    memSub(kind, bytes, malloc_usable_size(ptr));
+    free(ptr);
+}
+
+/*Función para imprimir la contabilidad junto con el pico de RSS del proceso*/
+void memReport(){
+    printf("Memoria: arreglos %zu, nodos %zu, contenido %zu, holgura %zu, total %zu bytes\n",
+           mem_bytes[MEM_TABLE], mem_bytes[MEM_NODES], mem_bytes[MEM_KEYS], mem_bytes[MEM_SLACK], mem_current);
+    printf("Pico: %zu bytes. Remodel: %zu veces, %zu bytes reservados\n", mem_peak, mem_remodels, mem_remodel_bytes);
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage) == 0 && usage.ru_maxrss > 0)
+        printf("RSS pico (getrusage): %ld KB (el pico contabilizado es %.1f%% del RSS)\n", usage.ru_maxrss,
+               100.0*mem_peak/(1024.0*usage.ru_maxrss));
+}
+
+/*..........................................POLÍTICA DE MEMORIA..........................................................................*/
+//Variables globales de la política de memoria
+int alloc_policy = 0;
+int alloc_node = 0;
+
+/*Función para leer la política desde un argumento con opciones separadas por comas ("huge", "thp", "interleave", "prefault" y
+//..."node=N"). Cada opción tiene que ser exactamente una de ésas; si alguna no lo es, el argumento no es de la política y no cambia nada.
+//...Regresa YES si el argumento era de la política*/
+int parseAllocPolicy(const char *arg){
+    int policy = 0, node = alloc_node;
+    const char *p = arg;
+    while(*p != '\0'){
+        size_t len = strcspn(p, ",");
+        if(len == 4 && strncmp(p, "huge", 4)==0)
+            policy |= ALLOC_HUGETLB;
+        else if(len == 3 && strncmp(p, "thp", 3)==0)
+            policy |= ALLOC_THP;
+        else if(len == 10 && strncmp(p, "interleave", 10)==0)
+            policy |= ALLOC_INTERLEAVE;
+        else if(len == 8 && strncmp(p, "prefault", 8)==0)
+            policy |= ALLOC_PREFAULT;
+        else if(len > 5 && strncmp(p, "node=", 5)==0){
+            char *end;
+            long value = strtol(p + 5, &end, 10);
+            if(end != p + len || value < 0 || value >= (long)(8*sizeof(unsigned long)))
+                return NO;
+            policy |= ALLOC_BIND;
+            node = (int)value;
+        }
+        else
+            return NO;
+        p += len;
+        if(*p == ',')
+            p++;
+    }
+    if(policy == 0)
+        return NO;
+    alloc_policy |= policy;
+    alloc_node = node;
+    return YES;
+}
+
+/*Función para leer la máscara de nodos NUMA en línea (p. ej. "0-3") desde sysfs*/
+unsigned long onlineNumaNodes(){
+    unsigned long mask = 0;
+    FILE *file = fopen("/sys/devices/system/node/online", "r");
+    if(file == NULL)
+        return 1;                   //Sin NUMA: sólo el nodo 0
+    int first, last;
+    char sep;
+    while(fscanf(file, "%d", &first) == 1){
+        last = first;
+        if(fscanf(file, "%c", &sep) == 1 && sep == '-'){
+            if(fscanf(file, "%d", &last) != 1)
+                break;
+            if(fscanf(file, "%c", &sep) != 1)
+                sep = '\n';
+        }
+        for(int n = first; n <= last && n < (int)(8*sizeof(unsigned long)); n++)
+            mask |= 1ul << n;
+        if(sep != ',')
+            break;
+    }
+    fclose(file);
+    return (mask != 0) ? mask : 1;
+}
+
+/*Función para reservar un arreglo de una tabla (en 0) según la política de memoria. "kind" es su uso para la contabilidad*/
+void* allocTableArrayKind(size_t bytes, int kind){
+    if(!usesTableMapping(bytes)){
+        void *ptr = calloc(1, bytes);
+        if(ptr != NULL)
+            memAdd(kind, bytes, malloc_usable_size(ptr));
+        return ptr;
+    }
+    size_t len = ((bytes + HUGE_PAGE_SIZE - 1)/HUGE_PAGE_SIZE)*HUGE_PAGE_SIZE;
+    void *ptr = MAP_FAILED;
+    //Primero se intenta con páginas grandes explícitas (falla si el sistema no tiene reservadas)
+    if(alloc_policy & ALLOC_HUGETLB)
+        ptr = mmap(NULL, len, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS|MAP_HUGETLB, -1, 0);
+    if(ptr == MAP_FAILED){
+        //Se reserva de más para alinear el inicio a 2 MB (así el kernel puede usar páginas grandes transparentes) y se recorta el sobrante
+        char *raw = (char*)mmap(NULL, len + HUGE_PAGE_SIZE, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+        if(raw == (char*)MAP_FAILED)
+            return NULL;
+        char *aligned = (char*)(((uintptr_t)raw + HUGE_PAGE_SIZE - 1) & ~(uintptr_t)(HUGE_PAGE_SIZE - 1));
+        if(aligned > raw)
+            munmap(raw, aligned - raw);
+        munmap(aligned + len, (raw + HUGE_PAGE_SIZE) - aligned);
+        ptr = aligned;
+        if(alloc_policy & (ALLOC_HUGETLB|ALLOC_THP))
+            madvise(ptr, len, MADV_HUGEPAGE);
+    }
+    //La colocación NUMA se fija antes de tocar las páginas
+    if(alloc_policy & (ALLOC_INTERLEAVE|ALLOC_BIND)){
+        unsigned long mask = (alloc_policy & ALLOC_BIND) ? (1ul << alloc_node) : onlineNumaNodes();
+        int policy = (alloc_policy & ALLOC_BIND) ? MPOL_BIND : MPOL_INTERLEAVE;
+        if(syscall(SYS_mbind, ptr, len, policy, &mask, 8*sizeof(unsigned long), 0) != 0)
+            fprintf(stderr, "Cannot apply NUMA policy to table.\n");
+    }
+    //Prefault: se escribe un byte por página para que el kernel las asigne desde ahora
+    if(alloc_policy & ALLOC_PREFAULT){
+        for(size_t i=0; i<len; i+=4096)
+            ((volatile char*)ptr)[i] = 0;
+    }
+    memAdd(kind, bytes, len);
+    return ptr;
+}
+
+/*Función para liberar un arreglo reservado con allocTableArray (se necesita el mismo número de bytes)*/
+void freeTableArrayKind(void *ptr, size_t bytes, int kind){
+    if(ptr == NULL)
+        return;
+    if(!usesTableMapping(bytes)){
+        memFree(kind, ptr, bytes);
+        return;
+    }
+    size_t len = ((bytes + HUGE_PAGE_SIZE - 1)/HUGE_PAGE_SIZE)*HUGE_PAGE_SIZE;
+    memSub(kind, bytes, len);
+    munmap(ptr, len);
+}
+
+/*Función para cambiar de tamaño un arreglo reservado con allocTableArray (la parte nueva no se inicializa en 0 si viene de realloc)*/
+void* reallocTableArrayKind(void *ptr, size_t old_bytes, size_t new_bytes, int kind){
+    if(!usesTableMapping(old_bytes) && !usesTableMapping(new_bytes))
+        return memRealloc(kind, ptr, old_bytes, new_bytes);
+    void *new_ptr = allocTableArrayKind(new_bytes, kind);
+    if(new_ptr == NULL)
+        return NULL;
+    memcpy(new_ptr, ptr, (old_bytes < new_bytes) ? old_bytes : new_bytes);
+    freeTableArrayKind(ptr, old_bytes, kind);
+    return new_ptr;
+}
+
+/*Las mismas funciones para los arreglos de casillas y cabezas (el uso más común)*/
+void* allocTableArray(size_t bytes){
+    return allocTableArrayKind(bytes, MEM_TABLE);
+}
+void freeTableArray(void *ptr, size_t bytes){
+    freeTableArrayKind(ptr, bytes, MEM_TABLE);
+}
+void* reallocTableArray(void *ptr, size_t old_bytes, size_t new_bytes){
+    return reallocTableArrayKind(ptr, old_bytes, new_bytes, MEM_TABLE);
+}
+
+/*Función para imprimir cuánta memoria anónima del proceso está respaldada por páginas grandes*/
+void printHugePageUsage(){
+    FILE *file = fopen("/proc/self/smaps_rollup", "r");
+    if(file == NULL)
+        return;
+    char line[256];
+    while(fgets(line, sizeof(line), file) != NULL){
+        if(strncmp(line, "AnonHugePages:", 14) == 0 || strncmp(line, "Private_Hugetlb:", 16) == 0)
+            printf("%s", line);
+    }
+    fclose(file);
+}
+
+/*..........................................SUSTITUTOS DEL TLB...........................................................................*/
+uint64_t find_ns = 0;
+size_t find_count = 0;
+
+/*Función para imprimir los sustitutos de los fallos del TLB (ver ht_common.h)*/
+void tlbProxyReport(){
+    if(perf_enabled && perf_available[PERF_TLB])
+        printf("Fallos del TLB: medidos con los contadores (ver \"Contadores por operación\")\n");
+    else
+        printf("Fallos del TLB: contadores dTLB no disponibles; se muestran sustitutos\n");
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    size_t table = mem_bytes[MEM_TABLE];
+    printf("Fallos de página: %ld menores, %ld mayores (%.1f KB del pico por fallo)\n", usage.ru_minflt, usage.ru_majflt,
+           (usage.ru_minflt > 0) ? mem_peak/1024.0/usage.ru_minflt : 0.0);
+    printf("Arreglos de tabla: %.2f MB = %zu páginas de 4 KB o %zu de 2 MB\n", table/(1024.0*1024.0), (table + 4095)/4096,
+           (table + HUGE_PAGE_SIZE - 1)/HUGE_PAGE_SIZE);
+    printHugePageUsage();
+    if(find_count > 0)
+        printf("Búsquedas: %zu, %.1f ns c/u\n", find_count, (double)find_ns/find_count);
+}
+
+/*Función generador de llaves*/
+uint32_t adler32(unsigned char *data, size_t len) {
+    uint32_t a = 1, b = 0;
+    size_t index;
+
+    //Process each byte of the data in order
+    for (index = 0; index < len; ++index){
+        a = (a + data[index]) % MOD_ADLER;
+        b = (b + a) % MOD_ADLER;
+    }
+    return (b << 16) | a; //Aquí se recorre b 16 bits a la izquierda y después cada bit de b se opera OR con el respectivo bit de a
+}
+
+/*..........................................LLAVES CON SEMILLA.............................................................................*/
+uint64_t hash_seed = 0;                 //Semilla del proceso (0 = aún no se sortea)
+size_t flood_detections = 0;            //Inserciones con un recorrido anormalmente largo
+size_t flood_reseeds = 0;               //Tablas reconstruidas con otra semilla
+
+/*Función para sortear una semilla (con getrandom; si no se puede, con el reloj y una dirección). Nunca regresa 0*/
+uint64_t randomSeed(){
+    uint64_t seed = 0;
+    if(syscall(SYS_getrandom, &seed, sizeof(seed), 0) != (long)sizeof(seed)){
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        seed = ((uint64_t)ts.tv_sec*1000000000ULL + (uint64_t)ts.tv_nsec) ^ (uint64_t)(uintptr_t)&seed;
+    }
+    return (seed != 0) ? seed : 1;
+}
+
+/*Función para obtener la semilla del proceso (la primera tabla la sortea; si dos hilos llegan a la vez se quedan con la misma)*/
+uint64_t tableSeed(){
+    uint64_t seed = __atomic_load_n(&hash_seed, __ATOMIC_ACQUIRE);
+    if(seed == 0){
+        uint64_t fresh = randomSeed();
+        if(__atomic_compare_exchange_n(&hash_seed, &seed, fresh, NO, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+            seed = fresh;
+    }
+    return seed;
+}
+
+/*Ronda de SipHash*/
+#define SIP_ROTL(x, b) (((x) << (b)) | ((x) >> (64 - (b))))
+static inline void sipRound(uint64_t *v0, uint64_t *v1, uint64_t *v2, uint64_t *v3){
+    *v0 += *v1; *v1 = SIP_ROTL(*v1, 13); *v1 ^= *v0; *v0 = SIP_ROTL(*v0, 32);
+    *v2 += *v3; *v3 = SIP_ROTL(*v3, 16); *v3 ^= *v2;
+    *v0 += *v3; *v3 = SIP_ROTL(*v3, 21); *v3 ^= *v0;
+    *v2 += *v1; *v1 = SIP_ROTL(*v1, 17); *v1 ^= *v2; *v2 = SIP_ROTL(*v2, 32);
+}
+
+/*Función para el hash de 64 bits con semilla (SipHash-1-3: una ronda por bloque de 8 bytes y tres al final). La segunda mitad de la
+//...clave de 128 bits se deriva de la semilla*/
+uint64_t seededHash64(uint64_t seed, const unsigned char *data, size_t len){
+    uint64_t k0 = seed, k1 = (seed * 0x9E3779B97F4A7C15ULL) ^ 0x2545F4914F6CDD1DULL;
+    uint64_t v0 = k0 ^ 0x736f6d6570736575ULL, v1 = k1 ^ 0x646f72616e646f6dULL;
+    uint64_t v2 = k0 ^ 0x6c7967656e657261ULL, v3 = k1 ^ 0x7465646279746573ULL;
+    size_t i = 0;
+    for(; i+8<=len; i+=8){
+        uint64_t m;
+        memcpy(&m, data + i, 8);
+        v3 ^= m;
+        sipRound(&v0, &v1, &v2, &v3);
+        v0 ^= m;
+    }
+    //Los bytes que sobran van en el último bloque junto con la longitud
+    uint64_t last = (uint64_t)len << 56;
+    for(size_t j=0; i+j<len; j++)
+        last |= (uint64_t)data[i+j] << (8*j);
+    v3 ^= last;
+    sipRound(&v0, &v1, &v2, &v3);
+    v0 ^= last;
+    v2 ^= 0xff;
+    sipRound(&v0, &v1, &v2, &v3);
+    sipRound(&v0, &v1, &v2, &v3);
+    sipRound(&v0, &v1, &v2, &v3);
+    return v0 ^ v1 ^ v2 ^ v3;
+}
+
+/*Función generador de llaves con semilla (las dos mitades del hash de 64 bits)*/
+uint32_t seededKey(uint64_t seed, const unsigned char *data, size_t len){
+    uint64_t h = seededHash64(seed, data, len);
+    return (uint32_t)(h ^ (h >> 32));
+}
+
+/*Función para imprimir las detecciones*/
+void floodReport(){
+    printf("Semillas: %zu recorridos anormales detectados, %zu tablas resembradas\n", flood_detections, flood_reseeds);
+}
+
+/*..........................................HASH POR LOTES.................................................................................*/
+/*Función para el último bloque de SipHash de un contenido (los bytes que sobran y la longitud)*/
+static inline uint64_t sipLastBlock(const unsigned char *data, size_t len){
+    uint64_t m = (uint64_t)len << 56;
+    for(size_t j=0; 8*(len/8)+j<len; j++)
+        m |= (uint64_t)data[8*(len/8)+j] << (8*j);
+    return m;
+}
+
+/*Función para el bloque "t" de una llave con "full" bloques completos y último bloque "last" (después del último regresa 0)*/
+static inline uint64_t sipBlock(const unsigned char *data, size_t full, uint64_t last, size_t t){
+    uint64_t m = 0;
+    if(t < full)
+        memcpy(&m, data + 8*t, 8);
+    else if(t == full)
+        m = last;
+    return m;
+}
+
+/*Versión escalar (una llave a la vez)*/
+void seededHashScalar(uint64_t seed, const unsigned char **data, const size_t *len, size_t n, uint64_t *out){
+    for(size_t i=0; i<n; i++)
+        out[i] = seededHash64(seed, data[i], len[i]);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+/*Ronda de SipHash sobre 4 carriles (la rotación de 32 es un intercambio de mitades)*/
+#define SIP_ROTL256(x, b) _mm256_or_si256(_mm256_slli_epi64((x), (b)), _mm256_srli_epi64((x), 64 - (b)))
+#define SIP_ROUND256(v0, v1, v2, v3)                                                                                                    \
+    do{                                                                                                                                 \
+        v0 = _mm256_add_epi64(v0, v1); v1 = SIP_ROTL256(v1, 13); v1 = _mm256_xor_si256(v1, v0);                                        \
+        v0 = _mm256_shuffle_epi32(v0, _MM_SHUFFLE(2, 3, 0, 1));                                                                         \
+        v2 = _mm256_add_epi64(v2, v3); v3 = SIP_ROTL256(v3, 16); v3 = _mm256_xor_si256(v3, v2);                                        \
+        v0 = _mm256_add_epi64(v0, v3); v3 = SIP_ROTL256(v3, 21); v3 = _mm256_xor_si256(v3, v0);                                        \
+        v2 = _mm256_add_epi64(v2, v1); v1 = SIP_ROTL256(v1, 17); v1 = _mm256_xor_si256(v1, v2);                                        \
+        v2 = _mm256_shuffle_epi32(v2, _MM_SHUFFLE(2, 3, 0, 1));                                                                         \
+    }while(0)
+
+/*Versión AVX2: de 4 en 4 llaves*/
+__attribute__((target("avx2")))
+void seededHashAVX2(uint64_t seed, const unsigned char **data, const size_t *len, size_t n, uint64_t *out){
+    uint64_t k0 = seed, k1 = (seed * 0x9E3779B97F4A7C15ULL) ^ 0x2545F4914F6CDD1DULL;
+    for(size_t base=0; base<n; base+=4){
+        size_t lanes = (n - base < 4) ? n - base : 4;
+        //Los carriles que sobran no hacen ninguna ronda (y sipBlock nunca lee su contenido)
+        uint64_t blocks[4] = {0, 0, 0, 0}, full[4] = {0, 0, 0, 0}, last[4] = {0, 0, 0, 0}, m[4], h[4];
+        const unsigned char *lane[4] = {NULL, NULL, NULL, NULL};
+        size_t most = 0;
+        for(size_t l=0; l<lanes; l++){
+            lane[l] = data[base+l];
+            full[l] = len[base+l]/8;
+            blocks[l] = full[l] + 1;
+            last[l] = sipLastBlock(data[base+l], len[base+l]);
+            if(blocks[l] > most)
+                most = blocks[l];
+        }
+        __m256i v0 = _mm256_set1_epi64x((long long)(k0 ^ 0x736f6d6570736575ULL)), v1 = _mm256_set1_epi64x((long long)(k1 ^ 0x646f72616e646f6dULL));
+        __m256i v2 = _mm256_set1_epi64x((long long)(k0 ^ 0x6c7967656e657261ULL)), v3 = _mm256_set1_epi64x((long long)(k1 ^ 0x7465646279746573ULL));
+        __m256i count = _mm256_loadu_si256((const __m256i*)blocks);
+        for(size_t t=0; t<most; t++){
+            //El vector se arma con los bloques ya en registros (guardarlos y leerlos de 32 bytes no se puede reenviar del store)
+            for(size_t l=0; l<4; l++)
+                m[l] = sipBlock(lane[l], full[l], last[l], t);
+            __m256i M = _mm256_set_epi64x((long long)m[3], (long long)m[2], (long long)m[1], (long long)m[0]);
+            __m256i active = _mm256_cmpgt_epi64(count, _mm256_set1_epi64x((long long)t));
+            __m256i a0 = v0, a1 = v1, a2 = v2, a3 = _mm256_xor_si256(v3, M);
+            SIP_ROUND256(a0, a1, a2, a3);
+            a0 = _mm256_xor_si256(a0, M);
+            //Los carriles que ya terminaron se quedan como estaban
+            v0 = _mm256_blendv_epi8(v0, a0, active);
+            v1 = _mm256_blendv_epi8(v1, a1, active);
+            v2 = _mm256_blendv_epi8(v2, a2, active);
+            v3 = _mm256_blendv_epi8(v3, a3, active);
+        }
+        v2 = _mm256_xor_si256(v2, _mm256_set1_epi64x(0xff));
+        SIP_ROUND256(v0, v1, v2, v3);
+        SIP_ROUND256(v0, v1, v2, v3);
+        SIP_ROUND256(v0, v1, v2, v3);
+        _mm256_storeu_si256((__m256i*)h, _mm256_xor_si256(_mm256_xor_si256(v0, v1), _mm256_xor_si256(v2, v3)));
+        for(size_t l=0; l<lanes; l++)
+            out[base+l] = h[l];
+    }
+}
+
+/*Ronda de SipHash sobre 8 carriles (AVX-512 tiene rotación)*/
+#define SIP_ROUND512(v0, v1, v2, v3)                                                                                                    \
+    do{                                                                                                                                 \
+        v0 = _mm512_add_epi64(v0, v1); v1 = _mm512_rol_epi64(v1, 13); v1 = _mm512_xor_si512(v1, v0); v0 = _mm512_rol_epi64(v0, 32);    \
+        v2 = _mm512_add_epi64(v2, v3); v3 = _mm512_rol_epi64(v3, 16); v3 = _mm512_xor_si512(v3, v2);                                  \
+        v0 = _mm512_add_epi64(v0, v3); v3 = _mm512_rol_epi64(v3, 21); v3 = _mm512_xor_si512(v3, v0);                                  \
+        v2 = _mm512_add_epi64(v2, v1); v1 = _mm512_rol_epi64(v1, 17); v1 = _mm512_xor_si512(v1, v2); v2 = _mm512_rol_epi64(v2, 32);    \
+    }while(0)
+
+/*Versión AVX-512: de 8 en 8 llaves (los carriles que ya terminaron se enmascaran)*/
+__attribute__((target("avx512f")))
+void seededHashAVX512(uint64_t seed, const unsigned char **data, const size_t *len, size_t n, uint64_t *out){
+    uint64_t k0 = seed, k1 = (seed * 0x9E3779B97F4A7C15ULL) ^ 0x2545F4914F6CDD1DULL;
+    for(size_t base=0; base<n; base+=8){
+        size_t lanes = (n - base < 8) ? n - base : 8;
+        //Los carriles que sobran no hacen ninguna ronda (y sipBlock nunca lee su contenido)
+        uint64_t blocks[8] = {0, 0, 0, 0, 0, 0, 0, 0}, full[8] = {0, 0, 0, 0, 0, 0, 0, 0}, last[8] = {0, 0, 0, 0, 0, 0, 0, 0}, m[8], h[8];
+        const unsigned char *lane[8] = {NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL};
+        size_t most = 0;
+        for(size_t l=0; l<lanes; l++){
+            lane[l] = data[base+l];
+            full[l] = len[base+l]/8;
+            blocks[l] = full[l] + 1;
+            last[l] = sipLastBlock(data[base+l], len[base+l]);
+            if(blocks[l] > most)
+                most = blocks[l];
+        }
+        __m512i v0 = _mm512_set1_epi64((long long)(k0 ^ 0x736f6d6570736575ULL)), v1 = _mm512_set1_epi64((long long)(k1 ^ 0x646f72616e646f6dULL));
+        __m512i v2 = _mm512_set1_epi64((long long)(k0 ^ 0x6c7967656e657261ULL)), v3 = _mm512_set1_epi64((long long)(k1 ^ 0x7465646279746573ULL));
+        __m512i count = _mm512_loadu_si512((const void*)blocks);
+        for(size_t t=0; t<most; t++){
+            for(size_t l=0; l<8; l++)
+                m[l] = sipBlock(lane[l], full[l], last[l], t);
+            __m512i M = _mm512_set_epi64((long long)m[7], (long long)m[6], (long long)m[5], (long long)m[4], (long long)m[3],
+                                         (long long)m[2], (long long)m[1], (long long)m[0]);
+            __mmask8 active = _mm512_cmpgt_epu64_mask(count, _mm512_set1_epi64((long long)t));
+            __m512i a0 = v0, a1 = v1, a2 = v2, a3 = _mm512_xor_si512(v3, M);
+            SIP_ROUND512(a0, a1, a2, a3);
+            a0 = _mm512_xor_si512(a0, M);
+            v0 = _mm512_mask_blend_epi64(active, v0, a0);
+            v1 = _mm512_mask_blend_epi64(active, v1, a1);
+            v2 = _mm512_mask_blend_epi64(active, v2, a2);
+            v3 = _mm512_mask_blend_epi64(active, v3, a3);
+        }
+        v2 = _mm512_xor_si512(v2, _mm512_set1_epi64(0xff));
+        SIP_ROUND512(v0, v1, v2, v3);
+        SIP_ROUND512(v0, v1, v2, v3);
+        SIP_ROUND512(v0, v1, v2, v3);
+        _mm512_storeu_si512((void*)h, _mm512_xor_si512(_mm512_xor_si512(v0, v1), _mm512_xor_si512(v2, v3)));
+        for(size_t l=0; l<lanes; l++)
+            out[base+l] = h[l];
+    }
+}
+#endif
+
+/*Prototipo del selector (la primera llamada elige la versión según el CPU)*/
+static void seededHashResolve(uint64_t seed, const unsigned char **data, const size_t *len, size_t n, uint64_t *out);
+
+/*Puntero a la versión del núcleo que se usa*/
+void (*seededHashLanes)(uint64_t seed, const unsigned char **data, const size_t *len, size_t n, uint64_t *out) = seededHashResolve;
+
+/*Selector en tiempo de ejecución: revisa qué instrucciones tiene el CPU y fija el puntero del núcleo*/
+static void seededHashResolve(uint64_t seed, const unsigned char **data, const size_t *len, size_t n, uint64_t *out){
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx512f"))
+        seededHashLanes = seededHashAVX512;
+    else if(__builtin_cpu_supports("avx2"))
+        seededHashLanes = seededHashAVX2;
+    else
+        seededHashLanes = seededHashScalar;
+#else
+    seededHashLanes = seededHashScalar;
+#endif
+    seededHashLanes(seed, data, len, n, out);
+}
+
+/*Función para calcular las llaves de "n" contenidos con la misma semilla (lo mismo que seededKey para cada uno)*/
+void seededKeyBatch(uint64_t seed, const unsigned char **data, const size_t *len, size_t n, uint32_t *keys){
+    uint64_t h[HASH_LANES];
+    for(size_t base=0; base<n; base+=HASH_LANES){
+        size_t lanes = (n - base < HASH_LANES) ? n - base : HASH_LANES;
+        seededHashLanes(seed, data + base, len + base, lanes, h);
+        for(size_t l=0; l<lanes; l++)
+            keys[base+l] = (uint32_t)(h[l] ^ (h[l] >> 32));
+    }
+}
+
+/*..........................................COMPARACIÓN DE CONTENIDOS......................................................................*/
+#if defined(__x86_64__) || defined(__i386__)
+/*Versión SSE2: bloques de 16 bytes y la cola con la versión de palabras*/
+__attribute__((target("sse2")))
+static int compareBytesSSE2(const unsigned char *pA, const unsigned char *pB, size_t len){
+    size_t i = 0;
+    for(; i+16<=len; i+=16){
+        __m128i a = _mm_loadu_si128((const __m128i*)(pA+i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(pB+i));
+        if(_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) != 0xFFFF)
+            return NO;
+    }
+    return compareBytesWord(pA+i, pB+i, len-i);
+}
+
+/*Versión AVX2: bloques de 32 bytes y la cola con la versión de palabras*/
+__attribute__((target("avx2")))
+static int compareBytesAVX2(const unsigned char *pA, const unsigned char *pB, size_t len){
+    size_t i = 0;
+    for(; i+32<=len; i+=32){
+        __m256i a = _mm256_loadu_si256((const __m256i*)(pA+i));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(pB+i));
+        if((uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)) != 0xFFFFFFFFu)
+            return NO;
+    }
+    return compareBytesWord(pA+i, pB+i, len-i);
+}
+#endif
+
+/*Prototipo del selector (la primera llamada elige la versión según el CPU)*/
+static int compareBytesResolve(const unsigned char *pA, const unsigned char *pB, size_t len);
+
+/*Puntero a la versión del núcleo que se usa para llaves largas*/
+int (*compareBytesLong)(const unsigned char *pA, const unsigned char *pB, size_t len) = compareBytesResolve;
+
+/*Selector en tiempo de ejecución: revisa qué instrucciones tiene el CPU y fija el puntero del núcleo*/
+static int compareBytesResolve(const unsigned char *pA, const unsigned char *pB, size_t len){
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2"))
+        compareBytesLong = compareBytesAVX2;
+    else if(__builtin_cpu_supports("sse2"))
+        compareBytesLong = compareBytesSSE2;
+    else
+        compareBytesLong = compareBytesWord;
+#else
+    compareBytesLong = compareBytesWord;
+#endif
+    return compareBytesLong(pA, pB, len);
+}
+
+/*Función para checar los bytes entre dos contenidos y ver si son iguales o no*/
+int checkMatchRecord(record *A, record *B){
+    //Si la longitud de A y B son diferentes, de antemano ya sabemos que no son iguales
+    if(A->len != B->len)
+        return NO;
+    //Si son del mismo tamaño, el núcleo de comparación revisa los bytes por bloques
+    return compareBytes(A->bytes, B->bytes, A->len);
+}
+
+/*............................................LLAVES ENTERAS..............................................................................*/
+/*Función para leer una llave entera. Sólo acepta decimales sin signo y sin ceros a la izquierda ("007" no es lo mismo que "7" como record)*/
+int parseIntKey(const char *str, uint64_t *key){
+    size_t len = strlen(str);
+    if(len == 0 || len > 20 || (str[0]=='0' && len > 1))
+        return NO;
+    uint64_t value = 0;
+    for(size_t i=0; i<len; i++){
+        if(str[i]<'0' || str[i]>'9')
+            return NO;
+        uint64_t digit = (uint64_t)(str[i]-'0');
+        if(value > (UINT64_MAX - digit)/10)
+            return NO;
+        value = value*10 + digit;
+    }
+    *key = value;
+    return YES;
+}
+
+/*...............................................TRAZAS..................................................................................*/
+const char *OP_NAMES[OP_KINDS] = {"", "insert", "delete", "find"};
+
+/*Función para leer una opción de traza (o "perf", que enciende los contadores de hardware). Regresa YES si el argumento era una*/
+int parseTraceOption(trace_options *TO, const char *arg){
+    if(strncmp(arg, "record=", 7)==0)
+        TO->record = arg + 7;
+    else if(strncmp(arg, "replay=", 7)==0)
+        TO->replay = arg + 7;
+    else if(strncmp(arg, "threads=", 8)==0)
+        TO->threads = (atoi(arg + 8) > 0) ? atoi(arg + 8) : 1;
+    else if(strcmp(arg, "timed")==0)
+        TO->timed = YES;
+    else if(strcmp(arg, "perf")==0)
+        perf_enabled = YES;
+    else
+        return NO;
+    return YES;
+}
+
+/*Función para convertir un comando en su tipo de operación (0 si no se graba)*/
+static inline int traceOpCode(const char *command){
+    if(strcmp("insert", command)==0)
+        return OP_INSERT;
+    if(strcmp("delete", command)==0)
+        return OP_DELETE;
+    if(strcmp("find", command)==0)
+        return OP_FIND;
+    return 0;
+}
+
+/*Función para escribir un número como varint*/
+static inline void writeVarint(FILE *file, uint64_t v){
+    while(v >= 0x80){
+        fputc((int)(v & 0x7F) | 0x80, file);
+        v >>= 7;
+    }
+    fputc((int)v, file);
+}
+
+/*Función para leer un varint de [*p, end). Regresa NO si el número está cortado*/
+static inline int readVarint(const unsigned char **p, const unsigned char *end, uint64_t *v){
+    *v = 0;
+    for(int shift=0; shift<64; shift+=7){
+        if(*p >= end)
+            return NO;
+        unsigned char b = *(*p)++;
+        *v |= (uint64_t)(b & 0x7F) << shift;
+        if((b & 0x80) == 0)
+            return YES;
+    }
+    return NO;
+}
+
+/*Función para empezar a grabar una traza (si "path" es NULL no se graba nada)*/
+void openTraceWriter(trace_writer *TW, const char *path){
+    TW->file = NULL;
+    TW->last = 0;
+    TW->count = 0;
+    if(path == NULL)
+        return;
+    TW->file = fopen(path, "wb");
+    if(TW->file == NULL){
+        fprintf(stderr, "Cannot open trace file %s\n", path);
+        return;
+    }
+    fwrite(TRACE_MAGIC, 1, 4, TW->file);
+    fputc(TRACE_VERSION, TW->file);
+}
+
+/*Función para grabar un comando (los que no son insert, delete o find se ignoran)*/
+void traceCommand(trace_writer *TW, const char *command, const char *number){
+    if(TW->file == NULL)
+        return;
+    int op = traceOpCode(command);
+    if(op == 0)
+        return;
+    uint64_t now = nowNs();
+    if(TW->count == 0)
+        TW->last = now;
+    size_t len = strlen(number);
+    fputc(op, TW->file);
+    writeVarint(TW->file, now - TW->last);
+    writeVarint(TW->file, len);
+    fwrite(number, 1, len, TW->file);
+    TW->last = now;
+    TW->count++;
+}
+
+/*Función para terminar de grabar una traza*/
+void closeTraceWriter(trace_writer *TW){
+    if(TW->file == NULL)
+        return;
+    fclose(TW->file);
+    TW->file = NULL;
+    printf("Traza: %zu operaciones grabadas\n", TW->count);
+}
+
+/*Función para liberar una traza leída*/
+void freeTrace(trace *T){
+    free(T->ops);
+    free(T->data);
+    free(T);
+}
+
+/*Función para leer una traza completa. Regresa NULL si no se pudo leer o no es válida*/
+trace* loadTrace(const char *path){
+    FILE *file = fopen(path, "rb");
+    if(file == NULL){
+        fprintf(stderr, "Cannot open trace file %s\n", path);
+        return NULL;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    trace *T = (trace*)calloc(1, sizeof(trace));
+    if(T == NULL || size < 5){
+        fprintf(stderr, "Invalid trace file %s\n", path);
+        free(T);
+        fclose(file);
+        return NULL;
+    }
+    T->data = (char*)malloc(size);
+    if(T->data == NULL || fread(T->data, 1, size, file) != (size_t)size){
+        fprintf(stderr, "Cannot read trace file %s\n", path);
+        freeTrace(T);
+        fclose(file);
+        return NULL;
+    }
+    fclose(file);
+    if(memcmp(T->data, TRACE_MAGIC, 4) != 0 || T->data[4] != TRACE_VERSION){
+        fprintf(stderr, "Invalid trace file %s\n", path);
+        freeTrace(T);
+        return NULL;
+    }
+    //Cada operación ocupa al menos 3 bytes, así que con eso se acota cuántas hay
+    T->ops = (trace_op*)malloc(sizeof(trace_op)*(size/3 + 1));
+    if(T->ops == NULL){
+        fprintf(stderr, "Cannot allocate memory for trace.\n");
+        freeTrace(T);
+        return NULL;
+    }
+    const unsigned char *p = (const unsigned char*)T->data + 5;
+    const unsigned char *end = (const unsigned char*)T->data + size;
+    uint64_t time = 0;
+    while(p < end){
+        trace_op *op = &(T->ops[T->n]);
+        uint64_t delta, len;
+        op->op = *p++;
+        if(op->op < OP_INSERT || op->op > OP_FIND || readVarint(&p, end, &delta)==NO || readVarint(&p, end, &len)==NO
+           || len > (uint64_t)(end - p)){
+            fprintf(stderr, "Invalid trace file %s (operation %zu)\n", path, T->n);
+            freeTrace(T);
+            return NULL;
+        }
+        time += delta;
+        op->time = time;
+        op->len = (uint32_t)len;
+        op->bytes = (char*)p;
+        p += len;
+        T->n++;
+    }
+    return T;
+}
+
+/*Función para saber en qué cubeta del histograma cae una latencia (potencia de 2 y subcubeta lineal dentro de ella)*/
+static inline size_t latencyBucket(uint64_t ns){
+    if(ns < LAT_SUB)
+        return ns;
+    int msb = 63 - __builtin_clzll(ns);
+    return (size_t)(msb - 2)*LAT_SUB + ((ns >> (msb - 3)) & (LAT_SUB - 1));
+}
+
+/*Función para obtener el límite superior (exclusivo) de una cubeta del histograma*/
+static inline uint64_t latencyBucketEnd(size_t bucket){
+    if(bucket < LAT_SUB)
+        return bucket + 1;
+    int msb = (int)(bucket/LAT_SUB) + 2;
+    return (uint64_t)(LAT_SUB + bucket%LAT_SUB + 1) << (msb - 3);
+}
+
+/*Función para anotar un Remodel en la línea de tiempo del hilo*/
+void addResizeEvent(replay_thread *R, uint64_t time, uint64_t duration, size_t bytes, size_t op){
+    if(R->n_events == R->cap_events){
+        size_t cap = (R->cap_events == 0) ? 16 : R->cap_events*2;
+        resize_event *events = (resize_event*)realloc(R->events, sizeof(resize_event)*cap);
+        if(events == NULL)
+            return;
+        R->events = events;
+        R->cap_events = cap;
+    }
+    resize_event *ev = &(R->events[R->n_events++]);
+    ev->time = time;
+    ev->duration = duration;
+    ev->bytes = bytes;
+    ev->op = op;
+    ev->thread = R->id;
+}
+
+/*Función de cada hilo: repite sus operaciones sobre su propia tabla y mide cada una*/
+void* replayThread(void *arg){
+    replay_thread *R = (replay_thread*)arg;
+    void *HT = R->E->create(R->mode);
+    for(size_t k=0; k<R->n_mine; k++){
+        const trace_op *op = &(R->T->ops[R->mine[k]]);
+        //Con "timed" se espera hasta el momento original de la operación (lo último, activamente)
+        if(R->timed){
+            uint64_t target = R->start + op->time;
+            uint64_t now = nowNs();
+            if(now + SPIN_NS < target){
+                uint64_t wait = target - now - SPIN_NS;
+                struct timespec ts = {(time_t)(wait/1000000000ULL), (long)(wait%1000000000ULL)};
+                nanosleep(&ts, NULL);
+            }
+            while(nowNs() < target)
+                ;
+        }
+        record rec;
+        rec.bytes = op->bytes;
+        rec.len = op->len;
+        size_t remodels = mem_thread_remodels;
+        size_t allocated = mem_thread_allocated;
+        uint64_t snap[PERF_EVENTS];
+        perfBegin(snap);
+        uint64_t t0 = nowNs();
+        if(op->op == OP_INSERT)
+            R->E->insert(&HT, &rec, R->mode);
+        else if(op->op == OP_DELETE)
+            R->E->remove(&HT, &rec, R->mode);
+        else
+            R->E->find(&HT, &rec, R->mode);
+        uint64_t t1 = nowNs();
+        perfEnd(op->op, snap);
+        uint64_t ns = t1 - t0;
+        R->lat[op->op][latencyBucket(ns)]++;
+        R->lat_sum[op->op] += ns;
+        if(ns > R->lat_max[op->op])
+            R->lat_max[op->op] = ns;
+        if(mem_thread_remodels != remodels)
+            addResizeEvent(R, t0 - R->start, ns, mem_thread_allocated - allocated, R->mine[k]);
+    }
+    R->occupied = R->E->count(HT);
+    R->E->destroy(HT);
+    perfFlush();
+    return NULL;
+}
+
+/*Función para imprimir el histograma de un tipo de operación (ya sumado entre hilos)*/
+void printLatency(int op, const size_t *lat, uint64_t sum, uint64_t max){
+    size_t total = 0;
+    for(size_t b=0; b<LAT_BUCKETS; b++)
+        total += lat[b];
+    if(total == 0)
+        return;
+    //Percentiles (el límite superior de la cubeta donde caen)
+    const double P[] = {0.5, 0.9, 0.99, 0.999};
+    uint64_t pct[4];
+    size_t acc = 0, b = 0;
+    for(int i=0; i<4; i++){
+        size_t target = (P[i]*total > 1) ? (size_t)(P[i]*total) : 1;
+        while(b < LAT_BUCKETS && acc + lat[b] < target){
+            acc += lat[b];
+            b++;
+        }
+        pct[i] = latencyBucketEnd(b < LAT_BUCKETS ? b : LAT_BUCKETS - 1);
+    }
+    printf("%s: %zu ops, media %.0f ns, p50 < %lu ns, p90 < %lu ns, p99 < %lu ns, p99.9 < %lu ns, max %lu ns\n", OP_NAMES[op], total,
+           (double)sum/total, (unsigned long)pct[0], (unsigned long)pct[1], (unsigned long)pct[2], (unsigned long)pct[3], (unsigned long)max);
+    //El histograma se imprime por potencias de 2
+    for(size_t g=0; g<LAT_BUCKETS; g+=LAT_SUB){
+        size_t count = 0;
+        for(size_t s=g; s<g+LAT_SUB; s++)
+            count += lat[s];
+        if(count > 0)
+            printf("    [%lu, %lu) ns: %zu\n", (unsigned long)(g == 0 ? 0 : latencyBucketEnd(g - 1)),
+                   (unsigned long)latencyBucketEnd(g + LAT_SUB - 1), count);
+    }
+}
+
+/*Función para ordenar los Remodel por tiempo*/
+int compareResizeEvents(const void *a, const void *b){
+    const resize_event *A = (const resize_event*)a;
+    const resize_event *B = (const resize_event*)b;
+    return (A->time > B->time) - (A->time < B->time);
+}
+
+/*Función para repetir una traza con un motor en "threads" hilos. Regresa el código de salida del programa*/
+int replayTrace(const trace_options *TO, const replay_engine *E, size_t mode){
+    trace *T = loadTrace(TO->replay);
+    if(T == NULL)
+        return 1;
+    int threads = TO->threads;
+    replay_thread *R = (replay_thread*)calloc(threads, sizeof(replay_thread));
+    if(R == NULL){
+        fprintf(stderr, "Cannot allocate memory for replay.\n");
+        freeTrace(T);
+        return 1;
+    }
+    //Reparto de las operaciones: cada llave siempre va al mismo hilo
+    int *owner = (int*)malloc(sizeof(int)*(T->n + 1));
+    if(owner == NULL){
+        fprintf(stderr, "Cannot allocate memory for replay.\n");
+        exit(1);
+    }
+    for(int t=0; t<threads; t++){
+        R[t].id = t;
+        R[t].T = T;
+        R[t].E = E;
+        R[t].mode = mode;
+        R[t].timed = TO->timed;
+    }
+    for(size_t i=0; i<T->n; i++){
+        owner[i] = (threads == 1) ? 0 : (int)(mixKey32(adler32((unsigned char*)T->ops[i].bytes, T->ops[i].len)) % threads);
+        R[owner[i]].n_mine++;
+    }
+    for(int t=0; t<threads; t++){
+        R[t].mine = (size_t*)malloc(sizeof(size_t)*(R[t].n_mine + 1));
+        if(R[t].mine == NULL){
+            fprintf(stderr, "Cannot allocate memory for replay.\n");
+            exit(1);
+        }
+        R[t].n_mine = 0;
+    }
+    for(size_t i=0; i<T->n; i++)
+        R[owner[i]].mine[R[owner[i]].n_mine++] = i;
+    free(owner);
+    uint64_t start = nowNs();
+    for(int t=0; t<threads; t++){
+        R[t].start = start;
+        if(pthread_create(&R[t].thread, NULL, replayThread, &R[t]) != 0){
+            //Si no se pudo crear el hilo, sus operaciones se hacen aquí mismo
+            replayThread(&R[t]);
+            R[t].thread = pthread_self();
+        }
+    }
+    for(int t=0; t<threads; t++){
+        if(!pthread_equal(R[t].thread, pthread_self()))
+            pthread_join(R[t].thread, NULL);
+    }
+    uint64_t elapsed = nowNs() - start;
+    //Se suman los histogramas y se juntan las líneas de tiempo de todos los hilos
+    size_t occupied = 0, n_events = 0;
+    for(int t=1; t<threads; t++){
+        for(int op=0; op<OP_KINDS; op++){
+            for(size_t b=0; b<LAT_BUCKETS; b++)
+                R[0].lat[op][b] += R[t].lat[op][b];
+            R[0].lat_sum[op] += R[t].lat_sum[op];
+            if(R[t].lat_max[op] > R[0].lat_max[op])
+                R[0].lat_max[op] = R[t].lat_max[op];
+        }
+    }
+    for(int t=0; t<threads; t++){
+        occupied += R[t].occupied;
+        n_events += R[t].n_events;
+    }
+    resize_event *events = (resize_event*)malloc(sizeof(resize_event)*(n_events + 1));
+    n_events = 0;
+    for(int t=0; t<threads; t++){
+        if(events != NULL)
+            memcpy(events + n_events, R[t].events, sizeof(resize_event)*R[t].n_events);
+        n_events += R[t].n_events;
+        free(R[t].events);
+        free(R[t].mine);
+    }
+    printf("Repetición: %zu operaciones en %d hilo(s)%s, %.3f s (%.0f ops/s)\n", T->n, threads, TO->timed ? " con los tiempos originales" : "",
+           elapsed/1e9, (elapsed > 0) ? T->n/(elapsed/1e9) : 0.0);
+    for(int op=OP_INSERT; op<OP_KINDS; op++)
+        printLatency(op, R[0].lat[op], R[0].lat_sum[op], R[0].lat_max[op]);
+    perfReport();
+    if(events != NULL){
+        qsort(events, n_events, sizeof(resize_event), compareResizeEvents);
+        printf("Remodel: %zu\n", n_events);
+        for(size_t i=0; i<n_events; i++)
+            printf("    %.3f ms: hilo %d, operación %zu (%s), %.3f ms, %zu bytes reservados\n", events[i].time/1e6, events[i].thread,
+                   events[i].op, OP_NAMES[T->ops[events[i].op].op], events[i].duration/1e6, events[i].bytes);
+        free(events);
+    }
+    printf("Elementos ocupados: %zu\n", occupied);
+    memReport();
+    floodReport();
+    free(R);
+    freeTrace(T);
+    return 0;
+}
+
+/*...............................................VENCIMIENTO (TTL).........................................................................*/
+/*Función para iniciar la rueda ("ttl" es el TTL por omisión en ms)*/
+void initTimerWheel(timer_wheel *W, uint64_t ttl){
+    memset(W, 0, sizeof(timer_wheel));
+    W->ttl = ttl*1000000ULL;
+    W->tick = ttlNow(W)/TTL_TICK_NS;
+}
+
+/*Función para acomodar un nodo en la rueda: va en el nivel más bajo cuyo bloque de arriba es el mismo que el del tick actual (así su
+//...casilla se recorre antes de que venza). Si ya venció, pasa directo a los vencidos*/
+void wheelPlace(timer_wheel *W, timer_node *node){
+    //El tick de un nodo es el primero que empieza después de su vencimiento
+    uint64_t when = node->deadline/TTL_TICK_NS + 1;
+    if(when <= W->tick){
+        node->next = W->due;
+        W->due = node;
+        return;
+    }
+    size_t level = 0;
+    while(level < WHEEL_LEVELS && (when >> (WHEEL_BITS*(level+1))) != (W->tick >> (WHEEL_BITS*(level+1))))
+        level++;
+    size_t slot;
+    if(level == WHEEL_LEVELS){
+        //Vence después de lo que cubre la rueda: se deja en la siguiente casilla del último nivel y ahí se vuelve a acomodar
+        level = WHEEL_LEVELS-1;
+        slot = ((W->tick >> (WHEEL_BITS*level)) + 1) & (WHEEL_SLOTS-1);
+    }
+    else
+        slot = (when >> (WHEEL_BITS*level)) & (WHEEL_SLOTS-1);
+    node->next = W->slots[level][slot];
+    W->slots[level][slot] = node;
+    W->count[level]++;
+}
+
+/*Función para apuntar en la rueda el vencimiento de un record*/
+void wheelSchedule(timer_wheel *W, record *rec, uint64_t deadline){
+    timer_node *node = (timer_node*)memMalloc(MEM_NODES, sizeof(timer_node) + rec->len);
+    if(node == NULL){
+        fprintf(stderr, "Cannot allocate memory for timer!\n");
+        return;
+    }
+    node->deadline = deadline;
+    node->len = rec->len;
+    memcpy(node->bytes, rec->bytes, rec->len);
+    wheelPlace(W, node);
+    W->pending++;
+}
+
+/*Función para sacar una casilla de la rueda (regresa su lista)*/
+static inline timer_node* wheelTake(timer_wheel *W, size_t level, size_t slot){
+    timer_node *list = W->slots[level][slot];
+    W->slots[level][slot] = NULL;
+    for(timer_node *node = list; node != NULL; node = node->next)
+        W->count[level]--;
+    return list;
+}
+
+/*Función para avanzar la rueda hacia el reloj actual (a lo más TTL_TICKS pasos por llamada). Al cruzar el límite de un nivel, su
+//...casilla se baja a los niveles de abajo; lo de la casilla del nivel 0 pasa a los vencidos*/
+void wheelAdvance(timer_wheel *W){
+    uint64_t target = ttlNow(W)/TTL_TICK_NS;
+    for(size_t steps=0; steps<TTL_TICKS && W->tick<target; steps++){
+        //Si los niveles de abajo están vacíos, se brinca hasta el siguiente límite del primer nivel que sí tiene nodos
+        size_t level = 0;
+        while(level < WHEEL_LEVELS && W->count[level]==0)
+            level++;
+        if(level == WHEEL_LEVELS){
+            W->tick = target;
+            break;
+        }
+        if(level > 0){
+            uint64_t edge = ((W->tick >> (WHEEL_BITS*level)) + 1) << (WHEEL_BITS*level);
+            W->tick = (edge - 1 < target) ? edge - 1 : target - 1;
+        }
+        uint64_t t = ++W->tick;
+        for(level=WHEEL_LEVELS-1; level>0; level--){
+            if((t & (((uint64_t)1 << (WHEEL_BITS*level)) - 1)) != 0)
+                continue;
+            timer_node *node = wheelTake(W, level, (t >> (WHEEL_BITS*level)) & (WHEEL_SLOTS-1));
+            while(node != NULL){
+                timer_node *next = node->next;
+                wheelPlace(W, node);
+                node = next;
+            }
+        }
+        timer_node *node = wheelTake(W, 0, t & (WHEEL_SLOTS-1));
+        while(node != NULL){
+            timer_node *next = node->next;
+            node->next = W->due;
+            W->due = node;
+            node = next;
+        }
+    }
+}
+
+/*Función para liberar todos los nodos de la rueda*/
+void freeTimerWheel(timer_wheel *W){
+    timer_node *node;
+    while((node = wheelPopDue(W)) != NULL)
+        freeTimerNode(node);
+    for(size_t level=0; level<WHEEL_LEVELS; level++){
+        for(size_t slot=0; slot<WHEEL_SLOTS; slot++){
+            W->due = W->slots[level][slot];
+            W->slots[level][slot] = NULL;
+            while((node = wheelPopDue(W)) != NULL)
+                freeTimerNode(node);
+        }
+        W->count[level] = 0;
+    }
+}
+
+/*Función para imprimir los datos del TTL*/
+void ttlStats(timer_wheel *W){
+    printf("TTL: %zu vencidos quitados, %zu pendientes en la rueda, %zu avisos sin efecto\n", W->expired, W->pending, W->stale);
+}
+
+/*Función para leer la opción "ttl=ms" (TTL por omisión; con 0 sólo vencen los que lo piden al insertar). Regresa YES si era ésa*/
+int parseTTLOption(int *ttl, uint64_t *ms, const char *arg){
+    if(strncmp(arg, "ttl=", 4)!=0)
+        return NO;
+    *ttl = YES;
+    *ms = strtoull(arg + 4, NULL, 10);
+    return YES;
+}
+
+
+/*...............................................CICLO DE COMANDOS.........................................................................*/
+/*Función para atender los comandos de la entrada con las operaciones "ops" sobre "T" hasta "exit" o el fin de la entrada*/
+void runCommands(const command_ops *ops, void *T, trace_writer *TW){
+    record rec;
+    char buffer[100];
+    while(fgets(buffer, 100, stdin) != NULL){
+        char command[100] = " ";
+        char number[100] = " ";
+        char extra[100] = "";
+        sscanf(buffer, "%99s %99s %99s", command, number, extra);     //Recuerda usar el espacio para separar
+        traceCommand(TW, command, number);
+        rec.bytes = number;
+        rec.len = strlen(number);
+        if(ops->command != NULL && ops->command(T, buffer, command, number)==YES)
+            continue;
+        if(strcmp("insert", command)==0){               //Insertar ("insert llave [extra]")
+            ops->insert(T, &rec, extra);
+            continue;
+        }
+        if(strcmp("delete", command)==0){               //Borrar
+            ops->remove(T, &rec);
+            continue;
+        }
+        if(strcmp("find", command)==0){                 //Buscar (se mide el tiempo para los sustitutos del TLB)
+            uint64_t start = nowNs();
+            int found = ops->find(T, &rec);
+            find_ns += nowNs() - start;
+            find_count++;
+            if(found==YES)
+                printf("Encontrado: %s\n", number);
+            else
+                printf("No encontrado: %s\n", number);
+            continue;
+        }
+        if(strcmp("print", command)==0){                //Imprimir
+            ops->print(T);
+            continue;
+        }
+        if(strcmp("count", command)==0){                //Imprimir no. de elementos en la tabla
+            printf("Elementos ocupados: %zu\n", ops->count(T));
+            continue;
+        }
+        if(strcmp("mem", command)==0 || strcmp("stop", command)==0){    //Memoria ("stop" antes se quedaba en un ciclo infinito para medirla desde fuera)
+            if(ops->stats != NULL)
+                ops->stats(T);
+            memReport();
+            floodReport();
+            perfFlush();
+            perfReport();
+            tlbProxyReport();
+            continue;
+        }
+        if(strcmp("exit", command)==0)                  //Salir
+            break;
+    }
+    closeTraceWriter(TW);
+    if(alloc_policy != 0)
+        tlbProxyReport();
+    ops->destroy(T);
+}
+
+/*...............................................AGREGACIÓN...............................................................................*/
+/*Función para leer una línea de agregación: "add llave [delta]" o "insert llave" (cuenta 1). La llave se deja en "number" (de AGG_KEY
+//...bytes). Regresa NO si la línea no suma nada*/
+int parseAggLine(const char *line, record *rec, char *number, int64_t *delta){
+    char command[20] = " ";
+    long long value = 1;
+    number[0] = '\0';
+    int n = sscanf(line, "%19s %99s %lld", command, number, &value);
+    if(n < 2 || (strcmp("add", command)!=0 && strcmp("insert", command)!=0))
+        return NO;
+    if(strcmp("insert", command)==0)
+        value = 1;
+    rec->bytes = number;
+    rec->len = strlen(number);
+    *delta = (int64_t)value;
+    return YES;
+}
+
+/*Función para saber si un comando es de agregación*/
+int isAggCommand(const char *command){
+    return (strcmp("add", command)==0 || strcmp("get", command)==0 || strcmp("aggload", command)==0);
+}
+
+/*Función para leer la opción "agg" (acumulador por contenido para los comandos de agregación; con ella "insert llave" también cuenta 1,
+//...igual que en "aggload"). Regresa YES si era ésa*/
+int parseAggOption(int *agg, const char *arg){
+    if(strcmp(arg, "agg")!=0)
+        return NO;
+    *agg = YES;
+    return YES;
+}
+
+/*.....................................REDIMENSIÓN EN SEGUNDO PLANO......................................................................*/
+/*Función para inicializar el hilo de redimensión (todavía sin hilo: se crea al agendar)*/
+void initResizeWorker(resize_worker *RW, int mode, void (*copy)(resize_worker*, size_t, size_t), void (*replay)(resize_worker*, record*, int)){
+    pthread_mutex_init(&RW->lock, NULL);
+    RW->phase = RS_IDLE;
+    RW->mode = mode;
+    RW->source = NULL;
+    RW->target = NULL;
+    RW->span = 0;
+    RW->copy = copy;
+    RW->replay = replay;
+    RW->log = NULL;
+    RW->log_head = 0;
+    RW->log_len = 0;
+    RW->log_cap = 0;
+}
+
+/*Función del hilo: copia la tabla vieja por bloques y luego vacía la bitácora*/
+static void* resizeWorkerMain(void *arg){
+    resize_worker *RW = (resize_worker*)arg;
+    size_t mark = memRemodelBegin();
+    for(size_t start=0; start<RW->span; start+=RESIZE_CHUNK){
+        size_t end = (start + RESIZE_CHUNK < RW->span) ? start + RESIZE_CHUNK : RW->span;
+        pthread_mutex_lock(&RW->lock);
+        RW->copy(RW, start, end);
+        pthread_mutex_unlock(&RW->lock);
+    }
+    //La bitácora también se vacía por bloques; el último bloque se aplica con el candado tomado y ahí mismo se marca como lista
+    while(1){
+        pthread_mutex_lock(&RW->lock);
+        size_t end = RW->log_head + RESIZE_CHUNK;
+        int last = (end >= RW->log_len);
+        if(last)
+            end = RW->log_len;
+        for(; RW->log_head<end; RW->log_head++){
+            resize_op *op = &RW->log[RW->log_head];
+            RW->replay(RW, &op->rec, op->operation);
+            memFree(MEM_KEYS, op->rec.bytes, op->rec.len);
+        }
+        if(last){
+            RW->log_head = 0;
+            RW->log_len = 0;
+            memRemodelEnd(mark);
+            __atomic_store_n(&RW->phase, RS_READY, __ATOMIC_RELEASE);
+        }
+        pthread_mutex_unlock(&RW->lock);
+        if(last)
+            break;
+    }
+    return NULL;
+}
+
+/*Función para arrancar el hilo que copia "source" (de "span" posiciones) a "target", que ya está creada y vacía. Regresa NO si no se
+//...pudo crear el hilo (entonces quien llamó redimensiona como siempre)*/
+int startResizeWorker(resize_worker *RW, void *source, void *target, size_t span){
+    RW->source = source;
+    RW->target = target;
+    RW->span = span;
+    RW->phase = RS_BUILDING;
+    if(pthread_create(&RW->thread, NULL, resizeWorkerMain, RW) != 0){
+        RW->source = NULL;
+        RW->target = NULL;
+        RW->phase = RS_IDLE;
+        return NO;
+    }
+    return YES;
+}
+
+/*Función para esperar al hilo si ya terminó (o, con "wait", hasta que termine). Regresa YES si la tabla nueva ya se puede tomar de
+//..."target" (y la vieja liberar de "source")*/
+int finishResizeWorker(resize_worker *RW, int wait){
+    int phase = resizePhase(RW);
+    if(phase == RS_IDLE || (!wait && phase != RS_READY))
+        return NO;
+    pthread_join(RW->thread, NULL);
+    RW->phase = RS_IDLE;
+    return YES;
+}
+
+/*Función para anotar en la bitácora una operación hecha sobre la tabla vieja (se llama con el candado tomado)*/
+void logResizeOp(resize_worker *RW, record *rec, int operation){
+    if(RW->log_len == RW->log_cap){
+        size_t cap = (RW->log_cap == 0) ? RESIZE_CHUNK : RW->log_cap*2;
+        resize_op *log = (resize_op*)memRealloc(MEM_NODES, RW->log, sizeof(resize_op)*RW->log_cap, sizeof(resize_op)*cap);
+        if(log == NULL){
+            fprintf(stderr, "Cannot allocate memory for element!\n");
+            exit(1);
+        }
+        RW->log = log;
+        RW->log_cap = cap;
+    }
+    resize_op *op = &RW->log[RW->log_len];
+    op->rec.bytes = memMalloc(MEM_KEYS, rec->len);
+    if(op->rec.bytes == NULL){
+        fprintf(stderr, "Cannot allocate memory for element!\n");
+        exit(1);
+    }
+    memcpy(op->rec.bytes, rec->bytes, rec->len);
+    op->rec.len = rec->len;
+    op->operation = operation;
+    RW->log_len++;
+}
+
+/*Función para liberar la bitácora (cuando ya no hay redimensión en curso)*/
+void freeResizeWorker(resize_worker *RW){
+    memFree(MEM_NODES, RW->log, sizeof(resize_op)*RW->log_cap);
+    RW->log = NULL;
+    RW->log_cap = 0;
+    pthread_mutex_destroy(&RW->lock);
+}
+
+/*Función para leer la opción "bg" (redimensionar en segundo plano). Regresa YES si era ésa*/
+int parseBackgroundOption(int *background, const char *arg){
+    if(strcmp(arg, "bg")!=0)
+        return NO;
+    *background = YES;
+    return YES;
+}
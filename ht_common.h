@@ -0,0 +1,689 @@
+//Funciones comunes de las tablas hash con Open Addressing (HT_OA.c) y con Separate Chaining (HT_SC.c): contadores de hardware,
+//...contabilidad y política de memoria, llaves con semilla (SipHash y sus núcleos por lotes), comparación de contenidos, llaves enteras,
+//...grabación y repetición de trazas y la rueda de tiempos del TTL. Lo propio de cada tabla (elementos, histéresis, etc.) sigue en su archivo
+#ifndef HT_COMMON_H
+#define HT_COMMON_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+#include <string.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+#include <malloc.h>
+#include <sys/resource.h>
+#include <sys/ioctl.h>
+#include <linux/perf_event.h>
+#include <pthread.h>
+
+//Definimos macros (cuando el PC compile, YES lo traduce a 1 y NO a 0... no son variables globales)
+#define YES 1
+#define NO 0
+#define VALID 1
+#define NOTVALID 0
+#define DELETED NOTVALID
+#define MAX_64 2147483647
+#define FULL 2
+#define EMPTY 1
+#define RESEED 4                //Estado para Remodel: reconstruir del mismo tamaño con otra semilla
+#define UP 1
+#define DOWN 0
+
+//En este arreglo se contienen los números primos menores a cada potencia de 2 (hasta 2^16)
+#define HASH_SIZES 28
+extern const uint32_t HASH_SIZE[HASH_SIZES];
+
+//Constante de ADLER
+extern const uint32_t MOD_ADLER;
+
+/*..........................................CONTADORES DE HARDWARE.......................................................................*/
+/*Con la opción "perf" se abren (con perf_event_open) los contadores de instrucciones, ciclos, fallos de caché, fallos de predicción de
+//...saltos y fallos del TLB de datos, sólo de espacio de usuario y para el hilo que los abre. La repetición de trazas los lee antes y
+//...después de cada operación y los suma por tipo (insert, delete, find); los Remodel también se miden aparte (y cuentan dentro de la
+//...operación que los provocó). Cada hilo suma en sus propias variables y al terminar las pasa a los totales*/
+#define OP_INSERT 1
+#define OP_DELETE 2
+#define OP_FIND 3
+#define OP_REMODEL 4
+#define PERF_KINDS 5
+#define PERF_EVENTS 5
+#define PERF_TLB 4              //Posición de los fallos del TLB de datos en los contadores
+
+extern const char *PERF_KIND_NAMES[PERF_KINDS];
+extern const char *PERF_EVENT_NAMES[PERF_EVENTS];
+extern const uint32_t PERF_EVENT_TYPES[PERF_EVENTS];
+extern const uint64_t PERF_EVENT_CONFIGS[PERF_EVENTS];
+
+/*Estructura del grupo de contadores de un hilo*/
+typedef struct{
+    int fd[PERF_EVENTS];        //-1 si ese contador no se pudo abrir (el primero que se abre es el líder del grupo)
+    int leader;                 //fd del líder (-1 si no hay ninguno)
+    int n;                      //No. de contadores abiertos (en el orden de "fd")
+    int tried;                  //YES si este hilo ya intentó abrirlos
+    int depth;                  //Remodel anidados (sólo se mide el de afuera)
+    uint64_t remodel[PERF_EVENTS];              //Lectura al empezar el Remodel de afuera
+    uint64_t local[PERF_KINDS][PERF_EVENTS];    //Sumas de este hilo por tipo de operación
+    size_t ops[PERF_KINDS];
+}perf_group;
+
+//Variables globales de los contadores
+extern int perf_enabled;
+extern __thread perf_group perf_thread;
+extern uint64_t perf_totals[PERF_KINDS][PERF_EVENTS];
+extern size_t perf_ops[PERF_KINDS];
+extern int perf_available[PERF_EVENTS];        //YES si algún hilo pudo abrir ese contador
+
+/*Función para abrir el grupo de contadores del hilo actual (si alguno no existe en este procesador, se sigue sin él)*/
+void perfOpen();
+
+/*Función para leer todos los contadores del hilo en "values" (en 0 los que no están abiertos)*/
+static inline void perfRead(uint64_t *values){
+    perf_group *P = &perf_thread;
+    if(!P->tried)
+        perfOpen();
+    uint64_t buffer[1 + PERF_EVENTS];
+    memset(values, 0, sizeof(uint64_t)*PERF_EVENTS);
+    if(P->leader == -1 || read(P->leader, buffer, sizeof(uint64_t)*(1 + P->n)) <= 0)
+        return;
+    int k = 1;
+    for(int e=0; e<PERF_EVENTS; e++){
+        if(P->fd[e] != -1)
+            values[e] = buffer[k++];
+    }
+}
+
+/*Funciones para medir una operación: "snap" guarda la lectura del inicio*/
+static inline void perfBegin(uint64_t *snap){
+    if(perf_enabled)
+        perfRead(snap);
+}
+static inline void perfEnd(int kind, const uint64_t *snap){
+    if(!perf_enabled)
+        return;
+    uint64_t now[PERF_EVENTS];
+    perfRead(now);
+    for(int e=0; e<PERF_EVENTS; e++)
+        perf_thread.local[kind][e] += now[e] - snap[e];
+    perf_thread.ops[kind]++;
+}
+
+/*Funciones para medir un Remodel (los llaman memRemodelBegin y memRemodelEnd)*/
+static inline void perfRemodelBegin(){
+    if(perf_enabled && perf_thread.depth++ == 0)
+        perfRead(perf_thread.remodel);
+}
+static inline void perfRemodelEnd(){
+    if(perf_enabled && perf_thread.depth > 0 && --perf_thread.depth == 0)
+        perfEnd(OP_REMODEL, perf_thread.remodel);
+}
+
+/*Función para pasar las sumas del hilo actual a los totales y cerrar sus contadores*/
+void perfFlush();
+
+/*Función para imprimir los contadores por operación de cada tipo (ya pasados a los totales)*/
+void perfReport();
+
+/*..........................................CONTABILIDAD DE MEMORIA......................................................................*/
+/*Las reservas de las tablas pasan por estas funciones, que llevan la cuenta de los bytes pedidos según su uso, de lo que el asignador
+//...reservó de más (holgura), del máximo alcanzado y de lo que se reservó durante los Remodel. El comando "mem" lo imprime junto con el
+//...pico de RSS del proceso (getrusage), así ya no hace falta dejar el programa colgado con "stop" para medirlo desde fuera*/
+#define MEM_TABLE 0             //Estructuras de las tablas y arreglos de casillas, cabezas e índices
+#define MEM_NODES 1             //Chunks de las listas, bloques de las cabezas y stash
+#define MEM_KEYS 2              //Contenido de los records (y arenas)
+#define MEM_SLACK 3             //Lo que el asignador reservó de más sobre lo pedido
+#define MEM_KINDS 4
+
+//Variables globales de la contabilidad (se actualizan con atómicas: el hilo de redimensión también reserva)
+extern size_t mem_bytes[MEM_KINDS];
+extern size_t mem_current;         //Suma de todos los tipos (incluida la holgura)
+extern size_t mem_peak;            //Máximo de mem_current
+extern size_t mem_allocated;       //Total reservado desde el inicio (sólo crece)
+extern size_t mem_remodel_bytes;   //Reservado durante los Remodel
+extern size_t mem_remodels;        //No. de Remodel
+//Lo que ha reservado el hilo actual y sus Remodel (la repetición de trazas los usa para su línea de tiempo)
+extern __thread size_t mem_thread_allocated;
+extern __thread size_t mem_thread_remodels;
+
+/*Funciones para sumar o restar una reserva de "bytes" pedidos que en realidad ocupó "real" bytes*/
+static inline void memAdd(int kind, size_t bytes, size_t real){
+    __atomic_add_fetch(&mem_bytes[kind], bytes, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&mem_bytes[MEM_SLACK], real - bytes, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&mem_allocated, real, __ATOMIC_RELAXED);
+    mem_thread_allocated += real;
+    size_t now = __atomic_add_fetch(&mem_current, real, __ATOMIC_RELAXED);
+    size_t peak = __atomic_load_n(&mem_peak, __ATOMIC_RELAXED);
+    while(now > peak && !__atomic_compare_exchange_n(&mem_peak, &peak, now, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+static inline void memSub(int kind, size_t bytes, size_t real){
+    __atomic_sub_fetch(&mem_bytes[kind], bytes, __ATOMIC_RELAXED);
+    __atomic_sub_fetch(&mem_bytes[MEM_SLACK], real - bytes, __ATOMIC_RELAXED);
+    __atomic_sub_fetch(&mem_current, real, __ATOMIC_RELAXED);
+}
+
+/*Funciones como malloc, realloc y free que además llevan la cuenta (free necesita los mismos bytes que se pidieron)*/
+void* memMalloc(int kind, size_t bytes);
+void* memRealloc(int kind, void *ptr, size_t old_bytes, size_t new_bytes);
+void memFree(int kind, void *ptr, size_t bytes);
+
+/*Funciones para marcar el inicio y el fin de un Remodel (se cuenta todo lo que se reservó entre ambas)*/
+static inline size_t memRemodelBegin(){
+    perfRemodelBegin();
+    return __atomic_load_n(&mem_allocated, __ATOMIC_RELAXED);
+}
+static inline void memRemodelEnd(size_t start){
+    __atomic_add_fetch(&mem_remodels, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&mem_remodel_bytes, __atomic_load_n(&mem_allocated, __ATOMIC_RELAXED) - start, __ATOMIC_RELAXED);
+    mem_thread_remodels++;
+    perfRemodelEnd();
+}
+
+/*Función para imprimir la contabilidad junto con el pico de RSS del proceso*/
+void memReport();
+
+/*..........................................POLÍTICA DE MEMORIA..........................................................................*/
+/*Los arreglos grandes de las tablas (casillas, cabezas y arenas) se pueden reservar con páginas grandes, repartidos entre nodos NUMA
+//...y tocados desde el inicio (para no pagar los fallos de página durante las operaciones). La política se elige con cualquier
+//...argumento del programa después del modo, p. ej. "huge,interleave,prefault" o "thp,node=1". Sin política, todo se reserva con calloc*/
+#define ALLOC_HUGETLB 1             //Páginas grandes explícitas (MAP_HUGETLB); si no hay reservadas, se usa "thp"
+#define ALLOC_THP 2                 //Páginas grandes transparentes (madvise(MADV_HUGEPAGE))
+#define ALLOC_INTERLEAVE 4          //Repartir las páginas entre todos los nodos NUMA
+#define ALLOC_BIND 8                //Poner todas las páginas en el nodo "alloc_node"
+#define ALLOC_PREFAULT 16           //Tocar todas las páginas al crear el arreglo
+#define HUGE_PAGE_SIZE ((size_t)2*1024*1024)
+
+//Variables globales de la política de memoria
+extern int alloc_policy;
+extern int alloc_node;
+
+/*Función para leer la política desde un argumento con opciones separadas por comas. Regresa YES si el argumento era de la política*/
+int parseAllocPolicy(const char *arg);
+
+/*Función que indica si un arreglo de "bytes" se reserva con mmap (según la política) o con calloc*/
+static inline int usesTableMapping(size_t bytes){
+    return alloc_policy != 0 && bytes >= HUGE_PAGE_SIZE;
+}
+
+/*Función para reservar un arreglo de una tabla (en 0) según la política de memoria. "kind" es su uso para la contabilidad*/
+void* allocTableArrayKind(size_t bytes, int kind);
+
+/*Función para liberar un arreglo reservado con allocTableArray (se necesita el mismo número de bytes)*/
+void freeTableArrayKind(void *ptr, size_t bytes, int kind);
+
+/*Función para cambiar de tamaño un arreglo reservado con allocTableArray (la parte nueva no se inicializa en 0 si viene de realloc)*/
+void* reallocTableArrayKind(void *ptr, size_t old_bytes, size_t new_bytes, int kind);
+
+/*Las mismas funciones para los arreglos de casillas y cabezas (el uso más común)*/
+void* allocTableArray(size_t bytes);
+void freeTableArray(void *ptr, size_t bytes);
+void* reallocTableArray(void *ptr, size_t old_bytes, size_t new_bytes);
+
+/*Función para imprimir cuánta memoria anónima del proceso está respaldada por páginas grandes*/
+void printHugePageUsage();
+
+/*Sustitutos de los fallos del TLB: donde no se pueden abrir los contadores dTLB (perf_event_paranoid alto o una máquina virtual sin
+//...PMU), el efecto de la política se estima con lo que sí se mide: los fallos de página (uno por cada página de 4 KB que se toca, uno
+//...por cada 2 MB con páginas grandes), cuántas páginas hacen falta para cubrir los arreglos de las tablas (el alcance del TLB), la
+//...memoria respaldada por páginas grandes y el tiempo promedio de "find". Donde sí hay contadores, los fallos se miden con la opción
+//..."perf" (por operación) o por fuera con "perf stat -e dTLB-loads,dTLB-load-misses ./HT_OA 1 thp < comandos"*/
+extern uint64_t find_ns;            //Tiempo total de los "find" del ciclo de comandos
+extern size_t find_count;
+void tlbProxyReport();
+
+/*Función generador de llaves*/
+uint32_t adler32(unsigned char *data, size_t len);
+
+/*..........................................LLAVES CON SEMILLA.............................................................................*/
+/*Con adler32 es muy fácil fabricar muchos contenidos con la misma llave (y además las llaves de contenidos parecidos quedan juntas), así
+//...que quien escoja las llaves puede mandar todo a la misma cubeta y volver cada búsqueda O(n). Por eso las tablas ya no usan adler32
+//...como llave sino SipHash-1-3 con una semilla de 64 bits sorteada con getrandom: sin conocer la semilla no se pueden buscar choques.
+//...Todas las tablas empiezan con la semilla del proceso (así las operaciones de conjuntos y la agregación pueden pasar la llave guardada
+//...de una tabla a otra sin volver a calcularla); si al insertar se detecta un recorrido anormalmente largo (más de floodLimit), esa tabla
+//...se reconstruye con una semilla nueva sólo para ella (y entonces las llaves se vuelven a calcular al pasar de una tabla a otra)*/
+#define FLOOD_BASE 32                   //Recorrido que siempre se tolera (las tablas chicas tienen cúmulos por azar)
+
+extern uint64_t hash_seed;                 //Semilla del proceso (0 = aún no se sortea)
+extern size_t flood_detections;            //Inserciones con un recorrido anormalmente largo
+extern size_t flood_reseeds;               //Tablas reconstruidas con otra semilla
+
+/*Función para sortear una semilla (con getrandom; si no se puede, con el reloj y una dirección). Nunca regresa 0*/
+uint64_t randomSeed();
+
+/*Función para obtener la semilla del proceso (la primera tabla la sortea; si dos hilos llegan a la vez se quedan con la misma)*/
+uint64_t tableSeed();
+
+/*Función para el hash de 64 bits con semilla (SipHash-1-3: una ronda por bloque de 8 bytes y tres al final). La segunda mitad de la
+//...clave de 128 bits se deriva de la semilla*/
+uint64_t seededHash64(uint64_t seed, const unsigned char *data, size_t len);
+
+/*Función generador de llaves con semilla (las dos mitades del hash de 64 bits)*/
+uint32_t seededKey(uint64_t seed, const unsigned char *data, size_t len);
+
+/*Función para el recorrido máximo que se tolera al insertar en una tabla de "size" casillas o cabezas: FLOOD_BASE más 4 por cada bit
+//...del tamaño (con una buena función hash el recorrido más largo crece como log n)*/
+static inline size_t floodLimit(size_t size){
+    size_t bits = 0;
+    while((size >> bits) > 1)
+        bits++;
+    return FLOOD_BASE + 4*bits;
+}
+
+/*Función para revisar la marca que deja una inserción con un recorrido anormalmente largo: se cuenta la detección y se borra la marca.
+//...Regresa YES si además hay que reconstruir la tabla con otra semilla, es decir, si ya tiene al menos "floor" elementos (el doble que en
+//...su último resiembro; así una tabla con choques que no se quitan no se reconstruye con cada inserción)*/
+static inline int floodReseedDue(int *flooded, size_t occupied, size_t floor){
+    if(*flooded==NO)
+        return NO;
+    *flooded = NO;
+    __atomic_add_fetch(&flood_detections, 1, __ATOMIC_RELAXED);
+    return (occupied >= floor) ? YES : NO;
+}
+
+/*Función para imprimir las detecciones*/
+void floodReport();
+
+/*..........................................HASH POR LOTES.................................................................................*/
+/*Cuando se tienen muchas llaves a la mano (Remodel, el cambio de forma de la adaptativa, "insertall" y "findall"), el hash se calcula de a
+//...varias llaves a la vez: cada carril del vector lleva el estado de SipHash de una llave distinta (4 carriles con AVX2, 8 con AVX-512;
+//...los estados son de 64 bits). Las llaves de distinto tamaño hacen distinto número de rondas, así que en cada paso se enmascaran los
+//...carriles que ya terminaron y al final todos hacen las tres rondas de cierre. Los bloques de cada llave se leen uno por uno (el
+//...último con la longitud, igual que seededHash64) y se juntan en un vector. La versión se escoge según el CPU en la primera llamada*/
+#define HASH_LANES 8                    //Llaves por llamada al núcleo
+#define HASH_BATCH 64                   //Llaves por lote al insertar o buscar
+
+/*Núcleos del hash por lotes: calculan seededHash64 de "n" contenidos (seededHashLanes es el que escogió el selector según el CPU)*/
+void seededHashScalar(uint64_t seed, const unsigned char **data, const size_t *len, size_t n, uint64_t *out);
+#if defined(__x86_64__) || defined(__i386__)
+void seededHashAVX2(uint64_t seed, const unsigned char **data, const size_t *len, size_t n, uint64_t *out);
+void seededHashAVX512(uint64_t seed, const unsigned char **data, const size_t *len, size_t n, uint64_t *out);
+#endif
+extern void (*seededHashLanes)(uint64_t seed, const unsigned char **data, const size_t *len, size_t n, uint64_t *out);
+
+/*Función para calcular las llaves de "n" contenidos con la misma semilla (lo mismo que seededKey para cada uno)*/
+void seededKeyBatch(uint64_t seed, const unsigned char **data, const size_t *len, size_t n, uint32_t *keys);
+
+/*Estructura tipo record para incluir la longitud de cadena y los bytes de una información (como un stream de datos, con un puntero al inicio y de ahí sabemos la longitud)*/
+typedef struct{
+    void *bytes;                //El "void" es para que podamos decir que es un puntero de cualquier tipo de datos
+    size_t len;                 //Longitud del contenido
+}record;
+
+/*..........................................COMPARACIÓN DE CONTENIDOS......................................................................*/
+/*Núcleo de comparación: compara 8 bytes a la vez con cargas no alineadas (memcpy) y termina la cola de 4, 2 y 1 bytes*/
+/*NOTA: nunca lee más allá de "len", así que sirve con los bytes justos que reservamos para cada record*/
+static inline int compareBytesWord(const unsigned char *pA, const unsigned char *pB, size_t len){
+    size_t i = 0;
+    for(; i+8<=len; i+=8){
+        uint64_t a, b;
+        memcpy(&a, pA+i, 8);
+        memcpy(&b, pB+i, 8);
+        if(a != b)
+            return NO;
+    }
+    if(i+4<=len){
+        uint32_t a, b;
+        memcpy(&a, pA+i, 4);
+        memcpy(&b, pB+i, 4);
+        if(a != b)
+            return NO;
+        i+=4;
+    }
+    if(i+2<=len){
+        uint16_t a, b;
+        memcpy(&a, pA+i, 2);
+        memcpy(&b, pB+i, 2);
+        if(a != b)
+            return NO;
+        i+=2;
+    }
+    if(i<len && pA[i] != pB[i])
+        return NO;
+    return YES;
+}
+
+/*Puntero a la versión del núcleo que se usa para llaves largas (SSE2 o AVX2 según el CPU)*/
+extern int (*compareBytesLong)(const unsigned char *pA, const unsigned char *pB, size_t len);
+
+/*Compara los bytes de dos contenidos de la misma longitud: las llaves cortas no pasan por el selector*/
+static inline int compareBytes(const void *A, const void *B, size_t len){
+    if(len < 16)
+        return compareBytesWord((const unsigned char*)A, (const unsigned char*)B, len);
+    return compareBytesLong((const unsigned char*)A, (const unsigned char*)B, len);
+}
+
+/*Función para checar los bytes entre dos contenidos y ver si son iguales o no*/
+int checkMatchRecord(record *A, record *B);
+
+/*............................................LLAVES ENTERAS..............................................................................*/
+/*Función para leer una llave entera. Sólo acepta decimales sin signo y sin ceros a la izquierda ("007" no es lo mismo que "7" como record)*/
+int parseIntKey(const char *str, uint64_t *key);
+
+/*Funciones para mezclar los bits de una llave entera (el final de murmur3), así llaves consecutivas no caen en cubetas consecutivas*/
+static inline uint32_t mixKey32(uint32_t x){
+    x ^= x >> 16;
+    x *= 0x85ebca6bu;
+    x ^= x >> 13;
+    x *= 0xc2b2ae35u;
+    x ^= x >> 16;
+    return x;
+}
+static inline uint64_t mixKey64(uint64_t x){
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+/*Funciones para mezclar una llave entera con la semilla de su tabla: la semilla se combina (xor) con la llave antes de la mezcla, así que
+//...sin conocerla no se pueden escoger llaves que caigan en la misma cubeta. La mezcla de murmur3 se puede invertir, así que una tabla que
+//...ya tuvo que resembrarse ("sip" = YES) pasa sus llaves por SipHash (más lento, pero sin atajos para encontrar choques)*/
+static inline uint64_t seededMix32(uint64_t seed, int sip, uint32_t x){
+    if(sip)
+        return seededHash64(seed, (const unsigned char*)&x, sizeof(x));
+    return mixKey32(x ^ (uint32_t)(seed ^ (seed >> 32)));
+}
+static inline uint64_t seededMix64(uint64_t seed, int sip, uint64_t x){
+    if(sip)
+        return seededHash64(seed, (const unsigned char*)&x, sizeof(x));
+    return mixKey64(x ^ seed);
+}
+
+/*...............................................TRAZAS..................................................................................*/
+/*Los comandos insert/delete/find que recibe el programa se pueden grabar en un archivo binario ("record=archivo") para repetirlos después
+//...contra cualquier estrategia ("replay=archivo"): a toda velocidad o con los tiempos originales ("timed"), y en uno o varios hilos
+//...("threads=N"). Con varios hilos cada uno tiene su propia tabla y se queda con las llaves que le tocan (según su adler32 mezclado), así
+//...que el orden de las operaciones de cada llave se respeta. Al final se imprime un histograma de latencias por tipo de operación y la
+//...línea de tiempo de los Remodel.
+//...Formato: "HTTR" y un byte de versión; luego, por operación, un byte con el tipo, el tiempo desde la operación anterior (ns) y la
+//...longitud del contenido (ambos como varint de 7 bits por byte) y el contenido*/
+#define TRACE_MAGIC "HTTR"
+#define TRACE_VERSION 1
+#define OP_KINDS 4                  //Los tipos de operación (OP_INSERT, OP_DELETE y OP_FIND) son los de los contadores de hardware
+#define LAT_SUB 8                   //Subcubetas lineales dentro de cada potencia de 2 del histograma
+#define LAT_BUCKETS (64*LAT_SUB)
+#define SPIN_NS 50000               //Con "timed", lo que falta por esperar por debajo de esto se espera activamente (no con nanosleep)
+
+extern const char *OP_NAMES[OP_KINDS];
+
+/*Estructura para grabar una traza*/
+typedef struct{
+    FILE *file;                 //NULL si no se está grabando
+    uint64_t last;              //Tiempo de la operación anterior (ns)
+    size_t count;               //No. de operaciones grabadas
+}trace_writer;
+
+/*Estructura de una operación leída de una traza*/
+typedef struct{
+    uint8_t op;                 //OP_INSERT, OP_DELETE u OP_FIND
+    uint32_t len;               //Longitud del contenido
+    uint64_t time;              //ns desde la primera operación
+    char *bytes;                //Contenido (apunta dentro del archivo leído)
+}trace_op;
+
+/*Estructura de una traza completa en memoria*/
+typedef struct{
+    char *data;                 //Archivo completo
+    trace_op *ops;
+    size_t n;
+}trace;
+
+/*Estructura de las opciones de traza que se leen de los argumentos*/
+typedef struct{
+    const char *record;         //Archivo donde grabar (o NULL)
+    const char *replay;         //Archivo para repetir (o NULL)
+    int threads;
+    int timed;
+}trace_options;
+
+/*Estructura con las funciones de una estrategia para la repetición (el modo sólo lo usan las que comparten estructura)*/
+typedef struct{
+    void* (*create)(size_t mode);
+    void (*destroy)(void *HT);
+    void (*insert)(void **HT, record *rec, size_t mode);
+    void (*remove)(void **HT, record *rec, size_t mode);
+    void (*find)(void **HT, record *rec, size_t mode);
+    size_t (*count)(void *HT);
+}replay_engine;
+
+/*Estructura de un Remodel visto durante la repetición*/
+typedef struct{
+    uint64_t time;              //ns desde el inicio de la repetición (al empezar la operación que lo provocó)
+    uint64_t duration;          //ns que tardó esa operación
+    size_t bytes;               //Bytes que reservó el hilo durante esa operación (casi todo es del Remodel)
+    size_t op;                  //Posición de la operación en la traza
+    int thread;
+}resize_event;
+
+/*Estructura de cada hilo de la repetición*/
+typedef struct{
+    pthread_t thread;
+    int id;
+    const trace *T;
+    const replay_engine *E;
+    size_t mode;
+    int timed;
+    uint64_t start;             //Inicio común de todos los hilos
+    size_t *mine;               //Posiciones de las operaciones que le tocan a este hilo
+    size_t n_mine;
+    size_t lat[OP_KINDS][LAT_BUCKETS];
+    uint64_t lat_sum[OP_KINDS];
+    uint64_t lat_max[OP_KINDS];
+    resize_event *events;
+    size_t n_events;
+    size_t cap_events;
+    size_t occupied;            //Elementos en la tabla del hilo al terminar
+}replay_thread;
+
+/*Función para leer el reloj monotónico en ns*/
+static inline uint64_t nowNs(){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec*1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/*Función para leer una opción de traza (o "perf", que enciende los contadores de hardware). Regresa YES si el argumento era una*/
+int parseTraceOption(trace_options *TO, const char *arg);
+
+/*Función para empezar a grabar una traza (si "path" es NULL no se graba nada)*/
+void openTraceWriter(trace_writer *TW, const char *path);
+
+/*Función para grabar un comando (los que no son insert, delete o find se ignoran)*/
+void traceCommand(trace_writer *TW, const char *command, const char *number);
+
+/*Función para terminar de grabar una traza*/
+void closeTraceWriter(trace_writer *TW);
+
+/*Función para repetir una traza con un motor en "threads" hilos. Regresa el código de salida del programa*/
+int replayTrace(const trace_options *TO, const replay_engine *E, size_t mode);
+
+/*...............................................VENCIMIENTO (TTL).........................................................................*/
+/*Rueda de tiempos jerárquica del modo TTL (4 niveles de 64 casillas, un tick por ms): lleva lo que va a vencer y cada operación la avanza
+//...a lo más TTL_TICKS ticks y atiende a lo más TTL_BUDGET vencidos. Cómo se guarda el vencimiento en cada tabla está en su archivo*/
+#define WHEEL_BITS 6
+#define WHEEL_SLOTS (1<<WHEEL_BITS)         //Casillas por nivel
+#define WHEEL_LEVELS 4                      //Niveles (64^4 ticks son unas 4.6 horas; lo que vence después se vuelve a acomodar)
+#define TTL_TICK_NS 1000000ULL              //Duración de un tick (1 ms)
+#define TTL_TICKS 256                       //Máximo de ticks que avanza la rueda por operación
+#define TTL_BUDGET 32                       //Máximo de vencimientos que se atienden por operación
+
+/*Estructura de un vencimiento pendiente. Lleva su propia copia del contenido, porque los elementos cambian de lugar en cada Remodel*/
+typedef struct timer_node{
+    struct timer_node *next;
+    uint64_t deadline;          //Vencimiento (ns del reloj del TTL)
+    size_t len;                 //Longitud del contenido
+    char bytes[];               //Copia del contenido
+}timer_node;
+
+/*Estructura de la rueda de tiempos jerárquica*/
+typedef struct{
+    timer_node *slots[WHEEL_LEVELS][WHEEL_SLOTS];
+    size_t count[WHEEL_LEVELS]; //Nodos en cada nivel
+    timer_node *due;            //Ya vencidos: falta quitarlos de la tabla
+    uint64_t tick;              //Último tick que ya se recorrió
+    uint64_t offset;            //ns que se ha adelantado el reloj con "advance"
+    uint64_t ttl;               //TTL por omisión (ns; 0 = no vence)
+    size_t pending;             //Nodos en la rueda más los vencidos sin atender
+    size_t expired;             //Elementos quitados por vencimiento
+    size_t stale;               //Nodos que ya no valían (el elemento se borró o se le cambió el vencimiento)
+}timer_wheel;
+
+/*Función para leer el reloj del TTL (el monotónico más lo que se ha adelantado)*/
+static inline uint64_t ttlNow(timer_wheel *W){
+    return nowNs() + W->offset;
+}
+
+/*Función para ver si un vencimiento ya pasó (0 = no vence)*/
+static inline int ttlExpired(timer_wheel *W, uint64_t expires){
+    return expires != 0 && expires <= ttlNow(W);
+}
+
+/*Función para iniciar la rueda ("ttl" es el TTL por omisión en ms)*/
+void initTimerWheel(timer_wheel *W, uint64_t ttl);
+
+/*Función para apuntar en la rueda el vencimiento de un record*/
+void wheelSchedule(timer_wheel *W, record *rec, uint64_t deadline);
+
+/*Función para avanzar la rueda hacia el reloj actual (a lo más TTL_TICKS pasos por llamada). Al cruzar el límite de un nivel, su
+//...casilla se baja a los niveles de abajo; lo de la casilla del nivel 0 pasa a los vencidos*/
+void wheelAdvance(timer_wheel *W);
+
+/*Función para sacar el siguiente vencido sin atender (NULL si no hay)*/
+static inline timer_node* wheelPopDue(timer_wheel *W){
+    timer_node *node = W->due;
+    if(node != NULL){
+        W->due = node->next;
+        W->pending--;
+    }
+    return node;
+}
+
+/*Función para liberar un nodo de la rueda*/
+static inline void freeTimerNode(timer_node *node){
+    memFree(MEM_NODES, node, sizeof(timer_node) + node->len);
+}
+
+/*Función para liberar todos los nodos de la rueda*/
+void freeTimerWheel(timer_wheel *W);
+
+/*Función para imprimir los datos del TTL*/
+void ttlStats(timer_wheel *W);
+
+/*Función para leer la opción "ttl=ms" (TTL por omisión; con 0 sólo vencen los que lo piden al insertar). Regresa YES si era ésa*/
+int parseTTLOption(int *ttl, uint64_t *ms, const char *arg);
+
+/*...............................................AGREGACIÓN...............................................................................*/
+/*Los comandos de agregación son los mismos en los dos programas: "add llave [delta]" (upsert_add), "get llave" y "aggload archivo" (en
+//...paralelo, con tablas locales por partición que al final se juntan)*/
+
+/*Función para escoger la partición de una llave (bits altos de la llave mezclada, para no depender de los bits bajos de adler32)*/
+static inline size_t aggPartition(uint32_t key, size_t partitions){
+    return (size_t)(((uint64_t)(uint32_t)(key * 2654435761u) * partitions) >> 32);
+}
+
+#define AGG_KEY 100             //Bytes del buffer de la llave de una línea de agregación (como en el ciclo de comandos, a lo más 99)
+#define AGG_LINE 160            //Bytes de una línea de "aggload" (la llave más el comando y el delta)
+
+/*Función para leer una línea de agregación: "add llave [delta]" o "insert llave" (cuenta 1). La llave se deja en "number" (de AGG_KEY
+//...bytes). Regresa NO si la línea no suma nada*/
+int parseAggLine(const char *line, record *rec, char *number, int64_t *delta);
+
+/*Función para leer la opción "agg" (acumulador por contenido para los comandos de agregación; con ella "insert llave" también cuenta 1,
+//...igual que en "aggload"). Regresa YES si era ésa*/
+int parseAggOption(int *agg, const char *arg);
+
+/*Función para saber si un comando es de agregación*/
+int isAggCommand(const char *command);
+
+/*.....................................REDIMENSIÓN EN SEGUNDO PLANO......................................................................*/
+/*En vez de reconstruir la tabla en medio de una inserción o un borrado, el camino rápido sólo "agenda" la redimensión: un hilo aparte
+//...copia la tabla vieja a una nueva por bloques, mientras las operaciones siguen sobre la vieja y se anotan en una bitácora. Al terminar
+//...de copiar, el hilo aplica la bitácora y deja la tabla nueva lista; la siguiente operación sólo cambia un puntero por otro.
+//...El candado sólo se toma mientras hay una redimensión en curso (y el hilo lo suelta después de cada bloque). Aquí está lo que no
+//...depende de la tabla (el hilo, la bitácora y la opción "bg"); cada programa pone cómo se copian sus casillas o cabezas y cómo se
+//...aplica una operación anotada*/
+#define RS_IDLE 0               //No hay redimensión en curso
+#define RS_BUILDING 1           //El hilo está construyendo la tabla nueva
+#define RS_READY 2              //La tabla nueva ya tiene todo; falta cambiarla por la vieja
+#define RESIZE_CHUNK 4096       //Casillas (o entradas de la bitácora) que el hilo procesa cada vez que toma el candado
+
+/*Estructura de una operación anotada en la bitácora mientras se construye la tabla nueva*/
+typedef struct{
+    record rec;                 //Copia del record (el buffer del programa se reutiliza)
+    int operation;              //UP = inserción, DOWN = borrado
+}resize_op;
+
+/*Estructura del hilo de redimensión*/
+typedef struct resize_worker{
+    pthread_t thread;
+    pthread_mutex_t lock;       //Protege a la tabla vieja, a la nueva y a la bitácora mientras hay una redimensión en curso
+    int phase;                  //RS_IDLE, RS_BUILDING o RS_READY
+    int mode;                   //Estrategia de las tablas
+    void *source;               //Tabla vieja (la que siguen usando las operaciones)
+    void *target;               //Tabla nueva (sólo la toca el hilo hasta que está lista)
+    size_t span;                //Casillas o cabezas de la tabla vieja
+    void (*copy)(struct resize_worker *RW, size_t start, size_t end);     //Copia a la nueva lo que hay en las posiciones [start, end) de la vieja
+    void (*replay)(struct resize_worker *RW, record *rec, int operation); //Aplica a la nueva una operación de la bitácora
+    resize_op *log;             //Bitácora de operaciones hechas sobre la tabla vieja durante la copia
+    size_t log_head;            //Primera operación de la bitácora que falta aplicar
+    size_t log_len;             //No. de operaciones anotadas
+    size_t log_cap;             //Capacidad reservada de la bitácora
+}resize_worker;
+
+/*Función para inicializar el hilo de redimensión (todavía sin hilo: se crea al agendar)*/
+void initResizeWorker(resize_worker *RW, int mode, void (*copy)(resize_worker*, size_t, size_t), void (*replay)(resize_worker*, record*, int));
+
+/*Función para leer la fase (el hilo la cambia a RS_READY por su cuenta)*/
+static inline int resizePhase(resize_worker *RW){
+    return __atomic_load_n(&RW->phase, __ATOMIC_ACQUIRE);
+}
+
+/*Función para arrancar el hilo que copia "source" (de "span" posiciones) a "target", que ya está creada y vacía. Regresa NO si no se
+//...pudo crear el hilo (entonces quien llamó redimensiona como siempre)*/
+int startResizeWorker(resize_worker *RW, void *source, void *target, size_t span);
+
+/*Función para esperar al hilo si ya terminó (o, con "wait", hasta que termine). Regresa YES si la tabla nueva ya se puede tomar de
+//..."target" (y la vieja liberar de "source")*/
+int finishResizeWorker(resize_worker *RW, int wait);
+
+/*Función para anotar en la bitácora una operación hecha sobre la tabla vieja (se llama con el candado tomado)*/
+void logResizeOp(resize_worker *RW, record *rec, int operation);
+
+/*Función para liberar la bitácora (cuando ya no hay redimensión en curso)*/
+void freeResizeWorker(resize_worker *RW);
+
+/*Función para leer la opción "bg" (redimensionar en segundo plano). Regresa YES si era ésa*/
+int parseBackgroundOption(int *background, const char *arg);
+
+/*...............................................CICLO DE COMANDOS.........................................................................*/
+/*Los dos programas leen los mismos comandos ("insert llave", "delete llave", "find llave", "print", "count", "mem" o "stop" y "exit") con
+//...un solo ciclo: cada estrategia llena una tabla de operaciones y el ciclo sólo las llama, así todo comando común existe en todas.
+//...Lo que es propio de una estrategia (conjuntos, lotes, agregación, "advance" del TTL, "findall", etc.) lo atiende su función
+//..."command", que ve cada comando antes que el ciclo*/
+
+/*Estructura con las operaciones de una estrategia para el ciclo de comandos ("T" es lo que necesite la estrategia: su tabla y opciones)*/
+typedef struct{
+    int (*command)(void *T, char *buffer, char *command, char *number);   //Comandos propios (NULL = ninguno). Regresa YES si lo atendió
+    void (*insert)(void *T, record *rec, const char *extra);               //"extra" es la tercera palabra de la línea ("" si no hay)
+    void (*remove)(void *T, record *rec);
+    int (*find)(void *T, record *rec);
+    void (*print)(void *T);
+    size_t (*count)(void *T);
+    void (*stats)(void *T);             //Datos propios que se imprimen con "mem" o "stop" (NULL = ninguno)
+    void (*destroy)(void *T);           //Liberar todo al salir (y lo que se imprima al final)
+}command_ops;
+
+/*Función para atender los comandos de la entrada con las operaciones "ops" sobre "T" hasta "exit" o el fin de la entrada. Al terminar
+//...cierra la traza y libera "T"*/
+void runCommands(const command_ops *ops, void *T, trace_writer *TW);
+
+#endif
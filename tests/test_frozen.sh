@@ -0,0 +1,56 @@
+#!/bin/sh
+#Prueba de la tabla congelada: se insertan llaves (y se borran algunas), se congela escribiendo el archivo ("freeze archivo") y se busca
+#...cada llave, las borradas y otras que nunca estuvieron; después otra corrida abre el archivo ("frozen=archivo") y debe contestar lo
+#...mismo, también después de "thaw". Uso: tests/test_frozen.sh [directorio de HT_OA]
+BIN=${1:-.}
+TMP=${TMPDIR:-/tmp}/ht_frozen.$$
+mkdir -p "$TMP" || exit 1
+trap 'rm -rf "$TMP"' EXIT
+
+#Las inserciones y borrados (load.txt), las consultas (query.txt) y sus respuestas (exp.txt)
+awk -v load="$TMP/load.txt" -v query="$TMP/query.txt" -v want="$TMP/exp.txt" 'BEGIN{
+    n = 0
+    for(i=0; i<3000; i++)
+        print "insert key" i > load
+    for(i=0; i<3000; i+=3)
+        print "delete key" i > load
+    for(i=0; i<4000; i++){
+        print "find key" i > query
+        if(i < 3000 && i%3 != 0){
+            print "Encontrado: key" i > want
+            n++
+        }
+        else
+            print "No encontrado: key" i > want
+    }
+    print "count" > query
+    print "Elementos ocupados: " n > want
+}'
+cat "$TMP/exp.txt" "$TMP/exp.txt" > "$TMP/exp2.txt"
+
+#Corre "$@" con los comandos de la entrada y compara las respuestas con $1
+check(){
+    want=$1
+    shift
+    "$@" 2>/dev/null | grep -E '^(Encontrado|No encontrado|Elementos ocupados):' > "$TMP/got.txt"
+    if cmp -s "$TMP/got.txt" "$want"; then
+        echo "$*: OK"
+    else
+        echo "$*: FALLA"
+        fail=1
+    fi
+}
+
+fail=0
+for mode in 1 2 3 4; do
+    rm -f "$TMP/frozen.ht"
+    #Congelada en memoria (y escrita), y otra vez después de regresarla a open addressing
+    { cat "$TMP/load.txt"; echo "freeze $TMP/frozen.ht"; cat "$TMP/query.txt"; echo thaw; cat "$TMP/query.txt"; echo stop; } |
+        check "$TMP/exp2.txt" "$BIN/HT_OA" $mode
+    #Desde el archivo, con cada estrategia para "thaw"
+    for other in 1 2 3 4; do
+        { cat "$TMP/query.txt"; echo thaw; cat "$TMP/query.txt"; echo stop; } |
+            check "$TMP/exp2.txt" "$BIN/HT_OA" $other frozen="$TMP/frozen.ht"
+    done
+done
+exit $fail
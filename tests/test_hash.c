@@ -0,0 +1,67 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../ht_common.h"
+
+/*Prueba del hash por lotes: cada núcleo que tenga el CPU (escalar, AVX2 y AVX-512) debe dar lo mismo que seededHash64 llave por llave,
+//...con longitudes distintas en cada carril (de 0 a 3 bloques completos más el último) y lotes que no llenan todos los carriles.
+//...seededKeyBatch (con el núcleo que escoja el selector) debe dar lo mismo que seededKey*/
+#define KEYS 203                        //Ni múltiplo de 4 ni de 8, para que el último lote quede incompleto
+#define MAX_LEN 40
+
+typedef void (*hash_kernel)(uint64_t seed, const unsigned char **data, const size_t *len, size_t n, uint64_t *out);
+
+/*Función para revisar un núcleo contra seededHash64 con todos los tamaños de lote de 1 a KEYS. Regresa el No. de diferencias*/
+int checkKernel(const char *name, hash_kernel kernel, uint64_t seed, const unsigned char **data, const size_t *len){
+    uint64_t out[KEYS];
+    int errors = 0;
+    for(size_t n=1; n<=KEYS; n++){
+        kernel(seed, data, len, n, out);
+        for(size_t i=0; i<n; i++){
+            if(out[i] != seededHash64(seed, data[i], len[i])){
+                if(errors == 0)
+                    fprintf(stderr, "%s: lote de %zu, llave %zu (longitud %zu) no coincide\n", name, n, i, len[i]);
+                errors++;
+            }
+        }
+    }
+    printf("%s: %s\n", name, (errors == 0) ? "OK" : "FALLA");
+    return errors;
+}
+
+int main(){
+    static unsigned char bytes[KEYS][MAX_LEN];
+    const unsigned char *data[KEYS];
+    size_t len[KEYS];
+    uint32_t keys[KEYS];
+    srand(7);
+    for(size_t i=0; i<KEYS; i++){
+        for(size_t j=0; j<MAX_LEN; j++)
+            bytes[i][j] = (unsigned char)rand();
+        data[i] = bytes[i];
+        len[i] = (i < MAX_LEN) ? i : (size_t)rand() % MAX_LEN;
+    }
+    int errors = 0;
+    uint64_t seeds[] = {0, 1, 0x9E3779B97F4A7C15ULL};
+    for(size_t s=0; s<sizeof(seeds)/sizeof(seeds[0]); s++){
+        errors += checkKernel("escalar", seededHashScalar, seeds[s], data, len);
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_cpu_init();
+        if(__builtin_cpu_supports("avx2"))
+            errors += checkKernel("AVX2", seededHashAVX2, seeds[s], data, len);
+        else
+            printf("AVX2: no disponible\n");
+        if(__builtin_cpu_supports("avx512f"))
+            errors += checkKernel("AVX-512", seededHashAVX512, seeds[s], data, len);
+        else
+            printf("AVX-512: no disponible\n");
+#endif
+        seededKeyBatch(seeds[s], data, len, KEYS, keys);
+        int batch = 0;
+        for(size_t i=0; i<KEYS; i++)
+            batch += (keys[i] != seededKey(seeds[s], data[i], len[i]));
+        printf("seededKeyBatch: %s\n", (batch == 0) ? "OK" : "FALLA");
+        errors += batch;
+    }
+    return (errors == 0) ? 0 : 1;
+}
@@ -0,0 +1,109 @@
+#!/bin/sh
+#Prueba de modelo: para cada estrategia (y cada opción que cambia la tabla por dentro) se corre la misma secuencia aleatoria de insert,
+#...delete, find y count, y lo que contestan find y count se compara con un conjunto llevado en awk. Las llaves se repiten mucho, así que
+#...hay reinserciones sobre lápidas y borrados de llaves que no están. Hay tres flujos de llaves: cadenas, números (con los valores que
+#...las tablas de llaves enteras usan como marcas y llaves de más de 32 bits) y mezclados (empiezan con números y a la mitad llegan
+#...cadenas, así que las tablas enteras se pasan a las de cadenas con todo lo que tenían). Uso: tests/test_model.sh [directorio de HT_OA
+#...y HT_SC]
+BIN=${1:-.}
+TMP=${TMPDIR:-/tmp}/ht_model.$$
+mkdir -p "$TMP" || exit 1
+trap 'rm -rf "$TMP"' EXIT
+
+#Genera con la semilla $1 y el flujo $2 (str, num o mix) las operaciones (ops.txt, terminan con count) y las respuestas esperadas (exp.txt)
+generate(){
+    awk -v seed="$1" -v stream="$2" -v ops="$TMP/ops.txt" -v want="$TMP/exp.txt" '
+    #Llave número "i" del flujo: las primeras son las marcas (vacío y borrado de 32 bits, y 2^64-2), una de cada tres pasa de 2^32 y
+    #...en el flujo mezclado, a partir de la mitad, una de cada cuatro es una cadena (a veces con forma de número con ceros a la izquierda)
+    function key(i, op){
+        if(stream == "str")
+            return "k" i
+        if(stream == "mix" && op >= 2000 && i%4 == 1)
+            return (i%8 == 1) ? "k" i : "0" i
+        if(i < 3)
+            return (i == 0) ? "4294967294" : (i == 1) ? "4294967295" : "18446744073709551614"
+        if(i%3 == 0)
+            return sprintf("%.0f", 4294967296 + i*7919)
+        return i
+    }
+    BEGIN{
+        srand(seed)
+        n = 0
+        for(op=0; op<4000; op++){
+            k = key(int(rand()*rand()*600), op)
+            r = rand()
+            if(r < 0.45){
+                print "insert " k > ops
+                if(!(k in set)){ set[k] = 1; n++ }
+            }
+            else if(r < 0.7){
+                print "delete " k > ops
+                if(k in set){ delete set[k]; n-- }
+            }
+            else if(r < 0.97){
+                print "find " k > ops
+                print ((k in set) ? "Encontrado: " : "No encontrado: ") k > want
+            }
+            else{
+                print "count" > ops
+                print "Elementos ocupados: " n > want
+            }
+        }
+        print "count" > ops
+        print "Elementos ocupados: " n > want
+    }'
+}
+
+#Corre "$@" con las operaciones (más los comandos de $extra antes de stop) y compara con lo esperado
+check(){
+    { cat "$TMP/ops.txt"; printf '%sstop\n' "$extra"; } | "$@" 2>/dev/null |
+        grep -E '^(Encontrado|No encontrado|Elementos ocupados):' > "$TMP/got.txt"
+    if cmp -s "$TMP/got.txt" "$TMP/exp.txt"; then
+        echo "$*: OK"
+    else
+        echo "$*: FALLA (semilla $seed, llaves $stream)"
+        fail=1
+    fi
+}
+
+fail=0
+for stream in str num mix; do
+    for seed in 1 2; do
+        generate $seed $stream
+        extra=""
+        for mode in 1 2 3 4 5 6; do
+            check "$BIN/HT_OA" $mode
+        done
+        #La compartida deja su segmento hasta "unlink"
+        extra="unlink
+"
+        check "$BIN/HT_OA" 7 shm=/HT_OA_test.$$
+        extra=""
+        for mode in 1 0; do
+            check "$BIN/HT_SC" $mode
+        done
+        #La extensible vive en un archivo, así que cada corrida empieza con uno nuevo
+        rm -f "$TMP/sce.db"
+        check "$BIN/HT_SC" 2 file="$TMP/sce.db"
+        #Las opciones que cambian la tabla por dentro: el TTL (con un vencimiento que no llega durante la prueba), la adaptativa, la
+        #...caché (con lugar para todas las llaves, así que no desaloja nada), el hashing lineal, la redimensión en segundo plano y la
+        #...agregación (ahí "insert" suma 1 al acumulador, pero find, delete y count no cambian)
+        for mode in 1 2 3; do
+            check "$BIN/HT_OA" $mode bg
+        done
+        for mode in 1 2 3 4; do
+            check "$BIN/HT_OA" $mode ttl=3600000
+            check "$BIN/HT_OA" $mode adapt
+            check "$BIN/HT_OA" $mode cache=4096
+            check "$BIN/HT_OA" $mode agg
+        done
+        for mode in 1 0; do
+            check "$BIN/HT_SC" $mode ttl=3600000
+            check "$BIN/HT_SC" $mode adapt
+            check "$BIN/HT_SC" $mode linear
+            check "$BIN/HT_SC" $mode bg
+            check "$BIN/HT_SC" $mode agg
+        done
+    done
+done
+exit $fail